@@ -6,33 +6,51 @@
 
 #include "app_module.h"
 
+#include "../base/bnd_box_engine.h"
 #include "../base/bnd_utils.h"
+#include "../base/brep_mesh_cache.h"
 #include "../base/brep_utils.h"
+#include "../base/caf_utils.h"
 #include "../base/cpp_utils.h"
 #include "../base/io_reader.h"
 #include "../base/io_writer.h"
 #include "../base/io_system.h"
+#include "../base/mesh_edge_engine.h"
+#include "../base/mesh_lod_engine.h"
+#include "../base/point_cloud_data.h"
+#include "../base/point_cloud_octree.h"
 #include "../base/settings.h"
+#include "../base/task_progress.h"
+#include "../base/xcaf.h"
 #include "../gui/gui_application.h"
 #include "../gui/gui_document.h"
 #include "qtcore_utils.h"
 #include "filepath_conv.h"
 #include "qstring_conv.h"
 
-#include <BRepBndLib.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRepTools.hxx>
+#include <OSD_Parallel.hxx>
+#include <TopoDS_TShape.hxx>
 
 #include <QtCore/QDir>
+#include <QtCore/QStandardPaths>
 #include <QtCore/QtDebug>
 #include <QtGui/QGuiApplication>
 
 #include <fmt/format.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <iterator>
+#include <unordered_set>
 
 namespace Mayo {
 
 AppModule::AppModule()
     : m_settings(new Settings),
       m_props(m_settings),
+      m_brepMeshCache(filepathFrom(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)) / "brep_mesh", 0),
       m_stdLocale(std::locale("")),
       m_qtLocale(QLocale::system())
 {
@@ -247,40 +265,50 @@ void AppModule::recordRecentFileThumbnails(GuiApplication* guiApp)
     m_props.recentFiles.setValue(newListRecentFile);
 }
 
-static QuantityLength shapeChordalDeflection(const TopoDS_Shape& shape)
+// Returns the greatest dimension of the bounding box of 'shape', or -1 if no finite bounding box
+static double shapeMaxDimension(const TopoDS_Shape& shape)
 {
-    // Excerpted from Prs3d::GetDeflection(...)
-    constexpr QuantityLength baseDeviation = 1 * Quantity_Millimeter;
-
-    Bnd_Box bndBox;
-    constexpr bool useTriangulation = true;
-    BRepBndLib::Add(shape, bndBox, !useTriangulation);
+    // Note: bounding box is cached, so meshing several times the same shape doesn't recompute it
+    Bnd_Box bndBox = BndBoxEngine::instance().get(shape, BndBoxEngine::Mode::Geometry);
     if (bndBox.IsVoid())
-        return baseDeviation;
+        return -1;
 
     if (BndUtils::isOpen(bndBox)) {
         if (!BndUtils::hasFinitePart(bndBox))
-            return baseDeviation;
+            return -1;
 
         bndBox = BndUtils::finitePart(bndBox);
     }
 
     const auto coords = BndBoxCoords::get(bndBox);
     const gp_XYZ diag = coords.maxVertex().XYZ() - coords.minVertex().XYZ();
-    const double diagMaxComp = std::max({ diag.X(), diag.Y(), diag.Z() });
-    return 4 * diagMaxComp * baseDeviation;
+    return std::max({ diag.X(), diag.Y(), diag.Z() });
+}
+
+static QuantityLength shapeChordalDeflection(const TopoDS_Shape& shape)
+{
+    // Excerpted from Prs3d::GetDeflection(...)
+    constexpr QuantityLength baseDeviation = 1 * Quantity_Millimeter;
+    const double maxDimension = shapeMaxDimension(shape);
+    if (maxDimension < 0)
+        return baseDeviation;
+
+    return 4 * maxDimension * baseDeviation;
 }
 
 OccBRepMeshParameters AppModule::brepMeshParameters(const TopoDS_Shape& shape) const
 {
-    using BRepMeshQuality = AppModuleProperties::BRepMeshQuality;
+    return this->brepMeshParameters(shape, m_props.meshingQuality);
+}
 
+OccBRepMeshParameters AppModule::brepMeshParameters(const TopoDS_Shape& shape, BRepMeshQuality quality) const
+{
     OccBRepMeshParameters params;
     params.InParallel = true;
 #if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
     params.AllowQualityDecrease = true;
 #endif
-    if (m_props.meshingQuality == BRepMeshQuality::UserDefined) {
+    if (quality == BRepMeshQuality::UserDefined) {
         params.Deflection = UnitSystem::meters(m_props.meshingChordalDeflection.quantity());
         params.Angle = UnitSystem::radians(m_props.meshingAngularDeflection.quantity());
         params.Relative = m_props.meshingRelative;
@@ -301,7 +329,7 @@ OccBRepMeshParameters AppModule::brepMeshParameters(const TopoDS_Shape& shape) c
             }
             return { 1, 1 };
         };
-        const Coefficients coeffs = fnCoefficients(m_props.meshingQuality);
+        const Coefficients coeffs = fnCoefficients(quality);
         params.Deflection = UnitSystem::meters(coeffs.chordalDeflection * shapeChordalDeflection(shape));
         params.Angle = UnitSystem::radians(coeffs.angularDeflection * (20 * Quantity_Degree));
     }
@@ -311,13 +339,287 @@ OccBRepMeshParameters AppModule::brepMeshParameters(const TopoDS_Shape& shape) c
 
 void AppModule::computeBRepMesh(const TopoDS_Shape& shape, TaskProgress* progress)
 {
-    BRepUtils::computeMesh(shape, this->brepMeshParameters(shape), progress);
+    this->computeBRepMesh(shape, this->brepMeshParameters(shape), progress);
 }
 
 void AppModule::computeBRepMesh(const TDF_Label& labelEntity, TaskProgress* progress)
 {
-    if (XCaf::isShape(labelEntity))
-        this->computeBRepMesh(XCaf::shape(labelEntity), progress);
+    this->computeBRepMesh(labelEntity, m_props.meshingQuality, progress);
+}
+
+void AppModule::computeBRepMesh(const TDF_Label& labelEntity, BRepMeshQuality quality, TaskProgress* progress)
+{
+    std::vector<BRepMeshJob> vecJob = this->brepMeshJobs(labelEntity, quality);
+    AppModule::eraseMeshedJobs(&vecJob);
+    this->runBRepMeshJobs(vecJob, progress);
+}
+
+std::vector<AppModule::BRepMeshJob> AppModule::refineBRepMeshJobs(const TDF_Label& labelEntity) const
+{
+    std::vector<BRepMeshJob> vecJob = this->brepMeshJobs(labelEntity, m_props.meshingQuality);
+    AppModule::eraseMeshedJobs(&vecJob);
+    return vecJob;
+}
+
+std::function<void()> AppModule::refineBRepMesh(std::vector<BRepMeshJob> vecJob, TaskProgress* progress)
+{
+    if (vecJob.empty())
+        return {};
+
+    // Mesh copies of the shapes, geometry is shared as the mesher doesn't modify it
+    std::vector<TopoDS_Shape> vecShape;
+    vecShape.reserve(vecJob.size());
+    for (BRepMeshJob& job : vecJob) {
+        vecShape.push_back(job.shape);
+        constexpr bool copyGeom = false;
+        constexpr bool copyMesh = false;
+        job.shape = BRepBuilderAPI_Copy(job.shape, copyGeom, copyMesh).Shape();
+    }
+
+    this->runBRepMeshJobs(vecJob, progress);
+    if (TaskProgress::isAbortRequested(progress))
+        return {};
+
+    std::vector<TopoDS_Shape> vecShapeRefined;
+    vecShapeRefined.reserve(vecJob.size());
+    for (const BRepMeshJob& job : vecJob)
+        vecShapeRefined.push_back(job.shape);
+
+    return [=]{
+        for (unsigned i = 0; i < vecShape.size(); ++i) {
+            BRepUtils::transferMesh(vecShapeRefined.at(i), vecShape.at(i));
+            MeshEdgeEngine::instance().invalidate(vecShape.at(i));
+        }
+    };
+}
+
+void AppModule::computeBRepMeshLevelsOfDetail(const TDF_Label& labelEntity, TaskProgress* progress)
+{
+    // Chordal deflection of the levels is the one of configured quality multiplied by these factors,
+    // angular deflection is multiplied by their square root
+    constexpr double deflectionFactors[] = { 4., 16. };
+    constexpr int levelCount = int(std::size(deflectionFactors));
+    // Shapes having less triangles don't get levels, they are cheap enough to draw
+    constexpr int minTriangleCount = 1024;
+    const double maxAngle = UnitSystem::radians(45 * Quantity_Degree);
+
+    std::vector<BRepMeshJob> vecJob = this->brepMeshJobs(labelEntity, m_props.meshingQuality);
+    auto itJobEnd = std::remove_if(vecJob.begin(), vecJob.end(), [](const BRepMeshJob& job) {
+        return MeshLodEngine::triangleCount(job.shape) < minTriangleCount;
+    });
+    vecJob.erase(itJobEnd, vecJob.end());
+
+    // Levels are meshed on copies of the shapes, geometry is shared as the mesher doesn't modify it
+    // Parallelism is at level and prototype level
+    const int jobCount = CppUtils::safeStaticCast<int>(vecJob.size());
+    std::vector<TopoDS_Shape> vecShapeLevel(jobCount * levelCount);
+    const int meshCount = CppUtils::safeStaticCast<int>(vecShapeLevel.size());
+    TaskProgressCounter progressCounter(progress, meshCount);
+    OSD_Parallel::For(0, meshCount, [&](int i) {
+        if (TaskProgress::isAbortRequested(progress))
+            return;
+
+        const BRepMeshJob& job = vecJob.at(i / levelCount);
+        const double factor = deflectionFactors[i % levelCount];
+        OccBRepMeshParameters params = job.params;
+        params.InParallel = false;
+        params.Deflection *= factor;
+        params.Angle = std::min(params.Angle * std::sqrt(factor), maxAngle);
+        constexpr bool copyGeom = false;
+        constexpr bool copyMesh = false;
+        const TopoDS_Shape shapeLevel = BRepBuilderAPI_Copy(job.shape, copyGeom, copyMesh).Shape();
+        BRepUtils::computeMesh(shapeLevel, params);
+        vecShapeLevel.at(i) = shapeLevel;
+        progressCounter.add();
+    }, meshCount < 2/*isForceSingleThreadExecution*/);
+    progressCounter.flush();
+
+    if (TaskProgress::isAbortRequested(progress))
+        return;
+
+    // Keep only the levels significantly lighter than their finer level
+    for (int i = 0; i < jobCount; ++i) {
+        std::vector<TopoDS_Shape> vecLevel;
+        int finerTriangleCount = MeshLodEngine::triangleCount(vecJob.at(i).shape);
+        for (int j = 0; j < levelCount; ++j) {
+            const TopoDS_Shape& shapeLevel = vecShapeLevel.at(i * levelCount + j);
+            const int triangleCount = MeshLodEngine::triangleCount(shapeLevel);
+            if (triangleCount > 0 && 2 * triangleCount <= finerTriangleCount) {
+                vecLevel.push_back(shapeLevel);
+                finerTriangleCount = triangleCount;
+            }
+        }
+
+        MeshLodEngine::instance().setLevels(vecJob.at(i).shape, std::move(vecLevel));
+    }
+}
+
+MeshPostProcess::Parameters AppModule::meshPostProcessParameters() const
+{
+    MeshPostProcess::Parameters params;
+    params.weldNodes = m_props.meshImportWeldNodes;
+    params.weldTolerance = UnitSystem::millimeters(m_props.meshImportWeldTolerance.quantity());
+    params.computeNormals = m_props.meshImportComputeNormals;
+    params.creaseAngle = UnitSystem::radians(m_props.meshImportCreaseAngle.quantity());
+    return params;
+}
+
+TessellationStats AppModule::computeTessellationStats(const DocumentPtr& doc, TaskProgress* progress)
+{
+    return TessellationStats::compute(doc, [=](const TopoDS_Shape& shape) {
+        // Products are meshed concurrently
+        OccBRepMeshParameters params = this->brepMeshParameters(shape);
+        params.InParallel = false;
+        BRepUtils::computeMesh(shape, params);
+    }, progress);
+}
+
+std::vector<AppModule::BRepMeshJob> AppModule::brepMeshJobs(
+        const TDF_Label& labelEntity, BRepMeshQuality quality) const
+{
+    if (!XCaf::isShape(labelEntity))
+        return {};
+
+    const TopoDS_Shape shapeEntity = XCaf::shape(labelEntity);
+    const bool isMeshPerPart = m_props.meshingPerPart && quality != BRepMeshQuality::UserDefined;
+    if (!XCaf::isShapeAssembly(labelEntity) && !isMeshPerPart)
+        return { BRepMeshJob{ shapeEntity, this->brepMeshParameters(shapeEntity, quality) } };
+
+    // Collect the prototype shapes referred by the assembly, each prototype being listed once
+    // whatever the count of its references(ie instances)
+    std::vector<TopoDS_Shape> vecPrototype;
+    std::unordered_set<const TopoDS_TShape*> setVisitedTShape;
+    std::function<void(const TDF_Label&)> fnAddPrototypes;
+    fnAddPrototypes = [&](const TDF_Label& labelAssembly) {
+        for (const TDF_Label& labelComponent : XCaf::shapeComponents(labelAssembly)) {
+            const TDF_Label labelReferred = XCaf::shapeReferred(labelComponent);
+            const TopoDS_Shape shapeReferred = XCaf::shape(labelReferred);
+            if (shapeReferred.IsNull() || !setVisitedTShape.insert(shapeReferred.TShape().get()).second)
+                continue; // Skip already visited prototype
+
+            if (XCaf::isShapeAssembly(labelReferred))
+                fnAddPrototypes(labelReferred);
+            else
+                vecPrototype.push_back(shapeReferred);
+        }
+    };
+    if (XCaf::isShapeAssembly(labelEntity))
+        fnAddPrototypes(labelEntity);
+    else
+        vecPrototype.push_back(shapeEntity);
+
+    // Compute meshing parameters of each prototype
+    // In "per part" mode deflection is derived from the prototype bounding box, so small parts
+    // aren't over-tessellated and big ones aren't too coarse. Otherwise parameters are derived from
+    // the whole assembly, as for a single shape
+    const OccBRepMeshParameters assemblyParams = this->brepMeshParameters(shapeEntity, quality);
+    std::vector<OccBRepMeshParameters> vecParams(vecPrototype.size(), assemblyParams);
+    if (isMeshPerPart) {
+        // Deflection not lower than the size of 'meshingScreenSpaceError' pixels in a view where
+        // the whole assembly fits
+        // Actual view size isn't known at meshing time(and views can be resized), so a typical
+        // full HD viewport width is assumed
+        constexpr double referenceViewportWidth = 1920.;
+        const double screenSpaceError = m_props.meshingScreenSpaceError;
+        const double assemblyMaxDimension = screenSpaceError > 0 ? shapeMaxDimension(shapeEntity) : -1.;
+        const double minDeflection =
+                assemblyMaxDimension > 0 ?
+                    assemblyMaxDimension * screenSpaceError / referenceViewportWidth :
+                    0.;
+        OSD_Parallel::For(0, CppUtils::safeStaticCast<int>(vecPrototype.size()), [&](int i) {
+            OccBRepMeshParameters& params = vecParams.at(i);
+            params = this->brepMeshParameters(vecPrototype.at(i), quality);
+            // Floor is an absolute length, it doesn't apply to deflection relative to edge sizes
+            if (!params.Relative)
+                params.Deflection = std::max(params.Deflection, minDeflection);
+        });
+    }
+
+    std::vector<BRepMeshJob> vecJob;
+    for (unsigned i = 0; i < vecPrototype.size(); ++i)
+        vecJob.push_back({ vecPrototype.at(i), vecParams.at(i) });
+
+    return vecJob;
+}
+
+void AppModule::eraseMeshedJobs(std::vector<BRepMeshJob>* ptrVecJob)
+{
+    // Skip prototypes already meshed with the requested precision
+    // Relative deflection is a coefficient applied by the mesher to the size of each edge, it can't
+    // be compared to the deflection of existing triangulations. Such jobs are kept, the mesher
+    // itself doesn't recompute faces already meshed with adequate precision
+    auto itJobEnd = std::remove_if(ptrVecJob->begin(), ptrVecJob->end(), [](const BRepMeshJob& job) {
+        return !job.params.Relative && BRepTools::Triangulation(job.shape, job.params.Deflection);
+    });
+    ptrVecJob->erase(itJobEnd, ptrVecJob->end());
+}
+
+void AppModule::runBRepMeshJobs(const std::vector<BRepMeshJob>& vecJob, TaskProgress* progress)
+{
+    if (vecJob.size() == 1) {
+        this->computeBRepMesh(vecJob.front().shape, vecJob.front().params, progress);
+        return;
+    }
+
+    // Parallelism is at prototype level
+    const int meshCount = CppUtils::safeStaticCast<int>(vecJob.size());
+    TaskProgressCounter progressCounter(progress, meshCount);
+    OSD_Parallel::For(0, meshCount, [&](int i) {
+        if (TaskProgress::isAbortRequested(progress))
+            return;
+
+        OccBRepMeshParameters params = vecJob.at(i).params;
+        params.InParallel = false;
+        this->computeBRepMesh(vecJob.at(i).shape, params, nullptr);
+        progressCounter.add();
+    });
+    progressCounter.flush();
+}
+
+void AppModule::computePointCloudOctree(const TDF_Label& labelEntity, TaskProgress* progress)
+{
+    auto attrPointCloudData = CafUtils::findAttribute<PointCloudData>(labelEntity);
+    if (attrPointCloudData.IsNull() || !attrPointCloudData->points())
+        return;
+
+    const int threshold = m_props.pointCloudStreamingThreshold.value();
+    if (threshold <= 0 || attrPointCloudData->pointCount() < threshold)
+        return;
+
+    const OccHandle<Graphic3d_ArrayOfPoints> points = attrPointCloudData->points();
+    const FilePath dirPath =
+            filepathFrom(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)) / "point_cloud";
+    const FilePath filepath =
+            dirPath / (PointCloudOctree::computeKey(points) + PointCloudOctree::fileExtension());
+    std::shared_ptr<PointCloudOctree> octree = PointCloudOctree::open(filepath);
+    if (!octree || octree->pointCount() != uint64_t(points->VertexNumber())) {
+        octree.reset(); // Release the file before it's overwritten
+        octree = PointCloudOctree::build(points, filepath, progress);
+    }
+
+    if (!octree)
+        return; // Points are kept in memory
+
+    PointCloudData::Set(labelEntity, octree);
+    PointCloudOctree::evictFiles(dirPath, uint64_t(m_props.pointCloudCacheMaxSize.value()) * 1024 * 1024);
+}
+
+void AppModule::computeBRepMesh(
+        const TopoDS_Shape& shape, const OccBRepMeshParameters& params, TaskProgress* progress)
+{
+    if (!m_props.meshingCacheEnabled) {
+        BRepUtils::computeMesh(shape, params, progress);
+        return;
+    }
+
+    // Key must be computed before meshing
+    const std::string cacheKey = BRepMeshCache::computeKey(shape, params);
+    if (m_brepMeshCache.load(shape, cacheKey))
+        return;
+
+    BRepUtils::computeMesh(shape, params, progress);
+    m_brepMeshCache.setMaxSize(uint64_t(m_props.meshingCacheMaxSize.value()) * 1024 * 1024);
+    m_brepMeshCache.store(shape, cacheKey);
 }
 
 void AppModule::addPropertiesProvider(std::unique_ptr<DocumentTreeNodePropertiesProvider> ptr)
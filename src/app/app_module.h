@@ -9,20 +9,26 @@
 #include "app_module_properties.h"
 #include "qstring_utils.h"
 
+#include "../base/brep_mesh_cache.h"
 #include "../base/document_tree_node_properties_provider.h"
 #include "../base/io_parameters_provider.h"
 #include "../base/io_system.h"
+#include "../base/mesh_post_process.h"
 #include "../base/messenger.h"
 #include "../base/occ_brep_mesh_parameters.h"
 #include "../base/property_value_conversion.h"
 #include "../base/settings.h"
+#include "../base/tessellation_stats.h"
 #include "../base/unit_system.h"
 
+#include <TopoDS_Shape.hxx>
+
+#include <functional>
 #include <locale>
 #include <mutex>
+#include <vector>
 
 class TDF_Label;
-class TopoDS_Shape;
 
 namespace Mayo {
 
@@ -85,9 +91,58 @@ public:
     QSize recentFileThumbnailSize() const { return { 190, 150 }; }
 
     // Meshing of BRep shapes
+    // Computed meshes are stored in/reloaded from the on-disk mesh cache if enabled in settings
+    // For assemblies, each prototype shape is meshed once(in parallel) whatever its count of
+    // references
+    using BRepMeshQuality = AppModuleProperties::BRepMeshQuality;
     OccBRepMeshParameters brepMeshParameters(const TopoDS_Shape& shape) const;
+    OccBRepMeshParameters brepMeshParameters(const TopoDS_Shape& shape, BRepMeshQuality quality) const;
     void computeBRepMesh(const TopoDS_Shape& shape, TaskProgress* progress = nullptr);
     void computeBRepMesh(const TDF_Label& labelEntity, TaskProgress* progress = nullptr);
+    void computeBRepMesh(const TDF_Label& labelEntity, BRepMeshQuality quality, TaskProgress* progress = nullptr);
+    BRepMeshCache* brepMeshCache() { return &m_brepMeshCache; }
+
+    // Meshing of a shape with specific parameters
+    struct BRepMeshJob {
+        TopoDS_Shape shape;
+        OccBRepMeshParameters params;
+    };
+
+    // Progressive meshing: refines at configured quality the meshes of 'labelEntity' previously
+    // computed with a coarser quality
+    // Refinement is split in two steps:
+    //     - refineBRepMeshJobs() collects the shapes of 'labelEntity' to be refined, it reads the
+    //       XCAF document and current triangulations so it has to be called in the thread owning
+    //       the document
+    //     - refineBRepMesh() meshes copies of these shapes, it can be called from any thread
+    // Current triangulations are left untouched and can still be used concurrently(eg for display).
+    // The returned function swaps the refined triangulations into the shapes of 'labelEntity', it
+    // has to be called in the thread owning the graphics objects. Returns null function if there is
+    // nothing to refine
+    std::vector<BRepMeshJob> refineBRepMeshJobs(const TDF_Label& labelEntity) const;
+    std::function<void()> refineBRepMesh(std::vector<BRepMeshJob> vecJob, TaskProgress* progress = nullptr);
+
+    // Levels of detail: meshes copies of the shapes of 'labelEntity' with coarser deflections than the
+    // configured quality and stores them in MeshLodEngine, so the 3D view can switch to a lighter
+    // triangulation for parts appearing small on screen
+    // Shapes must be meshed beforehand, the ones having few triangles don't get levels
+    void computeBRepMeshLevelsOfDetail(const TDF_Label& labelEntity, TaskProgress* progress = nullptr);
+
+    // Point clouds: stores the points of 'labelEntity' in a multi-resolution octree file written in
+    // the cache directory, so they are streamed by the 3D view instead of being kept in memory
+    // Does nothing if 'labelEntity' has no in-memory point cloud or if its count of points is below
+    // the configured streaming threshold. The octree file is reused if the same points were
+    // imported before
+    void computePointCloudOctree(const TDF_Label& labelEntity, TaskProgress* progress = nullptr);
+
+    // Post-processing parameters(welding, normals) of the meshes read from files, derived from
+    // current settings
+    MeshPostProcess::Parameters meshPostProcessParameters() const;
+
+    // Statistics about the triangulations of 'doc' shapes
+    // Products not meshed yet are meshed with the parameters derived from current settings, the
+    // on-disk mesh cache being bypassed
+    TessellationStats computeTessellationStats(const DocumentPtr& doc, TaskProgress* progress = nullptr);
 
     // Providers to query document tree node properties
     void addPropertiesProvider(std::unique_ptr<DocumentTreeNodePropertiesProvider> ptr);
@@ -110,12 +165,19 @@ public:
 
 private:
     AppModule();
+    void computeBRepMesh(const TopoDS_Shape& shape, const OccBRepMeshParameters& params, TaskProgress* progress);
+
+    std::vector<BRepMeshJob> brepMeshJobs(const TDF_Label& labelEntity, BRepMeshQuality quality) const;
+    static void eraseMeshedJobs(std::vector<BRepMeshJob>* ptrVecJob);
+    void runBRepMeshJobs(const std::vector<BRepMeshJob>& vecJob, TaskProgress* progress);
+
     AppModule(const AppModule&) = delete; // Not copyable
     AppModule& operator=(const AppModule&) = delete; // Not copyable
 
     Settings* m_settings = nullptr;
     IO::System m_ioSystem;
     AppModuleProperties m_props;
+    BRepMeshCache m_brepMeshCache;
     std::vector<Message> m_messageLog;
     std::mutex m_mutexMessageLog;
     std::locale m_stdLocale;
@@ -13,6 +13,7 @@
 #include "../base/settings.h"
 #include "../base/unit_system.h"
 #include "../graphics/graphics_mesh_object_driver.h"
+#include "../gui/gui_document.h"
 
 namespace Mayo {
 
@@ -27,6 +28,7 @@ AppModuleProperties::AppModuleProperties(Settings* settings)
     const auto groupId_graphics = settings->addGroup(textId("graphics"));
 
     const auto sectionId_systemUnits = settings->addSection(this->groupId_system, textId("units"));
+    const auto sectionId_meshingImportedMeshes = settings->addSection(groupId_meshing, textId("importedMeshes"));
     const auto sectionId_graphicsClipPlanes = settings->addSection(groupId_graphics, textId("clipPlanes"));
     const auto sectionId_graphicsMeshDefaults = settings->addSection(groupId_graphics, textId("meshDefaults"));
 
@@ -57,16 +59,61 @@ AppModuleProperties::AppModuleProperties(Settings* settings)
     settings->addSetting(&this->meshingChordalDeflection, groupId_meshing);
     settings->addSetting(&this->meshingAngularDeflection, groupId_meshing);
     settings->addSetting(&this->meshingRelative, groupId_meshing);
+    settings->addSetting(&this->meshingLazy, groupId_meshing);
+    settings->addSetting(&this->meshingProgressive, groupId_meshing);
+    settings->addSetting(&this->meshingPerPart, groupId_meshing);
+    settings->addSetting(&this->meshingLevelsOfDetail, groupId_meshing);
+    this->meshingScreenSpaceError.setConstraintsEnabled(true);
+    this->meshingScreenSpaceError.setRange(0., 100.);
+    this->meshingScreenSpaceError.setSingleStep(0.5);
+    settings->addSetting(&this->meshingScreenSpaceError, groupId_meshing);
+    settings->addSetting(&this->meshingCacheEnabled, groupId_meshing);
+    this->meshingCacheMaxSize.setConstraintsEnabled(true);
+    this->meshingCacheMaxSize.setRange(0, 1024 * 1024);
+    this->meshingCacheMaxSize.setSingleStep(256);
+    settings->addSetting(&this->meshingCacheMaxSize, groupId_meshing);
+    // -- Imported meshes
+    settings->addSetting(&this->meshImportWeldNodes, sectionId_meshingImportedMeshes);
+    settings->addSetting(&this->meshImportWeldTolerance, sectionId_meshingImportedMeshes);
+    settings->addSetting(&this->meshImportComputeNormals, sectionId_meshingImportedMeshes);
+    settings->addSetting(&this->meshImportCreaseAngle, sectionId_meshingImportedMeshes);
 
     // Graphics
     settings->addSetting(&this->navigationStyle, groupId_graphics);
     settings->addSetting(&this->defaultShowOriginTrihedron, groupId_graphics);
     settings->addSetting(&this->instantZoomFactor, groupId_graphics);
     settings->addSetting(&this->turnViewAngleIncrement, groupId_graphics);
+    this->instancingThreshold.setConstraintsEnabled(true);
+    this->instancingThreshold.setRange(0, 1000000);
+    settings->addSetting(&this->instancingThreshold, groupId_graphics);
+    this->levelOfDetailPixelError.setConstraintsEnabled(true);
+    this->levelOfDetailPixelError.setRange(0.1, 100.);
+    this->levelOfDetailPixelError.setSingleStep(0.5);
+    settings->addSetting(&this->levelOfDetailPixelError, groupId_graphics);
+    this->cullingMinimumSize.setConstraintsEnabled(true);
+    this->cullingMinimumSize.setRange(0, 100);
+    settings->addSetting(&this->cullingMinimumSize, groupId_graphics);
+    settings->addSetting(&this->staticScene, groupId_graphics);
+    this->edgeRendering.mutableEnumeration().changeTrContext(AppModuleProperties::textIdContext());
+    settings->addSetting(&this->edgeRendering, groupId_graphics);
+    this->pointCloudStreamingThreshold.setConstraintsEnabled(true);
+    this->pointCloudStreamingThreshold.setRange(0, 1000000000);
+    this->pointCloudStreamingThreshold.setSingleStep(1000000);
+    settings->addSetting(&this->pointCloudStreamingThreshold, groupId_graphics);
+    this->pointCloudPointBudget.setConstraintsEnabled(true);
+    this->pointCloudPointBudget.setRange(100000, 100000000);
+    this->pointCloudPointBudget.setSingleStep(1000000);
+    settings->addSetting(&this->pointCloudPointBudget, groupId_graphics);
+    this->pointCloudCacheMaxSize.setConstraintsEnabled(true);
+    this->pointCloudCacheMaxSize.setRange(0, 1024 * 1024);
+    this->pointCloudCacheMaxSize.setSingleStep(1024);
+    settings->addSetting(&this->pointCloudCacheMaxSize, groupId_graphics);
     // -- Clip planes
     settings->addSetting(&this->clipPlanesCappingOn, sectionId_graphicsClipPlanes);
     settings->addSetting(&this->clipPlanesCappingHatchOn, sectionId_graphicsClipPlanes);
     // -- Mesh defaults
+    this->meshDefaultsPresentation.mutableEnumeration().changeTrContext(AppModuleProperties::textIdContext());
+    settings->addSetting(&this->meshDefaultsPresentation, sectionId_graphicsMeshDefaults);
     settings->addSetting(&this->meshDefaultsColor, sectionId_graphicsMeshDefaults);
     settings->addSetting(&this->meshDefaultsEdgeColor, sectionId_graphicsMeshDefaults);
     settings->addSetting(&this->meshDefaultsMaterial, sectionId_graphicsMeshDefaults);
@@ -95,12 +142,33 @@ AppModuleProperties::AppModuleProperties(Settings* settings)
         this->defaultShowOriginTrihedron.setValue(true);
         this->instantZoomFactor.setValue(5.);
         this->turnViewAngleIncrement.setQuantity(5 * Quantity_Degree);
+        this->instancingThreshold.setValue(16);
+        this->levelOfDetailPixelError.setValue(1.);
+        this->cullingMinimumSize.setValue(0);
+        this->staticScene.setValue(false);
+        this->edgeRendering.setValue(GraphicsShapeObjectDriver::EdgeRendering::FaceBoundaries);
+        this->pointCloudStreamingThreshold.setValue(2000000);
+        this->pointCloudPointBudget.setValue(5000000);
+        this->pointCloudCacheMaxSize.setValue(8 * 1024);
     });
     settings->addResetFunction(groupId_meshing, [&]{
         this->meshingQuality.setValue(BRepMeshQuality::Normal);
         this->meshingChordalDeflection.setQuantity(1 * Quantity_Millimeter);
         this->meshingAngularDeflection.setQuantity(20 * Quantity_Degree);
         this->meshingRelative.setValue(false);
+        this->meshingLazy.setValue(false);
+        this->meshingProgressive.setValue(false);
+        this->meshingPerPart.setValue(false);
+        this->meshingLevelsOfDetail.setValue(false);
+        this->meshingScreenSpaceError.setValue(0.);
+        this->meshingCacheEnabled.setValue(false);
+        this->meshingCacheMaxSize.setValue(2048);
+    });
+    settings->addResetFunction(sectionId_meshingImportedMeshes, [&]{
+        this->meshImportWeldNodes.setValue(true);
+        this->meshImportWeldTolerance.setQuantity(0 * Quantity_Millimeter);
+        this->meshImportComputeNormals.setValue(true);
+        this->meshImportCreaseAngle.setQuantity(30 * Quantity_Degree);
     });
     settings->addResetFunction(sectionId_graphicsClipPlanes, [=]{
         this->clipPlanesCappingOn.setValue(true);
@@ -108,6 +176,7 @@ AppModuleProperties::AppModuleProperties(Settings* settings)
     });
     settings->addResetFunction(sectionId_graphicsMeshDefaults, [=]{
         const GraphicsMeshObjectDriver::DefaultValues meshDefaults;
+        this->meshDefaultsPresentation.setValue(meshDefaults.presentation);
         this->meshDefaultsColor.setValue(meshDefaults.color);
         this->meshDefaultsEdgeColor.setValue(meshDefaults.edgeColor);
         this->meshDefaultsMaterial.setValue(meshDefaults.material);
@@ -191,12 +260,99 @@ void AppModuleProperties::retranslate()
                          "If activated, deflection used for the polygonalisation of each edge will be "
                          "`ChordalDeflection` &#215; `SizeOfEdge`. The deflection used for the faces will be "
                          "the maximum deflection of their edges."));
+    this->meshingLazy.setDescription(
+                textIdTr("Mesh BRep shapes when they are first displayed instead of at import time. "
+                         "Meshing runs in background, parts nearest to the camera first, and a bounding "
+                         "box is displayed until the mesh is ready\n\n"
+                         "Parts never displayed aren't meshed"));
+    this->meshingProgressive.setDescription(
+                textIdTr("Mesh BRep shapes with very coarse quality at import time so they are "
+                         "displayed quickly. Meshes are then refined in background with the "
+                         "configured quality and the 3D view is updated on the fly\n\n"
+                         "Not applicable when lazy meshing is enabled"));
+    this->meshingPerPart.setDescription(
+                textIdTr("Derive the deflection of each part from its own bounding box instead of the "
+                         "bounding box of the whole model, so small parts aren't over-tessellated and "
+                         "big parts aren't too coarse. Parts are meshed in parallel\n\n"
+                         "Not applicable when mesh quality is user-defined"));
+    this->meshingLevelsOfDetail.setDescription(
+                textIdTr("Also mesh BRep shapes with coarser deflections at import time, so the 3D "
+                         "view can draw lighter meshes for the parts appearing small on screen and "
+                         "while the view is rotated, panned or zoomed\n\n"
+                         "Not applicable when lazy or progressive meshing is enabled"));
+    this->meshingScreenSpaceError.setDescription(
+                textIdTr("Per-part meshing: minimum chordal deflection expressed in pixels, for a "
+                         "1920 pixels wide view where the whole model fits. Zero means no minimum"));
+    this->meshingCacheEnabled.setDescription(
+                textIdTr("Store on disk the meshes computed from BRep shapes, so reopening the same "
+                         "files with the same meshing parameters doesn't compute meshes again"));
+    this->meshingCacheMaxSize.setDescription(
+                textIdTr("Size limit of the mesh cache in megabytes. Least recently used meshes are "
+                         "removed when the limit is exceeded"));
+    this->meshImportWeldNodes.setDescription(
+                textIdTr("Merge the coincident nodes of meshes read from files(eg STL) where each "
+                         "triangle has its own nodes"));
+    this->meshImportWeldTolerance.setDescription(
+                textIdTr("Maximum distance between merged nodes. Zero means only nodes at the exact "
+                         "same position are merged"));
+    this->meshImportComputeNormals.setDescription(
+                textIdTr("Compute smooth normals at nodes of meshes read from files, so they are "
+                         "shaded smoothly"));
+    this->meshImportCreaseAngle.setDescription(
+                textIdTr("Adjacent triangles forming an angle greater than the crease angle keep "
+                         "distinct normals, so sharp edges are preserved"));
 
     // Graphics
     this->navigationStyle.setDescription(
                 textIdTr("3D view manipulation shortcuts configuration to mimic other common CAD applications"));
     this->turnViewAngleIncrement.setDescription(
                 textIdTr("Angle increment used to turn(rotate) the 3D view around the normal of the view plane(Z axis frame reference)"));
+    this->instancingThreshold.setDescription(
+                textIdTr("Minimum count of instances of a part so they are all drawn by a single "
+                         "graphics object, which is much faster for assemblies with many repeated "
+                         "parts(eg screws). Zero disables instancing. "
+                         "Change applies to documents opened afterwards"));
+    this->levelOfDetailPixelError.setDescription(
+                textIdTr("Maximum chordal deflection in pixels of the coarser meshes drawn for the "
+                         "parts appearing small on screen, see meshing option for levels of detail"));
+    this->cullingMinimumSize.setDescription(
+                textIdTr("Minimum size in pixels of the parts drawn in 3D view, smaller parts are "
+                         "skipped which speeds up views of big assemblies. Zero draws all parts. "
+                         "Change applies to documents opened afterwards"));
+    this->staticScene.setDescription(
+                textIdTr("Merge the parts of assemblies into a few graphics objects grouped by "
+                         "material, which speeds up views of assemblies with many distinct parts. "
+                         "Parts can still be selected and hidden individually. "
+                         "Change applies to documents opened afterwards"));
+    this->edgeRendering.setDescription(
+                textIdTr("How edges of shapes are drawn in `Shaded with face boundaries` mode\n\n"
+                         "`FaceBoundaries` computes face boundaries and isolines for each presentation. "
+                         "`Extracted` derives boundary and sharp edges once from the meshes, in parallel, "
+                         "and shares them between instances. "
+                         "`ScreenSpace` only draws the silhouette outline on the GPU, cheapest for huge models. "
+                         "Change applies to documents opened afterwards"));
+    this->pointCloudStreamingThreshold.setDescription(
+                textIdTr("Minimum count of points of the point clouds streamed from an octree file "
+                         "written in the cache directory at import. Only the points needed by the "
+                         "current view are then loaded and drawn. Zero disables streaming. "
+                         "Note that point clouds are still fully read in memory at import before the "
+                         "octree file is written: streaming reduces the memory used afterwards, not "
+                         "the peak memory during import. "
+                         "Change applies to files imported afterwards"));
+    this->pointCloudPointBudget.setDescription(
+                textIdTr("Maximum count of points drawn for the streamed point clouds of a document, "
+                         "coarse points are drawn first then refined where the view needs it"));
+    this->pointCloudCacheMaxSize.setDescription(
+                textIdTr("Maximum size in MB of the octree files of streamed point clouds kept in "
+                         "the cache directory, least recently used files are removed first"));
+
+    // -- Graphics/MeshDefaults
+    this->meshDefaultsPresentation.setDescription(
+                textIdTr("Kind of graphics object used to display meshes\n\n"
+                         "`Direct` builds graphics buffers straight from the mesh data in parallel, "
+                         "which is much faster and lighter for big meshes. "
+                         "`MeshVS` uses the OpenCascade MeshVS framework. "
+                         "Change applies to meshes displayed afterwards"));
 
     // -- Graphics/ClipPlanes
     this->defaultShowOriginTrihedron.setDescription(
@@ -210,13 +366,15 @@ void AppModuleProperties::retranslate()
 
 void AppModuleProperties::onPropertyChanged(Property* prop)
 {
-    if (prop == &this->meshDefaultsColor
+    if (prop == &this->meshDefaultsPresentation
+            || prop == &this->meshDefaultsColor
             || prop == &this->meshDefaultsEdgeColor
             || prop == &this->meshDefaultsMaterial
             || prop == &this->meshDefaultsShowEdges
             || prop == &this->meshDefaultsShowNodes)
     {
         auto values = GraphicsMeshObjectDriver::defaultValues();
+        values.presentation = this->meshDefaultsPresentation.value();
         values.color = this->meshDefaultsColor.value();
         values.edgeColor = this->meshDefaultsEdgeColor.value();
         values.material = static_cast<Graphic3d_NameOfMaterial>(this->meshDefaultsMaterial.value());
@@ -224,11 +382,38 @@ void AppModuleProperties::onPropertyChanged(Property* prop)
         values.showNodes = this->meshDefaultsShowNodes.value();
         GraphicsMeshObjectDriver::setDefaultValues(values);
     }
+    else if (prop == &this->instancingThreshold) {
+        GuiDocument::setDefaultInstancingThreshold(this->instancingThreshold.value());
+    }
+    else if (prop == &this->levelOfDetailPixelError) {
+        GuiDocument::setDefaultLevelOfDetailPixelError(this->levelOfDetailPixelError.value());
+    }
+    else if (prop == &this->cullingMinimumSize) {
+        GuiDocument::setDefaultCullingMinimumSize(this->cullingMinimumSize.value());
+    }
+    else if (prop == &this->pointCloudPointBudget) {
+        GuiDocument::setDefaultPointCloudPointBudget(this->pointCloudPointBudget.value());
+    }
     else if (prop == &this->meshingQuality) {
         const bool isUserDefined = this->meshingQuality.value() == BRepMeshQuality::UserDefined;
         this->meshingChordalDeflection.setEnabled(isUserDefined);
         this->meshingAngularDeflection.setEnabled(isUserDefined);
         this->meshingRelative.setEnabled(isUserDefined);
+        this->meshingPerPart.setEnabled(!isUserDefined);
+        this->meshingScreenSpaceError.setEnabled(!isUserDefined && this->meshingPerPart);
+    }
+    else if (prop == &this->meshingLazy) {
+        this->meshingProgressive.setEnabled(!this->meshingLazy);
+        this->meshingLevelsOfDetail.setEnabled(!this->meshingLazy && !this->meshingProgressive);
+    }
+    else if (prop == &this->meshingProgressive) {
+        this->meshingLevelsOfDetail.setEnabled(!this->meshingLazy && !this->meshingProgressive);
+    }
+    else if (prop == &this->meshingPerPart) {
+        this->meshingScreenSpaceError.setEnabled(this->meshingPerPart);
+    }
+    else if (prop == &this->meshingCacheEnabled) {
+        this->meshingCacheMaxSize.setEnabled(this->meshingCacheEnabled);
     }
 
     PropertyGroup::onPropertyChanged(prop);
@@ -15,6 +15,8 @@
 #include "../base/property_enumeration.h"
 #include "../base/settings.h"
 #include "../base/unit_system.h"
+#include "../graphics/graphics_mesh_object_driver.h"
+#include "../graphics/graphics_shape_object_driver.h"
 #include "widget_occ_view_controller.h"
 
 #include <memory>
@@ -59,15 +61,36 @@ public:
     PropertyLength meshingChordalDeflection{ this, textId("meshingChordalDeflection") };
     PropertyAngle meshingAngularDeflection{ this, textId("meshingAngularDeflection") };
     PropertyBool meshingRelative{ this, textId("meshingRelative") };
+    PropertyBool meshingLazy{ this, textId("meshingLazy") };
+    PropertyBool meshingProgressive{ this, textId("meshingProgressive") };
+    PropertyBool meshingPerPart{ this, textId("meshingPerPart") };
+    PropertyBool meshingLevelsOfDetail{ this, textId("meshingLevelsOfDetail") };
+    PropertyDouble meshingScreenSpaceError{ this, textId("meshingScreenSpaceError") }; // In pixels
+    PropertyBool meshingCacheEnabled{ this, textId("meshingCacheEnabled") };
+    PropertyInt meshingCacheMaxSize{ this, textId("meshingCacheMaxSize") }; // In MB
+    // -- Meshing/ImportedMeshes
+    PropertyBool meshImportWeldNodes{ this, textId("weldNodes") };
+    PropertyLength meshImportWeldTolerance{ this, textId("weldTolerance") };
+    PropertyBool meshImportComputeNormals{ this, textId("computeNormals") };
+    PropertyAngle meshImportCreaseAngle{ this, textId("creaseAngle") };
     // Graphics
     PropertyEnum<WidgetOccViewController::NavigationStyle> navigationStyle{ this, textId("navigationStyle") };
     PropertyBool defaultShowOriginTrihedron{ this, textId("defaultShowOriginTrihedron") };
     PropertyDouble instantZoomFactor{ this, textId("instantZoomFactor") };
     PropertyAngle turnViewAngleIncrement{ this, textId("turnViewAngleIncrement") };
+    PropertyInt instancingThreshold{ this, textId("instancingThreshold") };
+    PropertyDouble levelOfDetailPixelError{ this, textId("levelOfDetailPixelError") }; // In pixels
+    PropertyInt cullingMinimumSize{ this, textId("cullingMinimumSize") }; // In pixels
+    PropertyBool staticScene{ this, textId("staticScene") };
+    PropertyEnum<GraphicsShapeObjectDriver::EdgeRendering> edgeRendering{ this, textId("edgeRendering") };
+    PropertyInt pointCloudStreamingThreshold{ this, textId("pointCloudStreamingThreshold") }; // In points
+    PropertyInt pointCloudPointBudget{ this, textId("pointCloudPointBudget") }; // In points
+    PropertyInt pointCloudCacheMaxSize{ this, textId("pointCloudCacheMaxSize") }; // In MB
     // -- Graphics/ClipPlanes
     PropertyBool clipPlanesCappingOn{ this, textId("cappingOn") };
     PropertyBool clipPlanesCappingHatchOn{ this, textId("cappingHatchOn") };
     // -- Graphics/MeshDefaults
+    PropertyEnum<GraphicsMeshObjectDriver::Presentation> meshDefaultsPresentation{ this, textId("presentation") };
     PropertyOccColor meshDefaultsColor{ this, textId("color") };
     PropertyOccColor meshDefaultsEdgeColor{ this, textId("edgeColor") };
     PropertyEnumeration meshDefaultsMaterial{ this, textId("material"), &OcctEnums::Graphic3d_NameOfMaterial() };
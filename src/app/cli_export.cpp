@@ -11,8 +11,10 @@
 #include "qstring_conv.h"
 #include "../base/application.h"
 #include "../base/io_system.h"
+#include "../base/mesh_post_process.h"
 #include "../base/messenger.h"
 #include "../base/task_manager.h"
+#include "../base/tessellation_stats.h"
 
 #include <Message.hxx>
 
@@ -20,6 +22,7 @@
 
 #include <fmt/format.h>
 #include <atomic>
+#include <fstream>
 #include <functional>
 #include <iomanip>
 #include <iostream>
@@ -114,20 +117,29 @@ bool importInDocument(DocumentPtr doc, const CliExportArgs& args, Helper* helper
     bool brepMeshRequired = false;
     for (const FilePath& filepath : args.filesToExport) {
         const IO::Format format = appModule->ioSystem()->probeFormat(filepath);
-        brepMeshRequired = IO::formatProvidesMesh(format);
+        brepMeshRequired = brepMeshRequired || IO::formatProvidesMesh(format);
         if (brepMeshRequired)
             break; // Interrupt
     }
 
+    // Entities read from mesh files are welded and get normals as in the GUI application
+    const MeshPostProcess::Parameters meshPostProcessParams = appModule->meshPostProcessParameters();
+    const bool meshPostProcessRequired = meshPostProcessParams.weldNodes || meshPostProcessParams.computeNormals;
+
     ErrorMessageCollect errorCollect;
     const bool okImport = appModule->ioSystem()->importInDocument()
         .targetDocument(doc)
         .withFilepaths(args.filesToOpen)
         .withParametersProvider(appModule)
         .withEntityPostProcess([=](TDF_Label labelEntity, TaskProgress* progress) {
-            appModule->computeBRepMesh(labelEntity, progress);
+            if (MeshPostProcess::hasMeshFaces(labelEntity))
+                MeshPostProcess::apply(labelEntity, meshPostProcessParams, progress);
+            else if (brepMeshRequired)
+                appModule->computeBRepMesh(labelEntity, progress);
+        })
+        .withEntityPostProcessRequiredIf([=](IO::Format format) {
+            return brepMeshRequired || (IO::formatProvidesMesh(format) && meshPostProcessRequired);
         })
-        .withEntityPostProcessRequiredIf([=](IO::Format){ return brepMeshRequired; })
         .withEntityPostProcessInfoProgress(20, CliExport::textIdTr("Mesh BRep shapes"))
         .withMessenger(&errorCollect)
         .withTaskProgress(progress)
@@ -163,6 +175,32 @@ void exportDocument(const DocumentPtr& doc, const FilePath& filepath, Helper* he
     --(helper->exportTaskCount);
 }
 
+void writeTessellationReport(
+        const DocumentPtr& doc, const FilePath& filepath, Helper* helper, TaskProgress* progress)
+{
+    const std::string strFilename = filepath.filename().u8string();
+    std::string msg = fmt::format(CliExport::textIdTr("Written {}"), strFilename);
+    auto format = TessellationStats::Format::Csv;
+    bool okWrite = TessellationStats::formatFromFilePath(filepath.u8string(), &format);
+    if (okWrite) {
+        const TessellationStats stats = AppModule::get()->computeTessellationStats(doc, progress);
+        std::ofstream ofs(filepath, std::ios::out | std::ios::binary);
+        stats.write(ofs, format);
+        ofs.close();
+        okWrite = !ofs.fail();
+        if (!okWrite)
+            msg = fmt::format(CliExport::textIdTr("Failed to write file {}"), strFilename);
+    }
+    else {
+        msg = fmt::format(CliExport::textIdTr("Unsupported report format {}(expected .csv or .json)"), strFilename);
+    }
+
+    helper->taskMgr.setTitle(progress->taskId(), msg);
+    helper->mapTaskStatus.at(progress->taskId())->success = okWrite;
+    helper->mapTaskStatus.at(progress->taskId())->finished = true;
+    --(helper->exportTaskCount);
+}
+
 } // namespace
 
 void cli_asyncExportDocuments(
@@ -209,7 +247,7 @@ void cli_asyncExportDocuments(
             fnPrintProgress();
     });
 
-    helper->exportTaskCount = int(args.filesToExport.size());
+    helper->exportTaskCount = int(args.filesToExport.size() + args.filesTessellationReport.size());
     taskMgr->signalEnded.connectSlot([=]{
         if (helper->exportTaskCount == 0) {
             bool okExport = true;
@@ -247,6 +285,16 @@ void cli_asyncExportDocuments(
         taskMgr->setTitle(taskId, fmt::format(CliExport::textIdTr("Exporting {}..."), strFilename));
     }
 
+    // Run tessellation report operations(asynchronous)
+    for (const FilePath& filepath : args.filesTessellationReport) {
+        const TaskId taskId = taskMgr->newTask([=](TaskProgress* progress) {
+            writeTessellationReport(doc, filepath, helper, progress);
+        });
+        const std::string strFilename = filepath.filename().u8string();
+        helper->mapTaskStatus.insert({ taskId, std::make_unique<TaskStatus>() });
+        taskMgr->setTitle(taskId, fmt::format(CliExport::textIdTr("Writing {}..."), strFilename));
+    }
+
     taskMgr->foreachTask([=](TaskId taskId) {
         if (taskId != importTaskId)
             taskMgr->run(taskId, TaskAutoDestroy::Off);
@@ -20,9 +20,11 @@ struct CliExportArgs {
     bool progressReport = true;
     Span<const FilePath> filesToOpen;
     Span<const FilePath> filesToExport;
+    Span<const FilePath> filesTessellationReport; // See TessellationStats
 };
 
 // Asynchronously exports input file(s) listed in 'args'
+// Tessellation reports are written once imported BRep shapes are meshed
 // Calls 'fnContinuation' at the end of execution
 void cli_asyncExportDocuments(
         Application* app,
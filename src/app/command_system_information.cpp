@@ -14,6 +14,8 @@
 #include "../base/meta_enum.h"
 #include "../base/filepath.h"
 #include "../base/io_system.h"
+#include "../gui/gui_application.h"
+#include "../gui/gui_document.h"
 
 #include <QtCore/QDir>
 #include <QtCore/QFileSelector>
@@ -56,7 +58,7 @@ CommandSystemInformation::CommandSystemInformation(IAppContext* context)
 
 void CommandSystemInformation::execute()
 {
-    const QString text = CommandSystemInformation::data();
+    const QString text = CommandSystemInformation::data(this->guiApp());
 
     auto dlg = new QDialog(this->widgetMain());
     dlg->setWindowTitle(this->action()->text());
@@ -182,7 +184,7 @@ static void dumpOpenGlInfo(QTextStream& str)
     }
 }
 
-QString CommandSystemInformation::data()
+QString CommandSystemInformation::data(const GuiApplication* guiApp)
 {
     QString strSysInfo;
     QTextStream ostr(&strSysInfo);
@@ -270,6 +272,20 @@ QString CommandSystemInformation::data()
     ostr << '\n' << "OpenGL:" << '\n';
     dumpOpenGlInfo(ostr);
 
+    // 3D views culling
+    if (guiApp) {
+        ostr << '\n' << "3D views culling:\n";
+        for (GuiDocument* guiDoc : guiApp->guiDocuments()) {
+            const GraphicsScene::CullingStats stats = guiDoc->graphicsScene()->cullingStats(guiDoc->v3dView());
+            ostr << indent << "Document \"" << to_QString(guiDoc->document()->name()) << "\"\n"
+                 << indentx2 << "objectCount: " << stats.objectCount << '\n'
+                 << indentx2 << "frustumCulledCount: " << stats.frustumCulledCount << '\n'
+                 << indentx2 << "viewCulledCount: " << stats.viewCulledCount << '\n'
+                 << indentx2 << "sizeCulledCount: " << stats.sizeCulledCount << '\n'
+                 << indentx2 << "cullingMinimumSize: " << guiDoc->graphicsScene()->cullingMinimumSize() << "px" << '\n';
+        }
+    }
+
     // File selectors
     ostr << '\n' << "File selectors(increasing order of precedence):\n" << indent;
     for (const QString& selector : QFileSelector().allSelectors())
@@ -7,19 +7,27 @@
 #include "commands_file.h"
 
 #include "../base/application.h"
+#include "../base/label_data.h"
+#include "../base/mesh_post_process.h"
 #include "../base/task_manager.h"
 #include "../gui/gui_application.h"
+#include "../gui/gui_document.h"
 #include "app_module.h"
 #include "filepath_conv.h"
 #include "qstring_conv.h"
 #include "recent_files.h"
 #include "theme.h"
 
+#include <algorithm>
 #include <cassert>
 #include <fmt/format.h>
+#include <functional>
+#include <memory>
+#include <vector>
 #include <QtCore/QtDebug>
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QMimeData>
+#include <QtCore/QTimer>
 #include <QtGui/QDragEnterEvent>
 #include <QtGui/QDropEvent>
 #include <QtWidgets/QApplication>
@@ -154,6 +162,152 @@ QString strFilepathQuoted(const QString& filepath)
     return filepath;
 }
 
+// Provides mesh post-processing of the entities imported in a document
+// Entities read from mesh files(eg STL triangle soups) are welded and get normals as specified in
+// settings, see MeshPostProcess
+// In progressive mode entities are first meshed with very coarse quality so they can be displayed
+// quickly, meshes are then refined at configured quality by a background task(see runRefineTask())
+// Otherwise levels of detail of the entities are also computed if enabled in settings
+class ImportBRepMesher {
+public:
+    ImportBRepMesher()
+    {
+        const AppModuleProperties* props = AppModule::get()->properties();
+        m_isProgressive = props->meshingProgressive && !props->meshingLazy;
+        m_hasLevelsOfDetail = props->meshingLevelsOfDetail && !props->meshingLazy && !m_isProgressive;
+        m_meshPostProcessParams = AppModule::get()->meshPostProcessParameters();
+    }
+
+    // Whether entities read from files in 'format' have to be processed by computeMesh()
+    static bool isRequired(IO::Format format)
+    {
+        const AppModuleProperties* props = AppModule::get()->properties();
+        if (IO::formatProvidesBRep(format))
+            return !props->meshingLazy;
+
+        if (format == IO::Format_PLY && props->pointCloudStreamingThreshold > 0)
+            return true; // PLY files might provide point clouds
+
+        return IO::formatProvidesMesh(format)
+               && (props->meshImportWeldNodes || props->meshImportComputeNormals);
+    }
+
+    void computeMesh(const TDF_Label& labelEntity, TaskProgress* progress)
+    {
+        if (findLabelDataFlags(labelEntity) & LabelData_HasPointCloudData) {
+            AppModule::get()->computePointCloudOctree(labelEntity, progress);
+            return;
+        }
+
+        if (MeshPostProcess::hasMeshFaces(labelEntity)) {
+            MeshPostProcess::apply(labelEntity, m_meshPostProcessParams, progress);
+            return;
+        }
+
+        if (m_isProgressive) {
+            AppModule::get()->computeBRepMesh(labelEntity, AppModule::BRepMeshQuality::VeryCoarse, progress);
+            m_vecLabelEntity.push_back(labelEntity);
+        }
+        else if (m_hasLevelsOfDetail) {
+            {
+                TaskProgress meshProgress(progress, 70);
+                AppModule::get()->computeBRepMesh(labelEntity, &meshProgress);
+            }
+
+            TaskProgress lodProgress(progress, 30);
+            AppModule::get()->computeBRepMeshLevelsOfDetail(labelEntity, &lodProgress);
+        }
+        else {
+            AppModule::get()->computeBRepMesh(labelEntity, progress);
+        }
+    }
+
+    // Runs a task refining the meshes of the entities previously processed with computeMesh()
+    // Graphics of each entity are updated as soon as its refined meshes are available
+    // Does nothing if progressive mode is off
+    // Can be called from any thread, the task is created in the thread of 'context'
+    void runRefineTask(IAppContext* context, Document::Identifier docId) const
+    {
+        if (!m_isProgressive || m_vecLabelEntity.empty())
+            return;
+
+        const std::vector<TDF_Label> vecLabelEntity = m_vecLabelEntity;
+        QTimer::singleShot(0, context, [=]{
+            auto app = context->guiApp()->application();
+            if (app->findDocumentByIdentifier(docId).IsNull())
+                return;
+
+            // Shapes to be refined are collected in the thread owning the document, the task
+            // meshes copies of them and doesn't access the XCAF document
+            struct RefineJob {
+                TDF_Label labelEntity;
+                std::vector<AppModule::BRepMeshJob> vecMeshJob;
+            };
+            std::vector<RefineJob> vecRefineJob;
+            for (const TDF_Label& labelEntity : vecLabelEntity) {
+                std::vector<AppModule::BRepMeshJob> vecMeshJob = AppModule::get()->refineBRepMeshJobs(labelEntity);
+                if (!vecMeshJob.empty())
+                    vecRefineJob.push_back({ labelEntity, std::move(vecMeshJob) });
+            }
+
+            if (vecRefineJob.empty())
+                return;
+
+            const TaskId taskId = context->taskMgr()->newTask([=](TaskProgress* progress) {
+                const double portionSize = 100. / vecRefineJob.size();
+                for (const RefineJob& refineJob : vecRefineJob) {
+                    // Keep the document alive while its entity is processed
+                    const DocumentPtr doc = app->findDocumentByIdentifier(docId);
+                    if (doc.IsNull() || progress->isAbortRequested())
+                        return;
+
+                    TaskProgress subProgress(progress, portionSize);
+                    const TDF_Label labelEntity = refineJob.labelEntity;
+                    auto fnSwapMesh = AppModule::get()->refineBRepMesh(refineJob.vecMeshJob, &subProgress);
+                    if (fnSwapMesh) {
+                        QTimer::singleShot(0, context, [=]{
+                            ImportBRepMesher::swapMesh(context, docId, labelEntity, fnSwapMesh);
+                        });
+                    }
+                }
+            });
+            context->taskMgr()->setTitle(taskId, to_stdString(Command::tr("Refine meshes")));
+            context->taskMgr()->run(taskId);
+        });
+    }
+
+private:
+    static void swapMesh(
+            IAppContext* context,
+            Document::Identifier docId,
+            const TDF_Label& labelEntity,
+            const std::function<void()>& fnSwapMesh)
+    {
+        // Document or entity might have been closed/destroyed meanwhile
+        const DocumentPtr doc = context->guiApp()->application()->findDocumentByIdentifier(docId);
+        GuiDocument* guiDoc = !doc.IsNull() ? context->guiApp()->findGuiDocument(doc) : nullptr;
+        if (!guiDoc)
+            return;
+
+        for (int i = 0; i < doc->entityCount(); ++i) {
+            if (doc->entityLabel(i) == labelEntity) {
+                {
+                    std::unique_lock<std::shared_mutex> lock(doc->shapeMutex());
+                    fnSwapMesh();
+                }
+
+                guiDoc->recomputeGraphicsObjects(doc->entityTreeNodeId(i));
+                return;
+            }
+        }
+    }
+
+    bool m_isProgressive = false;
+    bool m_hasLevelsOfDetail = false;
+    MeshPostProcess::Parameters m_meshPostProcessParams;
+    std::vector<TDF_Label> m_vecLabelEntity;
+};
+
 } // namespace
 
 
@@ -184,21 +338,24 @@ void FileCommandTools::openDocumentsFromList(IAppContext* context, Span<const Fi
             const TaskId taskId = context->taskMgr()->newTask([=](TaskProgress* progress) {
                 QElapsedTimer chrono;
                 chrono.start();
+                auto brepMesher = std::make_shared<ImportBRepMesher>();
                 const bool okImport =
                         appModule->ioSystem()->importInDocument()
                         .targetDocument(app->findDocumentByIdentifier(newDocId))
                         .withFilepath(fp)
                         .withParametersProvider(appModule)
                         .withEntityPostProcess([=](TDF_Label labelEntity, TaskProgress* progress) {
-                            appModule->computeBRepMesh(labelEntity, progress);
+                            brepMesher->computeMesh(labelEntity, progress);
                         })
-                        .withEntityPostProcessRequiredIf(&IO::formatProvidesBRep)
+                        .withEntityPostProcessRequiredIf(&ImportBRepMesher::isRequired)
                         .withEntityPostProcessInfoProgress(20, Command::textIdTr("Mesh BRep shapes"))
                         .withMessenger(appModule)
                         .withTaskProgress(progress)
                         .execute();
                 if (okImport)
                     appModule->emitInfo(fmt::format(Command::textIdTr("Import time: {}ms"), chrono.elapsed()));
+
+                brepMesher->runRefineTask(context, newDocId);
             });
             context->taskMgr()->setTitle(taskId, fp.stem().u8string());
             context->taskMgr()->run(taskId);
@@ -355,24 +512,28 @@ void CommandImportInCurrentDocument::execute()
         return;
 
     auto appModule = AppModule::get();
+    IAppContext* context = this->context();
     const TaskId taskId = this->taskMgr()->newTask([=](TaskProgress* progress) {
         QElapsedTimer chrono;
         chrono.start();
 
+        auto brepMesher = std::make_shared<ImportBRepMesher>();
         const bool okImport = appModule->ioSystem()->importInDocument()
                 .targetDocument(guiDoc->document())
                 .withFilepaths(resFileNames.listFilepath)
                 .withParametersProvider(appModule)
                 .withEntityPostProcess([=](TDF_Label labelEntity, TaskProgress* progress) {
-                        appModule->computeBRepMesh(labelEntity, progress);
+                        brepMesher->computeMesh(labelEntity, progress);
                 })
-                .withEntityPostProcessRequiredIf(&IO::formatProvidesBRep)
+                .withEntityPostProcessRequiredIf(&ImportBRepMesher::isRequired)
                 .withEntityPostProcessInfoProgress(20, Command::textIdTr("Mesh BRep shapes"))
                 .withMessenger(appModule)
                 .withTaskProgress(progress)
                 .execute();
         if (okImport)
             appModule->emitInfo(fmt::format(Command::textIdTr("Import time: {}ms"), chrono.elapsed()));
+
+        brepMesher->runRefineTask(context, guiDoc->document()->identifier());
     });
     const QString taskTitle =
             resFileNames.listFilepath.size() > 1 ?
@@ -426,24 +587,90 @@ void CommandExportSelectedApplicationItems::execute()
 
     lastSettings.openDir = filepathFrom(strFilepath);
     const IO::Format format = formatFromFilter(lastSettings.selectedFilter);
-    const TaskId taskId = this->taskMgr()->newTask([=](TaskProgress* progress) {
-        QElapsedTimer chrono;
-        chrono.start();
-        const bool okExport =
-                appModule->ioSystem()->exportApplicationItems()
-                .targetFile(filepathFrom(strFilepath))
-                .targetFormat(format)
-                .withItems(this->guiApp()->selectionModel()->selectedItems())
-                .withParameters(appModule->findWriterParameters(format))
-                .withMessenger(appModule)
-                .withTaskProgress(progress)
-                .execute();
-        if (okExport)
-            appModule->emitInfo(fmt::format(Command::textIdTr("Export time: {}ms"), chrono.elapsed()));
-    });
-    this->taskMgr()->setTitle(taskId, to_stdString(QFileInfo(strFilepath).fileName()));
-    this->taskMgr()->run(taskId);
+    const Span<const ApplicationItem> spanItem = this->guiApp()->selectionModel()->selectedItems();
+    const std::vector<ApplicationItem> vecItem(spanItem.begin(), spanItem.end());
+    auto fnRunExportTask = [=]{
+        const TaskId taskId = this->taskMgr()->newTask([=](TaskProgress* progress) {
+            QElapsedTimer chrono;
+            chrono.start();
+            const bool okExport =
+                    appModule->ioSystem()->exportApplicationItems()
+                    .targetFile(filepathFrom(strFilepath))
+                    .targetFormat(format)
+                    .withItems(vecItem)
+                    .withParameters(appModule->findWriterParameters(format))
+                    .withMessenger(appModule)
+                    .withTaskProgress(progress)
+                    .execute();
+            if (okExport)
+                appModule->emitInfo(fmt::format(Command::textIdTr("Export time: {}ms"), chrono.elapsed()));
+        });
+        this->taskMgr()->setTitle(taskId, to_stdString(QFileInfo(strFilepath).fileName()));
+        this->taskMgr()->run(taskId);
+    };
+
     ImportExportSettings::save(lastSettings);
+    if (!appModule->properties()->meshingLazy || IO::formatProvidesBRep(format)) {
+        fnRunExportTask();
+        return;
+    }
+
+    // With lazy meshing, parts never displayed aren't meshed yet so they have to be meshed before
+    // being exported to a mesh format. Meshes are computed on copies of the shapes, then attached
+    // to the actual shapes in the current thread where graphics objects might read them
+    std::vector<TDF_Label> vecLabelEntity;
+    auto fnAddEntity = [&](const DocumentPtr& doc, TreeNodeId entityTreeNodeId) {
+        const TDF_Label labelEntity = doc->modelTree().nodeData(entityTreeNodeId);
+        if (std::find(vecLabelEntity.cbegin(), vecLabelEntity.cend(), labelEntity) == vecLabelEntity.cend())
+            vecLabelEntity.push_back(labelEntity);
+    };
+    for (const ApplicationItem& item : vecItem) {
+        const DocumentPtr doc = item.document();
+        if (item.isDocument()) {
+            for (int i = 0; i < doc->entityCount(); ++i)
+                fnAddEntity(doc, doc->entityTreeNodeId(i));
+        }
+        else if (item.isDocumentTreeNode()) {
+            fnAddEntity(doc, doc->modelTree().nodeRoot(item.documentTreeNode().id()));
+        }
+    }
+
+    // Shapes not meshed are collected here, the task doesn't access the XCAF documents
+    std::vector<std::vector<AppModule::BRepMeshJob>> vecEntityMeshJobs;
+    for (const TDF_Label& labelEntity : vecLabelEntity) {
+        std::vector<AppModule::BRepMeshJob> vecMeshJob = appModule->refineBRepMeshJobs(labelEntity);
+        if (!vecMeshJob.empty())
+            vecEntityMeshJobs.push_back(std::move(vecMeshJob));
+    }
+
+    if (vecEntityMeshJobs.empty()) {
+        fnRunExportTask();
+        return;
+    }
+
+    IAppContext* context = this->context();
+    const TaskId meshTaskId = this->taskMgr()->newTask([=](TaskProgress* progress) {
+        std::vector<std::function<void()>> vecFnSwapMesh;
+        const double portionSize = 100. / vecEntityMeshJobs.size();
+        for (const std::vector<AppModule::BRepMeshJob>& vecMeshJob : vecEntityMeshJobs) {
+            TaskProgress subProgress(progress, portionSize);
+            auto fnSwapMesh = appModule->refineBRepMesh(vecMeshJob, &subProgress);
+            if (progress->isAbortRequested())
+                return;
+
+            if (fnSwapMesh)
+                vecFnSwapMesh.push_back(std::move(fnSwapMesh));
+        }
+
+        QTimer::singleShot(0, context, [=]{
+            for (const std::function<void()>& fnSwapMesh : vecFnSwapMesh)
+                fnSwapMesh();
+
+            fnRunExportTask();
+        });
+    });
+    this->taskMgr()->setTitle(meshTaskId, to_stdString(Command::tr("Mesh items to export")));
+    this->taskMgr()->run(meshTaskId);
 }
 
 bool CommandExportSelectedApplicationItems::getEnabledStatus() const
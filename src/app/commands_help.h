@@ -24,7 +24,8 @@ public:
     CommandSystemInformation(IAppContext* context);
     void execute() override;
 
-    static QString data();
+    // 'guiApp' is optional, it provides the graphics stats of the opened documents
+    static QString data(const GuiApplication* guiApp = nullptr);
 
     struct LibraryInfo {
         std::string name;
@@ -8,17 +8,27 @@
 
 #include "../base/application.h"
 #include "../base/application_item_selection_model.h"
+#include "../base/mesh_post_process.h"
+#include "../base/task_manager.h"
+#include "../base/tessellation_stats.h"
 #include "../gui/gui_application.h"
 #include "../gui/gui_document.h"
 #include "app_module.h"
 #include "dialog_inspect_xde.h"
 #include "dialog_options.h"
 #include "dialog_save_image_view.h"
+#include "filepath_conv.h"
+#include "qstring_conv.h"
 #include "qtwidgets_utils.h"
 #include "theme.h"
 
+#include <QtCore/QTimer>
+#include <QtWidgets/QFileDialog>
 #include <QtWidgets/QWidget>
 
+#include <fmt/format.h>
+#include <fstream>
+
 namespace Mayo {
 
 CommandSaveViewImage::CommandSaveViewImage(IAppContext* context)
@@ -82,6 +92,143 @@ bool CommandInspectXde::getEnabledStatus() const
             && this->context()->currentPage() == IAppContext::Page::Documents;
 }
 
+CommandTessellationReport::CommandTessellationReport(IAppContext* context)
+    : Command(context)
+{
+    auto action = new QAction(this);
+    action->setText(Command::tr("Tessellation Report"));
+    action->setToolTip(Command::tr("Export statistics about triangulations of current document"));
+    this->setAction(action);
+}
+
+void CommandTessellationReport::execute()
+{
+    const GuiDocument* guiDoc = this->currentGuiDocument();
+    if (!guiDoc)
+        return;
+
+    const QString strFilepath = QFileDialog::getSaveFileName(
+                this->widgetMain(),
+                Command::tr("Select Output File"),
+                QString(),
+                Command::tr("CSV files(*.csv);;JSON files(*.json)")
+    );
+    if (strFilepath.isEmpty())
+        return;
+
+    auto format = TessellationStats::Format::Csv;
+    if (!TessellationStats::formatFromFilePath(to_stdString(strFilepath), &format)) {
+        QtWidgetsUtils::asyncMsgBoxCritical(
+                    this->widgetMain(),
+                    Command::tr("Error"),
+                    Command::tr("Unsupported report format(expected .csv or .json file)")
+        );
+        return;
+    }
+
+    // Use the Document identifier instead of handle within the job function(capture), see
+    // FileCommandTools::openDocumentsFromList()
+    auto app = this->app();
+    const Document::Identifier docId = guiDoc->document()->identifier();
+    const FilePath filepath = filepathFrom(strFilepath);
+    const TaskId taskId = this->taskMgr()->newTask([=](TaskProgress* progress) {
+        auto appModule = AppModule::get();
+        const DocumentPtr doc = app->findDocumentByIdentifier(docId);
+        if (doc.IsNull())
+            return;
+
+        const TessellationStats stats = appModule->computeTessellationStats(doc, progress);
+        std::ofstream ofs(filepath, std::ios::out | std::ios::binary);
+        stats.write(ofs, format);
+        ofs.close();
+        if (ofs.fail()) {
+            appModule->emitError(fmt::format(Command::textIdTr("Failed to write file {}"), filepath.u8string()));
+            return;
+        }
+
+        appModule->emitInfo(fmt::format(
+                Command::textIdTr("Tessellation report: {} products, {} triangles, {} KB"),
+                stats.products().size(), stats.total().triangleCount, stats.total().memorySize / 1024
+        ));
+    });
+    this->taskMgr()->setTitle(taskId, to_stdString(Command::tr("Tessellation report")));
+    this->taskMgr()->run(taskId);
+}
+
+bool CommandTessellationReport::getEnabledStatus() const
+{
+    return this->app()->documentCount() != 0
+           && this->context()->currentPage() == IAppContext::Page::Documents;
+}
+
+CommandMeshPostProcess::CommandMeshPostProcess(IAppContext* context)
+    : Command(context)
+{
+    auto action = new QAction(this);
+    action->setText(Command::tr("Weld and Smooth Meshes"));
+    action->setToolTip(
+                Command::tr("Merge coincident nodes and compute smooth normals of the mesh entities "
+                            "of current document, as specified in options")
+    );
+    this->setAction(action);
+}
+
+void CommandMeshPostProcess::execute()
+{
+    const GuiDocument* guiDoc = this->currentGuiDocument();
+    if (!guiDoc)
+        return;
+
+    // Use the Document identifier instead of handle within the job function(capture), see
+    // FileCommandTools::openDocumentsFromList()
+    auto context = this->context();
+    auto app = this->app();
+    const Document::Identifier docId = guiDoc->document()->identifier();
+    const MeshPostProcess::Parameters params = AppModule::get()->meshPostProcessParameters();
+    const TaskId taskId = this->taskMgr()->newTask([=](TaskProgress* progress) {
+        const DocumentPtr doc = app->findDocumentByIdentifier(docId);
+        if (doc.IsNull() || doc->entityCount() == 0)
+            return;
+
+        for (int i = 0; i < doc->entityCount(); ++i) {
+            TaskProgress subProgress(progress, 100. / doc->entityCount());
+            const TDF_Label labelEntity = doc->entityLabel(i);
+            auto fnAssignMesh = MeshPostProcess::prepare(labelEntity, params, &subProgress);
+            if (!fnAssignMesh)
+                continue;
+
+            // Meshes are assigned in the thread owning the graphics objects
+            QTimer::singleShot(0, context, [=]{
+                // Document or entity might have been closed/destroyed meanwhile
+                const DocumentPtr doc = app->findDocumentByIdentifier(docId);
+                GuiDocument* guiDoc = !doc.IsNull() ? context->guiApp()->findGuiDocument(doc) : nullptr;
+                if (!guiDoc)
+                    return;
+
+                for (int j = 0; j < doc->entityCount(); ++j) {
+                    if (doc->entityLabel(j) == labelEntity) {
+                        {
+                            std::unique_lock<std::shared_mutex> lock(doc->shapeMutex());
+                            fnAssignMesh();
+                        }
+
+                        guiDoc->recomputeGraphicsObjects(doc->entityTreeNodeId(j));
+                        return;
+                    }
+                }
+            });
+        }
+    });
+    this->taskMgr()->setTitle(taskId, to_stdString(Command::tr("Weld and smooth meshes")));
+    this->taskMgr()->run(taskId);
+}
+
+bool CommandMeshPostProcess::getEnabledStatus() const
+{
+    return this->app()->documentCount() != 0
+           && this->context()->currentPage() == IAppContext::Page::Documents;
+}
+
 CommandEditOptions::CommandEditOptions(IAppContext* context)
     : Command(context)
 {
@@ -28,6 +28,24 @@ public:
     static constexpr std::string_view Name = "inspect-xde";
 };
 
+class CommandTessellationReport : public Command {
+public:
+    CommandTessellationReport(IAppContext* context);
+    void execute() override;
+    bool getEnabledStatus() const override;
+
+    static constexpr std::string_view Name = "tessellation-report";
+};
+
+class CommandMeshPostProcess : public Command {
+public:
+    CommandMeshPostProcess(IAppContext* context);
+    void execute() override;
+    bool getEnabledStatus() const override;
+
+    static constexpr std::string_view Name = "mesh-post-process";
+};
+
 class CommandEditOptions : public Command {
 public:
     CommandEditOptions(IAppContext* context);
@@ -6,6 +6,7 @@
 
 #include "document_tree_node_properties_providers.h"
 
+#include "../base/application.h"
 #include "../base/caf_utils.h"
 #include "../base/label_data.h"
 #include "../base/triangulation_annex_data.h"
@@ -15,6 +16,7 @@
 #include "../base/mesh_utils.h"
 #include "../base/meta_enum.h"
 #include "../base/point_cloud_data.h"
+#include "../base/point_cloud_octree.h"
 #include "../base/xcaf.h"
 #include "../graphics/graphics_mesh_object_driver.h"
 #include "../graphics/graphics_point_cloud_object_driver.h"
@@ -25,12 +27,14 @@
 #include <TDataStd_Name.hxx>
 #include <QtCore/QStringList>
 
+#include <algorithm>
+
 namespace Mayo {
 
 class XCaf_DocumentTreeNodePropertiesProvider::Properties : public PropertyGroupSignals {
     MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::XCaf_DocumentTreeNodeProperties)
 public:
-    Properties(const DocumentTreeNode& treeNode)
+    Properties(const DocumentTreeNode& treeNode, MassPropertiesEngine* massPropsEngine)
         : m_label(treeNode.label())
     {
         const TDF_Label& label = m_label;
@@ -161,6 +165,18 @@ public:
             this->removeProperty(&m_propertyReferredColor);
         }
 
+        // Computed mass properties
+        {
+            const MassProperties massProps = massPropsEngine->get(label);
+            m_propertyComputedVolume.setQuantity(massProps.volume());
+            m_propertyComputedArea.setQuantity(massProps.area());
+            m_propertyComputedCentroid.setValue(massProps.centroid());
+            if (massProps.hasMass)
+                m_propertyComputedMass.setQuantity(massProps.mass);
+            else
+                this->removeProperty(&m_propertyComputedMass);
+        }
+
         for (Property* prop : this->properties())
             prop->setUserReadOnly(true);
 
@@ -196,10 +212,118 @@ public:
     PropertyArea m_propertyReferredValidationArea{ this, textId("ProductArea") };
     PropertyVolume m_propertyReferredValidationVolume{ this, textId("ProductVolume") };
 
+    PropertyVolume m_propertyComputedVolume{ this, textId("ComputedVolume") };
+    PropertyArea m_propertyComputedArea{ this, textId("ComputedArea") };
+    PropertyOccPnt m_propertyComputedCentroid{ this, textId("ComputedCentroid") };
+    PropertyMass m_propertyComputedMass{ this, textId("Mass") };
+
     TDF_Label m_label;
     TDF_Label m_labelReferred;
 };
 
+XCaf_DocumentTreeNodePropertiesProvider::XCaf_DocumentTreeNodePropertiesProvider()
+{
+    auto app = Application::instance();
+    m_connDocumentEntityAdded = app->signalDocumentEntityAdded.connectSlot(
+        [=](const DocumentPtr& doc, TreeNodeId entityId) {
+            const TDF_Label labelEntity = doc->modelTree().nodeData(entityId);
+            if (!XCaf::isShape(labelEntity))
+                return;
+
+            {
+                std::lock_guard<std::mutex> lock(m_jobMutex);
+                m_queueJob.push_back({ doc, labelEntity });
+                if (!m_jobThread.joinable())
+                    m_jobThread = std::thread([=]{ this->runMassPropertiesJobs(); });
+            }
+
+            m_jobCondition.notify_one();
+        }
+    );
+    m_connDocumentEntityAboutToBeDestroyed = app->signalDocumentEntityAboutToBeDestroyed.connectSlot(
+        [=](const DocumentPtr& doc, TreeNodeId entityId) {
+            const TDF_Label labelEntity = doc->modelTree().nodeData(entityId);
+            std::lock_guard<std::mutex> lock(m_jobMutex);
+            m_queueJob.erase(std::remove_if(m_queueJob.begin(), m_queueJob.end(), [&](const MassPropertiesJob& job) {
+                return job.labelEntity == labelEntity;
+            }), m_queueJob.end());
+            // Job being processed is skipped if not started yet, otherwise Document::destroyEntity()
+            // waits for its completion(see Document::shapeMutex())
+            if (m_labelRunningJob == labelEntity)
+                m_isRunningJobCancelled = true;
+        }
+    );
+    m_connDocumentAboutToClose = app->signalDocumentAboutToClose.connectSlot([=](const DocumentPtr& doc) {
+        {
+            std::lock_guard<std::mutex> lock(m_jobMutex);
+            m_queueJob.erase(std::remove_if(m_queueJob.begin(), m_queueJob.end(), [&](const MassPropertiesJob& job) {
+                return job.doc == doc;
+            }), m_queueJob.end());
+            // Results of the job being processed are erased once it's finished
+            if (m_docRunningJob == doc)
+                m_isRunningJobDiscarded = true;
+        }
+
+        m_massPropsEngine.erase(doc);
+    });
+}
+
+XCaf_DocumentTreeNodePropertiesProvider::~XCaf_DocumentTreeNodePropertiesProvider()
+{
+    m_connDocumentEntityAdded.disconnect();
+    m_connDocumentEntityAboutToBeDestroyed.disconnect();
+    m_connDocumentAboutToClose.disconnect();
+    {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        m_isStopRequested = true;
+    }
+
+    m_jobCondition.notify_all();
+    if (m_jobThread.joinable())
+        m_jobThread.join();
+}
+
+void XCaf_DocumentTreeNodePropertiesProvider::runMassPropertiesJobs()
+{
+    while (true) {
+        MassPropertiesJob job;
+        {
+            std::unique_lock<std::mutex> lock(m_jobMutex);
+            m_jobCondition.wait(lock, [=]{ return m_isStopRequested || !m_queueJob.empty(); });
+            if (m_isStopRequested)
+                return;
+
+            job = std::move(m_queueJob.front());
+            m_queueJob.pop_front();
+            m_docRunningJob = job.doc;
+            m_labelRunningJob = job.labelEntity;
+            m_isRunningJobDiscarded = false;
+            m_isRunningJobCancelled = false;
+        }
+
+        {
+            // Shapes and meshes of the document can't be modified while they are read
+            std::shared_lock<std::shared_mutex> lockShapes(job.doc->shapeMutex());
+            bool isCancelled = false;
+            {
+                std::lock_guard<std::mutex> lock(m_jobMutex);
+                isCancelled = m_isRunningJobCancelled || m_isRunningJobDiscarded;
+            }
+
+            // Computes and caches the properties of the entity and of all its components and products
+            if (!isCancelled)
+                m_massPropsEngine.get(job.labelEntity);
+        }
+
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        if (m_isRunningJobDiscarded)
+            m_massPropsEngine.erase(job.doc); // Document was closed meanwhile
+
+        m_docRunningJob.Nullify();
+        m_labelRunningJob.Nullify();
+    }
+}
+
 bool XCaf_DocumentTreeNodePropertiesProvider::supports(const DocumentTreeNode& treeNode) const
 {
     return GraphicsShapeObjectDriver::shapeSupportStatus(treeNode.label()) == GraphicsObjectDriver::Support::Complete;
@@ -211,7 +335,7 @@ XCaf_DocumentTreeNodePropertiesProvider::properties(const DocumentTreeNode& tree
     if (!treeNode.isValid())
         return {};
 
-    return std::make_unique<Properties>(treeNode);
+    return std::make_unique<Properties>(treeNode, &m_massPropsEngine);
 }
 
 class Mesh_DocumentTreeNodePropertiesProvider::Properties : public PropertyGroupSignals {
@@ -259,15 +383,20 @@ public:
     {
         auto attrPointCloudData = CafUtils::findAttribute<PointCloudData>(treeNode.label());
 
-        const bool hasAttrData = !attrPointCloudData.IsNull() && !attrPointCloudData->points().IsNull();
-        m_propertyPointCount.setValue(hasAttrData ? attrPointCloudData->points()->VertexNumber() : 0);
-        m_propertyHasColors.setValue(hasAttrData ? attrPointCloudData->points()->HasVertexColors() : false);
-        if (hasAttrData) {
-            Bnd_Box bndBox;
+        const bool hasAttrData = !attrPointCloudData.IsNull();
+        m_propertyPointCount.setValue(hasAttrData ? attrPointCloudData->pointCount() : 0);
+        m_propertyHasColors.setValue(hasAttrData ? attrPointCloudData->hasColors() : false);
+        Bnd_Box bndBox;
+        if (hasAttrData && attrPointCloudData->octree()) {
+            bndBox = attrPointCloudData->octree()->boundingBox();
+        }
+        else if (hasAttrData && !attrPointCloudData->points().IsNull()) {
             const int pntCount = attrPointCloudData->points()->VertexNumber();
             for (int i = 1; i <= pntCount; ++i)
                 bndBox.Add(attrPointCloudData->points()->Vertice(i));
+        }
 
+        if (!bndBox.IsVoid()) {
             m_propertyCornerMin.setValue(bndBox.CornerMin());
             m_propertyCornerMax.setValue(bndBox.CornerMax());
         }
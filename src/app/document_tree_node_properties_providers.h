@@ -7,20 +7,57 @@
 #pragma once
 
 #include "../base/document_tree_node_properties_provider.h"
+#include "../base/mass_properties.h"
 #include "../base/property_builtins.h"
+#include "../base/signal.h"
 
 #include <TDF_Label.hxx>
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 namespace Mayo {
 
 // Provides relevant properties for tree node pointing to XCAF data
+// Mass properties(volume, area, centroid, mass) are computed with MassPropertiesEngine, results
+// are cached until the owner document is closed
+// Mass properties of the entities are computed ahead of time by a background thread as soon as
+// they are added to a document, so selecting a tree node doesn't block on their computation
+// The background thread locks Document::shapeMutex() in shared mode while reading the shapes
 class XCaf_DocumentTreeNodePropertiesProvider : public DocumentTreeNodePropertiesProvider {
 public:
+    XCaf_DocumentTreeNodePropertiesProvider();
+    ~XCaf_DocumentTreeNodePropertiesProvider();
+
     bool supports(const DocumentTreeNode& treeNode) const override;
     std::unique_ptr<PropertyGroupSignals> properties(const DocumentTreeNode& treeNode) const override;
 
 private:
     class Properties;
+
+    struct MassPropertiesJob {
+        DocumentPtr doc; // Keeps the document alive while the job is processed
+        TDF_Label labelEntity;
+    };
+
+    void runMassPropertiesJobs();
+
+    mutable MassPropertiesEngine m_massPropsEngine;
+    SignalConnectionHandle m_connDocumentEntityAdded;
+    SignalConnectionHandle m_connDocumentEntityAboutToBeDestroyed;
+    SignalConnectionHandle m_connDocumentAboutToClose;
+
+    std::mutex m_jobMutex;
+    std::condition_variable m_jobCondition;
+    std::deque<MassPropertiesJob> m_queueJob;
+    DocumentPtr m_docRunningJob;
+    TDF_Label m_labelRunningJob;
+    bool m_isRunningJobDiscarded = false;
+    bool m_isRunningJobCancelled = false;
+    bool m_isStopRequested = false;
+    std::thread m_jobThread;
 };
 
 // Provides relevant properties for tree node pointing to mesh data
@@ -82,6 +82,7 @@ struct CommandLineArguments {
     FilePath filepathLog;
     bool includeDebugLogs = true;
     std::vector<FilePath> listFilepathToExport;
+    std::vector<FilePath> listFilepathTessellationReport;
     std::vector<FilePath> listFilepathToOpen;
     bool cliProgressReport = true;
     bool showSystemInformation = false;
@@ -212,6 +213,14 @@ static CommandLineArguments processCommandLine()
     );
     cmdParser.addOption(cmdFileToExport);
 
+    const QCommandLineOption cmdFileTessellationReport(
+                QStringList{ "tessellation-report" },
+                Main::tr("Mesh opened files and write statistics about triangulations into an output "
+                         "file(CSV or JSON format, deduced from file suffix)"),
+                Main::tr("filepath")
+    );
+    cmdParser.addOption(cmdFileTessellationReport);
+
     const QCommandLineOption cmdFileLog(
                 QStringList{ "log-file" },
                 Main::tr("Writes log messages into output file"),
@@ -269,6 +278,11 @@ static CommandLineArguments processCommandLine()
             args.listFilepathToExport.push_back(filepathFrom(strFilepath));
     }
 
+    if (cmdParser.isSet(cmdFileTessellationReport)) {
+        for (const QString& strFilepath : cmdParser.values(cmdFileTessellationReport))
+            args.listFilepathTessellationReport.push_back(filepathFrom(strFilepath));
+    }
+
     for (const QString& posArg : cmdParser.positionalArguments())
         args.listFilepathToOpen.push_back(filepathFrom(posArg));
 
@@ -417,7 +431,30 @@ static void initGui(GuiApplication* guiApp)
 #endif
 
     // Register Graphics entity drivers
-    guiApp->addGraphicsObjectDriver(std::make_unique<GraphicsShapeObjectDriver>());
+    GraphicsShapeObjectDriverPtr shapeDriver = new GraphicsShapeObjectDriver;
+    auto fnApplyLazyMeshing = [=]{
+        auto appModule = AppModule::get();
+        if (appModule->properties()->meshingLazy) {
+            shapeDriver->setLazyMeshingFunction([=](const TopoDS_Shape& shape) {
+                appModule->computeBRepMesh(shape);
+            });
+        }
+        else {
+            shapeDriver->setLazyMeshingFunction({});
+        }
+    };
+    fnApplyLazyMeshing();
+    shapeDriver->setStaticSceneEnabled(AppModule::get()->properties()->staticScene);
+    shapeDriver->setEdgeRendering(AppModule::get()->properties()->edgeRendering);
+    AppModule::get()->settings()->signalChanged.connectSlot([=](Property* prop) {
+        if (prop == &AppModule::get()->properties()->meshingLazy)
+            fnApplyLazyMeshing();
+        else if (prop == &AppModule::get()->properties()->staticScene)
+            shapeDriver->setStaticSceneEnabled(AppModule::get()->properties()->staticScene);
+        else if (prop == &AppModule::get()->properties()->edgeRendering)
+            shapeDriver->setEdgeRendering(AppModule::get()->properties()->edgeRendering);
+    });
+    guiApp->addGraphicsObjectDriver(shapeDriver);
     guiApp->addGraphicsObjectDriver(std::make_unique<GraphicsMeshObjectDriver>());
     guiApp->addGraphicsObjectDriver(std::make_unique<GraphicsPointCloudObjectDriver>());
 }
@@ -518,7 +555,7 @@ static int runApp(QCoreApplication* qtApp)
         return qtApp->exec();
     }
 
-    if (!args.listFilepathToExport.empty()) {
+    if (!args.listFilepathToExport.empty() || !args.listFilepathTessellationReport.empty()) {
         if (args.listFilepathToOpen.empty())
             fnCriticalExit(Main::tr("No input files -> nothing to export"));
 
@@ -530,6 +567,7 @@ static int runApp(QCoreApplication* qtApp)
             cliArgs.progressReport = args.cliProgressReport;
             cliArgs.filesToOpen = args.listFilepathToOpen;
             cliArgs.filesToExport = args.listFilepathToExport;
+            cliArgs.filesTessellationReport = args.listFilepathTessellationReport;
             cli_asyncExportDocuments(app, cliArgs, [=](int retcode) { qtApp->exit(retcode); });
         });
         return qtApp->exec();
@@ -595,7 +633,9 @@ int main(int argc, char* argv[])
     };
 
     // If the arguments(argv) contain any of the following option, then Mayo has to run in CLI mode
-    const bool isAppCliMode = fnArgsContainAnyOf({ "-e", "--export", "-h", "--help", "-v", "--version" });
+    const bool isAppCliMode = fnArgsContainAnyOf({
+            "-e", "--export", "--tessellation-report", "-h", "--help", "-v", "--version"
+    });
 
     // OpenCascade TKOpenGl depends on XLib for Linux(excepting Android) and BSD systems(excepting macOS)
     // See for example implementation of Aspect_DisplayConnection where XLib is explicitly used
@@ -122,6 +122,8 @@ void MainWindow::createCommands()
     // "Tools" commands
     this->addCommand<CommandSaveViewImage>();
     this->addCommand<CommandInspectXde>();
+    this->addCommand<CommandTessellationReport>();
+    this->addCommand<CommandMeshPostProcess>();
     this->addCommand<CommandEditOptions>();
 
     // "Window" commands
@@ -179,6 +181,8 @@ void MainWindow::createMenus()
         auto menu = m_ui->menu_Tools;
         fnAddAction(menu, CommandSaveViewImage::Name);
         fnAddAction(menu, CommandInspectXde::Name);
+        fnAddAction(menu, CommandTessellationReport::Name);
+        fnAddAction(menu, CommandMeshPostProcess::Name);
         menu->addSeparator();
         fnAddAction(menu, CommandEditOptions::Name);
     }
@@ -24,6 +24,12 @@ WidgetExplodeAssembly::WidgetExplodeAssembly(GuiDocument* guiDoc, QWidget* paren
         m_ui->edit_Factor->setValue(pct);
         m_guiDoc->setExplodingFactor(pct / 100.);
     });
+    QObject::connect(m_ui->slider_Factor, &QSlider::sliderPressed, this, [=]{
+        m_guiDoc->setExplodingInteractive(true);
+    });
+    QObject::connect(m_ui->slider_Factor, &QSlider::sliderReleased, this, [=]{
+        m_guiDoc->setExplodingInteractive(false);
+    });
     QObject::connect(m_ui->edit_Factor, qOverload<int>(&QSpinBox::valueChanged), this, [=](int pct) {
         QSignalBlocker sigBlock(m_ui->slider_Factor);
         m_ui->slider_Factor->setValue(pct);
@@ -193,8 +193,15 @@ WidgetGuiDocument::WidgetGuiDocument(GuiDocument* guiDoc, QWidget* parent)
                 m_btnMeasure, &ButtonFlat::checked,
                 this, &WidgetGuiDocument::toggleWidgetMeasure
     );
-    m_controller->signalDynamicActionStarted.connectSlot([=]{ m_guiDoc->stopViewCameraAnimation(); });
-    m_controller->signalViewScaled.connectSlot([=]{ m_guiDoc->stopViewCameraAnimation(); });
+    m_controller->signalDynamicActionStarted.connectSlot([=]{
+        m_guiDoc->stopViewCameraAnimation();
+        m_guiDoc->setCoarsestLevelOfDetailForced(true);
+    });
+    m_controller->signalDynamicActionEnded.connectSlot([=]{ m_guiDoc->setCoarsestLevelOfDetailForced(false); });
+    m_controller->signalViewScaled.connectSlot([=]{
+        m_guiDoc->stopViewCameraAnimation();
+        m_guiDoc->updateLevelsOfDetail();
+    });
     m_controller->signalMouseButtonClicked.connectSlot([=](Aspect_VKeyMouse btn) {
         if (btn == Aspect_VKeyMouse_LeftButton && !m_guiDoc->processAction(gfxScene->currentHighlightedOwner())) {
             gfxScene->select();
@@ -208,8 +215,10 @@ WidgetGuiDocument::WidgetGuiDocument(GuiDocument* guiDoc, QWidget* parent)
 
     m_guiDoc->viewCameraAnimation()->setBackend(std::make_unique<QtAnimationBackend>(QEasingCurve::OutExpo));
     m_guiDoc->viewCameraAnimation()->setRenderFunction([=](const Handle_V3d_View& view){
-        if (view == m_qtOccView->v3dView())
+        if (view == m_qtOccView->v3dView()) {
+            m_guiDoc->updateLevelsOfDetail();
             m_qtOccView->redraw();
+        }
     });
 }
 
@@ -25,6 +25,7 @@
 #include <cassert>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 Q_DECLARE_METATYPE(Mayo::DocumentPtr)
 Q_DECLARE_METATYPE(Mayo::DocumentTreeNode)
@@ -455,7 +456,23 @@ void WidgetModelTree::onTreeModelDataChanged(
         if (!guiDoc)
             return;
 
-        guiDoc->setNodeVisible(treeNode.id(), checkState == CheckState::On ? true : false);
+        // Toggling a selected item applies to all the selected items of the same document, graphics
+        // being updated in one pass
+        std::vector<TreeNodeId> vecNodeId = { treeNode.id() };
+        const QTreeWidgetItem* treeItem = m_ui->treeWidget_Model->itemFromIndex(indexItem);
+        if (treeItem && treeItem->isSelected()) {
+            for (const QTreeWidgetItem* selectedTreeItem : m_ui->treeWidget_Model->selectedItems()) {
+                const DocumentTreeNode selectedNode = Internal::treeItemDocumentTreeNode(selectedTreeItem);
+                if (selectedNode.isValid()
+                        && selectedNode.document() == treeNode.document()
+                        && selectedNode.id() != treeNode.id())
+                {
+                    vecNodeId.push_back(selectedNode.id());
+                }
+            }
+        }
+
+        guiDoc->setNodesVisible(vecNodeId, checkState == CheckState::On ? true : false);
         guiDoc->graphicsScene()->redraw();
     }
 }
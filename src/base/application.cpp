@@ -150,7 +150,11 @@ int Application::findIndexOfDocument(const DocumentPtr& doc) const
 
 void Application::closeDocument(const DocumentPtr& doc)
 {
-    TDocStd_Application::Close(doc);
+    {
+        std::unique_lock<std::shared_mutex> lock(doc->shapeMutex());
+        TDocStd_Application::Close(doc);
+    }
+
     doc->signalNameChanged.disconnectAll();
     doc->signalFilePathChanged.disconnectAll();
     doc->signalEntityAdded.disconnectAll();
@@ -0,0 +1,193 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "bnd_box_engine.h"
+
+#include "brep_utils.h"
+#include "mesh_utils.h"
+#include "xcaf.h"
+
+#include <BRepBndLib.hxx>
+#include <BRep_Tool.hxx>
+#include <OSD_Parallel.hxx>
+#include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Iterator.hxx>
+
+#include <functional>
+#include <vector>
+
+namespace Mayo {
+
+namespace {
+
+Bnd_Box faceBndBox(const TopoDS_Face& face, BndBoxEngine::Mode mode)
+{
+    Bnd_Box box;
+    TopLoc_Location locFace;
+    const OccHandle<Poly_Triangulation>& triangulation = BRep_Tool::Triangulation(face, locFace);
+    const bool useTriangulation =
+            !triangulation.IsNull()
+            && (mode == BndBoxEngine::Mode::Triangulation || !BRepUtils::isGeometric(face));
+    if (!useTriangulation) {
+        BRepBndLib::Add(face, box, false/*useTriangulation*/);
+        return box;
+    }
+
+    std::vector<gp_XYZ> vecNodeCopy;
+    Span<const gp_XYZ> spanNode = MeshUtils::contiguousNodes(triangulation, &vecNodeCopy);
+    if (!locFace.IsIdentity()) {
+        // Nodes have to be copied to be transformed, unless already copied
+        if (vecNodeCopy.empty())
+            vecNodeCopy.assign(spanNode.begin(), spanNode.end());
+
+        const gp_Trsf& trsf = locFace.Transformation();
+        for (gp_XYZ& node : vecNodeCopy)
+            trsf.Transforms(node);
+
+        spanNode = vecNodeCopy;
+    }
+
+    gp_XYZ pntMin, pntMax;
+    if (MeshUtils::batchBoundingBox(spanNode, &pntMin, &pntMax)) {
+        box.Update(pntMin.X(), pntMin.Y(), pntMin.Z(), pntMax.X(), pntMax.Y(), pntMax.Z());
+        box.Enlarge(BRep_Tool::Tolerance(face));
+    }
+
+    return box;
+}
+
+void hashCombine(size_t* ptrHash, size_t value)
+{
+    *ptrHash ^= value + 0x9e3779b97f4a7c15 + (*ptrHash << 6) + (*ptrHash >> 2);
+}
+
+// Hash of the state of 'shape' the box depends on, it's computed on each cache lookup so it must
+// be cheap: faces and free edges are explored without any allocation
+size_t shapeStateHash(const TopoDS_Shape& shape, BndBoxEngine::Mode mode)
+{
+    size_t hash = 0;
+    for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+        const TopoDS_Face& face = TopoDS::Face(expl.Current());
+        TopLoc_Location locFace;
+        const OccHandle<Geom_Surface>& surface = BRep_Tool::Surface(face, locFace);
+        hashCombine(&hash, BRepUtils::hashCode(face));
+        hashCombine(&hash, std::hash<const void*>{}(surface.get()));
+        hashCombine(&hash, std::hash<double>{}(BRep_Tool::Tolerance(face)));
+        // Mesh-only faces are bounded with their triangulation in Geometry mode too
+        if (mode == BndBoxEngine::Mode::Triangulation || surface.IsNull())
+            hashCombine(&hash, std::hash<const void*>{}(BRep_Tool::Triangulation(face, locFace).get()));
+    }
+
+    for (TopExp_Explorer expl(shape, TopAbs_EDGE, TopAbs_FACE); expl.More(); expl.Next()) {
+        const TopoDS_Edge& edge = TopoDS::Edge(expl.Current());
+        hashCombine(&hash, BRepUtils::hashCode(edge));
+        hashCombine(&hash, std::hash<double>{}(BRep_Tool::Tolerance(edge)));
+    }
+
+    return hash;
+}
+
+} // namespace
+
+BndBoxEngine& BndBoxEngine::instance()
+{
+    static BndBoxEngine engine;
+    return engine;
+}
+
+Bnd_Box BndBoxEngine::compute(const TopoDS_Shape& shape, Mode mode)
+{
+    Bnd_Box box;
+    if (shape.IsNull())
+        return box;
+
+    // Faces are processed in parallel
+    TopTools_IndexedMapOfShape mapFace;
+    TopExp::MapShapes(shape, TopAbs_FACE, mapFace);
+    std::vector<Bnd_Box> vecFaceBox(mapFace.Extent());
+    OSD_Parallel::For(0, mapFace.Extent(), [&](int i) {
+        vecFaceBox.at(i) = faceBndBox(TopoDS::Face(mapFace.FindKey(i + 1)), mode);
+    }, mapFace.Extent() < 2/*isForceSingleThreadExecution*/);
+
+    for (const Bnd_Box& faceBox : vecFaceBox)
+        box.Add(faceBox);
+
+    // Free edges and free vertices
+    const bool useTriangulation = mode == Mode::Triangulation;
+    for (TopExp_Explorer expl(shape, TopAbs_EDGE, TopAbs_FACE); expl.More(); expl.Next())
+        BRepBndLib::Add(expl.Current(), box, useTriangulation);
+
+    for (TopExp_Explorer expl(shape, TopAbs_VERTEX, TopAbs_EDGE); expl.More(); expl.Next())
+        BRepBndLib::Add(expl.Current(), box, useTriangulation);
+
+    return box;
+}
+
+Bnd_Box BndBoxEngine::get(const TopoDS_Shape& shape, Mode mode)
+{
+    if (shape.IsNull())
+        return Bnd_Box();
+
+    const Bnd_Box box = this->localBox(shape, mode);
+    if (box.IsVoid() || shape.Location().IsIdentity())
+        return box;
+
+    return box.Transformed(shape.Location().Transformation());
+}
+
+Bnd_Box BndBoxEngine::get(const TDF_Label& label, Mode mode)
+{
+    return this->get(XCaf::shape(label), mode);
+}
+
+void BndBoxEngine::purge()
+{
+    m_geometryCache.purge();
+    m_triangulationCache.purge();
+}
+
+void BndBoxEngine::clear()
+{
+    m_geometryCache.clear();
+    m_triangulationCache.clear();
+}
+
+int BndBoxEngine::cacheSize() const
+{
+    return m_geometryCache.size() + m_triangulationCache.size();
+}
+
+Bnd_Box BndBoxEngine::localBox(const TopoDS_Shape& shape, Mode mode)
+{
+    const TopoDS_Shape shapeLocal = shape.Located(TopLoc_Location());
+    const size_t stateHash = shapeStateHash(shapeLocal, mode);
+    const std::optional<CachedBox> cachedBox = this->cache(mode).find(shapeLocal);
+    if (cachedBox && cachedBox->stateHash == stateHash)
+        return cachedBox->box;
+
+    Bnd_Box box;
+    if (shapeLocal.ShapeType() == TopAbs_COMPOUND) {
+        // Boxes of sub-shapes are cached so instances of the same sub-shape are computed once
+        for (TopoDS_Iterator it(shapeLocal); it.More(); it.Next())
+            box.Add(this->get(it.Value(), mode));
+    }
+    else {
+        box = BndBoxEngine::compute(shapeLocal, mode);
+    }
+
+    this->cache(mode).insert(shapeLocal, CachedBox{ box, stateHash });
+    return box;
+}
+
+TShapeCache<BndBoxEngine::CachedBox>& BndBoxEngine::cache(Mode mode)
+{
+    return mode == Mode::Geometry ? m_geometryCache : m_triangulationCache;
+}
+
+} // namespace Mayo
@@ -0,0 +1,63 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "tshape_cache.h"
+
+#include <Bnd_Box.hxx>
+#include <TDF_Label.hxx>
+#include <TopoDS_Shape.hxx>
+
+namespace Mayo {
+
+// Provides computation of bounding boxes of BRep shapes
+// Computation is parallelized over the faces of a shape, boxes of faces having triangulation are
+// computed with MeshUtils::batchBoundingBox()
+// Results are cached per TShape in the local coordinate system of the shape, so sub-shapes shared by
+// compounds(eg product instances of an assembly) are computed once and then placed with their
+// location. Note that placing a box with a rotation gives a box that might not be the tightest one
+// Cache entries are checked on each lookup against the state of the faces and free edges(location,
+// surface, tolerance, and triangulation in Triangulation mode), so shapes modified in place are
+// recomputed. Entries of shapes no longer referenced outside the cache are purged from time to time
+class BndBoxEngine {
+public:
+    enum class Mode {
+        Geometry, // Use the geometry of faces and edges, see BRepBndLib::Add()
+        Triangulation // Use the triangulation of faces if any, geometry otherwise
+    };
+
+    // Global engine, shared by application and gui modules
+    static BndBoxEngine& instance();
+
+    // Bounding box of 'shape', not cached
+    static Bnd_Box compute(const TopoDS_Shape& shape, Mode mode = Mode::Geometry);
+
+    // Bounding box of 'shape' with its location applied
+    Bnd_Box get(const TopoDS_Shape& shape, Mode mode = Mode::Geometry);
+
+    // Bounding box of the shape stored in 'label', see XCaf::shape()
+    Bnd_Box get(const TDF_Label& label, Mode mode = Mode::Geometry);
+
+    // Removes entries of shapes only referenced by the cache
+    void purge();
+    void clear();
+    int cacheSize() const;
+
+private:
+    struct CachedBox {
+        Bnd_Box box; // In local coordinate system of the shape
+        size_t stateHash = 0; // State of the shape the box was computed from
+    };
+
+    Bnd_Box localBox(const TopoDS_Shape& shape, Mode mode);
+    TShapeCache<CachedBox>& cache(Mode mode);
+
+    TShapeCache<CachedBox> m_geometryCache;
+    TShapeCache<CachedBox> m_triangulationCache;
+};
+
+} // namespace Mayo
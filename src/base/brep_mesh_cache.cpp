@@ -0,0 +1,589 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "brep_mesh_cache.h"
+
+#include "mesh_utils.h"
+
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <BRepTools.hxx>
+#include <Geom_Curve.hxx>
+#include <Geom_Surface.hxx>
+#include <Geom2d_Curve.hxx>
+#include <GeomTools.hxx>
+#include <OSD_Parallel.hxx>
+#include <Poly_PolygonOnTriangulation.hxx>
+#include <TColStd_Array1OfInteger.hxx>
+#include <TColStd_Array1OfReal.hxx>
+#include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Edge.hxx>
+#include <TopoDS_Face.hxx>
+#include <TopoDS_TShape.hxx>
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+namespace Mayo {
+
+namespace {
+
+// Identifies the cache file format, to be incremented on any change in the layout
+constexpr char cacheFileMagic[] = "MAYOMESH";
+constexpr uint32_t cacheFileVersion = 3;
+constexpr std::string_view cacheFileExtension = ".mesh";
+
+// FNV-1a hash of binary values
+class Fnv1aHash {
+public:
+    uint64_t value() const { return m_hash; }
+
+    void add(const void* data, size_t size) {
+        for (size_t i = 0; i < size; ++i)
+            m_hash = (m_hash ^ static_cast<const uint8_t*>(data)[i]) * 1099511628211ull;
+    }
+
+    template<typename T> void add(const T& value) {
+        static_assert(std::is_arithmetic_v<T>);
+        this->add(&value, sizeof(T));
+    }
+
+private:
+    uint64_t m_hash = 14695981039346656037ull;
+};
+
+// Returns the faces of 'shape', each underlying TShape being listed once
+std::vector<TopoDS_Face> uniqueFaces(const TopoDS_Shape& shape)
+{
+    std::vector<TopoDS_Face> vecFace;
+    std::unordered_set<const TopoDS_TShape*> setTShape;
+    for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+        if (setTShape.insert(expl.Current().TShape().get()).second)
+            vecFace.push_back(TopoDS::Face(expl.Current()));
+    }
+
+    return vecFace;
+}
+
+// Returns the edges of 'face', seam edges being listed once
+std::vector<TopoDS_Edge> faceEdges(const TopoDS_Face& face)
+{
+    TopTools_IndexedMapOfShape mapEdge;
+    TopExp::MapShapes(face, TopAbs_EDGE, mapEdge);
+    std::vector<TopoDS_Edge> vecEdge;
+    vecEdge.reserve(mapEdge.Extent());
+    for (int i = 1; i <= mapEdge.Extent(); ++i)
+        vecEdge.push_back(TopoDS::Edge(mapEdge.FindKey(i)));
+
+    return vecEdge;
+}
+
+// Adds to 'hash' the full definition of 'geom'(type, parameters, poles, knots, basis curve or
+// surface, ...) as written by GeomTools, with enough digits so any change is caught
+template<typename GeomHandle> void addGeometry(Fnv1aHash* hash, const GeomHandle& geom)
+{
+    if (!geom) {
+        hash->add(0);
+        return;
+    }
+
+    std::ostringstream ostr;
+    ostr.precision(std::numeric_limits<double>::max_digits10);
+    GeomTools::Write(geom, ostr);
+    const std::string str = ostr.str();
+    hash->add(str.data(), str.size());
+}
+
+void addLocation(Fnv1aHash* hash, const TopLoc_Location& loc)
+{
+    const gp_Trsf& trsf = loc.Transformation();
+    for (int row = 1; row <= 3; ++row) {
+        for (int col = 1; col <= 4; ++col)
+            hash->add(trsf.Value(row, col));
+    }
+}
+
+// Returns a fingerprint of the data of 'face' the mesher depends on: surface, boundary curves,
+// tolerances and locations. Geometries are hashed with their full definitions
+uint64_t faceFingerprint(const TopoDS_Face& face)
+{
+    Fnv1aHash hash;
+    hash.add(int(face.Orientation()));
+    hash.add(BRep_Tool::Tolerance(face));
+    hash.add(BRep_Tool::NaturalRestriction(face));
+    double uMin, uMax, vMin, vMax;
+    BRepTools::UVBounds(face, uMin, uMax, vMin, vMax);
+    hash.add(uMin); hash.add(uMax); hash.add(vMin); hash.add(vMax);
+
+    TopLoc_Location locSurface;
+    addGeometry(&hash, BRep_Tool::Surface(face, locSurface));
+    addLocation(&hash, locSurface);
+
+    // Boundary curves, in 3D and in the parametric space of the surface
+    for (TopExp_Explorer expl(face, TopAbs_EDGE); expl.More(); expl.Next()) {
+        const TopoDS_Edge& edge = TopoDS::Edge(expl.Current());
+        hash.add(int(edge.Orientation()));
+        hash.add(BRep_Tool::Tolerance(edge));
+        hash.add(BRep_Tool::Degenerated(edge));
+        double first, last;
+        addGeometry(&hash, BRep_Tool::CurveOnSurface(edge, face, first, last));
+        hash.add(first);
+        hash.add(last);
+        TopLoc_Location locCurve;
+        addGeometry(&hash, BRep_Tool::Curve(edge, locCurve, first, last));
+        addLocation(&hash, locCurve);
+        hash.add(first);
+        hash.add(last);
+    }
+
+    return hash.value();
+}
+
+// Fingerprints of 'vecFace' items, computed in parallel
+std::vector<uint64_t> faceFingerprints(const std::vector<TopoDS_Face>& vecFace)
+{
+    std::vector<uint64_t> vecFingerprint(vecFace.size());
+    const int faceCount = int(vecFace.size());
+    OSD_Parallel::For(0, faceCount, [&](int i) {
+        vecFingerprint.at(i) = faceFingerprint(vecFace.at(i));
+    }, faceCount < 2/*isForceSingleThreadExecution*/);
+    return vecFingerprint;
+}
+
+template<typename T> void writeValue(std::ostream& ostr, const T& value)
+{
+    ostr.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T> T readValue(std::istream& istr)
+{
+    T value = {};
+    istr.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+
+void writeTriangulation(std::ostream& ostr, const OccHandle<Poly_Triangulation>& triangulation)
+{
+    if (!triangulation || triangulation->NbNodes() <= 0) {
+        writeValue<int32_t>(ostr, 0);
+        return;
+    }
+
+    writeValue<int32_t>(ostr, triangulation->NbNodes());
+    writeValue<int32_t>(ostr, triangulation->NbTriangles());
+    writeValue<uint8_t>(ostr, triangulation->HasUVNodes() ? 1 : 0);
+    writeValue<double>(ostr, triangulation->Deflection());
+    for (int i = 1; i <= triangulation->NbNodes(); ++i) {
+#if OCC_VERSION_HEX >= 0x070600
+        const gp_Pnt pnt = triangulation->Node(i);
+#else
+        const gp_Pnt& pnt = triangulation->Nodes().Value(i);
+#endif
+        writeValue<double>(ostr, pnt.X());
+        writeValue<double>(ostr, pnt.Y());
+        writeValue<double>(ostr, pnt.Z());
+    }
+
+    if (triangulation->HasUVNodes()) {
+        for (int i = 1; i <= triangulation->NbNodes(); ++i) {
+#if OCC_VERSION_HEX >= 0x070600
+            const gp_Pnt2d uv = triangulation->UVNode(i);
+#else
+            const gp_Pnt2d& uv = triangulation->UVNodes().Value(i);
+#endif
+            writeValue<double>(ostr, uv.X());
+            writeValue<double>(ostr, uv.Y());
+        }
+    }
+
+    for (const Poly_Triangle& triangle : MeshUtils::triangles(triangulation)) {
+        int n1, n2, n3;
+        triangle.Get(n1, n2, n3);
+        writeValue<int32_t>(ostr, n1);
+        writeValue<int32_t>(ostr, n2);
+        writeValue<int32_t>(ostr, n3);
+    }
+}
+
+OccHandle<Poly_Triangulation> readTriangulation(std::istream& istr)
+{
+    const auto nodeCount = readValue<int32_t>(istr);
+    if (nodeCount <= 0)
+        return {};
+
+    const auto triangleCount = readValue<int32_t>(istr);
+    const bool hasUvNodes = readValue<uint8_t>(istr) != 0;
+    const auto deflection = readValue<double>(istr);
+    if (!istr || triangleCount < 0)
+        return {};
+
+    OccHandle<Poly_Triangulation> triangulation = new Poly_Triangulation(nodeCount, triangleCount, hasUvNodes);
+    triangulation->Deflection(deflection);
+    for (int i = 1; i <= nodeCount; ++i) {
+        const auto x = readValue<double>(istr);
+        const auto y = readValue<double>(istr);
+        const auto z = readValue<double>(istr);
+        MeshUtils::setNode(triangulation, i, gp_Pnt(x, y, z));
+    }
+
+    if (hasUvNodes) {
+        for (int i = 1; i <= nodeCount; ++i) {
+            const auto u = readValue<double>(istr);
+            const auto v = readValue<double>(istr);
+            MeshUtils::setUvNode(triangulation, i, u, v);
+        }
+    }
+
+    auto fnIsValidNode = [=](int n) { return n >= 1 && n <= nodeCount; };
+    for (int i = 1; i <= triangleCount; ++i) {
+        const auto n1 = readValue<int32_t>(istr);
+        const auto n2 = readValue<int32_t>(istr);
+        const auto n3 = readValue<int32_t>(istr);
+        if (!fnIsValidNode(n1) || !fnIsValidNode(n2) || !fnIsValidNode(n3))
+            return {};
+
+        MeshUtils::setTriangle(triangulation, i, Poly_Triangle(n1, n2, n3));
+    }
+
+    return istr ? triangulation : OccHandle<Poly_Triangulation>{};
+}
+
+// Discretization of an edge on the triangulation of a face, see Poly_PolygonOnTriangulation
+void writePolygon(std::ostream& ostr, const OccHandle<Poly_PolygonOnTriangulation>& polygon)
+{
+    if (!polygon || polygon->NbNodes() <= 0) {
+        writeValue<int32_t>(ostr, 0);
+        return;
+    }
+
+    writeValue<int32_t>(ostr, polygon->NbNodes());
+    writeValue<double>(ostr, polygon->Deflection());
+    writeValue<uint8_t>(ostr, polygon->HasParameters() ? 1 : 0);
+    for (int i = 1; i <= polygon->NbNodes(); ++i) {
+#if OCC_VERSION_HEX >= 0x070600
+        writeValue<int32_t>(ostr, polygon->Node(i));
+#else
+        writeValue<int32_t>(ostr, polygon->Nodes().Value(i));
+#endif
+    }
+
+    if (polygon->HasParameters()) {
+        for (int i = 1; i <= polygon->NbNodes(); ++i)
+            writeValue<double>(ostr, polygon->Parameters()->Value(i));
+    }
+}
+
+OccHandle<Poly_PolygonOnTriangulation> readPolygon(std::istream& istr, int triangulationNodeCount)
+{
+    const auto nodeCount = readValue<int32_t>(istr);
+    if (nodeCount <= 0)
+        return {};
+
+    const auto deflection = readValue<double>(istr);
+    const bool hasParameters = readValue<uint8_t>(istr) != 0;
+    TColStd_Array1OfInteger nodes(1, nodeCount);
+    for (int i = 1; i <= nodeCount; ++i) {
+        const auto node = readValue<int32_t>(istr);
+        if (node < 1 || node > triangulationNodeCount)
+            return {};
+
+        nodes.SetValue(i, node);
+    }
+
+    OccHandle<Poly_PolygonOnTriangulation> polygon;
+    if (hasParameters) {
+        TColStd_Array1OfReal params(1, nodeCount);
+        for (int i = 1; i <= nodeCount; ++i)
+            params.SetValue(i, readValue<double>(istr));
+
+        polygon = new Poly_PolygonOnTriangulation(nodes, params);
+    }
+    else {
+        polygon = new Poly_PolygonOnTriangulation(nodes);
+    }
+
+    polygon->Deflection(deflection);
+    return istr ? polygon : OccHandle<Poly_PolygonOnTriangulation>{};
+}
+
+// Mesh data of a face read from a cache file
+struct FaceMesh {
+    OccHandle<Poly_Triangulation> triangulation;
+    struct EdgePolygons {
+        OccHandle<Poly_PolygonOnTriangulation> polygon;
+        OccHandle<Poly_PolygonOnTriangulation> polygonReversed; // Seam edges only
+    };
+    std::vector<EdgePolygons> vecEdgePolygons; // Same order as faceEdges()
+};
+
+} // namespace
+
+BRepMeshCache::BRepMeshCache(const FilePath& dirPath, uint64_t maxSize)
+    : m_dirPath(dirPath),
+      m_maxSize(maxSize)
+{
+}
+
+std::string BRepMeshCache::computeKey(const TopoDS_Shape& shape, const OccBRepMeshParameters& params)
+{
+    Fnv1aHash hash;
+    hash.add(cacheFileVersion);
+    hash.add(params.Deflection);
+    hash.add(params.Angle);
+    hash.add(params.Relative);
+    hash.add(params.InternalVerticesMode);
+    hash.add(params.ControlSurfaceDeflection);
+    for (uint64_t fingerprint : faceFingerprints(uniqueFaces(shape)))
+        hash.add(fingerprint);
+
+    return fmt::format("{:016x}", hash.value());
+}
+
+bool BRepMeshCache::load(const TopoDS_Shape& shape, std::string_view key) const
+{
+    const FilePath filepath = this->cacheFilePath(key);
+    std::ifstream istr(filepath, std::ios::in | std::ios::binary);
+    if (!istr.is_open())
+        return false;
+
+    char magic[sizeof(cacheFileMagic) - 1] = {};
+    istr.read(magic, sizeof(magic));
+    if (!std::equal(std::begin(magic), std::end(magic), cacheFileMagic))
+        return false;
+
+    if (readValue<uint32_t>(istr) != cacheFileVersion)
+        return false;
+
+    const std::vector<TopoDS_Face> vecFace = uniqueFaces(shape);
+    if (readValue<uint32_t>(istr) != vecFace.size())
+        return false;
+
+    // Each face must match the fingerprint stored, which is much stronger than the 64bits key
+    const std::vector<uint64_t> vecFingerprint = faceFingerprints(vecFace);
+
+    // Read all mesh data first so 'shape' is left unchanged in case of error
+    std::vector<FaceMesh> vecFaceMesh(vecFace.size());
+    for (size_t i = 0; i < vecFace.size() && istr; ++i) {
+        if (readValue<uint64_t>(istr) != vecFingerprint.at(i))
+            return false;
+
+        FaceMesh& faceMesh = vecFaceMesh.at(i);
+        faceMesh.triangulation = readTriangulation(istr);
+        const int nodeCount = faceMesh.triangulation ? faceMesh.triangulation->NbNodes() : 0;
+        const auto edgeCount = readValue<uint32_t>(istr);
+        if (!istr || edgeCount != faceEdges(vecFace.at(i)).size())
+            return false;
+
+        faceMesh.vecEdgePolygons.resize(edgeCount);
+        for (FaceMesh::EdgePolygons& edgePolygons : faceMesh.vecEdgePolygons) {
+            const bool isSeam = readValue<uint8_t>(istr) != 0;
+            edgePolygons.polygon = readPolygon(istr, nodeCount);
+            if (isSeam)
+                edgePolygons.polygonReversed = readPolygon(istr, nodeCount);
+        }
+    }
+
+    if (!istr)
+        return false;
+
+    BRep_Builder builder;
+    for (size_t i = 0; i < vecFace.size(); ++i) {
+        const TopoDS_Face& face = vecFace.at(i);
+        const FaceMesh& faceMesh = vecFaceMesh.at(i);
+        if (!faceMesh.triangulation)
+            continue;
+
+        builder.UpdateFace(face, faceMesh.triangulation);
+        const std::vector<TopoDS_Edge> vecEdge = faceEdges(face);
+        for (size_t j = 0; j < vecEdge.size(); ++j) {
+            const FaceMesh::EdgePolygons& edgePolygons = faceMesh.vecEdgePolygons.at(j);
+            const TopoDS_Edge& edge = vecEdge.at(j);
+            if (edgePolygons.polygon && edgePolygons.polygonReversed) {
+                builder.UpdateEdge(
+                            TopoDS::Edge(edge.Oriented(TopAbs_FORWARD)),
+                            edgePolygons.polygon, edgePolygons.polygonReversed,
+                            faceMesh.triangulation, face.Location()
+                );
+            }
+            else if (edgePolygons.polygon) {
+                builder.UpdateEdge(edge, edgePolygons.polygon, faceMesh.triangulation, face.Location());
+            }
+        }
+    }
+
+    // Mark cache file as recently used
+    std::error_code ec;
+    std_filesystem::last_write_time(filepath, std_filesystem::file_time_type::clock::now(), ec);
+    return true;
+}
+
+bool BRepMeshCache::store(const TopoDS_Shape& shape, std::string_view key)
+{
+    std::error_code ec;
+    std_filesystem::create_directories(m_dirPath, ec);
+    const FilePath filepath = this->cacheFilePath(key);
+    // Temporary file is unique per thread, the same key might be stored concurrently
+    FilePath filepathTmp = filepath;
+    filepathTmp += fmt::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+    {
+        std::ofstream ostr(filepathTmp, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!ostr.is_open())
+            return false;
+
+        ostr.write(cacheFileMagic, sizeof(cacheFileMagic) - 1);
+        writeValue<uint32_t>(ostr, cacheFileVersion);
+        const std::vector<TopoDS_Face> vecFace = uniqueFaces(shape);
+        const std::vector<uint64_t> vecFingerprint = faceFingerprints(vecFace);
+        writeValue<uint32_t>(ostr, static_cast<uint32_t>(vecFace.size()));
+        for (size_t i = 0; i < vecFace.size(); ++i) {
+            const TopoDS_Face& face = vecFace.at(i);
+            TopLoc_Location loc;
+            const OccHandle<Poly_Triangulation>& triangulation = BRep_Tool::Triangulation(face, loc);
+            writeValue<uint64_t>(ostr, vecFingerprint.at(i));
+            writeTriangulation(ostr, triangulation);
+            // Discretization of the edges on the triangulation, seam edges have two polygons
+            const std::vector<TopoDS_Edge> vecEdge = faceEdges(face);
+            writeValue<uint32_t>(ostr, static_cast<uint32_t>(vecEdge.size()));
+            for (const TopoDS_Edge& edge : vecEdge) {
+                const bool isSeam = triangulation && BRep_Tool::IsClosed(edge, face);
+                writeValue<uint8_t>(ostr, isSeam ? 1 : 0);
+                if (isSeam) {
+                    const TopoDS_Edge edgeForward = TopoDS::Edge(edge.Oriented(TopAbs_FORWARD));
+                    const TopoDS_Edge edgeReversed = TopoDS::Edge(edge.Oriented(TopAbs_REVERSED));
+                    writePolygon(ostr, BRep_Tool::PolygonOnTriangulation(edgeForward, triangulation, loc));
+                    writePolygon(ostr, BRep_Tool::PolygonOnTriangulation(edgeReversed, triangulation, loc));
+                }
+                else if (triangulation) {
+                    writePolygon(ostr, BRep_Tool::PolygonOnTriangulation(edge, triangulation, loc));
+                }
+                else {
+                    writePolygon(ostr, {});
+                }
+            }
+        }
+
+        if (!ostr.good()) {
+            ostr.close();
+            std_filesystem::remove(filepathTmp, ec);
+            return false;
+        }
+    }
+
+    // Rename so concurrent readers never see partially written files
+    const uint64_t fileSize = filepathFileSize(filepathTmp);
+    const uint64_t replacedFileSize = filepathFileSize(filepath);
+    std_filesystem::rename(filepathTmp, filepath, ec);
+    if (ec) {
+        std_filesystem::remove(filepathTmp, ec);
+        return false;
+    }
+
+    // Cache directory is scanned only if the size limit is exceeded
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_cacheSize) {
+        *m_cacheSize += fileSize;
+        *m_cacheSize -= std::min(replacedFileSize, *m_cacheSize);
+    }
+
+    if (!m_cacheSize || *m_cacheSize > m_maxSize)
+        this->evictFiles();
+
+    return true;
+}
+
+uint64_t BRepMeshCache::size() const
+{
+    uint64_t size = 0;
+    std::error_code ec;
+    for (const auto& entry : std_filesystem::directory_iterator(m_dirPath, ec)) {
+        if (entry.path().extension().u8string() == cacheFileExtension)
+            size += filepathFileSize(entry.path());
+    }
+
+    return size;
+}
+
+void BRepMeshCache::evict()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    this->evictFiles();
+}
+
+void BRepMeshCache::evictFiles()
+{
+    struct CacheFile {
+        FilePath filepath;
+        uint64_t size;
+        std_filesystem::file_time_type lastUseTime;
+    };
+
+    std::vector<CacheFile> vecCacheFile;
+    uint64_t cacheSize = 0;
+    std::error_code ec;
+    for (const auto& entry : std_filesystem::directory_iterator(m_dirPath, ec)) {
+        if (entry.path().extension().u8string() != cacheFileExtension)
+            continue;
+
+        const CacheFile cacheFile{
+            entry.path(), filepathFileSize(entry.path()), filepathLastWriteTime(entry.path())
+        };
+        cacheSize += cacheFile.size;
+        vecCacheFile.push_back(cacheFile);
+    }
+
+    m_cacheSize = cacheSize;
+    if (cacheSize <= m_maxSize)
+        return;
+
+    std::sort(vecCacheFile.begin(), vecCacheFile.end(), [](const CacheFile& lhs, const CacheFile& rhs) {
+        return lhs.lastUseTime < rhs.lastUseTime;
+    });
+    for (const CacheFile& cacheFile : vecCacheFile) {
+        if (cacheSize <= m_maxSize)
+            break;
+
+        if (std_filesystem::remove(cacheFile.filepath, ec))
+            cacheSize -= cacheFile.size;
+    }
+
+    m_cacheSize = cacheSize;
+}
+
+void BRepMeshCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<FilePath> vecFilepath;
+    std::error_code ec;
+    for (const auto& entry : std_filesystem::directory_iterator(m_dirPath, ec)) {
+        if (entry.path().extension().u8string() == cacheFileExtension)
+            vecFilepath.push_back(entry.path());
+    }
+
+    for (const FilePath& filepath : vecFilepath)
+        std_filesystem::remove(filepath, ec);
+
+    m_cacheSize.reset(); // Some files might not have been removed
+}
+
+FilePath BRepMeshCache::cacheFilePath(std::string_view key) const
+{
+    FilePath filepath = m_dirPath / std::string(key);
+    filepath += std::string(cacheFileExtension);
+    return filepath;
+}
+
+} // namespace Mayo
@@ -0,0 +1,73 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "filepath.h"
+#include "occ_brep_mesh_parameters.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+class TopoDS_Shape;
+
+namespace Mayo {
+
+// Provides a persistent on-disk cache of BRep face triangulations
+// Triangulations of all the faces of a shape, along with the discretization of their edges, are
+// stored in a single cache file, named after a key computed from the meshing parameters and the
+// fingerprints of the faces(surface, boundary curves, tolerances and location). Fingerprints are
+// also stored in the file and checked on load
+// The size of the cache directory is bounded: least recently used files are evicted once the
+// total size exceeds the limit. Last use of a cache file is tracked with its modification time
+// Total size is scanned once then maintained by store(), directory is scanned again only when
+// the limit is exceeded
+class BRepMeshCache {
+public:
+    BRepMeshCache(const FilePath& dirPath, uint64_t maxSize);
+
+    const FilePath& directoryPath() const { return m_dirPath; }
+
+    // Cache size limit in bytes, applied by next call to store() or evict()
+    uint64_t maxSize() const { return m_maxSize; }
+    void setMaxSize(uint64_t size) { m_maxSize = size; }
+
+    // Returns the cache key of 'shape' meshed with parameters 'params'
+    // Existing triangulations of 'shape' are ignored
+    static std::string computeKey(const TopoDS_Shape& shape, const OccBRepMeshParameters& params);
+
+    // Attaches to 'shape' faces the triangulations stored for 'key'
+    // Returns true on cache hit, 'shape' is then left unchanged on cache miss
+    bool load(const TopoDS_Shape& shape, std::string_view key) const;
+
+    // Stores triangulations of 'shape' faces for 'key', then evicts least recently used files if
+    // cache size limit is exceeded
+    bool store(const TopoDS_Shape& shape, std::string_view key);
+
+    // Total size in bytes of the cache files
+    uint64_t size() const;
+
+    // Removes least recently used files until cache size is not greater than maxSize()
+    void evict();
+
+    // Removes all cache files
+    void clear();
+
+private:
+    FilePath cacheFilePath(std::string_view key) const;
+    void evictFiles(); // Requires lock on 'm_mutex'
+
+    FilePath m_dirPath;
+    std::atomic<uint64_t> m_maxSize{0};
+    mutable std::mutex m_mutex;
+    std::optional<uint64_t> m_cacheSize; // Unknown until cache directory is scanned
+};
+
+} // namespace Mayo
@@ -17,8 +17,10 @@
 #include <BRep_Tool.hxx>
 #include <BRepTools.hxx>
 #include <TopoDS_Compound.hxx>
+#include <TopoDS_TShape.hxx>
 #include <climits>
 #include <sstream>
+#include <unordered_set>
 
 namespace Mayo {
 
@@ -112,4 +114,46 @@ void BRepUtils::computeMesh(
     MAYO_UNUSED(mesher);
 }
 
+void BRepUtils::transferMesh(const TopoDS_Shape& shapeFrom, const TopoDS_Shape& shapeTo)
+{
+    BRep_Builder builder;
+    std::unordered_set<const TopoDS_TShape*> setVisitedTFace;
+    TopExp_Explorer expFaceFrom(shapeFrom, TopAbs_FACE);
+    TopExp_Explorer expFaceTo(shapeTo, TopAbs_FACE);
+    for (; expFaceFrom.More() && expFaceTo.More(); expFaceFrom.Next(), expFaceTo.Next()) {
+        const TopoDS_Face& faceFrom = TopoDS::Face(expFaceFrom.Current());
+        const TopoDS_Face& faceTo = TopoDS::Face(expFaceTo.Current());
+        if (!setVisitedTFace.insert(faceTo.TShape().get()).second)
+            continue; // Face already processed
+
+        TopLoc_Location locFace;
+        const Handle(Poly_Triangulation)& triangulation = BRep_Tool::Triangulation(faceFrom, locFace);
+        if (triangulation.IsNull())
+            continue;
+
+        // Polygons on triangulation are bound to the triangulation, so edges have to be updated
+        // otherwise boundaries of 'faceTo' would no longer match its triangulation
+        TopExp_Explorer expEdgeFrom(faceFrom, TopAbs_EDGE);
+        TopExp_Explorer expEdgeTo(faceTo, TopAbs_EDGE);
+        for (; expEdgeFrom.More() && expEdgeTo.More(); expEdgeFrom.Next(), expEdgeTo.Next()) {
+            const TopoDS_Edge edgeFrom = TopoDS::Edge(expEdgeFrom.Current().Oriented(TopAbs_FORWARD));
+            const TopoDS_Edge edgeTo = TopoDS::Edge(expEdgeTo.Current().Oriented(TopAbs_FORWARD));
+            auto polygon = BRep_Tool::PolygonOnTriangulation(edgeFrom, triangulation, locFace);
+            if (polygon.IsNull())
+                continue;
+
+            if (BRep_Tool::IsClosed(edgeFrom, faceFrom)) {
+                const TopoDS_Edge edgeFromReversed = TopoDS::Edge(edgeFrom.Reversed());
+                auto polygonReversed = BRep_Tool::PolygonOnTriangulation(edgeFromReversed, triangulation, locFace);
+                builder.UpdateEdge(edgeTo, polygon, polygonReversed, triangulation, locFace);
+            }
+            else {
+                builder.UpdateEdge(edgeTo, polygon, triangulation, locFace);
+            }
+        }
+
+        builder.UpdateFace(faceTo, triangulation);
+    }
+}
+
 } // namespace Mayo
@@ -73,6 +73,11 @@ struct BRepUtils {
             const OccBRepMeshParameters& params,
             TaskProgress* progress = nullptr
     );
+
+    // Replaces the triangulations of 'shapeTo' faces by the ones of 'shapeFrom' faces, along with
+    // the polygons on triangulation of the face edges
+    // 'shapeTo' must be topologically identical to 'shapeFrom'(eg a copy made with BRepBuilderAPI_Copy)
+    static void transferMesh(const TopoDS_Shape& shapeFrom, const TopoDS_Shape& shapeTo);
 };
 
 
@@ -191,6 +191,7 @@ void Document::destroyEntity(TreeNodeId entityTreeNodeId)
         return;
 
     this->signalEntityAboutToBeDestroyed.send(entityTreeNodeId);
+    std::unique_lock<std::shared_mutex> lock(m_shapeMutex);
     entityLabel.ForgetAllAttributes();
     entityLabel.Nullify();
     m_modelTree.removeRoot(entityTreeNodeId);
@@ -14,6 +14,7 @@
 #include "signal.h"
 #include "xcaf.h"
 
+#include <shared_mutex>
 #include <string>
 #include <string_view>
 
@@ -68,6 +69,11 @@ public:
     void addEntityTreeNodeSequence(const TDF_LabelSequence& seqLabel);
     void destroyEntity(TreeNodeId entityTreeNodeId);
 
+    // Guards the shapes of the document and the meshes attached to them against concurrent access
+    // Code modifying shapes/meshes of existing entities has to lock it exclusively, background
+    // readers(eg computation of mass properties) have to lock it in shared mode
+    std::shared_mutex& shapeMutex() const { return m_shapeMutex; }
+
     // Signals
     Signal<const std::string&> signalNameChanged;
     Signal<const FilePath&> signalFilePathChanged;
@@ -99,6 +105,7 @@ private:
     FilePath m_filePath;
     XCaf m_xcaf;
     Tree<TDF_Label> m_modelTree;
+    mutable std::shared_mutex m_shapeMutex;
 };
 
 } // namespace Mayo
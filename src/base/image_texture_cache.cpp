@@ -0,0 +1,218 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "image_texture_cache.h"
+#include "filepath_conv.h"
+
+#include <NCollection_Buffer.hxx>
+#if OCC_VERSION_HEX >= 0x070500
+#  include <XCAFDoc_VisMaterial.hxx>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iterator>
+
+namespace Mayo {
+
+ImageTextureCache& ImageTextureCache::global()
+{
+    static ImageTextureCache cache;
+    return cache;
+}
+
+OccHandle<Image_Texture> ImageTextureCache::findOrCreate(Span<const uint8_t> data, std::string_view textureId)
+{
+    const std::string_view strData(reinterpret_cast<const char*>(data.data()), data.size());
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_mapHashDataTextures.find(std::hash<std::string_view>{}(strData));
+        if (it != m_mapHashDataTextures.cend()) {
+            for (const TextureHandle& texture : it->second) {
+                if (dataView(texture) == strData)
+                    return texture;
+            }
+        }
+    }
+
+    // Copy data outside of the lock, 'data' can be huge
+    OccHandle<NCollection_Buffer> buffer = new NCollection_Buffer(NCollection_BaseAllocator::CommonBaseAllocator(), data.size());
+    std::memcpy(buffer->ChangeData(), data.data(), data.size());
+    const TCollection_AsciiString strTextureId(textureId.data(), int(textureId.size()));
+    TextureHandle texture = new Image_Texture(buffer, strTextureId);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return this->insertData(texture, dataView(texture));
+}
+
+OccHandle<Image_Texture> ImageTextureCache::findOrCreate(const FilePath& filepath)
+{
+    const std::string key = ImageTextureCache::fileKey(filepath, -1, -1);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_mapKeyFileTexture.find(key);
+    if (it != m_mapKeyFileTexture.cend())
+        return it->second;
+
+    TextureHandle texture = new Image_Texture(filepathTo<TCollection_AsciiString>(filepath));
+    return this->insertFile(texture, key);
+}
+
+OccHandle<Image_Texture> ImageTextureCache::share(const OccHandle<Image_Texture>& texture)
+{
+    if (!texture)
+        return texture;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_setCachedTexture.find(texture.get()) != m_setCachedTexture.cend())
+            return texture;
+    }
+
+    if (texture->DataBuffer()) {
+        const std::string_view strData = dataView(texture);
+        const size_t hash = std::hash<std::string_view>{}(strData);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_mapHashDataTextures.find(hash);
+        if (it != m_mapHashDataTextures.cend()) {
+            for (const TextureHandle& cachedTexture : it->second) {
+                if (dataView(cachedTexture) == strData)
+                    return cachedTexture;
+            }
+        }
+
+        return this->insertData(texture, strData);
+    }
+
+    if (!texture->FilePath().IsEmpty()) {
+        const std::string key = ImageTextureCache::fileKey(
+                    filepathFrom(texture->FilePath()), texture->FileOffset(), texture->FileLength()
+        );
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_mapKeyFileTexture.find(key);
+        if (it != m_mapKeyFileTexture.cend())
+            return it->second;
+
+        return this->insertFile(texture, key);
+    }
+
+    return texture;
+}
+
+#if OCC_VERSION_HEX >= 0x070500
+void ImageTextureCache::shareTextures(const OccHandle<XCAFDoc_VisMaterial>& material)
+{
+    if (!material)
+        return;
+
+    auto fnShare = [=](OccHandle<Image_Texture>& texture) {
+        const OccHandle<Image_Texture> sharedTexture = this->share(texture);
+        const bool isSharedTexture = sharedTexture != texture;
+        texture = sharedTexture;
+        return isSharedTexture;
+    };
+
+    if (material->HasCommonMaterial()) {
+        XCAFDoc_VisMaterialCommon common = material->CommonMaterial();
+        if (fnShare(common.DiffuseTexture))
+            material->SetCommonMaterial(common);
+    }
+
+    if (material->HasPbrMaterial()) {
+        XCAFDoc_VisMaterialPBR pbr = material->PbrMaterial();
+        bool isPbrModified = false;
+        isPbrModified |= fnShare(pbr.BaseColorTexture);
+        isPbrModified |= fnShare(pbr.MetallicRoughnessTexture);
+        isPbrModified |= fnShare(pbr.EmissiveTexture);
+        isPbrModified |= fnShare(pbr.OcclusionTexture);
+        isPbrModified |= fnShare(pbr.NormalTexture);
+        if (isPbrModified)
+            material->SetPbrMaterial(pbr);
+    }
+}
+#endif
+
+void ImageTextureCache::purgeUnused()
+{
+    // A refcount of 1 means the texture is referenced by the cache only
+    auto fnIsUnused = [=](const TextureHandle& texture) {
+        if (texture->GetRefCount() > 1)
+            return false;
+
+        m_setCachedTexture.erase(texture.get());
+        return true;
+    };
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_mapHashDataTextures.begin(); it != m_mapHashDataTextures.end(); ) {
+        std::vector<TextureHandle>& vecTexture = it->second;
+        vecTexture.erase(std::remove_if(vecTexture.begin(), vecTexture.end(), fnIsUnused), vecTexture.end());
+        it = vecTexture.empty() ? m_mapHashDataTextures.erase(it) : std::next(it);
+    }
+
+    for (auto it = m_mapKeyFileTexture.begin(); it != m_mapKeyFileTexture.end(); ) {
+        it = fnIsUnused(it->second) ? m_mapKeyFileTexture.erase(it) : std::next(it);
+    }
+}
+
+int ImageTextureCache::count() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<int>(m_setCachedTexture.size());
+}
+
+uint64_t ImageTextureCache::dataSize() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint64_t size = 0;
+    for (const auto& [hash, vecTexture] : m_mapHashDataTextures) {
+        for (const TextureHandle& texture : vecTexture)
+            size += texture->DataBuffer()->Size();
+    }
+
+    return size;
+}
+
+std::string ImageTextureCache::fileKey(const FilePath& filepath, int64_t offset, int64_t length)
+{
+    // Last write time is part of the key so a texture file modified on disk gets reloaded
+    const FilePath canonicalFilepath = filepathCanonical(filepath);
+    const auto lastWriteTime = filepathLastWriteTime(canonicalFilepath).time_since_epoch().count();
+    return canonicalFilepath.u8string()
+            + '|' + std::to_string(offset)
+            + '|' + std::to_string(length)
+            + '|' + std::to_string(lastWriteTime);
+}
+
+std::string_view ImageTextureCache::dataView(const TextureHandle& texture)
+{
+    const OccHandle<NCollection_Buffer>& buffer = texture->DataBuffer();
+    return std::string_view(reinterpret_cast<const char*>(buffer->Data()), buffer->Size());
+}
+
+// Must be called with m_mutex locked
+ImageTextureCache::TextureHandle ImageTextureCache::insertData(const TextureHandle& texture, std::string_view data)
+{
+    std::vector<TextureHandle>& vecTexture = m_mapHashDataTextures[std::hash<std::string_view>{}(data)];
+    // Another thread may have inserted the same contents in the meantime
+    for (const TextureHandle& cachedTexture : vecTexture) {
+        if (dataView(cachedTexture) == data)
+            return cachedTexture;
+    }
+
+    vecTexture.push_back(texture);
+    m_setCachedTexture.insert(texture.get());
+    return texture;
+}
+
+// Must be called with m_mutex locked
+ImageTextureCache::TextureHandle ImageTextureCache::insertFile(const TextureHandle& texture, const std::string& key)
+{
+    m_mapKeyFileTexture.insert({ key, texture });
+    m_setCachedTexture.insert(texture.get());
+    return texture;
+}
+
+} // namespace Mayo
@@ -0,0 +1,82 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "filepath.h"
+#include "occ_handle.h"
+#include "span.h"
+
+#include <Image_Texture.hxx>
+#include <Standard_Version.hxx>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#if OCC_VERSION_HEX >= 0x070500
+class XCAFDoc_VisMaterial;
+#endif
+
+namespace Mayo {
+
+// Provides an application-wide cache of Image_Texture objects shared by mesh readers
+// In-memory textures are identified by a hash of their contents, file textures by their canonical
+// filepath(along with offset/length within the file and last write time). This way the same
+// texture loaded many times(eg texture atlas referenced by a batch of models) results in a single
+// Image_Texture object
+// Cached textures are reference-counted through OpenCascade handles, purgeUnused() releases the
+// ones which aren't referenced anymore outside of the cache
+// All functions are thread-safe
+class ImageTextureCache {
+public:
+    // Application-wide cache object
+    static ImageTextureCache& global();
+
+    // Returns texture holding a copy of 'data'
+    // If a texture with the same contents is already cached then it's returned and no copy is done
+    OccHandle<Image_Texture> findOrCreate(Span<const uint8_t> data, std::string_view textureId);
+
+    // Returns texture referring to image file 'filepath'
+    OccHandle<Image_Texture> findOrCreate(const FilePath& filepath);
+
+    // Returns the cached equivalent of 'texture'
+    // If no equivalent texture is found then 'texture' is added to the cache and returned
+    OccHandle<Image_Texture> share(const OccHandle<Image_Texture>& texture);
+
+#if OCC_VERSION_HEX >= 0x070500
+    // Replaces all the textures referenced by 'material' with their shared equivalents
+    void shareTextures(const OccHandle<XCAFDoc_VisMaterial>& material);
+#endif
+
+    // Releases textures not referenced anymore outside the cache
+    void purgeUnused();
+
+    // Count of textures currently cached
+    int count() const;
+
+    // Size in bytes of the in-memory texture data currently cached
+    uint64_t dataSize() const;
+
+private:
+    using TextureHandle = OccHandle<Image_Texture>;
+
+    static std::string fileKey(const FilePath& filepath, int64_t offset, int64_t length);
+    static std::string_view dataView(const TextureHandle& texture);
+    TextureHandle insertData(const TextureHandle& texture, std::string_view data);
+    TextureHandle insertFile(const TextureHandle& texture, const std::string& key);
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<size_t, std::vector<TextureHandle>> m_mapHashDataTextures;
+    std::unordered_map<std::string, TextureHandle> m_mapKeyFileTexture;
+    std::unordered_set<const Image_Texture*> m_setCachedTexture;
+};
+
+} // namespace Mayo
@@ -0,0 +1,359 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "mass_properties.h"
+
+#include "brep_utils.h"
+#include "cpp_utils.h"
+#include "document.h"
+#include "xcaf.h"
+
+#include <BRepGProp.hxx>
+#include <BRep_Tool.hxx>
+#include <GProp_GProps.hxx>
+#include <OSD_Parallel.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace Mayo {
+
+namespace {
+
+using Moments = MassProperties::Moments;
+
+gp_Mat outerProduct(const gp_XYZ& a, const gp_XYZ& b)
+{
+    return gp_Mat(
+                a.X() * b.X(), a.X() * b.Y(), a.X() * b.Z(),
+                a.Y() * b.X(), a.Y() * b.Y(), a.Y() * b.Z(),
+                a.Z() * b.X(), a.Z() * b.Y(), a.Z() * b.Z()
+    );
+}
+
+gp_Mat identityMatrix(double diagonal)
+{
+    return gp_Mat(diagonal, 0, 0, 0, diagonal, 0, 0, 0, diagonal);
+}
+
+double trace(const gp_Mat& mat)
+{
+    return mat.Value(1, 1) + mat.Value(2, 2) + mat.Value(3, 3);
+}
+
+// Converts properties computed by BRepGProp(with default location at origin)
+Moments toMoments(const GProp_GProps& gprops)
+{
+    Moments moments;
+    moments.measure = gprops.Mass();
+    const gp_XYZ centroid = gprops.CentreOfMass().XYZ();
+    moments.firstMoment = moments.measure * centroid;
+    // Inertia at origin I0 = Ic + m(|c|^2.E - c.cT), and second moment J = (tr(I0)/2).E - I0
+    const gp_Mat inertiaOrigin =
+            gprops.MatrixOfInertia()
+            + (identityMatrix(centroid.SquareModulus()) - outerProduct(centroid, centroid)) * moments.measure;
+    moments.secondMoment = identityMatrix(trace(inertiaOrigin) / 2.) - inertiaOrigin;
+    return moments;
+}
+
+// Moments of the tetrahedron(origin, p1, p2, p3), volume being signed
+Moments tetrahedronMoments(const gp_XYZ& p1, const gp_XYZ& p2, const gp_XYZ& p3)
+{
+    Moments moments;
+    moments.measure = p1.Dot(p2.Crossed(p3)) / 6.;
+    const gp_XYZ sum = p1 + p2 + p3;
+    moments.firstMoment = (moments.measure / 4.) * sum;
+    const gp_Mat matSum = outerProduct(p1, p1) + outerProduct(p2, p2) + outerProduct(p3, p3) + outerProduct(sum, sum);
+    moments.secondMoment = matSum * (moments.measure / 20.);
+    return moments;
+}
+
+Moments triangleMoments(const gp_XYZ& p1, const gp_XYZ& p2, const gp_XYZ& p3)
+{
+    Moments moments;
+    moments.measure = 0.5 * ((p2 - p1).Crossed(p3 - p1)).Modulus();
+    const gp_XYZ sum = p1 + p2 + p3;
+    moments.firstMoment = (moments.measure / 3.) * sum;
+    const gp_Mat matSum = outerProduct(p1, p1) + outerProduct(p2, p2) + outerProduct(p3, p3) + outerProduct(sum, sum);
+    moments.secondMoment = matSum * (moments.measure / 12.);
+    return moments;
+}
+
+// Computes volume and surface moments of a triangulation, in parallel over chunks of triangles
+void addTriangulationMoments(
+        const Handle(Poly_Triangulation)& triangulation,
+        const gp_Trsf& trsf,
+        bool reversed,
+        Moments* volumeMoments,
+        Moments* areaMoments)
+{
+    constexpr int chunkSize = 4096;
+    const int triangleCount = triangulation->NbTriangles();
+    const int chunkCount = (triangleCount + chunkSize - 1) / chunkSize;
+    std::vector<Moments> vecChunkVolumeMoments(chunkCount);
+    std::vector<Moments> vecChunkAreaMoments(chunkCount);
+    OSD_Parallel::For(0, chunkCount, [&](int iChunk) {
+        const int iFirst = 1 + iChunk * chunkSize;
+        const int iLast = std::min(triangleCount, iFirst + chunkSize - 1);
+        Moments& chunkVolumeMoments = vecChunkVolumeMoments.at(iChunk);
+        Moments& chunkAreaMoments = vecChunkAreaMoments.at(iChunk);
+        for (int i = iFirst; i <= iLast; ++i) {
+            int n1, n2, n3;
+            triangulation->Triangle(i).Get(n1, n2, n3);
+            if (reversed)
+                std::swap(n2, n3);
+
+            const gp_XYZ p1 = triangulation->Node(n1).Transformed(trsf).XYZ();
+            const gp_XYZ p2 = triangulation->Node(n2).Transformed(trsf).XYZ();
+            const gp_XYZ p3 = triangulation->Node(n3).Transformed(trsf).XYZ();
+            chunkVolumeMoments.add(tetrahedronMoments(p1, p2, p3));
+            chunkAreaMoments.add(triangleMoments(p1, p2, p3));
+        }
+    }, chunkCount < 2/*isForceSingleThreadExecution*/);
+
+    for (const Moments& moments : vecChunkVolumeMoments)
+        volumeMoments->add(moments);
+
+    for (const Moments& moments : vecChunkAreaMoments)
+        areaMoments->add(moments);
+}
+
+} // namespace
+
+void MassProperties::Moments::add(const Moments& other)
+{
+    this->measure += other.measure;
+    this->firstMoment += other.firstMoment;
+    this->secondMoment += other.secondMoment;
+}
+
+MassProperties::Moments MassProperties::Moments::transformed(const gp_Trsf& trsf) const
+{
+    // x' = R.x + t
+    // J' = R.J.RT + R.s1.tT + t.(R.s1)T + m.t.tT
+    const gp_Mat matR = trsf.VectorialPart();
+    const gp_XYZ t = trsf.TranslationPart();
+    const gp_XYZ rs1 = matR * this->firstMoment;
+    Moments moments;
+    moments.measure = this->measure;
+    moments.firstMoment = rs1 + this->measure * t;
+    moments.secondMoment =
+            matR * this->secondMoment * matR.Transposed()
+            + outerProduct(rs1, t)
+            + outerProduct(t, rs1)
+            + outerProduct(t, t) * this->measure;
+    return moments;
+}
+
+gp_Pnt MassProperties::Moments::centroid() const
+{
+    if (std::abs(this->measure) < 1e-20)
+        return gp_Pnt{};
+
+    return this->firstMoment / this->measure;
+}
+
+gp_Mat MassProperties::Moments::inertia() const
+{
+    // I0 = tr(J).E - J, then Ic = I0 - m(|c|^2.E - c.cT)
+    const gp_XYZ c = this->centroid().XYZ();
+    const gp_Mat inertiaOrigin = identityMatrix(trace(this->secondMoment)) - this->secondMoment;
+    return inertiaOrigin - (identityMatrix(c.SquareModulus()) - outerProduct(c, c)) * this->measure;
+}
+
+QuantityVolume MassProperties::volume() const
+{
+    return this->volumeMoments.measure * Quantity_CubicMillimeter;
+}
+
+QuantityArea MassProperties::area() const
+{
+    return this->areaMoments.measure * Quantity_SquareMillimeter;
+}
+
+gp_Pnt MassProperties::centroid() const
+{
+    return this->volumeMoments.measure > 0 ? this->volumeMoments.centroid() : this->areaMoments.centroid();
+}
+
+gp_Mat MassProperties::inertia() const
+{
+    return this->volumeMoments.measure > 0 ? this->volumeMoments.inertia() : this->areaMoments.inertia();
+}
+
+void MassProperties::add(const MassProperties& other)
+{
+    this->volumeMoments.add(other.volumeMoments);
+    this->areaMoments.add(other.areaMoments);
+    this->mass += other.mass;
+    this->hasMass = this->hasMass || other.hasMass;
+}
+
+MassProperties MassProperties::transformed(const gp_Trsf& trsf) const
+{
+    MassProperties props = *this;
+    props.volumeMoments = this->volumeMoments.transformed(trsf);
+    props.areaMoments = this->areaMoments.transformed(trsf);
+    return props;
+}
+
+MassProperties MassPropertiesEngine::compute(const TopoDS_Shape& shape, QuantityDensity density)
+{
+    // Collect faces, volume contribution is considered only for faces bounding a solid
+    // Each solid contributes with all its faces, so faces shared between solids contribute to the
+    // volume of each of them. Area contribution is considered once per face, faces being identified
+    // by their TShape and location(ie repeated instances of a solid are all counted)
+    struct FaceData {
+        TopoDS_Face face;
+        bool isSolidBoundary = false;
+        bool isAreaCounted = false;
+        Moments volumeMoments;
+        Moments areaMoments;
+    };
+    std::vector<FaceData> vecFaceData;
+    TopTools_IndexedMapOfShape mapAreaFace;
+    auto fnAddAreaFace = [&](const TopoDS_Face& face) {
+        const int faceCount = mapAreaFace.Extent();
+        return mapAreaFace.Add(face) > faceCount;
+    };
+    BRepUtils::forEachSubShape(shape, TopAbs_SOLID, [&](const TopoDS_Shape& solid) {
+        BRepUtils::forEachSubFace(solid, [&](const TopoDS_Face& face) {
+            vecFaceData.push_back({ face, true, fnAddAreaFace(face) });
+        });
+    });
+    BRepUtils::forEachSubFace(shape, [&](const TopoDS_Face& face) {
+        if (fnAddAreaFace(face))
+            vecFaceData.push_back({ face, false, true });
+    });
+
+    // Geometric faces are processed in parallel, mesh faces are parallelized over triangles
+    std::vector<int> vecMeshFaceIndex;
+    const int faceCount = CppUtils::safeStaticCast<int>(vecFaceData.size());
+    for (int i = 0; i < faceCount; ++i) {
+        if (!BRepUtils::isGeometric(vecFaceData.at(i).face))
+            vecMeshFaceIndex.push_back(i);
+    }
+
+    OSD_Parallel::For(0, faceCount, [&](int i) {
+        FaceData& faceData = vecFaceData.at(i);
+        if (!BRepUtils::isGeometric(faceData.face))
+            return;
+
+        if (faceData.isAreaCounted) {
+            GProp_GProps surfaceProps;
+            BRepGProp::SurfaceProperties(faceData.face, surfaceProps);
+            faceData.areaMoments = toMoments(surfaceProps);
+        }
+
+        if (faceData.isSolidBoundary) {
+            GProp_GProps volumeProps;
+            BRepGProp::VolumeProperties(faceData.face, volumeProps);
+            faceData.volumeMoments = toMoments(volumeProps);
+        }
+    });
+
+    // Mesh faces are assumed to bound a closed volume, see MeshUtils::triangulationVolume()
+    for (int i : vecMeshFaceIndex) {
+        FaceData& faceData = vecFaceData.at(i);
+        TopLoc_Location locFace;
+        const Handle(Poly_Triangulation)& triangulation = BRep_Tool::Triangulation(faceData.face, locFace);
+        if (!triangulation.IsNull()) {
+            const bool reversed = faceData.face.Orientation() == TopAbs_REVERSED;
+            Moments areaMoments;
+            addTriangulationMoments(
+                        triangulation, locFace.Transformation(), reversed,
+                        &faceData.volumeMoments, &areaMoments
+            );
+            if (faceData.isAreaCounted)
+                faceData.areaMoments = areaMoments;
+        }
+    }
+
+    MassProperties props;
+    for (const FaceData& faceData : vecFaceData) {
+        props.volumeMoments.add(faceData.volumeMoments);
+        props.areaMoments.add(faceData.areaMoments);
+    }
+
+    // Mesh having inward oriented triangles
+    if (!vecMeshFaceIndex.empty() && props.volumeMoments.measure < 0) {
+        Moments& moments = props.volumeMoments;
+        moments.measure = -moments.measure;
+        moments.firstMoment.Reverse();
+        moments.secondMoment = moments.secondMoment * -1.;
+    }
+
+    if (density.value() > 0) {
+        // Density is in kg/m^3 and volume in mm^3
+        props.mass = (density.value() * props.volumeMoments.measure * 1e-9) * Quantity_Kilogram;
+        props.hasMass = true;
+    }
+
+    return props;
+}
+
+MassProperties MassPropertiesEngine::get(const TDF_Label& label)
+{
+    const TopoDS_Shape shape = XCaf::shape(label);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_mapLabelEntry.find(label);
+        if (it != m_mapLabelEntry.cend()) {
+            if (it->second.shape.IsEqual(shape))
+                return it->second.props;
+
+            m_mapLabelEntry.erase(it); // Shape was changed
+        }
+    }
+
+    MassProperties props;
+    if (XCaf::isShapeReference(label)) {
+        const TopLoc_Location loc = XCaf::shapeReferenceLocation(label);
+        props = this->get(XCaf::shapeReferred(label)).transformed(loc.Transformation());
+    }
+    else if (XCaf::isShapeAssembly(label)) {
+        for (const TDF_Label& labelComponent : XCaf::shapeComponents(label))
+            props.add(this->get(labelComponent));
+    }
+    else {
+        props = MassPropertiesEngine::compute(shape, XCaf::shapeMaterialDensity(label));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mapLabelEntry.insert_or_assign(label, Entry{ shape, props });
+    return props;
+}
+
+void MassPropertiesEngine::erase(const DocumentPtr& doc)
+{
+    if (doc.IsNull())
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const TDF_Data* docData = doc->GetData().get();
+    for (auto it = m_mapLabelEntry.begin(); it != m_mapLabelEntry.end(); ) {
+        if (it->first.Data() == docData)
+            it = m_mapLabelEntry.erase(it);
+        else
+            ++it;
+    }
+}
+
+void MassPropertiesEngine::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mapLabelEntry.clear();
+}
+
+int MassPropertiesEngine::cacheSize() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return CppUtils::safeStaticCast<int>(m_mapLabelEntry.size());
+}
+
+} // namespace Mayo
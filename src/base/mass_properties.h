@@ -0,0 +1,87 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "caf_utils.h"
+#include "document_ptr.h"
+#include "quantity.h"
+
+#include <TDF_Label.hxx>
+#include <TopoDS_Shape.hxx>
+#include <gp_Mat.hxx>
+#include <gp_Pnt.hxx>
+#include <gp_Trsf.hxx>
+#include <gp_XYZ.hxx>
+
+#include <mutex>
+#include <unordered_map>
+
+namespace Mayo {
+
+// Mass properties of a shape, volume and surface integrals are computed with unit density
+struct MassProperties {
+    // Integrals of 1, x and x.xT over a domain(volume or surface) expressed with respect to the
+    // origin. Such representation is additive and can be transformed without loss of precision
+    struct Moments {
+        double measure = 0; // Volume or area
+        gp_XYZ firstMoment;
+        gp_Mat secondMoment = gp_Mat(0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+        void add(const Moments& other);
+        Moments transformed(const gp_Trsf& trsf) const;
+        gp_Pnt centroid() const;
+        gp_Mat inertia() const; // Matrix of inertia at centroid()
+    };
+
+    Moments volumeMoments;
+    Moments areaMoments;
+    QuantityMass mass = QuantityMass::null(); // From material densities, null if there is no material
+    bool hasMass = false; // Some material density was found
+
+    QuantityVolume volume() const;
+    QuantityArea area() const;
+
+    // Volume centroid, or surface centroid if there is no volume
+    gp_Pnt centroid() const;
+
+    // Matrix of inertia at centroid(), same fallback rule as centroid()
+    gp_Mat inertia() const;
+
+    void add(const MassProperties& other);
+    MassProperties transformed(const gp_Trsf& trsf) const;
+};
+
+// Provides computation of mass properties of BRep shapes and of XCAF shape labels
+// Computation is parallelized over the faces of a shape, and over the triangles of non-geometric
+// faces(ie mesh). Assembly properties are aggregated from the product properties, each instance
+// being placed with its location. Mass is computed from XCaf::shapeMaterialDensity() of products
+// Results are cached per label and recomputed only if the shape of the label was changed
+class MassPropertiesEngine {
+public:
+    // Mass properties of the shape stored in 'label', which can be an assembly, a component or a
+    // simple shape
+    MassProperties get(const TDF_Label& label);
+
+    // Mass properties of 'shape', not cached
+    static MassProperties compute(const TopoDS_Shape& shape, QuantityDensity density = QuantityDensity::null());
+
+    // Removes cached results of the labels belonging to 'doc'
+    void erase(const DocumentPtr& doc);
+    void clear();
+    int cacheSize() const;
+
+private:
+    struct Entry {
+        TopoDS_Shape shape;
+        MassProperties props;
+    };
+
+    std::unordered_map<TDF_Label, Entry> m_mapLabelEntry;
+    mutable std::mutex m_mutex;
+};
+
+} // namespace Mayo
@@ -0,0 +1,258 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "mesh_edge_engine.h"
+#include "mesh_utils.h"
+
+#include <BRep_Tool.hxx>
+#include <OSD_Parallel.hxx>
+#include <Poly_PolygonOnTriangulation.hxx>
+#include <Poly_Triangulation.hxx>
+#include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopoDS.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Mayo {
+
+namespace {
+
+struct EdgeTriangles {
+    int count = 0;
+    int triangles[2] = {};
+};
+
+// Key of the triangulation edge between nodes 'n1' and 'n2', whatever their order
+uint64_t edgeKey(int n1, int n2)
+{
+    const auto [nMin, nMax] = std::minmax(n1, n2);
+    return (uint64_t(nMin) << 32) | uint64_t(nMax);
+}
+
+// Keys of the triangulation edges lying on the seam and degenerated edges of 'face'
+// Triangles along a seam aren't connected to the ones on the other side(nodes are duplicated in
+// the parametric space of the face), so these edges would be wrongly reported as boundaries
+std::unordered_set<uint64_t> seamEdgeKeys(
+        const TopoDS_Face& face, const Handle(Poly_Triangulation)& mesh, const TopLoc_Location& locFace)
+{
+    std::unordered_set<uint64_t> setKey;
+    auto fnAddPolygon = [&](const TopoDS_Edge& edge) {
+        const Handle(Poly_PolygonOnTriangulation) polygon = BRep_Tool::PolygonOnTriangulation(edge, mesh, locFace);
+        if (polygon.IsNull())
+            return;
+
+        const TColStd_Array1OfInteger& nodes = polygon->Nodes();
+        for (int i = nodes.Lower(); i < nodes.Upper(); ++i)
+            setKey.insert(edgeKey(nodes.Value(i), nodes.Value(i + 1)));
+    };
+
+    for (TopExp_Explorer expl(face, TopAbs_EDGE); expl.More(); expl.Next()) {
+        const TopoDS_Edge& edge = TopoDS::Edge(expl.Current());
+        if (BRep_Tool::Degenerated(edge)) {
+            fnAddPolygon(edge);
+        }
+        else if (BRep_Tool::IsClosed(edge, face)) {
+            // Seam edge has a polygon for each of its orientations
+            fnAddPolygon(edge);
+            fnAddPolygon(TopoDS::Edge(edge.Reversed()));
+        }
+    }
+
+    return setKey;
+}
+
+// Appends to 'edges' the boundary and sharp segments of 'face' triangulation
+void addFaceEdges(const TopoDS_Face& face, double cosSharpAngle, MeshEdgeEngine::Edges* edges)
+{
+    TopLoc_Location locFace;
+    const Handle(Poly_Triangulation)& mesh = BRep_Tool::Triangulation(face, locFace);
+    if (mesh.IsNull())
+        return;
+
+    const gp_Trsf& trsfFace = locFace.Transformation();
+    std::vector<gp_XYZ> vecNode;
+    vecNode.reserve(mesh->NbNodes());
+    for (int i = 1; i <= mesh->NbNodes(); ++i)
+        vecNode.push_back(mesh->Node(i).Transformed(trsfFace).XYZ());
+
+    // Map each triangle edge(key made of its ordered node indices) to its adjacent triangles
+    const Span<const Poly_Triangle> spanTriangle = MeshUtils::contiguousTriangles(mesh);
+    std::unordered_map<uint64_t, EdgeTriangles> mapEdge;
+    mapEdge.reserve(3 * spanTriangle.size() / 2 + 1);
+    for (int iTri = 0; iTri < int(spanTriangle.size()); ++iTri) {
+        int n[3];
+        spanTriangle[iTri].Get(n[0], n[1], n[2]);
+        for (int j = 0; j < 3; ++j) {
+            EdgeTriangles& edge = mapEdge[edgeKey(n[j], n[(j + 1) % 3])];
+            if (edge.count < 2)
+                edge.triangles[edge.count] = iTri;
+
+            ++edge.count;
+        }
+    }
+
+    auto fnTriangleNormal = [&](int iTri) {
+        int n1, n2, n3;
+        spanTriangle[iTri].Get(n1, n2, n3);
+        const gp_XYZ& p1 = vecNode.at(n1 - 1);
+        return (vecNode.at(n2 - 1) - p1).Crossed(vecNode.at(n3 - 1) - p1);
+    };
+
+    const std::unordered_set<uint64_t> setSeamEdgeKey = seamEdgeKeys(face, mesh, locFace);
+    for (const auto& [key, edge] : mapEdge) {
+        std::vector<gp_XYZ>* vecEdgeNode = nullptr;
+        if (edge.count != 2) {
+            if (setSeamEdgeKey.find(key) == setSeamEdgeKey.cend())
+                vecEdgeNode = &edges->vecBoundaryNode;
+        }
+        else {
+            const gp_XYZ n1 = fnTriangleNormal(edge.triangles[0]);
+            const gp_XYZ n2 = fnTriangleNormal(edge.triangles[1]);
+            const double lengthProduct = n1.Modulus() * n2.Modulus();
+            if (lengthProduct > 0. && n1.Dot(n2) < cosSharpAngle * lengthProduct)
+                vecEdgeNode = &edges->vecSharpNode;
+        }
+
+        if (vecEdgeNode) {
+            vecEdgeNode->push_back(vecNode.at(int(key >> 32) - 1));
+            vecEdgeNode->push_back(vecNode.at(int(key & 0xFFFFFFFF) - 1));
+        }
+    }
+}
+
+// Removes the duplicated segments of 'vecNode'(two nodes per segment), whatever the order of their
+// nodes. Typically the boundary of a face is also the boundary of its neighbour faces
+void removeDuplicatedSegments(std::vector<gp_XYZ>* vecNode)
+{
+    auto fnLess = [](const gp_XYZ& lhs, const gp_XYZ& rhs) {
+        return std::make_tuple(lhs.X(), lhs.Y(), lhs.Z()) < std::make_tuple(rhs.X(), rhs.Y(), rhs.Z());
+    };
+    using Segment = std::pair<gp_XYZ, gp_XYZ>;
+    std::vector<Segment> vecSegment;
+    vecSegment.reserve(vecNode->size() / 2);
+    for (size_t i = 0; i + 1 < vecNode->size(); i += 2) {
+        const gp_XYZ& p1 = vecNode->at(i);
+        const gp_XYZ& p2 = vecNode->at(i + 1);
+        vecSegment.push_back(fnLess(p2, p1) ? Segment{ p2, p1 } : Segment{ p1, p2 });
+    }
+
+    auto fnSegmentLess = [=](const Segment& lhs, const Segment& rhs) {
+        if (fnLess(lhs.first, rhs.first))
+            return true;
+
+        return !fnLess(rhs.first, lhs.first) && fnLess(lhs.second, rhs.second);
+    };
+    auto fnSegmentEqual = [](const Segment& lhs, const Segment& rhs) {
+        return lhs.first.IsEqual(rhs.first, 0.) && lhs.second.IsEqual(rhs.second, 0.);
+    };
+    std::sort(vecSegment.begin(), vecSegment.end(), fnSegmentLess);
+    vecSegment.erase(std::unique(vecSegment.begin(), vecSegment.end(), fnSegmentEqual), vecSegment.end());
+
+    vecNode->clear();
+    for (const Segment& segment : vecSegment) {
+        vecNode->push_back(segment.first);
+        vecNode->push_back(segment.second);
+    }
+}
+
+} // namespace
+
+MeshEdgeEngine& MeshEdgeEngine::instance()
+{
+    static MeshEdgeEngine engine;
+    return engine;
+}
+
+std::shared_ptr<const MeshEdgeEngine::Edges> MeshEdgeEngine::edges(const TopoDS_Shape& shape)
+{
+    if (shape.IsNull())
+        return {};
+
+    const std::optional<std::shared_ptr<const Edges>> cachedEdges = m_cache.find(shape);
+    if (cachedEdges)
+        return *cachedEdges;
+
+    // Computation is done without locking, so other shapes can be processed concurrently
+    const double sharpAngle = this->sharpAngle();
+    auto edges = std::make_shared<const Edges>(MeshEdgeEngine::computeEdges(shape, sharpAngle));
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (sharpAngle != m_sharpAngle) // Sharp angle changed meanwhile, don't cache obsolete edges
+        return edges;
+
+    return m_cache.insertIfAbsent(shape, std::move(edges));
+}
+
+void MeshEdgeEngine::invalidate(const TopoDS_Shape& shape)
+{
+    m_cache.erase(shape);
+}
+
+double MeshEdgeEngine::sharpAngle() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_sharpAngle;
+}
+
+void MeshEdgeEngine::setSharpAngle(double angle)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (angle != m_sharpAngle) {
+        m_sharpAngle = angle;
+        m_cache.clear();
+    }
+}
+
+MeshEdgeEngine::Edges MeshEdgeEngine::computeEdges(const TopoDS_Shape& shape, double sharpAngle)
+{
+    Edges edges;
+    if (shape.IsNull())
+        return edges;
+
+    // Faces are processed in parallel
+    TopTools_IndexedMapOfShape mapFace;
+    TopExp::MapShapes(shape.Located(TopLoc_Location()), TopAbs_FACE, mapFace);
+    const double cosSharpAngle = std::cos(sharpAngle);
+    std::vector<Edges> vecFaceEdges(mapFace.Extent());
+    OSD_Parallel::For(0, mapFace.Extent(), [&](int i) {
+        addFaceEdges(TopoDS::Face(mapFace.FindKey(i + 1)), cosSharpAngle, &vecFaceEdges.at(i));
+    }, mapFace.Extent() < 2/*isForceSingleThreadExecution*/);
+
+    for (const Edges& faceEdges : vecFaceEdges) {
+        edges.vecBoundaryNode.insert(
+                    edges.vecBoundaryNode.end(), faceEdges.vecBoundaryNode.cbegin(), faceEdges.vecBoundaryNode.cend()
+        );
+        edges.vecSharpNode.insert(
+                    edges.vecSharpNode.end(), faceEdges.vecSharpNode.cbegin(), faceEdges.vecSharpNode.cend()
+        );
+    }
+
+    removeDuplicatedSegments(&edges.vecBoundaryNode);
+    return edges;
+}
+
+void MeshEdgeEngine::purge()
+{
+    m_cache.purge();
+}
+
+void MeshEdgeEngine::clear()
+{
+    m_cache.clear();
+}
+
+int MeshEdgeEngine::cacheSize() const
+{
+    return m_cache.size();
+}
+
+} // namespace Mayo
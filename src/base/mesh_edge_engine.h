@@ -0,0 +1,65 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "tshape_cache.h"
+
+#include <TopoDS_Shape.hxx>
+#include <gp_XYZ.hxx>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Mayo {
+
+// Provides the edges of BRep shapes derived from the triangulations of their faces
+// Boundary edges are the free edges of face triangulations(ie face boundaries), sharp edges are the
+// inner edges whose adjacent triangles form an angle greater than the sharp angle
+// Edges are computed once(faces in parallel) and cached per TShape, so instances of the same
+// product(eg components of an assembly) share them. Entries of shapes no longer referenced outside
+// the cache are purged from time to time
+class MeshEdgeEngine {
+public:
+    // Segments expressed in the coordinate system of the TShape(ie the location of the shape isn't
+    // applied), two nodes per segment
+    struct Edges {
+        std::vector<gp_XYZ> vecBoundaryNode;
+        std::vector<gp_XYZ> vecSharpNode;
+    };
+
+    // Global engine, shared by application and gui modules
+    static MeshEdgeEngine& instance();
+
+    // Edges of 'shape', computed if not yet cached. Faces without triangulation are skipped
+    // Returns null if 'shape' is null
+    std::shared_ptr<const Edges> edges(const TopoDS_Shape& shape);
+
+    // Removes the cached edges of 'shape', typically needed when its triangulations were replaced
+    void invalidate(const TopoDS_Shape& shape);
+
+    // Minimum angle(radians) between adjacent triangles of a sharp edge. Changing the angle clears
+    // the cache
+    static constexpr double DefaultSharpAngle = 0.5235987755982988; // 30 degrees
+    double sharpAngle() const;
+    void setSharpAngle(double angle);
+
+    // Computes the edges of 'shape' without using the cache
+    static Edges computeEdges(const TopoDS_Shape& shape, double sharpAngle);
+
+    // Removes entries of shapes only referenced by the cache
+    void purge();
+    void clear();
+    int cacheSize() const;
+
+private:
+    TShapeCache<std::shared_ptr<const Edges>> m_cache;
+    double m_sharpAngle = DefaultSharpAngle;
+    mutable std::mutex m_mutex; // Guards m_sharpAngle, locked before any lock of m_cache
+};
+
+} // namespace Mayo
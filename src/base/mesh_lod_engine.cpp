@@ -0,0 +1,67 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "mesh_lod_engine.h"
+
+#include <BRep_Tool.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+
+namespace Mayo {
+
+MeshLodEngine& MeshLodEngine::instance()
+{
+    static MeshLodEngine engine;
+    return engine;
+}
+
+std::vector<TopoDS_Shape> MeshLodEngine::levels(const TopoDS_Shape& shape) const
+{
+    return m_cache.find(shape).value_or(std::vector<TopoDS_Shape>{});
+}
+
+void MeshLodEngine::setLevels(const TopoDS_Shape& shape, std::vector<TopoDS_Shape> vecLevel)
+{
+    if (vecLevel.empty())
+        m_cache.erase(shape);
+    else
+        m_cache.insert(shape, std::move(vecLevel));
+}
+
+bool MeshLodEngine::hasLevels(const TopoDS_Shape& shape) const
+{
+    return m_cache.find(shape).has_value();
+}
+
+int MeshLodEngine::triangleCount(const TopoDS_Shape& shape)
+{
+    int count = 0;
+    for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+        TopLoc_Location locFace;
+        const auto& triangulation = BRep_Tool::Triangulation(TopoDS::Face(expl.Current()), locFace);
+        if (!triangulation.IsNull())
+            count += triangulation->NbTriangles();
+    }
+
+    return count;
+}
+
+void MeshLodEngine::purge()
+{
+    m_cache.purge();
+}
+
+void MeshLodEngine::clear()
+{
+    m_cache.clear();
+}
+
+int MeshLodEngine::cacheSize() const
+{
+    return m_cache.size();
+}
+
+} // namespace Mayo
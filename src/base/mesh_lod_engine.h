@@ -0,0 +1,48 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "tshape_cache.h"
+
+#include <TopoDS_Shape.hxx>
+
+#include <vector>
+
+namespace Mayo {
+
+// Provides storage of the levels of detail(LOD) of BRep shapes
+// A level is a copy of the shape(see BRepBuilderAPI_Copy) sharing its geometry but meshed with a
+// coarser deflection, so it has its own triangulations. The shape itself is the finest level and
+// isn't stored
+// Levels are cached per TShape, so instances of the same product(eg components of an assembly)
+// share their levels. Entries of shapes no longer referenced outside the cache are purged from time
+// to time
+class MeshLodEngine {
+public:
+    // Global engine, shared by application and gui modules
+    static MeshLodEngine& instance();
+
+    // Levels of 'shape', ordered from the finest to the coarsest
+    // Faces of the levels must be in the same order as the faces of 'shape', so triangulations can
+    // be mapped by exploring the shapes in lockstep
+    std::vector<TopoDS_Shape> levels(const TopoDS_Shape& shape) const;
+    void setLevels(const TopoDS_Shape& shape, std::vector<TopoDS_Shape> vecLevel);
+    bool hasLevels(const TopoDS_Shape& shape) const;
+
+    // Sum of the triangle counts of 'shape' faces
+    static int triangleCount(const TopoDS_Shape& shape);
+
+    // Removes entries of shapes only referenced by the cache
+    void purge();
+    void clear();
+    int cacheSize() const;
+
+private:
+    TShapeCache<std::vector<TopoDS_Shape>> m_cache;
+};
+
+} // namespace Mayo
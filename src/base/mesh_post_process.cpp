@@ -0,0 +1,406 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "mesh_post_process.h"
+
+#include "brep_utils.h"
+#include "mesh_utils.h"
+#include "task_progress.h"
+#include "triangulation_annex_data.h"
+#include "xcaf.h"
+
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <OSD_Parallel.hxx>
+#include <Precision.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <tuple>
+
+namespace Mayo {
+
+namespace {
+
+struct GridCell {
+    int64_t x;
+    int64_t y;
+    int64_t z;
+
+    bool operator<(const GridCell& other) const {
+        return std::tie(x, y, z) < std::tie(other.x, other.y, other.z);
+    }
+};
+
+struct GridCellNode {
+    GridCell cell;
+    int node; // 0-based
+};
+
+GridCell gridCell(const gp_XYZ& pnt, double cellSize)
+{
+    return {
+        int64_t(std::floor(pnt.X() / cellSize)),
+        int64_t(std::floor(pnt.Y() / cellSize)),
+        int64_t(std::floor(pnt.Z() / cellSize))
+    };
+}
+
+// Creates a mesh whose nodes are copied from 'source' as specified by 'vecSourceNode'(1-based indices)
+OccHandle<Poly_Triangulation> createMesh(
+        const OccHandle<Poly_Triangulation>& source,
+        const std::vector<int>& vecSourceNode,
+        const std::vector<Poly_Triangle>& vecTriangle)
+{
+    const int nodeCount = int(vecSourceNode.size());
+    const int triangleCount = int(vecTriangle.size());
+    const bool hasUvNodes = source->HasUVNodes();
+    OccHandle<Poly_Triangulation> mesh = new Poly_Triangulation(nodeCount, triangleCount, hasUvNodes);
+    OSD_Parallel::For(0, nodeCount, [&](int i) {
+        const int iSource = vecSourceNode.at(i);
+        MeshUtils::setNode(mesh, i + 1, source->Node(iSource));
+        if (hasUvNodes) {
+            const gp_Pnt2d uv = source->UVNode(iSource);
+            MeshUtils::setUvNode(mesh, i + 1, uv.X(), uv.Y());
+        }
+    }, nodeCount < 1024/*isForceSingleThreadExecution*/);
+
+    for (int i = 0; i < triangleCount; ++i)
+        MeshUtils::setTriangle(mesh, i + 1, vecTriangle.at(i));
+
+    mesh->Deflection(source->Deflection());
+    return mesh;
+}
+
+std::vector<TopoDS_Face> meshFaces(const TopoDS_Shape& shape)
+{
+    std::vector<TopoDS_Face> vecFace;
+    TopTools_IndexedMapOfShape mapFace;
+    TopExp::MapShapes(shape, TopAbs_FACE, mapFace);
+    for (int i = 1; i <= mapFace.Extent(); ++i) {
+        const TopoDS_Face& face = TopoDS::Face(mapFace.FindKey(i));
+        TopLoc_Location locFace;
+        if (!BRepUtils::isGeometric(face) && !BRep_Tool::Triangulation(face, locFace).IsNull())
+            vecFace.push_back(face);
+    }
+
+    return vecFace;
+}
+
+} // namespace
+
+MeshPostProcess::Result MeshPostProcess::weldNodes(const OccHandle<Poly_Triangulation>& mesh, double tolerance)
+{
+    Result result;
+    if (mesh.IsNull() || mesh->NbNodes() == 0)
+        return result;
+
+    const int nodeCount = mesh->NbNodes();
+    std::vector<gp_XYZ> vecNodeCopy;
+    const Span<const gp_XYZ> spanNode = MeshUtils::contiguousNodes(mesh, &vecNodeCopy);
+    const double cellSize = std::max(tolerance, Precision::Confusion());
+    const double sqTolerance = tolerance > 0 ? tolerance * tolerance : 0.;
+    const bool isSingleThread = nodeCount < 1024;
+
+    // Bucket nodes in grid cells, sorting gives contiguous ranges of nodes per cell
+    std::vector<GridCellNode> vecCellNode(nodeCount);
+    OSD_Parallel::For(0, nodeCount, [&](int i) {
+        vecCellNode.at(i) = { gridCell(spanNode[i], cellSize), i };
+    }, isSingleThread);
+    std::sort(vecCellNode.begin(), vecCellNode.end(), [](const GridCellNode& lhs, const GridCellNode& rhs) {
+        return lhs.cell < rhs.cell || (!(rhs.cell < lhs.cell) && lhs.node < rhs.node);
+    });
+
+    // Representative of each node is the node of smallest index within tolerance, so it's always
+    // lower or equal to the node index
+    std::vector<int> vecRepresentative(nodeCount);
+    OSD_Parallel::For(0, nodeCount, [&](int i) {
+        const gp_XYZ& pnt = spanNode[i];
+        const GridCell cell = gridCell(pnt, cellSize);
+        int representative = i;
+        for (int64_t dx = -1; dx <= 1; ++dx) {
+            for (int64_t dy = -1; dy <= 1; ++dy) {
+                for (int64_t dz = -1; dz <= 1; ++dz) {
+                    const GridCellNode key{ { cell.x + dx, cell.y + dy, cell.z + dz }, 0 };
+                    auto itCandidate = std::lower_bound(
+                                vecCellNode.cbegin(), vecCellNode.cend(), key,
+                                [](const GridCellNode& lhs, const GridCellNode& rhs) { return lhs.cell < rhs.cell; }
+                    );
+                    // Nodes are sorted by index within a cell
+                    for (; itCandidate != vecCellNode.cend(); ++itCandidate) {
+                        if (key.cell < itCandidate->cell || itCandidate->node >= representative)
+                            break;
+
+                        if ((spanNode[itCandidate->node] - pnt).SquareModulus() <= sqTolerance)
+                            representative = itCandidate->node;
+                    }
+                }
+            }
+        }
+
+        vecRepresentative.at(i) = representative;
+    }, isSingleThread);
+
+    // Compact nodes, a node is merged into the final node of its representative
+    std::vector<int> vecNewNode(nodeCount);
+    for (int i = 0; i < nodeCount; ++i) {
+        const int representative = vecRepresentative.at(i);
+        if (representative == i) {
+            result.vecSourceNode.push_back(i + 1);
+            vecNewNode.at(i) = int(result.vecSourceNode.size());
+        }
+        else {
+            vecNewNode.at(i) = vecNewNode.at(representative);
+        }
+    }
+
+    // Remap triangles and remove the degenerated ones
+    const Span<const Poly_Triangle> spanTriangle = MeshUtils::contiguousTriangles(mesh);
+    std::vector<Poly_Triangle> vecTriangle(spanTriangle.size());
+    OSD_Parallel::For(0, int(spanTriangle.size()), [&](int i) {
+        int n1, n2, n3;
+        spanTriangle[i].Get(n1, n2, n3);
+        vecTriangle.at(i).Set(vecNewNode.at(n1 - 1), vecNewNode.at(n2 - 1), vecNewNode.at(n3 - 1));
+    }, spanTriangle.size() < 1024/*isForceSingleThreadExecution*/);
+
+    auto itTriangleEnd = std::remove_if(vecTriangle.begin(), vecTriangle.end(), [](const Poly_Triangle& tri) {
+        int n1, n2, n3;
+        tri.Get(n1, n2, n3);
+        return n1 == n2 || n2 == n3 || n3 == n1;
+    });
+    result.removedTriangleCount = int(std::distance(itTriangleEnd, vecTriangle.end()));
+    vecTriangle.erase(itTriangleEnd, vecTriangle.end());
+
+    result.mesh = createMesh(mesh, result.vecSourceNode, vecTriangle);
+    return result;
+}
+
+MeshPostProcess::Result MeshPostProcess::computeSmoothNormals(
+        const OccHandle<Poly_Triangulation>& mesh, double creaseAngle)
+{
+    Result result;
+    if (mesh.IsNull() || mesh->NbNodes() == 0)
+        return result;
+
+    const int nodeCount = mesh->NbNodes();
+    std::vector<gp_XYZ> vecNodeCopy;
+    const Span<const gp_XYZ> spanNode = MeshUtils::contiguousNodes(mesh, &vecNodeCopy);
+    const Span<const Poly_Triangle> spanTriangle = MeshUtils::contiguousTriangles(mesh);
+    const int triangleCount = int(spanTriangle.size());
+    const int cornerCount = 3 * triangleCount;
+
+    // Unit normal of each triangle, null vector for degenerated triangles
+    std::vector<gp_XYZ> vecTriangleNormal(triangleCount);
+    MeshUtils::batchTriangleNormals({ spanNode, spanTriangle }, vecTriangleNormal);
+    OSD_Parallel::For(0, triangleCount, [&](int i) {
+        gp_XYZ& normal = vecTriangleNormal.at(i);
+        const double length = normal.Modulus();
+        normal = length > 0 ? normal / length : gp_XYZ();
+    }, triangleCount < 1024/*isForceSingleThreadExecution*/);
+
+    // Angle of each triangle corner(weight of the triangle normal)
+    std::vector<double> vecCornerAngle(cornerCount);
+    OSD_Parallel::For(0, triangleCount, [&](int i) {
+        int n[3];
+        spanTriangle[i].Get(n[0], n[1], n[2]);
+        for (int k = 0; k < 3; ++k) {
+            const gp_XYZ& pnt = spanNode[n[k] - 1];
+            const gp_XYZ vec1 = spanNode[n[(k + 1) % 3] - 1] - pnt;
+            const gp_XYZ vec2 = spanNode[n[(k + 2) % 3] - 1] - pnt;
+            vecCornerAngle.at(3 * i + k) = std::atan2(vec1.Crossed(vec2).Modulus(), vec1.Dot(vec2));
+        }
+    }, triangleCount < 1024/*isForceSingleThreadExecution*/);
+
+    // Corners adjacent to each node(compressed storage)
+    std::vector<int> vecNodeCornerStart(nodeCount + 1, 0);
+    for (const Poly_Triangle& tri : spanTriangle) {
+        for (int k = 1; k <= 3; ++k)
+            ++vecNodeCornerStart.at(tri.Value(k));
+    }
+
+    for (int i = 0; i < nodeCount; ++i)
+        vecNodeCornerStart.at(i + 1) += vecNodeCornerStart.at(i);
+
+    std::vector<int> vecNodeCorner(cornerCount);
+    {
+        std::vector<int> vecNodeCornerPos(vecNodeCornerStart.cbegin(), vecNodeCornerStart.cend() - 1);
+        for (int i = 0; i < triangleCount; ++i) {
+            for (int k = 0; k < 3; ++k)
+                vecNodeCorner.at(vecNodeCornerPos.at(spanTriangle[i].Value(k + 1) - 1)++) = 3 * i + k;
+        }
+    }
+
+    // For each corner compute the normal from the adjacent triangles not separated by a crease
+    // Corners of a node with the same normal share the same node variant
+    const double cosCrease = std::cos(creaseAngle);
+    std::vector<gp_XYZ> vecCornerNormal(cornerCount);
+    std::vector<int> vecCornerVariant(cornerCount);
+    std::vector<int> vecNodeVariantCount(nodeCount);
+    OSD_Parallel::For(0, nodeCount, [&](int iNode) {
+        const int cornerStart = vecNodeCornerStart.at(iNode);
+        const int cornerEnd = vecNodeCornerStart.at(iNode + 1);
+        std::vector<int> vecVariantCorner;
+        for (int i = cornerStart; i < cornerEnd; ++i) {
+            const int corner = vecNodeCorner.at(i);
+            const gp_XYZ& triNormal = vecTriangleNormal.at(corner / 3);
+            const bool isDegenerated = triNormal.SquareModulus() == 0;
+            gp_XYZ normal;
+            for (int j = cornerStart; j < cornerEnd; ++j) {
+                const int otherCorner = vecNodeCorner.at(j);
+                const gp_XYZ& otherTriNormal = vecTriangleNormal.at(otherCorner / 3);
+                if (isDegenerated || triNormal.Dot(otherTriNormal) >= cosCrease)
+                    normal += vecCornerAngle.at(otherCorner) * otherTriNormal;
+            }
+
+            const double length = normal.Modulus();
+            normal = length > 0 ? normal / length : triNormal;
+            vecCornerNormal.at(corner) = normal;
+            auto itVariant = std::find_if(vecVariantCorner.cbegin(), vecVariantCorner.cend(), [&](int c) {
+                return (vecCornerNormal.at(c) - normal).SquareModulus() < 1e-12;
+            });
+            vecCornerVariant.at(corner) = int(std::distance(vecVariantCorner.cbegin(), itVariant));
+            if (itVariant == vecVariantCorner.cend())
+                vecVariantCorner.push_back(corner);
+        }
+
+        vecNodeVariantCount.at(iNode) = int(vecVariantCorner.size());
+    }, nodeCount < 1024/*isForceSingleThreadExecution*/);
+
+    // First new node(0-based) of each source node
+    std::vector<int> vecNodeFirstVariant(nodeCount);
+    int newNodeCount = 0;
+    for (int i = 0; i < nodeCount; ++i) {
+        vecNodeFirstVariant.at(i) = newNodeCount;
+        newNodeCount += vecNodeVariantCount.at(i);
+    }
+
+    result.vecSourceNode.resize(newNodeCount);
+    std::vector<gp_XYZ> vecNewNodeNormal(newNodeCount);
+    OSD_Parallel::For(0, nodeCount, [&](int iNode) {
+        for (int i = vecNodeCornerStart.at(iNode); i < vecNodeCornerStart.at(iNode + 1); ++i) {
+            const int corner = vecNodeCorner.at(i);
+            const int iNewNode = vecNodeFirstVariant.at(iNode) + vecCornerVariant.at(corner);
+            result.vecSourceNode.at(iNewNode) = iNode + 1;
+            vecNewNodeNormal.at(iNewNode) = vecCornerNormal.at(corner);
+        }
+    }, nodeCount < 1024/*isForceSingleThreadExecution*/);
+
+    std::vector<Poly_Triangle> vecTriangle(triangleCount);
+    OSD_Parallel::For(0, triangleCount, [&](int i) {
+        int n[3];
+        spanTriangle[i].Get(n[0], n[1], n[2]);
+        for (int k = 0; k < 3; ++k)
+            n[k] = vecNodeFirstVariant.at(n[k] - 1) + vecCornerVariant.at(3 * i + k) + 1;
+
+        vecTriangle.at(i).Set(n[0], n[1], n[2]);
+    }, triangleCount < 1024/*isForceSingleThreadExecution*/);
+
+    result.mesh = createMesh(mesh, result.vecSourceNode, vecTriangle);
+    MeshUtils::allocateNormals(result.mesh);
+    OSD_Parallel::For(0, newNodeCount, [&](int i) {
+        const gp_XYZ& normal = vecNewNodeNormal.at(i);
+        const MeshUtils::Poly_Triangulation_NormalType n(
+                    float(normal.X()), float(normal.Y()), float(normal.Z())
+        );
+        MeshUtils::setNormal(result.mesh, i + 1, n);
+    }, newNodeCount < 1024/*isForceSingleThreadExecution*/);
+
+    return result;
+}
+
+MeshPostProcess::Result MeshPostProcess::run(const OccHandle<Poly_Triangulation>& mesh, const Parameters& params)
+{
+    Result result;
+    result.mesh = mesh;
+    if (!mesh.IsNull()) {
+        result.vecSourceNode.resize(mesh->NbNodes());
+        for (int i = 0; i < mesh->NbNodes(); ++i)
+            result.vecSourceNode.at(i) = i + 1;
+    }
+
+    if (params.weldNodes)
+        result = MeshPostProcess::weldNodes(result.mesh, params.weldTolerance);
+
+    if (params.computeNormals) {
+        Result resultNormals = MeshPostProcess::computeSmoothNormals(result.mesh, params.creaseAngle);
+        for (int& iSourceNode : resultNormals.vecSourceNode)
+            iSourceNode = result.vecSourceNode.at(iSourceNode - 1);
+
+        resultNormals.removedTriangleCount = result.removedTriangleCount;
+        result = std::move(resultNormals);
+    }
+
+    return result;
+}
+
+std::function<void()> MeshPostProcess::prepare(
+        const TDF_Label& label, const Parameters& params, TaskProgress* progress)
+{
+    if (!params.weldNodes && !params.computeNormals)
+        return {};
+
+    const std::vector<TopoDS_Face> vecFace = meshFaces(XCaf::shape(label));
+    if (vecFace.empty())
+        return {};
+
+    std::vector<Result> vecResult;
+    for (const TopoDS_Face& face : vecFace) {
+        if (TaskProgress::isAbortRequested(progress))
+            return {};
+
+        TopLoc_Location locFace;
+        vecResult.push_back(MeshPostProcess::run(BRep_Tool::Triangulation(face, locFace), params));
+        if (progress)
+            progress->setValue(int(100 * vecResult.size() / vecFace.size()));
+    }
+
+    // Node colors are defined for a single triangulation, see IMeshAccess
+    std::vector<Quantity_Color> vecNodeColor;
+    TriangulationAnnexDataPtr annexData;
+    if (vecFace.size() == 1 && label.FindAttribute(TriangulationAnnexData::GetID(), annexData)) {
+        const Span<const Quantity_Color> spanNodeColor = annexData->nodeColors();
+        const Result& result = vecResult.front();
+        TopLoc_Location locFace;
+        if (!result.mesh.IsNull()
+                && !spanNodeColor.empty()
+                && int(spanNodeColor.size()) == BRep_Tool::Triangulation(vecFace.front(), locFace)->NbNodes())
+        {
+            vecNodeColor.reserve(result.vecSourceNode.size());
+            for (int iSourceNode : result.vecSourceNode)
+                vecNodeColor.push_back(spanNodeColor[iSourceNode - 1]);
+        }
+    }
+
+    return [=]{
+        BRep_Builder builder;
+        for (size_t i = 0; i < vecFace.size(); ++i) {
+            if (!vecResult.at(i).mesh.IsNull())
+                builder.UpdateFace(vecFace.at(i), vecResult.at(i).mesh);
+        }
+
+        if (!vecNodeColor.empty())
+            TriangulationAnnexData::Set(label, Span<const Quantity_Color>(vecNodeColor));
+    };
+}
+
+bool MeshPostProcess::apply(const TDF_Label& label, const Parameters& params, TaskProgress* progress)
+{
+    const std::function<void()> fnAssign = MeshPostProcess::prepare(label, params, progress);
+    if (fnAssign)
+        fnAssign();
+
+    return bool(fnAssign);
+}
+
+bool MeshPostProcess::hasMeshFaces(const TDF_Label& label)
+{
+    return !meshFaces(XCaf::shape(label)).empty();
+}
+
+} // namespace Mayo
@@ -0,0 +1,75 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "occ_handle.h"
+
+#include <Poly_Triangulation.hxx>
+#include <TDF_Label.hxx>
+
+#include <functional>
+#include <vector>
+
+namespace Mayo {
+
+class TaskProgress;
+
+// Provides post-processing of triangle meshes, typically the "triangle soups" read from STL files,
+// or from OBJ/PLY files without shared vertices, where each triangle has its own nodes
+// Welding and normal computation are parallelized
+class MeshPostProcess {
+public:
+    struct Parameters {
+        bool weldNodes = true;
+        double weldTolerance = 0.; // Maximum distance between merged nodes, zero merges coincident nodes
+        bool computeNormals = true;
+        double creaseAngle = 0.5235987755982988; // 30°, in radians
+    };
+
+    struct Result {
+        OccHandle<Poly_Triangulation> mesh; // Null if input mesh is null or empty
+        std::vector<int> vecSourceNode; // For each node of 'mesh', index of the source node(1-based)
+        int removedTriangleCount = 0; // Triangles made degenerated by welding
+    };
+
+    // Merges the nodes closer than 'tolerance', triangles made degenerated are removed
+    // Nodes are bucketed in a regular grid of cell size 'tolerance'(spatial hashing) so candidates
+    // for a node are found in the 27 surrounding cells
+    // Each node is merged with the node of smallest index within 'tolerance'(which might be merged
+    // itself with a node of smaller index). So merging is not fully transitive: whether a chain of
+    // nodes spaced by less than 'tolerance' is merged into a single node depends on node order
+    static Result weldNodes(const OccHandle<Poly_Triangulation>& mesh, double tolerance);
+
+    // Computes normals at nodes as the angle-weighted average of the normals of the adjacent
+    // triangles. Triangles forming an angle greater than 'creaseAngle' don't contribute to each
+    // other normals, so nodes are duplicated along such crease edges to keep sharp features
+    // Nodes not referenced by any triangle are removed
+    static Result computeSmoothNormals(const OccHandle<Poly_Triangulation>& mesh, double creaseAngle);
+
+    // Runs weldNodes() then computeSmoothNormals() as specified by 'params'
+    static Result run(const OccHandle<Poly_Triangulation>& mesh, const Parameters& params);
+
+    // Post-processes the meshes of the non-geometric faces of the shape stored in 'label'(eg mesh
+    // entity created by a mesh reader), faces relying on a geometric surface are ignored
+    // Post-processed meshes are computed but not assigned to the faces, this is done by the returned
+    // function along with remapping of the node colors(see TriangulationAnnexData). So current
+    // meshes can still be used concurrently(eg for display), the returned function has to be called
+    // in the thread owning the graphics objects
+    // Returns null function if there is nothing to post-process
+    static std::function<void()> prepare(
+            const TDF_Label& label, const Parameters& params, TaskProgress* progress = nullptr
+    );
+
+    // Same as prepare() but post-processed meshes are assigned immediately
+    // Returns true if some mesh was post-processed
+    static bool apply(const TDF_Label& label, const Parameters& params, TaskProgress* progress = nullptr);
+
+    // Does the shape stored in 'label' have non-geometric faces with a triangulation?
+    static bool hasMeshFaces(const TDF_Label& label);
+};
+
+} // namespace Mayo
@@ -5,11 +5,17 @@
 ****************************************************************************/
 
 #include "mesh_utils.h"
+#include "cpp_utils.h"
 #include "math_utils.h"
 
+#include <OSD_Parallel.hxx>
+
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <numeric>
 #include <stdexcept>
+#include <vector>
 
 namespace Mayo {
 namespace MeshUtils {
@@ -25,6 +31,30 @@ namespace {
         return TColStd_Array1OfReal();
 }
 
+// Size of the triangle chunks processed in parallel by the triangulation functions
+constexpr int TriangleChunkSize = 4096;
+
+// Calls 'fnBatch' on each chunk of the triangles of 'triangulation', chunks are processed in parallel
+// Returns the results in chunk order so reductions are deterministic
+template<typename Result, typename Function>
+std::vector<Result> parallelForTriangleChunks(const Handle_Poly_Triangulation& triangulation, Function fnBatch)
+{
+    std::vector<gp_XYZ> vecNodeCopy;
+    const Span<const gp_XYZ> spanNode = MeshUtils::contiguousNodes(triangulation, &vecNodeCopy);
+    const Span<const Poly_Triangle> spanTriangle = MeshUtils::contiguousTriangles(triangulation);
+    const int triangleCount = CppUtils::safeStaticCast<int>(spanTriangle.size());
+    const int chunkCount = (triangleCount + TriangleChunkSize - 1) / TriangleChunkSize;
+    std::vector<Result> vecChunkResult(chunkCount);
+    OSD_Parallel::For(0, chunkCount, [&](int iChunk) {
+        const int iFirst = iChunk * TriangleChunkSize;
+        const int count = std::min(TriangleChunkSize, triangleCount - iFirst);
+        const TriangleBatch batch{ spanNode, spanTriangle.subspan(iFirst, count) };
+        vecChunkResult.at(iChunk) = fnBatch(batch);
+    }, chunkCount < 2/*isForceSingleThreadExecution*/);
+
+    return vecChunkResult;
+}
+
 } // namespace
 
 double triangleSignedVolume(const gp_XYZ& p1, const gp_XYZ& p2, const gp_XYZ& p3)
@@ -51,18 +81,10 @@ double triangulationVolume(const Handle_Poly_Triangulation& triangulation)
     if (!triangulation)
         return 0;
 
-    double volume = 0;
-    // TODO Parallelize computation
-    for (const Poly_Triangle& tri : MeshUtils::triangles(triangulation)) {
-        int v1, v2, v3;
-        tri.Get(v1, v2, v3);
-        volume += MeshUtils::triangleSignedVolume(
-                    triangulation->Node(v1).Coord(),
-                    triangulation->Node(v2).Coord(),
-                    triangulation->Node(v3).Coord());
-    }
-
-    return std::abs(volume);
+    const std::vector<double> vecChunkVolume = parallelForTriangleChunks<double>(
+        triangulation, [](const TriangleBatch& batch) { return MeshUtils::batchSignedVolume(batch); }
+    );
+    return std::abs(std::accumulate(vecChunkVolume.cbegin(), vecChunkVolume.cend(), 0.));
 }
 
 double triangulationArea(const Handle_Poly_Triangulation& triangulation)
@@ -70,18 +92,90 @@ double triangulationArea(const Handle_Poly_Triangulation& triangulation)
     if (!triangulation)
         return 0;
 
+    const std::vector<double> vecChunkArea = parallelForTriangleChunks<double>(
+        triangulation, [](const TriangleBatch& batch) { return MeshUtils::batchArea(batch); }
+    );
+    return std::accumulate(vecChunkArea.cbegin(), vecChunkArea.cend(), 0.);
+}
+
+gp_XYZ triangulationCentroid(const Handle_Poly_Triangulation& triangulation)
+{
+    if (!triangulation)
+        return {};
+
+    struct ChunkResult {
+        double area = 0;
+        gp_XYZ centroid;
+    };
+    const std::vector<ChunkResult> vecChunkResult = parallelForTriangleChunks<ChunkResult>(
+        triangulation, [](const TriangleBatch& batch) {
+            return ChunkResult{ MeshUtils::batchArea(batch), MeshUtils::batchCentroid(batch) };
+        }
+    );
     double area = 0;
-    // TODO Parallelize computation
-    for (const Poly_Triangle& tri : MeshUtils::triangles(triangulation)) {
-        int v1, v2, v3;
-        tri.Get(v1, v2, v3);
-        area += MeshUtils::triangleArea(
-                    triangulation->Node(v1).Coord(),
-                    triangulation->Node(v2).Coord(),
-                    triangulation->Node(v3).Coord());
+    gp_XYZ moment;
+    for (const ChunkResult& chunk : vecChunkResult) {
+        area += chunk.area;
+        moment += chunk.area * chunk.centroid;
     }
 
-    return area;
+    return area > 0 ? moment / area : gp_XYZ{};
+}
+
+std::vector<gp_XYZ> nodeNormals(const Handle_Poly_Triangulation& triangulation)
+{
+    if (!triangulation || triangulation->NbNodes() <= 0)
+        return {};
+
+    // Non-normalized triangle normals are weighted by the triangle area
+    std::vector<gp_XYZ> vecNodeCopy;
+    const Span<const gp_XYZ> spanNode = MeshUtils::contiguousNodes(triangulation, &vecNodeCopy);
+    const Span<const Poly_Triangle> spanTriangle = MeshUtils::contiguousTriangles(triangulation);
+    std::vector<gp_XYZ> vecTriangleNormal(spanTriangle.size());
+    const int triangleCount = CppUtils::safeStaticCast<int>(spanTriangle.size());
+    const int chunkCount = (triangleCount + TriangleChunkSize - 1) / TriangleChunkSize;
+    OSD_Parallel::For(0, chunkCount, [&](int iChunk) {
+        const int iFirst = iChunk * TriangleChunkSize;
+        const int count = std::min(TriangleChunkSize, triangleCount - iFirst);
+        const TriangleBatch batch{ spanNode, spanTriangle.subspan(iFirst, count) };
+        MeshUtils::batchTriangleNormals(batch, Span<gp_XYZ>(vecTriangleNormal).subspan(iFirst, count));
+    }, chunkCount < 2/*isForceSingleThreadExecution*/);
+
+    std::vector<gp_XYZ> vecNodeNormal(spanNode.size());
+    for (int i = 0; i < triangleCount; ++i) {
+        int n1, n2, n3;
+        spanTriangle[i].Get(n1, n2, n3);
+        const gp_XYZ& normal = vecTriangleNormal.at(i);
+        vecNodeNormal.at(n1 - 1) += normal;
+        vecNodeNormal.at(n2 - 1) += normal;
+        vecNodeNormal.at(n3 - 1) += normal;
+    }
+
+    const int nodeCount = CppUtils::safeStaticCast<int>(vecNodeNormal.size());
+    OSD_Parallel::For(0, nodeCount, [&](int i) {
+        gp_XYZ& normal = vecNodeNormal.at(i);
+        const double length = normal.Modulus();
+        if (length > 0)
+            normal /= length;
+    }, nodeCount < TriangleChunkSize/*isForceSingleThreadExecution*/);
+
+    return vecNodeNormal;
+}
+
+void computeNormals(const Handle_Poly_Triangulation& triangulation)
+{
+    const std::vector<gp_XYZ> vecNodeNormal = MeshUtils::nodeNormals(triangulation);
+    if (vecNodeNormal.empty())
+        return;
+
+    MeshUtils::allocateNormals(triangulation);
+    for (int i = 0; i < triangulation->NbNodes(); ++i) {
+        const gp_XYZ& normal = vecNodeNormal.at(i);
+        const MeshUtils::Poly_Triangulation_NormalType n(
+                    float(normal.X()), float(normal.Y()), float(normal.Z())
+        );
+        MeshUtils::setNormal(triangulation, i + 1, n);
+    }
 }
 
 void setNode(const Handle_Poly_Triangulation& triangulation, int index, const gp_Pnt& pnt)
@@ -114,6 +208,18 @@ void setNormal(const Handle_Poly_Triangulation& triangulation, int index, const
 #endif
 }
 
+gp_XYZ nodeNormal(const Handle_Poly_Triangulation& triangulation, int index)
+{
+#if OCC_VERSION_HEX >= 0x070600
+    gp_Vec3f n;
+    triangulation->Normal(index, n);
+    return gp_XYZ(n.x(), n.y(), n.z());
+#else
+    const TShort_Array1OfShortReal& normals = triangulation->Normals();
+    return gp_XYZ(normals.Value(index * 3 - 2), normals.Value(index * 3 - 1), normals.Value(index * 3));
+#endif
+}
+
 void setUvNode(const Handle_Poly_Triangulation& triangulation, int index, double u, double v)
 {
 #if OCC_VERSION_HEX >= 0x070600
@@ -7,11 +7,14 @@
 #pragma once
 
 #include "occ_handle.h"
+#include "span.h"
 
 #include <Poly_Polygon3D.hxx>
 #include <Poly_Triangulation.hxx>
 #include <Standard_Version.hxx>
-class gp_XYZ;
+#include <gp_XYZ.hxx>
+
+#include <vector>
 
 namespace Mayo {
 
@@ -24,6 +27,68 @@ double triangleArea(const gp_XYZ& p1, const gp_XYZ& p2, const gp_XYZ& p3);
 double triangulationVolume(const Handle_Poly_Triangulation& triangulation);
 double triangulationArea(const Handle_Poly_Triangulation& triangulation);
 
+// Area-weighted centroid of the triangles, expressed in the local coordinate system of 'triangulation'
+gp_XYZ triangulationCentroid(const Handle_Poly_Triangulation& triangulation);
+
+// Unit normals at nodes of 'triangulation' computed as the area-weighted average of the normals of
+// the adjacent triangles. Normals stored in 'triangulation' are neither used nor modified
+std::vector<gp_XYZ> nodeNormals(const Handle_Poly_Triangulation& triangulation);
+
+// Stores in 'triangulation' the normals returned by nodeNormals(). Any existing normals are overwritten
+void computeNormals(const Handle_Poly_Triangulation& triangulation);
+
+// --
+// -- Batch functions
+// --
+
+// Contiguous view over triangle mesh data, suitable for the batch functions
+// Node indices of 'triangles' are 1-based as for Poly_Triangulation
+struct TriangleBatch {
+    Span<const gp_XYZ> nodes;
+    Span<const Poly_Triangle> triangles;
+};
+
+// Returns a contiguous view over the nodes of 'triangulation' suitable for TriangleBatch::nodes
+// The view refers to the node storage of 'triangulation' when nodes are stored as double precision
+// points, otherwise nodes are copied into 'ptrVecNodeCopy' which the view then refers to
+Span<const gp_XYZ> contiguousNodes(
+        const Handle_Poly_Triangulation& triangulation, std::vector<gp_XYZ>* ptrVecNodeCopy
+);
+
+// Returns a view over the triangles stored in 'triangulation'(no copy)
+Span<const Poly_Triangle> contiguousTriangles(const Handle_Poly_Triangulation& triangulation);
+
+// Instruction set used by the batch functions
+// Argument can be specified to force the scalar implementation, the batch functions fall back to
+// scalar implementation if requested instruction set isn't supported by the running CPU
+enum class SimdInstructionSet { None, Avx2, Neon };
+
+// Best instruction set supported by the running CPU, it's detected once
+SimdInstructionSet simdInstructionSet();
+
+// Sum of the triangle areas
+double batchArea(const TriangleBatch& batch, SimdInstructionSet simd = simdInstructionSet());
+
+// Sum of the signed volumes of the tetrahedrons(origin, p1, p2, p3) of the triangles
+double batchSignedVolume(const TriangleBatch& batch, SimdInstructionSet simd = simdInstructionSet());
+
+// Area-weighted centroid of the triangles, origin if the batch has no area
+gp_XYZ batchCentroid(const TriangleBatch& batch, SimdInstructionSet simd = simdInstructionSet());
+
+// Writes in 'normals' the non-normalized normal (p2 - p1)^(p3 - p1) of each triangle
+// Vector length is twice the triangle area. 'normals' size must be at least the triangle count
+void batchTriangleNormals(
+        const TriangleBatch& batch, Span<gp_XYZ> normals, SimdInstructionSet simd = simdInstructionSet()
+);
+
+// Computes the bounding box of 'nodes', returns false if 'nodes' is empty
+bool batchBoundingBox(
+        Span<const gp_XYZ> nodes,
+        gp_XYZ* ptrMin,
+        gp_XYZ* ptrMax,
+        SimdInstructionSet simd = simdInstructionSet()
+);
+
 #if OCC_VERSION_HEX >= 0x070600
 using Poly_Triangulation_NormalType = gp_Vec3f;
 #else
@@ -33,6 +98,7 @@ using Poly_Triangulation_NormalType = gp_Vec;
 void setNode(const Handle_Poly_Triangulation& triangulation, int index, const gp_Pnt& pnt);
 void setTriangle(const Handle_Poly_Triangulation& triangulation, int index, const Poly_Triangle& triangle);
 void setNormal(const Handle_Poly_Triangulation& triangulation, int index, const Poly_Triangulation_NormalType& n);
+gp_XYZ nodeNormal(const Handle_Poly_Triangulation& triangulation, int index); // Requires HasNormals()
 void setUvNode(const Handle_Poly_Triangulation& triangulation, int index, double u, double v);
 void allocateNormals(const Handle_Poly_Triangulation& triangulation);
 
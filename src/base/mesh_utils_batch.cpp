@@ -0,0 +1,641 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+// Batch functions of MeshUtils working on contiguous node/triangle arrays
+// Each kernel has a scalar implementation and vectorized implementations for AVX2(x86, selected
+// at runtime) and NEON(AArch64, always available)
+
+#include "global.h"
+#include "mesh_utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define MAYO_MESHUTILS_AVX2 1
+#  include <immintrin.h>
+#  if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#    define MAYO_TARGET_AVX2
+#  else
+#    define MAYO_TARGET_AVX2 __attribute__((target("avx2")))
+#  endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#  define MAYO_MESHUTILS_NEON 1
+#  include <arm_neon.h>
+#endif
+
+namespace Mayo {
+namespace MeshUtils {
+
+namespace {
+
+static_assert(sizeof(gp_XYZ) == 3 * sizeof(double), "gp_XYZ must be laid out as 3 doubles");
+static_assert(sizeof(Poly_Triangle) == 3 * sizeof(int), "Poly_Triangle must be laid out as 3 ints");
+
+// Raw data of TriangleBatch, node indices are 1-based
+struct RawBatch {
+    const double* xyz; // Interleaved node coordinates
+    const int* indices; // Three node indices per triangle
+    size_t triangleCount;
+
+    RawBatch(const TriangleBatch& batch)
+        : xyz(reinterpret_cast<const double*>(batch.nodes.data())),
+          indices(reinterpret_cast<const int*>(batch.triangles.data())),
+          triangleCount(batch.triangles.size())
+    {}
+
+    const double* node(size_t triangleIndex, int corner) const {
+        return this->xyz + 3 * size_t(this->indices[3 * triangleIndex + corner] - 1);
+    }
+};
+
+struct AreaMoment {
+    double area = 0;
+    double mx = 0, my = 0, mz = 0; // Sum of area * triangle centroid
+};
+
+// Computes (b - a)^(c - a)
+void scalarCross(const double* a, const double* b, const double* c, double* n)
+{
+    const double ux = b[0] - a[0], uy = b[1] - a[1], uz = b[2] - a[2];
+    const double vx = c[0] - a[0], vy = c[1] - a[1], vz = c[2] - a[2];
+    n[0] = uy * vz - uz * vy;
+    n[1] = uz * vx - ux * vz;
+    n[2] = ux * vy - uy * vx;
+}
+
+// --
+// -- Scalar kernels
+// --
+
+double scalarArea(const RawBatch& batch, size_t iStart)
+{
+    double area = 0;
+    for (size_t i = iStart; i < batch.triangleCount; ++i) {
+        double n[3];
+        scalarCross(batch.node(i, 0), batch.node(i, 1), batch.node(i, 2), n);
+        area += 0.5 * std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    }
+
+    return area;
+}
+
+double scalarSignedVolume(const RawBatch& batch, size_t iStart)
+{
+    double volume = 0;
+    for (size_t i = iStart; i < batch.triangleCount; ++i) {
+        const double* a = batch.node(i, 0);
+        const double* b = batch.node(i, 1);
+        const double* c = batch.node(i, 2);
+        const double cx = b[1] * c[2] - b[2] * c[1];
+        const double cy = b[2] * c[0] - b[0] * c[2];
+        const double cz = b[0] * c[1] - b[1] * c[0];
+        volume += (a[0] * cx + a[1] * cy + a[2] * cz) / 6.;
+    }
+
+    return volume;
+}
+
+AreaMoment scalarAreaMoment(const RawBatch& batch, size_t iStart)
+{
+    AreaMoment sum;
+    for (size_t i = iStart; i < batch.triangleCount; ++i) {
+        const double* a = batch.node(i, 0);
+        const double* b = batch.node(i, 1);
+        const double* c = batch.node(i, 2);
+        double n[3];
+        scalarCross(a, b, c, n);
+        const double area = 0.5 * std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        sum.area += area;
+        sum.mx += area * (a[0] + b[0] + c[0]) / 3.;
+        sum.my += area * (a[1] + b[1] + c[1]) / 3.;
+        sum.mz += area * (a[2] + b[2] + c[2]) / 3.;
+    }
+
+    return sum;
+}
+
+void scalarTriangleNormals(const RawBatch& batch, size_t iStart, double* normals)
+{
+    for (size_t i = iStart; i < batch.triangleCount; ++i)
+        scalarCross(batch.node(i, 0), batch.node(i, 1), batch.node(i, 2), normals + 3 * i);
+}
+
+void scalarBoundingBox(const double* xyz, size_t iStart, size_t nodeCount, double* pmin, double* pmax)
+{
+    for (size_t i = iStart; i < nodeCount; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            pmin[j] = std::min(pmin[j], xyz[3 * i + j]);
+            pmax[j] = std::max(pmax[j], xyz[3 * i + j]);
+        }
+    }
+}
+
+// --
+// -- AVX2 kernels, 4 triangles per iteration
+// --
+
+#ifdef MAYO_MESHUTILS_AVX2
+bool cpuSupportsAvx2()
+{
+#  if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {};
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    __cpuid(info, 1);
+    const bool hasOsXSave = (info[2] & (1 << 27)) != 0;
+    const bool hasAvx = (info[2] & (1 << 28)) != 0;
+    if (!hasOsXSave || !hasAvx || (_xgetbv(0) & 6) != 6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#  else
+    return __builtin_cpu_supports("avx2");
+#  endif
+}
+
+struct Avx2Vec3 {
+    __m256d x;
+    __m256d y;
+    __m256d z;
+};
+
+// Gathers the 'corner' nodes of the 4 triangles starting at 'i'
+MAYO_TARGET_AVX2 inline Avx2Vec3 avx2GatherNodes(const RawBatch& batch, size_t i, int corner)
+{
+    const int* idx = batch.indices + 3 * i + corner;
+    const __m128i offset = _mm_setr_epi32(3 * (idx[0] - 1), 3 * (idx[3] - 1), 3 * (idx[6] - 1), 3 * (idx[9] - 1));
+    // Note: masked variant avoids the "uninitialized" warnings of GCC with _mm256_i32gather_pd()
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d mask = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    return {
+        _mm256_mask_i32gather_pd(zero, batch.xyz, offset, mask, 8),
+        _mm256_mask_i32gather_pd(zero, batch.xyz + 1, offset, mask, 8),
+        _mm256_mask_i32gather_pd(zero, batch.xyz + 2, offset, mask, 8)
+    };
+}
+
+MAYO_TARGET_AVX2 inline Avx2Vec3 avx2Sub(const Avx2Vec3& a, const Avx2Vec3& b)
+{
+    return { _mm256_sub_pd(a.x, b.x), _mm256_sub_pd(a.y, b.y), _mm256_sub_pd(a.z, b.z) };
+}
+
+MAYO_TARGET_AVX2 inline Avx2Vec3 avx2Add(const Avx2Vec3& a, const Avx2Vec3& b)
+{
+    return { _mm256_add_pd(a.x, b.x), _mm256_add_pd(a.y, b.y), _mm256_add_pd(a.z, b.z) };
+}
+
+MAYO_TARGET_AVX2 inline Avx2Vec3 avx2Cross(const Avx2Vec3& u, const Avx2Vec3& v)
+{
+    return {
+        _mm256_sub_pd(_mm256_mul_pd(u.y, v.z), _mm256_mul_pd(u.z, v.y)),
+        _mm256_sub_pd(_mm256_mul_pd(u.z, v.x), _mm256_mul_pd(u.x, v.z)),
+        _mm256_sub_pd(_mm256_mul_pd(u.x, v.y), _mm256_mul_pd(u.y, v.x))
+    };
+}
+
+MAYO_TARGET_AVX2 inline __m256d avx2Dot(const Avx2Vec3& u, const Avx2Vec3& v)
+{
+    return _mm256_add_pd(
+                _mm256_add_pd(_mm256_mul_pd(u.x, v.x), _mm256_mul_pd(u.y, v.y)),
+                _mm256_mul_pd(u.z, v.z)
+    );
+}
+
+MAYO_TARGET_AVX2 inline double avx2HorizontalSum(__m256d v)
+{
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, v);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+// Twice the area of the 4 triangles starting at 'i'
+MAYO_TARGET_AVX2 inline __m256d avx2DoubleArea(const RawBatch& batch, size_t i, Avx2Vec3* sumNodes = nullptr)
+{
+    const Avx2Vec3 a = avx2GatherNodes(batch, i, 0);
+    const Avx2Vec3 b = avx2GatherNodes(batch, i, 1);
+    const Avx2Vec3 c = avx2GatherNodes(batch, i, 2);
+    if (sumNodes)
+        *sumNodes = avx2Add(avx2Add(a, b), c);
+
+    const Avx2Vec3 n = avx2Cross(avx2Sub(b, a), avx2Sub(c, a));
+    return _mm256_sqrt_pd(avx2Dot(n, n));
+}
+
+MAYO_TARGET_AVX2 double avx2Area(const RawBatch& batch)
+{
+    __m256d sum = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= batch.triangleCount; i += 4)
+        sum = _mm256_add_pd(sum, avx2DoubleArea(batch, i));
+
+    return 0.5 * avx2HorizontalSum(sum) + scalarArea(batch, i);
+}
+
+MAYO_TARGET_AVX2 double avx2SignedVolume(const RawBatch& batch)
+{
+    __m256d sum = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= batch.triangleCount; i += 4) {
+        const Avx2Vec3 a = avx2GatherNodes(batch, i, 0);
+        const Avx2Vec3 b = avx2GatherNodes(batch, i, 1);
+        const Avx2Vec3 c = avx2GatherNodes(batch, i, 2);
+        sum = _mm256_add_pd(sum, avx2Dot(a, avx2Cross(b, c)));
+    }
+
+    return avx2HorizontalSum(sum) / 6. + scalarSignedVolume(batch, i);
+}
+
+MAYO_TARGET_AVX2 AreaMoment avx2AreaMoment(const RawBatch& batch)
+{
+    __m256d sumArea = _mm256_setzero_pd();
+    Avx2Vec3 sumMoment = { _mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd() };
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d third = _mm256_set1_pd(1. / 3.);
+    size_t i = 0;
+    for (; i + 4 <= batch.triangleCount; i += 4) {
+        Avx2Vec3 sumNodes;
+        const __m256d area = _mm256_mul_pd(half, avx2DoubleArea(batch, i, &sumNodes));
+        const __m256d weight = _mm256_mul_pd(area, third);
+        sumArea = _mm256_add_pd(sumArea, area);
+        sumMoment.x = _mm256_add_pd(sumMoment.x, _mm256_mul_pd(weight, sumNodes.x));
+        sumMoment.y = _mm256_add_pd(sumMoment.y, _mm256_mul_pd(weight, sumNodes.y));
+        sumMoment.z = _mm256_add_pd(sumMoment.z, _mm256_mul_pd(weight, sumNodes.z));
+    }
+
+    AreaMoment moment = scalarAreaMoment(batch, i);
+    moment.area += avx2HorizontalSum(sumArea);
+    moment.mx += avx2HorizontalSum(sumMoment.x);
+    moment.my += avx2HorizontalSum(sumMoment.y);
+    moment.mz += avx2HorizontalSum(sumMoment.z);
+    return moment;
+}
+
+MAYO_TARGET_AVX2 void avx2TriangleNormals(const RawBatch& batch, double* normals)
+{
+    size_t i = 0;
+    for (; i + 4 <= batch.triangleCount; i += 4) {
+        const Avx2Vec3 a = avx2GatherNodes(batch, i, 0);
+        const Avx2Vec3 b = avx2GatherNodes(batch, i, 1);
+        const Avx2Vec3 c = avx2GatherNodes(batch, i, 2);
+        const Avx2Vec3 n = avx2Cross(avx2Sub(b, a), avx2Sub(c, a));
+        alignas(32) double nx[4], ny[4], nz[4];
+        _mm256_store_pd(nx, n.x);
+        _mm256_store_pd(ny, n.y);
+        _mm256_store_pd(nz, n.z);
+        double* out = normals + 3 * i;
+        for (int k = 0; k < 4; ++k) {
+            out[3 * k] = nx[k];
+            out[3 * k + 1] = ny[k];
+            out[3 * k + 2] = nz[k];
+        }
+    }
+
+    scalarTriangleNormals(batch, i, normals);
+}
+
+// Nodes are processed 4 at a time as 3 vectors of interleaved coordinates:
+//     [x0 y0 z0 x1] [y1 z1 x2 y2] [z2 x3 y3 z3]
+MAYO_TARGET_AVX2 void avx2BoundingBox(const double* xyz, size_t nodeCount, double* pmin, double* pmax)
+{
+    __m256d min0 = _mm256_setr_pd(pmin[0], pmin[1], pmin[2], pmin[0]);
+    __m256d min1 = _mm256_setr_pd(pmin[1], pmin[2], pmin[0], pmin[1]);
+    __m256d min2 = _mm256_setr_pd(pmin[2], pmin[0], pmin[1], pmin[2]);
+    __m256d max0 = _mm256_setr_pd(pmax[0], pmax[1], pmax[2], pmax[0]);
+    __m256d max1 = _mm256_setr_pd(pmax[1], pmax[2], pmax[0], pmax[1]);
+    __m256d max2 = _mm256_setr_pd(pmax[2], pmax[0], pmax[1], pmax[2]);
+    size_t i = 0;
+    for (; i + 4 <= nodeCount; i += 4) {
+        const double* ptr = xyz + 3 * i;
+        const __m256d v0 = _mm256_loadu_pd(ptr);
+        const __m256d v1 = _mm256_loadu_pd(ptr + 4);
+        const __m256d v2 = _mm256_loadu_pd(ptr + 8);
+        min0 = _mm256_min_pd(min0, v0);
+        min1 = _mm256_min_pd(min1, v1);
+        min2 = _mm256_min_pd(min2, v2);
+        max0 = _mm256_max_pd(max0, v0);
+        max1 = _mm256_max_pd(max1, v1);
+        max2 = _mm256_max_pd(max2, v2);
+    }
+
+    alignas(32) double m0[4], m1[4], m2[4];
+    _mm256_store_pd(m0, min0);
+    _mm256_store_pd(m1, min1);
+    _mm256_store_pd(m2, min2);
+    pmin[0] = std::min({ m0[0], m0[3], m1[2], m2[1] });
+    pmin[1] = std::min({ m0[1], m1[0], m1[3], m2[2] });
+    pmin[2] = std::min({ m0[2], m1[1], m2[0], m2[3] });
+    _mm256_store_pd(m0, max0);
+    _mm256_store_pd(m1, max1);
+    _mm256_store_pd(m2, max2);
+    pmax[0] = std::max({ m0[0], m0[3], m1[2], m2[1] });
+    pmax[1] = std::max({ m0[1], m1[0], m1[3], m2[2] });
+    pmax[2] = std::max({ m0[2], m1[1], m2[0], m2[3] });
+    scalarBoundingBox(xyz, i, nodeCount, pmin, pmax);
+}
+#endif // MAYO_MESHUTILS_AVX2
+
+// --
+// -- NEON kernels, 2 triangles per iteration
+// --
+
+#ifdef MAYO_MESHUTILS_NEON
+struct NeonVec3 {
+    float64x2_t x;
+    float64x2_t y;
+    float64x2_t z;
+};
+
+// Loads the 'corner' nodes of the 2 triangles starting at 'i'
+inline NeonVec3 neonLoadNodes(const RawBatch& batch, size_t i, int corner)
+{
+    const double* p0 = batch.node(i, corner);
+    const double* p1 = batch.node(i + 1, corner);
+    return {
+        vcombine_f64(vld1_f64(p0), vld1_f64(p1)),
+        vcombine_f64(vld1_f64(p0 + 1), vld1_f64(p1 + 1)),
+        vcombine_f64(vld1_f64(p0 + 2), vld1_f64(p1 + 2))
+    };
+}
+
+inline NeonVec3 neonSub(const NeonVec3& a, const NeonVec3& b)
+{
+    return { vsubq_f64(a.x, b.x), vsubq_f64(a.y, b.y), vsubq_f64(a.z, b.z) };
+}
+
+inline NeonVec3 neonCross(const NeonVec3& u, const NeonVec3& v)
+{
+    return {
+        vsubq_f64(vmulq_f64(u.y, v.z), vmulq_f64(u.z, v.y)),
+        vsubq_f64(vmulq_f64(u.z, v.x), vmulq_f64(u.x, v.z)),
+        vsubq_f64(vmulq_f64(u.x, v.y), vmulq_f64(u.y, v.x))
+    };
+}
+
+inline float64x2_t neonDot(const NeonVec3& u, const NeonVec3& v)
+{
+    return vaddq_f64(vaddq_f64(vmulq_f64(u.x, v.x), vmulq_f64(u.y, v.y)), vmulq_f64(u.z, v.z));
+}
+
+double neonArea(const RawBatch& batch)
+{
+    float64x2_t sum = vdupq_n_f64(0.);
+    size_t i = 0;
+    for (; i + 2 <= batch.triangleCount; i += 2) {
+        const NeonVec3 a = neonLoadNodes(batch, i, 0);
+        const NeonVec3 n = neonCross(neonSub(neonLoadNodes(batch, i, 1), a), neonSub(neonLoadNodes(batch, i, 2), a));
+        sum = vaddq_f64(sum, vsqrtq_f64(neonDot(n, n)));
+    }
+
+    return 0.5 * vaddvq_f64(sum) + scalarArea(batch, i);
+}
+
+double neonSignedVolume(const RawBatch& batch)
+{
+    float64x2_t sum = vdupq_n_f64(0.);
+    size_t i = 0;
+    for (; i + 2 <= batch.triangleCount; i += 2) {
+        const NeonVec3 a = neonLoadNodes(batch, i, 0);
+        const NeonVec3 b = neonLoadNodes(batch, i, 1);
+        const NeonVec3 c = neonLoadNodes(batch, i, 2);
+        sum = vaddq_f64(sum, neonDot(a, neonCross(b, c)));
+    }
+
+    return vaddvq_f64(sum) / 6. + scalarSignedVolume(batch, i);
+}
+
+AreaMoment neonAreaMoment(const RawBatch& batch)
+{
+    float64x2_t sumArea = vdupq_n_f64(0.);
+    NeonVec3 sumMoment = { vdupq_n_f64(0.), vdupq_n_f64(0.), vdupq_n_f64(0.) };
+    size_t i = 0;
+    for (; i + 2 <= batch.triangleCount; i += 2) {
+        const NeonVec3 a = neonLoadNodes(batch, i, 0);
+        const NeonVec3 b = neonLoadNodes(batch, i, 1);
+        const NeonVec3 c = neonLoadNodes(batch, i, 2);
+        const NeonVec3 n = neonCross(neonSub(b, a), neonSub(c, a));
+        const float64x2_t area = vmulq_n_f64(vsqrtq_f64(neonDot(n, n)), 0.5);
+        const float64x2_t weight = vmulq_n_f64(area, 1. / 3.);
+        sumArea = vaddq_f64(sumArea, area);
+        sumMoment.x = vaddq_f64(sumMoment.x, vmulq_f64(weight, vaddq_f64(vaddq_f64(a.x, b.x), c.x)));
+        sumMoment.y = vaddq_f64(sumMoment.y, vmulq_f64(weight, vaddq_f64(vaddq_f64(a.y, b.y), c.y)));
+        sumMoment.z = vaddq_f64(sumMoment.z, vmulq_f64(weight, vaddq_f64(vaddq_f64(a.z, b.z), c.z)));
+    }
+
+    AreaMoment moment = scalarAreaMoment(batch, i);
+    moment.area += vaddvq_f64(sumArea);
+    moment.mx += vaddvq_f64(sumMoment.x);
+    moment.my += vaddvq_f64(sumMoment.y);
+    moment.mz += vaddvq_f64(sumMoment.z);
+    return moment;
+}
+
+void neonTriangleNormals(const RawBatch& batch, double* normals)
+{
+    size_t i = 0;
+    for (; i + 2 <= batch.triangleCount; i += 2) {
+        const NeonVec3 a = neonLoadNodes(batch, i, 0);
+        const NeonVec3 n = neonCross(neonSub(neonLoadNodes(batch, i, 1), a), neonSub(neonLoadNodes(batch, i, 2), a));
+        double* out = normals + 3 * i;
+        // Store lane 0 as(x0, y0, z0) and lane 1 as (x1, y1, z1)
+        vst1q_f64(out, vzip1q_f64(n.x, n.y));
+        vst1q_f64(out + 3, vzip2q_f64(n.x, n.y));
+        out[2] = vgetq_lane_f64(n.z, 0);
+        out[5] = vgetq_lane_f64(n.z, 1);
+    }
+
+    scalarTriangleNormals(batch, i, normals);
+}
+
+// Nodes are processed 2 at a time as 3 vectors of interleaved coordinates:
+//     [x0 y0] [z0 x1] [y1 z1]
+void neonBoundingBox(const double* xyz, size_t nodeCount, double* pmin, double* pmax)
+{
+    const double initMin0[2] = { pmin[0], pmin[1] }, initMin1[2] = { pmin[2], pmin[0] }, initMin2[2] = { pmin[1], pmin[2] };
+    const double initMax0[2] = { pmax[0], pmax[1] }, initMax1[2] = { pmax[2], pmax[0] }, initMax2[2] = { pmax[1], pmax[2] };
+    float64x2_t min0 = vld1q_f64(initMin0), min1 = vld1q_f64(initMin1), min2 = vld1q_f64(initMin2);
+    float64x2_t max0 = vld1q_f64(initMax0), max1 = vld1q_f64(initMax1), max2 = vld1q_f64(initMax2);
+    size_t i = 0;
+    for (; i + 2 <= nodeCount; i += 2) {
+        const double* ptr = xyz + 3 * i;
+        const float64x2_t v0 = vld1q_f64(ptr);
+        const float64x2_t v1 = vld1q_f64(ptr + 2);
+        const float64x2_t v2 = vld1q_f64(ptr + 4);
+        min0 = vminq_f64(min0, v0);
+        min1 = vminq_f64(min1, v1);
+        min2 = vminq_f64(min2, v2);
+        max0 = vmaxq_f64(max0, v0);
+        max1 = vmaxq_f64(max1, v1);
+        max2 = vmaxq_f64(max2, v2);
+    }
+
+    pmin[0] = std::min(vgetq_lane_f64(min0, 0), vgetq_lane_f64(min1, 1));
+    pmin[1] = std::min(vgetq_lane_f64(min0, 1), vgetq_lane_f64(min2, 0));
+    pmin[2] = std::min(vgetq_lane_f64(min1, 0), vgetq_lane_f64(min2, 1));
+    pmax[0] = std::max(vgetq_lane_f64(max0, 0), vgetq_lane_f64(max1, 1));
+    pmax[1] = std::max(vgetq_lane_f64(max0, 1), vgetq_lane_f64(max2, 0));
+    pmax[2] = std::max(vgetq_lane_f64(max1, 0), vgetq_lane_f64(max2, 1));
+    scalarBoundingBox(xyz, i, nodeCount, pmin, pmax);
+}
+#endif // MAYO_MESHUTILS_NEON
+
+// Returns 'simd' if it's supported by the running CPU, None otherwise
+SimdInstructionSet supportedSimd(SimdInstructionSet simd)
+{
+    return simd == simdInstructionSet() ? simd : SimdInstructionSet::None;
+}
+
+} // namespace
+
+Span<const gp_XYZ> contiguousNodes(
+        const Handle_Poly_Triangulation& triangulation, std::vector<gp_XYZ>* ptrVecNodeCopy)
+{
+    if (!triangulation || triangulation->NbNodes() <= 0)
+        return {};
+
+    // gp_Pnt only wraps a gp_XYZ, so an array of gp_Pnt can be viewed as an array of gp_XYZ
+    static_assert(sizeof(gp_Pnt) == sizeof(gp_XYZ));
+    const auto nodeCount = static_cast<size_t>(triangulation->NbNodes());
+#if OCC_VERSION_HEX >= 0x070600
+    const Poly_ArrayOfNodes& nodes = triangulation->InternalNodes();
+    if (nodes.IsDoublePrecision() && nodes.Stride() == sizeof(gp_Pnt))
+        return Span<const gp_XYZ>(reinterpret_cast<const gp_XYZ*>(nodes.value(0)), nodeCount);
+
+    // Single precision nodes, fall back to a copy
+    ptrVecNodeCopy->clear();
+    ptrVecNodeCopy->reserve(nodeCount);
+    for (int i = 1; i <= triangulation->NbNodes(); ++i)
+        ptrVecNodeCopy->push_back(triangulation->Node(i).XYZ());
+
+    return *ptrVecNodeCopy;
+#else
+    MAYO_UNUSED(ptrVecNodeCopy);
+    const TColgp_Array1OfPnt& nodes = triangulation->Nodes();
+    return Span<const gp_XYZ>(&nodes.First().XYZ(), nodeCount);
+#endif
+}
+
+Span<const Poly_Triangle> contiguousTriangles(const Handle_Poly_Triangulation& triangulation)
+{
+    if (!triangulation || triangulation->NbTriangles() <= 0)
+        return {};
+
+    const Poly_Array1OfTriangle& triangles = MeshUtils::triangles(triangulation);
+    return Span<const Poly_Triangle>(&triangles.First(), triangles.Size());
+}
+
+SimdInstructionSet simdInstructionSet()
+{
+#if defined(MAYO_MESHUTILS_AVX2)
+    static const SimdInstructionSet simd = cpuSupportsAvx2() ? SimdInstructionSet::Avx2 : SimdInstructionSet::None;
+    return simd;
+#elif defined(MAYO_MESHUTILS_NEON)
+    return SimdInstructionSet::Neon;
+#else
+    return SimdInstructionSet::None;
+#endif
+}
+
+double batchArea(const TriangleBatch& batch, SimdInstructionSet simd)
+{
+    const RawBatch raw(batch);
+    switch (supportedSimd(simd)) {
+#ifdef MAYO_MESHUTILS_AVX2
+    case SimdInstructionSet::Avx2: return avx2Area(raw);
+#endif
+#ifdef MAYO_MESHUTILS_NEON
+    case SimdInstructionSet::Neon: return neonArea(raw);
+#endif
+    default: return scalarArea(raw, 0);
+    }
+}
+
+double batchSignedVolume(const TriangleBatch& batch, SimdInstructionSet simd)
+{
+    const RawBatch raw(batch);
+    switch (supportedSimd(simd)) {
+#ifdef MAYO_MESHUTILS_AVX2
+    case SimdInstructionSet::Avx2: return avx2SignedVolume(raw);
+#endif
+#ifdef MAYO_MESHUTILS_NEON
+    case SimdInstructionSet::Neon: return neonSignedVolume(raw);
+#endif
+    default: return scalarSignedVolume(raw, 0);
+    }
+}
+
+gp_XYZ batchCentroid(const TriangleBatch& batch, SimdInstructionSet simd)
+{
+    const RawBatch raw(batch);
+    AreaMoment moment;
+    switch (supportedSimd(simd)) {
+#ifdef MAYO_MESHUTILS_AVX2
+    case SimdInstructionSet::Avx2: moment = avx2AreaMoment(raw); break;
+#endif
+#ifdef MAYO_MESHUTILS_NEON
+    case SimdInstructionSet::Neon: moment = neonAreaMoment(raw); break;
+#endif
+    default: moment = scalarAreaMoment(raw, 0); break;
+    }
+
+    if (moment.area <= 0)
+        return {};
+
+    return gp_XYZ(moment.mx, moment.my, moment.mz) / moment.area;
+}
+
+void batchTriangleNormals(const TriangleBatch& batch, Span<gp_XYZ> normals, SimdInstructionSet simd)
+{
+    if (normals.size() < batch.triangles.size())
+        throw std::invalid_argument("Normals array is too small");
+
+    const RawBatch raw(batch);
+    double* ptrNormals = reinterpret_cast<double*>(normals.data());
+    switch (supportedSimd(simd)) {
+#ifdef MAYO_MESHUTILS_AVX2
+    case SimdInstructionSet::Avx2: avx2TriangleNormals(raw, ptrNormals); break;
+#endif
+#ifdef MAYO_MESHUTILS_NEON
+    case SimdInstructionSet::Neon: neonTriangleNormals(raw, ptrNormals); break;
+#endif
+    default: scalarTriangleNormals(raw, 0, ptrNormals); break;
+    }
+}
+
+bool batchBoundingBox(Span<const gp_XYZ> nodes, gp_XYZ* ptrMin, gp_XYZ* ptrMax, SimdInstructionSet simd)
+{
+    if (nodes.empty())
+        return false;
+
+    const double* xyz = reinterpret_cast<const double*>(nodes.data());
+    double pmin[3] = { xyz[0], xyz[1], xyz[2] };
+    double pmax[3] = { xyz[0], xyz[1], xyz[2] };
+    switch (supportedSimd(simd)) {
+#ifdef MAYO_MESHUTILS_AVX2
+    case SimdInstructionSet::Avx2: avx2BoundingBox(xyz, nodes.size(), pmin, pmax); break;
+#endif
+#ifdef MAYO_MESHUTILS_NEON
+    case SimdInstructionSet::Neon: neonBoundingBox(xyz, nodes.size(), pmin, pmax); break;
+#endif
+    default: scalarBoundingBox(xyz, 0, nodes.size(), pmin, pmax); break;
+    }
+
+    if (ptrMin)
+        ptrMin->SetCoord(pmin[0], pmin[1], pmin[2]);
+
+    if (ptrMax)
+        ptrMax->SetCoord(pmax[0], pmax[1], pmax[2]);
+
+    return true;
+}
+
+} // namespace MeshUtils
+} // namespace Mayo
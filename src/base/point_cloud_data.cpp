@@ -5,6 +5,7 @@
 ****************************************************************************/
 
 #include "point_cloud_data.h"
+#include "point_cloud_octree.h"
 
 #include <Standard_GUID.hxx>
 #include <TDF_Label.hxx>
@@ -32,9 +33,34 @@ PointCloudDataPtr PointCloudData::Set(const TDF_Label& label, const Handle(Graph
 {
     PointCloudDataPtr data = PointCloudData::Set(label);
     data->m_points = points;
+    data->m_octree.reset();
     return data;
 }
 
+PointCloudDataPtr PointCloudData::Set(const TDF_Label& label, const std::shared_ptr<PointCloudOctree>& octree)
+{
+    PointCloudDataPtr data = PointCloudData::Set(label);
+    data->m_points.Nullify();
+    data->m_octree = octree;
+    return data;
+}
+
+int PointCloudData::pointCount() const
+{
+    if (m_octree)
+        return int(m_octree->pointCount());
+
+    return !m_points.IsNull() ? m_points->VertexNumber() : 0;
+}
+
+bool PointCloudData::hasColors() const
+{
+    if (m_octree)
+        return m_octree->hasColors();
+
+    return !m_points.IsNull() ? m_points->HasVertexColors() : false;
+}
+
 const Standard_GUID& PointCloudData::ID() const
 {
     return PointCloudData::GetID();
@@ -43,8 +69,10 @@ const Standard_GUID& PointCloudData::ID() const
 void PointCloudData::Restore(const Handle(TDF_Attribute)& attribute)
 {
     auto data = PointCloudDataPtr::DownCast(attribute);
-    if (data)
+    if (data) {
         m_points = data->m_points;
+        m_octree = data->m_octree;
+    }
 }
 
 Handle(TDF_Attribute) PointCloudData::NewEmpty() const
@@ -55,8 +83,10 @@ Handle(TDF_Attribute) PointCloudData::NewEmpty() const
 void PointCloudData::Paste(const Handle(TDF_Attribute)& into, const Handle(TDF_RelocationTable)&) const
 {
     auto data = PointCloudDataPtr::DownCast(into);
-    if (data)
+    if (data) {
         data->m_points = m_points;
+        data->m_octree = m_octree;
+    }
 }
 
 Standard_OStream& PointCloudData::Dump(Standard_OStream& ostr) const
@@ -9,21 +9,33 @@
 #include <Graphic3d_ArrayOfPoints.hxx>
 #include <TDF_Attribute.hxx>
 
+#include <memory>
+
 namespace Mayo {
 
 // Pre-declarations
+class PointCloudOctree;
 class PointCloudData;
 DEFINE_STANDARD_HANDLE(PointCloudData, TDF_Attribute)
 using PointCloudDataPtr = Handle(PointCloudData);
 
 // Provides a label attribute to store point cloud data
+// Points are either held in memory(see points()) or streamed from the file of a multi-resolution
+// octree(see octree()), the latter for huge point clouds
 class PointCloudData : public TDF_Attribute {
 public:
     static const Standard_GUID& GetID();
     static PointCloudDataPtr Set(const TDF_Label& label);
     static PointCloudDataPtr Set(const TDF_Label& label, const Handle(Graphic3d_ArrayOfPoints)& points);
+    // In-memory points are released
+    static PointCloudDataPtr Set(const TDF_Label& label, const std::shared_ptr<PointCloudOctree>& octree);
 
+    // Null if points are stored in an octree
     const Handle(Graphic3d_ArrayOfPoints)& points() const { return m_points; }
+    const std::shared_ptr<PointCloudOctree>& octree() const { return m_octree; }
+
+    int pointCount() const;
+    bool hasColors() const;
 
     // -- from TDF_Attribute
     const Standard_GUID& ID() const override;
@@ -36,6 +48,7 @@ public:
 
 private:
     Handle(Graphic3d_ArrayOfPoints) m_points;
+    std::shared_ptr<PointCloudOctree> m_octree;
 };
 
 } // namespace Mayo
@@ -0,0 +1,532 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "point_cloud_octree.h"
+
+#include "task_progress.h"
+
+#include <OSD_Parallel.hxx>
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <atomic>
+#include <unordered_set>
+
+namespace Mayo {
+
+namespace {
+
+// Identifies the octree file format, to be incremented on any change in the layout
+constexpr char octreeFileMagic[] = "MAYOPCOT";
+constexpr uint32_t octreeFileVersion = 1;
+
+template<typename T> void writeValue(std::ostream& ostr, const T& value)
+{
+    ostr.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T> T readValue(std::istream& istr)
+{
+    T value = {};
+    istr.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+
+void writeXYZ(std::ostream& ostr, const gp_XYZ& coords)
+{
+    writeValue<double>(ostr, coords.X());
+    writeValue<double>(ostr, coords.Y());
+    writeValue<double>(ostr, coords.Z());
+}
+
+gp_XYZ readXYZ(std::istream& istr)
+{
+    const auto x = readValue<double>(istr);
+    const auto y = readValue<double>(istr);
+    const auto z = readValue<double>(istr);
+    return { x, y, z };
+}
+
+// Paths of the octree files currently open, protected against eviction
+std::mutex& openFilesMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::unordered_set<std::string>& openFiles()
+{
+    static std::unordered_set<std::string> setFilepath;
+    return setFilepath;
+}
+
+// Builds the nodes of an octree, writing their points to a file as soon as they are built
+// Each node reorders the indices of its points so the points kept in the node come first, followed
+// by the points of each child octant. Nodes processing disjoint index ranges can be built in parallel
+class OctreeBuilder {
+public:
+    using Node = PointCloudOctree::Node;
+
+    OctreeBuilder(const OccHandle<Graphic3d_ArrayOfPoints>& points, std::ostream& ostr, TaskProgress* progress)
+        : m_points(points),
+          m_hasColors(points->HasVertexColors()),
+          m_ostr(ostr),
+          m_progress(progress),
+          m_progressCounter(progress, points->VertexNumber())
+    {
+        m_vecIndex.resize(points->VertexNumber());
+        for (uint32_t i = 0; i < m_vecIndex.size(); ++i)
+            m_vecIndex.at(i) = i;
+    }
+
+    // Returns false on error or if building was aborted
+    bool build()
+    {
+        if (m_vecIndex.empty())
+            return false;
+
+        // Root cube encloses all the points
+        Bnd_Box bndBox;
+        for (uint32_t i = 0; i < m_vecIndex.size(); ++i)
+            bndBox.Add(this->point(i));
+
+        const gp_XYZ cornerMin = bndBox.CornerMin().XYZ();
+        const gp_XYZ extent = bndBox.CornerMax().XYZ() - cornerMin;
+        const double cubeSize = std::max({ extent.X(), extent.Y(), extent.Z(), 1e-9 });
+        const int iRoot = this->newNode();
+        this->buildNode(iRoot, 0, m_vecIndex.size(), cornerMin, cubeSize, 0);
+        m_progressCounter.flush();
+        return !m_hasError && !TaskProgress::isAbortRequested(m_progress);
+    }
+
+    const std::vector<Node>& nodes() const { return m_vecNode; }
+
+private:
+    gp_Pnt point(uint32_t index) const { return m_points->Vertice(int(index) + 1); }
+
+    int newNode()
+    {
+        std::lock_guard<std::mutex> lock(m_mutexNode);
+        m_vecNode.emplace_back();
+        return int(m_vecNode.size()) - 1;
+    }
+
+    void buildNode(int iNode, size_t begin, size_t end, const gp_XYZ& cubeMin, double cubeSize, int level)
+    {
+        if (m_hasError || TaskProgress::isAbortRequested(m_progress))
+            return;
+
+        Node node;
+        node.level = level;
+        node.spacing = cubeSize / PointCloudOctree::GridSize;
+        Bnd_Box bndBox;
+        for (size_t i = begin; i < end; ++i)
+            bndBox.Add(this->point(m_vecIndex.at(i)));
+
+        node.cornerMin = bndBox.CornerMin().XYZ();
+        node.cornerMax = bndBox.CornerMax().XYZ();
+        if (end - begin <= size_t(PointCloudOctree::MaxNodePointCount) || level >= PointCloudOctree::MaxDepth) {
+            this->writeNodePoints(&node, begin, end);
+            this->setNode(iNode, node);
+            return;
+        }
+
+        // Keep in the node the first point found in each cell of the grid subsampling the cube
+        constexpr int gridSize = PointCloudOctree::GridSize;
+        const double invCellSize = gridSize / cubeSize;
+        auto fnCellCoord = [=](double coord, double coordMin) {
+            return std::clamp(int((coord - coordMin) * invCellSize), 0, gridSize - 1);
+        };
+        std::vector<bool> vecCellUsed(gridSize * gridSize * gridSize, false);
+        size_t nodeEnd = begin;
+        for (size_t i = begin; i < end; ++i) {
+            const gp_Pnt pnt = this->point(m_vecIndex.at(i));
+            const int cx = fnCellCoord(pnt.X(), cubeMin.X());
+            const int cy = fnCellCoord(pnt.Y(), cubeMin.Y());
+            const int cz = fnCellCoord(pnt.Z(), cubeMin.Z());
+            const int cell = (cx * gridSize + cy) * gridSize + cz;
+            if (!vecCellUsed.at(cell)) {
+                vecCellUsed.at(cell) = true;
+                std::swap(m_vecIndex.at(i), m_vecIndex.at(nodeEnd++));
+            }
+        }
+
+        vecCellUsed = {};
+        this->writeNodePoints(&node, begin, nodeEnd);
+
+        // Dispatch the other points in the octants of the cube
+        const double halfSize = cubeSize / 2.;
+        const gp_XYZ center = cubeMin + gp_XYZ(halfSize, halfSize, halfSize);
+        auto fnPartition = [&](size_t first, size_t last, int axis) {
+            auto itFirst = m_vecIndex.begin() + first;
+            auto itLast = m_vecIndex.begin() + last;
+            auto itMid = std::partition(itFirst, itLast, [&](uint32_t index) {
+                return this->point(index).Coord(axis + 1) < center.Coord(axis + 1);
+            });
+            return size_t(itMid - m_vecIndex.begin());
+        };
+        // Octant index bits: 1 for upper X, 2 for upper Y, 4 for upper Z
+        size_t octantBounds[9] = {};
+        octantBounds[0] = nodeEnd;
+        octantBounds[8] = end;
+        octantBounds[4] = fnPartition(octantBounds[0], octantBounds[8], 2);
+        for (int z = 0; z < 8; z += 4) {
+            octantBounds[z + 2] = fnPartition(octantBounds[z], octantBounds[z + 4], 1);
+            for (int y = z; y < z + 4; y += 2)
+                octantBounds[y + 1] = fnPartition(octantBounds[y], octantBounds[y + 2], 0);
+        }
+
+        struct Child {
+            int octant;
+            int nodeIndex;
+        };
+        std::vector<Child> vecChild;
+        for (int octant = 0; octant < 8; ++octant) {
+            if (octantBounds[octant] < octantBounds[octant + 1]) {
+                const int iChild = this->newNode();
+                node.children[octant] = iChild;
+                vecChild.push_back({ octant, iChild });
+            }
+        }
+
+        this->setNode(iNode, node);
+        const bool isSmall = end - begin < (size_t(1) << 20);
+        OSD_Parallel::For(0, int(vecChild.size()), [&](int i) {
+            const Child& child = vecChild.at(i);
+            const gp_XYZ childMin = cubeMin + gp_XYZ(
+                        (child.octant & 1) ? halfSize : 0.,
+                        (child.octant & 2) ? halfSize : 0.,
+                        (child.octant & 4) ? halfSize : 0.
+            );
+            this->buildNode(
+                        child.nodeIndex,
+                        octantBounds[child.octant], octantBounds[child.octant + 1],
+                        childMin, halfSize, level + 1
+            );
+        }, isSmall || vecChild.size() < 2/*isForceSingleThreadExecution*/);
+    }
+
+    void setNode(int iNode, const Node& node)
+    {
+        std::lock_guard<std::mutex> lock(m_mutexNode);
+        m_vecNode.at(iNode) = node;
+    }
+
+    // Points are stored as float coordinates followed by RGBA colors if any
+    void writeNodePoints(Node* node, size_t begin, size_t end)
+    {
+        const size_t count = end - begin;
+        std::vector<float> vecCoord;
+        vecCoord.reserve(3 * count);
+        std::vector<Graphic3d_Vec4ub> vecColor;
+        vecColor.reserve(m_hasColors ? count : 0);
+        for (size_t i = begin; i < end; ++i) {
+            const uint32_t index = m_vecIndex.at(i);
+            const gp_Pnt pnt = this->point(index);
+            vecCoord.push_back(float(pnt.X()));
+            vecCoord.push_back(float(pnt.Y()));
+            vecCoord.push_back(float(pnt.Z()));
+            if (m_hasColors) {
+                Graphic3d_Vec4ub color;
+                m_points->VertexColor(int(index) + 1, color);
+                vecColor.push_back(color);
+            }
+        }
+
+        node->pointCount = uint32_t(count);
+        {
+            std::lock_guard<std::mutex> lock(m_mutexFile);
+            node->pointsOffset = uint64_t(m_ostr.tellp());
+            m_ostr.write(reinterpret_cast<const char*>(vecCoord.data()), vecCoord.size() * sizeof(float));
+            m_ostr.write(reinterpret_cast<const char*>(vecColor.data()), vecColor.size() * sizeof(Graphic3d_Vec4ub));
+            if (!m_ostr.good())
+                m_hasError = true;
+        }
+
+        // Nodes are built concurrently, progress is reported in the thread calling build()
+        m_progressCounter.add(int64_t(count));
+    }
+
+    OccHandle<Graphic3d_ArrayOfPoints> m_points;
+    bool m_hasColors = false;
+    std::vector<uint32_t> m_vecIndex;
+    std::vector<Node> m_vecNode;
+    std::mutex m_mutexNode;
+    std::ostream& m_ostr;
+    std::mutex m_mutexFile;
+    std::atomic<bool> m_hasError = false;
+    TaskProgress* m_progress = nullptr;
+    TaskProgressCounter m_progressCounter;
+};
+
+} // namespace
+
+PointCloudOctree::~PointCloudOctree()
+{
+    std::lock_guard<std::mutex> lock(openFilesMutex());
+    openFiles().erase(m_filepath.u8string());
+}
+
+std::shared_ptr<PointCloudOctree> PointCloudOctree::build(
+        const OccHandle<Graphic3d_ArrayOfPoints>& points, const FilePath& filepath, TaskProgress* progress)
+{
+    if (!points || points->VertexNumber() <= 0)
+        return {};
+
+    std::error_code ec;
+    if (filepath.has_parent_path())
+        std_filesystem::create_directories(filepath.parent_path(), ec);
+
+    // Temporary file is renamed once complete, so partially written files are never opened
+    FilePath filepathTmp = filepath;
+    filepathTmp += ".tmp";
+    {
+        std::ofstream ostr(filepathTmp, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!ostr.is_open())
+            return {};
+
+        // Header, offset of the node table is written once known
+        ostr.write(octreeFileMagic, sizeof(octreeFileMagic) - 1);
+        writeValue<uint32_t>(ostr, octreeFileVersion);
+        writeValue<uint64_t>(ostr, uint64_t(points->VertexNumber()));
+        writeValue<uint8_t>(ostr, points->HasVertexColors() ? 1 : 0);
+        const auto posNodeTableOffset = ostr.tellp();
+        writeValue<uint64_t>(ostr, 0);
+
+        OctreeBuilder builder(points, ostr, progress);
+        const bool okBuild = builder.build();
+        const auto nodeTableOffset = uint64_t(ostr.tellp());
+        writeValue<uint32_t>(ostr, uint32_t(builder.nodes().size()));
+        for (const Node& node : builder.nodes()) {
+            writeXYZ(ostr, node.cornerMin);
+            writeXYZ(ostr, node.cornerMax);
+            writeValue<double>(ostr, node.spacing);
+            writeValue<int32_t>(ostr, node.level);
+            for (int child : node.children)
+                writeValue<int32_t>(ostr, child);
+
+            writeValue<uint32_t>(ostr, node.pointCount);
+            writeValue<uint64_t>(ostr, node.pointsOffset);
+        }
+
+        ostr.seekp(posNodeTableOffset);
+        writeValue<uint64_t>(ostr, nodeTableOffset);
+        if (!okBuild || !ostr.good()) {
+            ostr.close();
+            std_filesystem::remove(filepathTmp, ec);
+            return {};
+        }
+    }
+
+    std_filesystem::rename(filepathTmp, filepath, ec);
+    if (ec) {
+        std_filesystem::remove(filepathTmp, ec);
+        return {};
+    }
+
+    return PointCloudOctree::open(filepath);
+}
+
+std::shared_ptr<PointCloudOctree> PointCloudOctree::open(const FilePath& filepath)
+{
+    std::shared_ptr<PointCloudOctree> octree(new PointCloudOctree);
+    std::ifstream& istr = octree->m_file;
+    istr.open(filepath, std::ios::in | std::ios::binary);
+    if (!istr.is_open())
+        return {};
+
+    char magic[sizeof(octreeFileMagic) - 1] = {};
+    istr.read(magic, sizeof(magic));
+    if (!std::equal(std::begin(magic), std::end(magic), octreeFileMagic))
+        return {};
+
+    if (readValue<uint32_t>(istr) != octreeFileVersion)
+        return {};
+
+    octree->m_pointCount = readValue<uint64_t>(istr);
+    octree->m_hasColors = readValue<uint8_t>(istr) != 0;
+    const auto nodeTableOffset = readValue<uint64_t>(istr);
+    istr.seekg(nodeTableOffset);
+    const auto nodeCount = readValue<uint32_t>(istr);
+    if (!istr || nodeCount == 0)
+        return {};
+
+    octree->m_vecNode.resize(nodeCount);
+    for (Node& node : octree->m_vecNode) {
+        node.cornerMin = readXYZ(istr);
+        node.cornerMax = readXYZ(istr);
+        node.spacing = readValue<double>(istr);
+        node.level = readValue<int32_t>(istr);
+        for (int& child : node.children) {
+            child = readValue<int32_t>(istr);
+            if (child >= int(nodeCount))
+                return {};
+        }
+
+        node.pointCount = readValue<uint32_t>(istr);
+        node.pointsOffset = readValue<uint64_t>(istr);
+    }
+
+    if (!istr)
+        return {};
+
+    octree->m_filepath = filepath;
+    {
+        std::lock_guard<std::mutex> lock(openFilesMutex());
+        openFiles().insert(filepath.u8string());
+    }
+
+    // Mark octree file as recently used
+    std::error_code ec;
+    std_filesystem::last_write_time(filepath, std_filesystem::file_time_type::clock::now(), ec);
+    return octree;
+}
+
+std::string PointCloudOctree::computeKey(const OccHandle<Graphic3d_ArrayOfPoints>& points)
+{
+    // FNV-1a hash
+    auto fnHash = [](uint64_t* ptrHash, const void* data, size_t size) {
+        for (size_t i = 0; i < size; ++i)
+            *ptrHash = (*ptrHash ^ static_cast<const uint8_t*>(data)[i]) * 1099511628211ull;
+    };
+    constexpr uint64_t hashInit = 14695981039346656037ull;
+
+    const int count = points ? points->VertexNumber() : 0;
+    const bool hasColors = points && points->HasVertexColors();
+    uint64_t hash = hashInit;
+    fnHash(&hash, &octreeFileVersion, sizeof(octreeFileVersion));
+    fnHash(&hash, &count, sizeof(count));
+    fnHash(&hash, &hasColors, sizeof(hasColors));
+
+    // All the points are hashed, so point clouds differing by a single point get different keys
+    // Chunks of points are hashed in parallel, then chunk hashes are combined in order
+    constexpr int chunkSize = 1 << 20;
+    const int chunkCount = (count + chunkSize - 1) / chunkSize;
+    std::vector<uint64_t> vecChunkHash(chunkCount, hashInit);
+    OSD_Parallel::For(0, chunkCount, [&](int iChunk) {
+        uint64_t& chunkHash = vecChunkHash.at(iChunk);
+        const int iEnd = std::min(count, (iChunk + 1) * chunkSize);
+        for (int i = iChunk * chunkSize + 1; i <= iEnd; ++i) {
+            const gp_Pnt pnt = points->Vertice(i);
+            const float coords[] = { float(pnt.X()), float(pnt.Y()), float(pnt.Z()) };
+            fnHash(&chunkHash, coords, sizeof(coords));
+            if (hasColors) {
+                Graphic3d_Vec4ub color;
+                points->VertexColor(i, color);
+                fnHash(&chunkHash, color.GetData(), 4);
+            }
+        }
+    }, chunkCount < 2/*isForceSingleThreadExecution*/);
+
+    for (uint64_t chunkHash : vecChunkHash)
+        fnHash(&hash, &chunkHash, sizeof(chunkHash));
+
+    return fmt::format("{:016x}", hash);
+}
+
+void PointCloudOctree::evictFiles(const FilePath& dirPath, uint64_t maxSize)
+{
+    struct OctreeFile {
+        FilePath filepath;
+        uint64_t size;
+        std_filesystem::file_time_type lastUseTime;
+    };
+
+    std::vector<OctreeFile> vecOctreeFile;
+    uint64_t totalSize = 0;
+    std::error_code ec;
+    for (const auto& entry : std_filesystem::directory_iterator(dirPath, ec)) {
+        if (entry.path().extension().u8string() != PointCloudOctree::fileExtension())
+            continue;
+
+        const OctreeFile octreeFile{
+            entry.path(), filepathFileSize(entry.path()), filepathLastWriteTime(entry.path())
+        };
+        totalSize += octreeFile.size;
+        vecOctreeFile.push_back(octreeFile);
+    }
+
+    if (totalSize <= maxSize)
+        return;
+
+    std::sort(vecOctreeFile.begin(), vecOctreeFile.end(), [](const OctreeFile& lhs, const OctreeFile& rhs) {
+        return lhs.lastUseTime < rhs.lastUseTime;
+    });
+    std::lock_guard<std::mutex> lock(openFilesMutex());
+    for (const OctreeFile& octreeFile : vecOctreeFile) {
+        if (totalSize <= maxSize)
+            break;
+
+        if (openFiles().find(octreeFile.filepath.u8string()) != openFiles().cend())
+            continue;
+
+        if (std_filesystem::remove(octreeFile.filepath, ec))
+            totalSize -= octreeFile.size;
+    }
+}
+
+Bnd_Box PointCloudOctree::boundingBox() const
+{
+    Bnd_Box bndBox;
+    if (!m_vecNode.empty()) {
+        bndBox.Update(
+                    m_vecNode.front().cornerMin.X(), m_vecNode.front().cornerMin.Y(), m_vecNode.front().cornerMin.Z(),
+                    m_vecNode.front().cornerMax.X(), m_vecNode.front().cornerMax.Y(), m_vecNode.front().cornerMax.Z()
+        );
+    }
+
+    return bndBox;
+}
+
+OccHandle<Graphic3d_ArrayOfPoints> PointCloudOctree::readNodePoints(int index) const
+{
+    const Node& node = m_vecNode.at(index);
+    std::vector<Graphic3d_Vec3> vecCoords(node.pointCount);
+    std::vector<Graphic3d_Vec4ub> vecColor(m_hasColors ? node.pointCount : 0);
+    {
+        std::lock_guard<std::mutex> lock(m_fileMutex);
+        m_file.clear();
+        m_file.seekg(node.pointsOffset);
+        m_file.read(reinterpret_cast<char*>(vecCoords.data()), vecCoords.size() * sizeof(Graphic3d_Vec3));
+        m_file.read(reinterpret_cast<char*>(vecColor.data()), vecColor.size() * sizeof(Graphic3d_Vec4ub));
+        if (!m_file)
+            return {};
+    }
+
+    OccHandle<Graphic3d_ArrayOfPoints> points =
+            new Graphic3d_ArrayOfPoints(int(node.pointCount), m_hasColors, false/*hasNormals*/);
+    for (uint32_t i = 0; i < node.pointCount; ++i) {
+        const int rank = points->AddVertex(vecCoords.at(i));
+        if (m_hasColors)
+            points->SetVertexColor(rank, vecColor.at(i));
+    }
+
+    return points;
+}
+
+OccHandle<Graphic3d_ArrayOfPoints> PointCloudOctree::readAllPoints() const
+{
+    OccHandle<Graphic3d_ArrayOfPoints> points =
+            new Graphic3d_ArrayOfPoints(int(m_pointCount), m_hasColors, false/*hasNormals*/);
+    for (int i = 0; i < this->nodeCount(); ++i) {
+        const OccHandle<Graphic3d_ArrayOfPoints> nodePoints = this->readNodePoints(i);
+        if (!nodePoints)
+            return {};
+
+        for (int j = 1; j <= nodePoints->VertexNumber(); ++j) {
+            const int rank = points->AddVertex(nodePoints->Vertice(j));
+            if (m_hasColors) {
+                Graphic3d_Vec4ub color;
+                nodePoints->VertexColor(j, color);
+                points->SetVertexColor(rank, color);
+            }
+        }
+    }
+
+    return points;
+}
+
+} // namespace Mayo
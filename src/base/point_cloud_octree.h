@@ -0,0 +1,100 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "filepath.h"
+#include "occ_handle.h"
+
+#include <Bnd_Box.hxx>
+#include <Graphic3d_ArrayOfPoints.hxx>
+#include <gp_XYZ.hxx>
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Mayo {
+
+class TaskProgress;
+
+// Provides a multi-resolution octree of a point cloud, stored in a file so the points can be
+// streamed instead of being kept in memory
+// Each node holds a subsample of the points of its cube, spatially uniform with a spacing of
+// 'cube size / GridSize': points of a node aren't repeated in its children. Drawing a node and all
+// its ancestors gives a view of the node cube whose density increases with the depth of the node
+// The node table is kept in memory, points of a node are read on demand(see readNodePoints())
+class PointCloudOctree {
+public:
+    // Resolution of the grid subsampling the points of a node cube
+    static constexpr int GridSize = 128;
+    // Nodes having at most this count of points aren't subdivided
+    static constexpr int MaxNodePointCount = 1 << 16;
+    static constexpr int MaxDepth = 20;
+
+    struct Node {
+        gp_XYZ cornerMin; // Bounding box of the points of the node subtree
+        gp_XYZ cornerMax;
+        double spacing = 0.; // Minimum distance between the points of the node and of its ancestors
+        int level = 0;
+        int children[8] = { -1, -1, -1, -1, -1, -1, -1, -1 };
+        uint32_t pointCount = 0;
+        uint64_t pointsOffset = 0; // Position of the points in the octree file
+    };
+
+    ~PointCloudOctree();
+
+    // Builds the octree of 'points' into file 'filepath'
+    // Nodes are built in parallel. Returns null on error or if building was aborted
+    static std::shared_ptr<PointCloudOctree> build(
+            const OccHandle<Graphic3d_ArrayOfPoints>& points, const FilePath& filepath, TaskProgress* progress = nullptr
+    );
+
+    // Opens an octree file previously written by build(). Returns null if the file is invalid
+    static std::shared_ptr<PointCloudOctree> open(const FilePath& filepath);
+
+    // Returns a key identifying 'points', computed from all the points and their colors
+    // Suitable to name the octree file of 'points' in a cache directory
+    static std::string computeKey(const OccHandle<Graphic3d_ArrayOfPoints>& points);
+
+    // Removes least recently used octree files in 'dirPath' until their total size is not greater
+    // than 'maxSize'. Files of the octrees currently open are never removed
+    static void evictFiles(const FilePath& dirPath, uint64_t maxSize);
+
+    // File extension of the octree files
+    static const char* fileExtension() { return ".pcoctree"; }
+
+    const FilePath& filepath() const { return m_filepath; }
+    uint64_t pointCount() const { return m_pointCount; }
+    bool hasColors() const { return m_hasColors; }
+    Bnd_Box boundingBox() const;
+
+    // Node at index zero is the root
+    int nodeCount() const { return int(m_vecNode.size()); }
+    const Node& node(int index) const { return m_vecNode.at(index); }
+
+    // Reads the points of node 'index' from the octree file. Can be called from any thread
+    // Returns null on error
+    OccHandle<Graphic3d_ArrayOfPoints> readNodePoints(int index) const;
+
+    // Reads all the points of the octree, typically for export
+    OccHandle<Graphic3d_ArrayOfPoints> readAllPoints() const;
+
+private:
+    PointCloudOctree() = default;
+
+    FilePath m_filepath;
+    uint64_t m_pointCount = 0;
+    bool m_hasColors = false;
+    std::vector<Node> m_vecNode;
+    mutable std::ifstream m_file;
+    mutable std::mutex m_fileMutex;
+};
+
+} // namespace Mayo
@@ -6,6 +6,7 @@
 
 #include "task_progress.h"
 #include "task_manager.h"
+#include "math_utils.h"
 
 #include <algorithm>
 #include <cmath>
@@ -86,4 +87,24 @@ void TaskProgress::requestAbort()
         m_isAbortRequested = true;
 }
 
+TaskProgressCounter::TaskProgressCounter(TaskProgress* progress, int64_t itemCount)
+    : m_progress(progress),
+      m_itemCount(itemCount),
+      m_threadId(std::this_thread::get_id())
+{
+}
+
+void TaskProgressCounter::add(int64_t count)
+{
+    const int64_t processedCount = m_processedCount += count;
+    if (m_progress && std::this_thread::get_id() == m_threadId)
+        m_progress->setValue(MathUtils::toPercent(processedCount, 0, m_itemCount));
+}
+
+void TaskProgressCounter::flush()
+{
+    if (m_progress)
+        m_progress->setValue(MathUtils::toPercent(m_processedCount.load(), 0, m_itemCount));
+}
+
 } // namespace Mayo
@@ -8,8 +8,10 @@
 
 #include "task_common.h"
 #include <atomic>
+#include <cstdint>
 #include <string>
 #include <string_view>
+#include <thread>
 
 namespace Mayo {
 
@@ -65,4 +67,26 @@ private:
     bool m_isAbortRequested = false;
 };
 
+// Provides progress feedback of a task made of items processed concurrently(eg with OSD_Parallel)
+// Processed items can be counted from any thread, but the TaskProgress object isn't thread-safe so
+// it's updated only from the thread having created the counter. That thread is expected to take
+// part in the processing, which is the case of OSD_Parallel::For() calling thread
+class TaskProgressCounter {
+public:
+    TaskProgressCounter(TaskProgress* progress, int64_t itemCount);
+
+    // Adds 'count' processed items, can be called from any thread
+    void add(int64_t count = 1);
+
+    // Updates progress with the count of items processed so far, regardless of the calling thread
+    // Must not be called concurrently with add()
+    void flush();
+
+private:
+    TaskProgress* m_progress = nullptr;
+    int64_t m_itemCount = 0;
+    std::atomic<int64_t> m_processedCount = 0;
+    std::thread::id m_threadId;
+};
+
 } // namespace Mayo
@@ -0,0 +1,364 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "tessellation_stats.h"
+
+#include "brep_utils.h"
+#include "caf_utils.h"
+#include "cpp_utils.h"
+#include "document.h"
+#include "meta_enum.h"
+#include "string_conv.h"
+#include "task_progress.h"
+#include "xcaf.h"
+
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRepTools.hxx>
+#include <BRep_Tool.hxx>
+#include <GeomAdaptor_Surface.hxx>
+#include <OSD_Parallel.hxx>
+#include <Precision.hxx>
+#include <TopoDS_TShape.hxx>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Mayo {
+
+namespace {
+
+std::string faceTypeName(const TopoDS_Face& face)
+{
+    if (!BRepUtils::isGeometric(face))
+        return "Triangulation";
+
+    const GeomAdaptor_Surface surface(BRep_Tool::Surface(face));
+    return std::string(MetaEnum::nameWithoutPrefix(surface.GetType(), "GeomAbs_"));
+}
+
+uint64_t triangulationMemorySize(const Handle(Poly_Triangulation)& triangulation)
+{
+    const auto nodeCount = uint64_t(triangulation->NbNodes());
+    uint64_t size = nodeCount * sizeof(gp_Pnt);
+    size += uint64_t(triangulation->NbTriangles()) * sizeof(Poly_Triangle);
+    if (triangulation->HasUVNodes())
+        size += nodeCount * sizeof(gp_Pnt2d);
+
+    if (triangulation->HasNormals())
+        size += nodeCount * 3 * sizeof(float);
+
+    return size;
+}
+
+std::string jsonEscaped(std::string_view str)
+{
+    std::string strEscaped;
+    strEscaped.reserve(str.size());
+    for (char c : str) {
+        switch (c) {
+        case '"': strEscaped += "\\\""; break;
+        case '\\': strEscaped += "\\\\"; break;
+        case '\n': strEscaped += "\\n"; break;
+        case '\r': strEscaped += "\\r"; break;
+        case '\t': strEscaped += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                std::ostringstream oss;
+                oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c);
+                strEscaped += oss.str();
+            }
+            else {
+                strEscaped += c;
+            }
+        }
+    }
+
+    return strEscaped;
+}
+
+std::string csvEscaped(std::string_view str)
+{
+    if (str.find_first_of(",\"\n\r") == std::string_view::npos)
+        return std::string(str);
+
+    std::string strEscaped = "\"";
+    for (char c : str) {
+        if (c == '"')
+            strEscaped += '"';
+
+        strEscaped += c;
+    }
+
+    strEscaped += '"';
+    return strEscaped;
+}
+
+} // namespace
+
+void TessellationStats::Counters::add(const Counters& other)
+{
+    this->faceCount += other.faceCount;
+    this->meshedFaceCount += other.meshedFaceCount;
+    this->triangleCount += other.triangleCount;
+    this->nodeCount += other.nodeCount;
+    this->memorySize += other.memorySize;
+    if (other.meshingTime >= 0)
+        this->meshingTime = std::max(this->meshingTime, 0.) + other.meshingTime;
+}
+
+TessellationStats TessellationStats::compute(
+        const DocumentPtr& doc, const MeshingFunction& fnMeshing, TaskProgress* progress)
+{
+    TessellationStats stats;
+    if (doc.IsNull())
+        return stats;
+
+    // Collect the products(ie non-assembly shapes) along with their count of instances and layers
+    struct ProductData {
+        TDF_Label label;
+        std::set<std::string> setLayer;
+    };
+    std::vector<ProductData> vecProductData;
+    std::unordered_map<TDF_Label, int> mapLabelProductIndex;
+    const XCaf& xcaf = doc->xcaf();
+    auto fnAddLayers = [&](const TDF_Label& label, ProductData* data) {
+        for (const TDF_Label& labelLayer : xcaf.layers(label))
+            data->setLayer.insert(to_stdString(xcaf.layerName(labelLayer)));
+    };
+    std::function<void(const TDF_Label&, const TDF_Label&)> fnAddShape;
+    fnAddShape = [&](const TDF_Label& labelShape, const TDF_Label& labelInstance) {
+        if (XCaf::isShapeAssembly(labelShape)) {
+            for (const TDF_Label& labelComponent : XCaf::shapeComponents(labelShape))
+                fnAddShape(XCaf::shapeReferred(labelComponent), labelComponent);
+
+            return;
+        }
+
+        auto [it, isNewProduct] = mapLabelProductIndex.insert({ labelShape, int(vecProductData.size()) });
+        if (isNewProduct) {
+            vecProductData.push_back({ labelShape, {} });
+            stats.m_vecProduct.push_back({ to_stdString(CafUtils::labelAttrStdName(labelShape)), 0, {} });
+            fnAddLayers(labelShape, &vecProductData.back());
+        }
+
+        ++(stats.m_vecProduct.at(it->second).instanceCount);
+        if (!labelInstance.IsNull())
+            fnAddLayers(labelInstance, &vecProductData.at(it->second));
+    };
+    for (int i = 0; i < doc->entityCount(); ++i) {
+        const TDF_Label labelEntity = doc->entityLabel(i);
+        if (XCaf::isShape(labelEntity))
+            fnAddShape(labelEntity, TDF_Label());
+    }
+
+    // Compute counters of each product, faces shared between products are counted for each of them
+    // Products are processed in parallel as the ones not meshed yet are meshed to be reported
+    const int productCount = CppUtils::safeStaticCast<int>(vecProductData.size());
+    std::vector<TopoDS_Shape> vecProductShape;
+    vecProductShape.reserve(productCount);
+    for (const ProductData& data : vecProductData)
+        vecProductShape.push_back(XCaf::shape(data.label));
+
+    std::vector<std::map<std::string, Counters>> vecProductFaceTypeCounters(productCount);
+    TaskProgressCounter progressCounter(progress, productCount);
+    OSD_Parallel::For(0, productCount, [&](int i) {
+        if (TaskProgress::isAbortRequested(progress))
+            return;
+
+        TopoDS_Shape shape = vecProductShape.at(i);
+        Counters& productCounters = stats.m_vecProduct.at(i).counters;
+        if (fnMeshing && !BRepTools::Triangulation(shape, Precision::Infinite())) {
+            // Mesh a copy so the document is left untouched
+            constexpr bool copyGeom = false;
+            constexpr bool copyMesh = false;
+            shape = BRepBuilderAPI_Copy(shape, copyGeom, copyMesh).Shape();
+            const auto timeStart = std::chrono::steady_clock::now();
+            fnMeshing(shape);
+            const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - timeStart;
+            productCounters.meshingTime = duration.count();
+        }
+
+        std::unordered_set<const TopoDS_TShape*> setVisitedTFace;
+        BRepUtils::forEachSubFace(shape, [&](const TopoDS_Face& face) {
+            if (!setVisitedTFace.insert(face.TShape().get()).second)
+                return;
+
+            Counters faceCounters;
+            faceCounters.faceCount = 1;
+            TopLoc_Location locFace;
+            const Handle(Poly_Triangulation)& triangulation = BRep_Tool::Triangulation(face, locFace);
+            if (!triangulation.IsNull()) {
+                faceCounters.meshedFaceCount = 1;
+                faceCounters.triangleCount = triangulation->NbTriangles();
+                faceCounters.nodeCount = triangulation->NbNodes();
+                faceCounters.memorySize = triangulationMemorySize(triangulation);
+            }
+
+            productCounters.add(faceCounters);
+            vecProductFaceTypeCounters.at(i)[faceTypeName(face)].add(faceCounters);
+        });
+
+        progressCounter.add();
+    }, productCount < 2/*isForceSingleThreadExecution*/);
+    progressCounter.flush();
+
+    std::map<std::string, Counters> mapFaceTypeCounters;
+    std::map<std::string, Counters> mapLayerCounters;
+    for (int i = 0; i < productCount; ++i) {
+        const Counters& productCounters = stats.m_vecProduct.at(i).counters;
+        for (const auto& [name, counters] : vecProductFaceTypeCounters.at(i))
+            mapFaceTypeCounters[name].add(counters);
+
+        for (const std::string& layer : vecProductData.at(i).setLayer)
+            mapLayerCounters[layer].add(productCounters);
+
+        stats.m_total.add(productCounters);
+    }
+
+    for (const auto& [name, counters] : mapFaceTypeCounters)
+        stats.m_vecFaceType.push_back({ name, counters });
+
+    for (const auto& [name, counters] : mapLayerCounters)
+        stats.m_vecLayer.push_back({ name, counters });
+
+    return stats;
+}
+
+int64_t TessellationStats::instancedTriangleCount() const
+{
+    int64_t count = 0;
+    for (const ProductStats& product : m_vecProduct)
+        count += product.instanceCount * product.counters.triangleCount;
+
+    return count;
+}
+
+void TessellationStats::write(std::ostream& ostr, Format format) const
+{
+    switch (format) {
+    case Format::Csv: this->writeCsv(ostr); break;
+    case Format::Json: this->writeJson(ostr); break;
+    }
+}
+
+std::string TessellationStats::toString(Format format) const
+{
+    std::ostringstream oss;
+    this->write(oss, format);
+    return oss.str();
+}
+
+bool TessellationStats::formatFromFilePath(std::string_view filepath, Format* format)
+{
+    auto fnEndsWith = [=](std::string_view suffix) {
+        if (filepath.size() < suffix.size())
+            return false;
+
+        const std::string_view strEnd = filepath.substr(filepath.size() - suffix.size());
+        return std::equal(strEnd.cbegin(), strEnd.cend(), suffix.cbegin(), [](char lhs, char rhs) {
+            return std::tolower(static_cast<unsigned char>(lhs)) == rhs;
+        });
+    };
+
+    if (fnEndsWith(".csv")) {
+        *format = Format::Csv;
+        return true;
+    }
+
+    if (fnEndsWith(".json")) {
+        *format = Format::Json;
+        return true;
+    }
+
+    return false;
+}
+
+void TessellationStats::writeCsv(std::ostream& ostr) const
+{
+    ostr << "category,name,instances,faces,meshed_faces,triangles,nodes,memory_bytes,meshing_time_ms\n";
+    auto fnWriteRow = [&](std::string_view category, std::string_view name, int instanceCount, const Counters& counters) {
+        ostr << category << ',' << csvEscaped(name) << ',';
+        if (instanceCount >= 0)
+            ostr << instanceCount;
+
+        ostr << ',' << counters.faceCount
+             << ',' << counters.meshedFaceCount
+             << ',' << counters.triangleCount
+             << ',' << counters.nodeCount
+             << ',' << counters.memorySize
+             << ',';
+        if (counters.meshingTime >= 0)
+            ostr << counters.meshingTime;
+
+        ostr << '\n';
+    };
+
+    for (const ProductStats& product : m_vecProduct)
+        fnWriteRow("product", product.name, product.instanceCount, product.counters);
+
+    for (const GroupStats& faceType : m_vecFaceType)
+        fnWriteRow("face_type", faceType.name, -1, faceType.counters);
+
+    for (const GroupStats& layer : m_vecLayer)
+        fnWriteRow("layer", layer.name, -1, layer.counters);
+
+    fnWriteRow("total", "", -1, m_total);
+}
+
+void TessellationStats::writeJson(std::ostream& ostr) const
+{
+    auto fnCountersToJson = [](const Counters& counters) {
+        std::ostringstream oss;
+        oss << "\"faces\": " << counters.faceCount
+            << ", \"meshedFaces\": " << counters.meshedFaceCount
+            << ", \"triangles\": " << counters.triangleCount
+            << ", \"nodes\": " << counters.nodeCount
+            << ", \"memoryBytes\": " << counters.memorySize;
+        if (counters.meshingTime >= 0)
+            oss << ", \"meshingTimeMs\": " << counters.meshingTime;
+
+        return oss.str();
+    };
+
+    auto fnWriteGroups = [&](std::string_view key, Span<const GroupStats> spanGroup) {
+        ostr << "  \"" << key << "\": [";
+        for (const GroupStats& group : spanGroup) {
+            ostr << (&group != &spanGroup.front() ? ",\n" : "\n");
+            ostr << "    { \"name\": \"" << jsonEscaped(group.name) << "\", "
+                 << fnCountersToJson(group.counters) << " }";
+        }
+
+        ostr << (!spanGroup.empty() ? "\n  ]" : "]");
+    };
+
+    ostr << "{\n";
+    ostr << "  \"products\": [";
+    for (const ProductStats& product : m_vecProduct) {
+        ostr << (&product != &m_vecProduct.front() ? ",\n" : "\n");
+        ostr << "    { \"name\": \"" << jsonEscaped(product.name) << "\", "
+             << "\"instances\": " << product.instanceCount << ", "
+             << fnCountersToJson(product.counters) << " }";
+    }
+
+    ostr << (!m_vecProduct.empty() ? "\n  ],\n" : "],\n");
+    fnWriteGroups("faceTypes", m_vecFaceType);
+    ostr << ",\n";
+    fnWriteGroups("layers", m_vecLayer);
+    ostr << ",\n";
+    ostr << "  \"total\": { " << fnCountersToJson(m_total)
+         << ", \"instancedTriangles\": " << this->instancedTriangleCount() << " }\n";
+    ostr << "}\n";
+}
+
+} // namespace Mayo
@@ -0,0 +1,97 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "document_ptr.h"
+#include "span.h"
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class TopoDS_Shape;
+
+namespace Mayo {
+
+class TaskProgress;
+
+// Provides statistics about the triangulations(ie tessellation) of the BRep shapes in a document
+// Statistics are aggregated per product(part referred by assembly instances), per face surface
+// type(plane, cylinder, bspline, ...) and per layer
+// Triangulations are counted once per product whatever the count of its instances, see
+// ProductStats::instanceCount to get the count of triangles actually rendered
+class TessellationStats {
+public:
+    struct Counters {
+        int faceCount = 0;
+        int meshedFaceCount = 0; // Faces having a triangulation
+        int64_t triangleCount = 0;
+        int64_t nodeCount = 0;
+        uint64_t memorySize = 0; // Approximate size in bytes of the triangulation data
+        double meshingTime = -1; // In milliseconds, negative if not measured
+
+        void add(const Counters& other);
+    };
+
+    struct ProductStats {
+        std::string name;
+        int instanceCount = 0;
+        Counters counters;
+    };
+
+    struct GroupStats {
+        std::string name;
+        Counters counters;
+    };
+
+    // Meshing function used for products not meshed yet
+    // It's called on a copy of the product shape, the copy having no triangulation
+    // Calls might be concurrent
+    using MeshingFunction = std::function<void(const TopoDS_Shape&)>;
+
+    // Walks the entities of 'doc' and collects statistics of the current triangulations
+    // If 'fnMeshing' is not null then products not meshed yet are meshed(on a copy, 'doc' is left
+    // untouched) and reported with their meshing time. Meshing time of other products isn't measured
+    static TessellationStats compute(
+            const DocumentPtr& doc,
+            const MeshingFunction& fnMeshing = {},
+            TaskProgress* progress = nullptr
+    );
+
+    Span<const ProductStats> products() const { return m_vecProduct; }
+    Span<const GroupStats> faceTypes() const { return m_vecFaceType; }
+    Span<const GroupStats> layers() const { return m_vecLayer; }
+
+    // Sum of product counters, so triangulations are counted once per product
+    const Counters& total() const { return m_total; }
+
+    // Count of triangles when all product instances are considered
+    int64_t instancedTriangleCount() const;
+
+    // Export
+    enum class Format { Csv, Json };
+    void write(std::ostream& ostr, Format format) const;
+    std::string toString(Format format) const;
+
+    // Returns the export format matching file suffix of 'filepath'(".csv" or ".json")
+    // Returns false if suffix isn't recognized
+    static bool formatFromFilePath(std::string_view filepath, Format* format);
+
+private:
+    void writeCsv(std::ostream& ostr) const;
+    void writeJson(std::ostream& ostr) const;
+
+    std::vector<ProductStats> m_vecProduct;
+    std::vector<GroupStats> m_vecFaceType;
+    std::vector<GroupStats> m_vecLayer;
+    Counters m_total;
+};
+
+} // namespace Mayo
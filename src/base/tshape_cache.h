@@ -0,0 +1,154 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <TopoDS_Shape.hxx>
+#include <TopoDS_TShape.hxx>
+
+#include <algorithm>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace Mayo {
+
+// Provides a thread-safe cache of values computed from BRep shapes, keyed by TShape
+// Shapes sharing the same TShape(eg instances of the same product at different locations) share
+// the same value. Each entry keeps its TShape alive, so a key can't be reused by another TShape
+// Entries of shapes no longer referenced outside the cache are purged from time to time
+template<typename T>
+class TShapeCache {
+public:
+    // Value cached for the TShape of 'shape', if any
+    std::optional<T> find(const TopoDS_Shape& shape) const;
+
+    // Caches 'value' for the TShape of 'shape', replacing any existing value
+    void insert(const TopoDS_Shape& shape, T value);
+
+    // Caches 'value' for the TShape of 'shape' unless a value already exists
+    // Returns the value finally cached
+    T insertIfAbsent(const TopoDS_Shape& shape, T value);
+
+    void erase(const TopoDS_Shape& shape);
+
+    // Removes entries of shapes only referenced by the cache
+    void purge();
+    void clear();
+    int size() const;
+
+private:
+    struct Entry {
+        TopoDS_Shape shape;
+        T value;
+    };
+
+    void purgeIfNeeded();
+    void eraseUnreferencedEntries();
+
+    std::unordered_map<const TopoDS_TShape*, Entry> m_mapEntry;
+    size_t m_purgeThreshold = 1024;
+    mutable std::mutex m_mutex;
+};
+
+
+
+// --
+// -- Implementation
+// --
+
+template<typename T>
+std::optional<T> TShapeCache<T>::find(const TopoDS_Shape& shape) const
+{
+    if (shape.IsNull())
+        return {};
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_mapEntry.find(shape.TShape().get());
+    if (it != m_mapEntry.cend())
+        return it->second.value;
+
+    return {};
+}
+
+template<typename T>
+void TShapeCache<T>::insert(const TopoDS_Shape& shape, T value)
+{
+    if (shape.IsNull())
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    this->purgeIfNeeded();
+    m_mapEntry.insert_or_assign(shape.TShape().get(), Entry{ shape, std::move(value) });
+}
+
+template<typename T>
+T TShapeCache<T>::insertIfAbsent(const TopoDS_Shape& shape, T value)
+{
+    if (shape.IsNull())
+        return value;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    this->purgeIfNeeded();
+    auto itInserted = m_mapEntry.insert({ shape.TShape().get(), Entry{ shape, std::move(value) } }).first;
+    return itInserted->second.value;
+}
+
+template<typename T>
+void TShapeCache<T>::erase(const TopoDS_Shape& shape)
+{
+    if (shape.IsNull())
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mapEntry.erase(shape.TShape().get());
+}
+
+template<typename T>
+void TShapeCache<T>::purge()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    this->eraseUnreferencedEntries();
+}
+
+template<typename T>
+void TShapeCache<T>::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mapEntry.clear();
+}
+
+template<typename T>
+int TShapeCache<T>::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return int(m_mapEntry.size());
+}
+
+template<typename T>
+void TShapeCache<T>::purgeIfNeeded()
+{
+    // Note: m_mutex is locked by the caller
+    if (m_mapEntry.size() < m_purgeThreshold)
+        return;
+
+    this->eraseUnreferencedEntries();
+    m_purgeThreshold = std::max<size_t>(1024, 2 * m_mapEntry.size());
+}
+
+template<typename T>
+void TShapeCache<T>::eraseUnreferencedEntries()
+{
+    // Note: m_mutex is locked by the caller
+    for (auto it = m_mapEntry.begin(); it != m_mapEntry.end(); ) {
+        if (it->second.shape.TShape()->GetRefCount() <= 1)
+            it = m_mapEntry.erase(it);
+        else
+            ++it;
+    }
+}
+
+} // namespace Mayo
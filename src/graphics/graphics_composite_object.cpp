@@ -0,0 +1,315 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "graphics_composite_object.h"
+
+#include "../base/mesh_utils.h"
+#include "../base/xcaf.h"
+
+#include <AIS_DisplayMode.hxx>
+#include <AIS_InteractiveContext.hxx>
+#include <BRep_Tool.hxx>
+#include <Graphic3d_ArrayOfSegments.hxx>
+#include <Graphic3d_MaterialAspect.hxx>
+#include <Select3D_SensitivePrimitiveArray.hxx>
+#include <StdPrs_ShadedShape.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopTools_DataMapOfShapeInteger.hxx>
+#include <TopoDS.hxx>
+#include <XCAFPrs.hxx>
+#include <XCAFPrs_IndexedDataMapOfShapeStyle.hxx>
+
+#include <algorithm>
+#include <numeric>
+
+namespace Mayo {
+
+namespace {
+
+Graphic3d_Vec3 toGraphicVec3(const gp_XYZ& coords)
+{
+    return Graphic3d_Vec3(float(coords.X()), float(coords.Y()), float(coords.Z()));
+}
+
+Graphic3d_Vec4ub toGraphicVec4ub(const Quantity_Color& color)
+{
+    return Graphic3d_Vec4ub(
+                Standard_Byte(color.Red() * 255.),
+                Standard_Byte(color.Green() * 255.),
+                Standard_Byte(color.Blue() * 255.),
+                Standard_Byte(255)
+    );
+}
+
+} // namespace
+
+GraphicsCompositeObject::GraphicsCompositeObject()
+{
+    // Highlighting is specific to each instance, see HilightOwnerWithColor() and HilightSelected()
+    this->SetAutoHilight(false);
+}
+
+int GraphicsCompositeObject::visibleInstanceCount() const
+{
+    return int(std::count_if(m_vecInstance.cbegin(), m_vecInstance.cend(), [](const Instance& instance) {
+        return instance.visible;
+    }));
+}
+
+void GraphicsCompositeObject::setInstanceTransformation(int index, const gp_Trsf& trsf)
+{
+    m_vecInstance.at(index).trsf = trsf;
+    this->invalidateArraysPlacement();
+}
+
+void GraphicsCompositeObject::setInstanceVisible(int index, bool on)
+{
+    Instance& instance = m_vecInstance.at(index);
+    if (instance.visible != on) {
+        instance.visible = on;
+        // Hidden instances are collapsed in place, shown instances might be missing from the arrays
+        if (on)
+            this->invalidateArraysCache();
+        else
+            this->invalidateArraysPlacement();
+    }
+}
+
+bool GraphicsCompositeObject::AcceptDisplayMode(const int mode) const
+{
+    return mode == AIS_WireFrame || mode == AIS_Shaded;
+}
+
+void GraphicsCompositeObject::ComputeSelection(const Handle(SelectMgr_Selection)& sel, const int mode)
+{
+    if (mode != 0)
+        return;
+
+    // Each sensitive entity builds a BVH over the shape triangles placed by the instance location
+    for (int i = 0; i < this->instanceCount(); ++i) {
+        const Instance& instance = m_vecInstance.at(i);
+        if (!instance.visible)
+            continue;
+
+        const OccHandle<Graphic3d_ArrayOfTriangles> triangles = this->instanceSensitiveTriangles(i);
+        if (triangles.IsNull())
+            continue;
+
+        OccHandle<Select3D_SensitivePrimitiveArray> sensitive = new Select3D_SensitivePrimitiveArray(instance.owner);
+        sensitive->InitTriangulation(triangles->Attributes(), triangles->Indices(), TopLoc_Location(instance.trsf));
+        sel->Add(sensitive);
+    }
+}
+
+void GraphicsCompositeObject::HilightSelected(
+        const Handle(PrsMgr_PresentationManager)& pm, const SelectMgr_SequenceOfOwner& seqOwner)
+{
+    if (this->GetContext().IsNull())
+        return;
+
+    std::vector<int> vecInstanceIndex;
+    for (const Handle(SelectMgr_EntityOwner)& owner : seqOwner) {
+        auto instanceOwner = Handle(GraphicsInstanceOwner)::DownCast(owner);
+        if (instanceOwner)
+            vecInstanceIndex.push_back(instanceOwner->instanceIndex());
+    }
+
+    const Handle(Prs3d_Drawer)& style =
+            !this->HilightAttributes().IsNull() ? this->HilightAttributes() : this->GetContext()->SelectionStyle();
+    Handle(Prs3d_Presentation) pres = this->GetSelectPresentation(pm);
+    pres->Clear();
+    this->fillHighlightPresentation(pres, style, vecInstanceIndex);
+    pres->Display();
+}
+
+void GraphicsCompositeObject::HilightOwnerWithColor(
+        const Handle(PrsMgr_PresentationManager)& pm,
+        const Handle(Prs3d_Drawer)& style,
+        const Handle(SelectMgr_EntityOwner)& owner)
+{
+    auto instanceOwner = Handle(GraphicsInstanceOwner)::DownCast(owner);
+    if (!instanceOwner)
+        return;
+
+    const int instanceIndex = instanceOwner->instanceIndex();
+    Handle(Prs3d_Presentation) pres = this->GetHilightPresentation(pm);
+    pres->Clear();
+    this->fillHighlightPresentation(pres, style, Span<const int>(&instanceIndex, 1));
+    if (pm->IsImmediateModeOn())
+        pm->AddToImmediateList(pres);
+    else
+        pres->Display();
+}
+
+void GraphicsCompositeObject::loadShapeTriangles(
+        ShapeTriangles* data, const TDF_Label& label, const TopoDS_Shape& shapeMesh, bool withSensitiveTriangles)
+{
+    *data = {};
+    const TopoDS_Shape shape = XCaf::shape(label);
+    if (shape.IsNull() || shapeMesh.IsNull())
+        return;
+
+    // Styles are applied from the biggest shapes to the smallest ones, so faces get the style of
+    // their most specific sub-shape
+    XCAFPrs_IndexedDataMapOfShapeStyle mapShapeStyle;
+    XCAFPrs::CollectStyleSettings(label, TopLoc_Location(), mapShapeStyle);
+    std::vector<int> vecStyleIndex(mapShapeStyle.Extent());
+    std::iota(vecStyleIndex.begin(), vecStyleIndex.end(), 1);
+    std::stable_sort(vecStyleIndex.begin(), vecStyleIndex.end(), [&](int lhs, int rhs) {
+        return mapShapeStyle.FindKey(lhs).ShapeType() < mapShapeStyle.FindKey(rhs).ShapeType();
+    });
+    TopTools_DataMapOfShapeInteger mapFaceStyleIndex;
+    for (int styleIndex : vecStyleIndex) {
+        for (TopExp_Explorer expl(mapShapeStyle.FindKey(styleIndex), TopAbs_FACE); expl.More(); expl.Next())
+            mapFaceStyleIndex.Bind(expl.Current(), styleIndex);
+    }
+
+    TopExp_Explorer explMesh(shapeMesh, TopAbs_FACE);
+    for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More() && explMesh.More(); expl.Next(), explMesh.Next()) {
+        const TopoDS_Face& face = TopoDS::Face(expl.Current());
+        const TopoDS_Face& faceMesh = TopoDS::Face(explMesh.Current());
+        TopLoc_Location locFace;
+        const OccHandle<Poly_Triangulation>& mesh = BRep_Tool::Triangulation(faceMesh, locFace);
+        if (mesh.IsNull())
+            continue;
+
+        Quantity_Color faceColor = Quantity_NOC_WHITE; // Same default as XCAFPrs_AISObject
+        FaceMaterial faceMaterial;
+        const int* ptrStyleIndex = mapFaceStyleIndex.Seek(face);
+        if (ptrStyleIndex) {
+            const XCAFPrs_Style& style = mapShapeStyle.FindFromIndex(*ptrStyleIndex);
+            if (!style.IsVisible())
+                continue;
+
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+            faceMaterial.visMaterial = style.Material();
+            if (!style.IsSetColorSurf() && faceMaterial.visMaterial) {
+                // Base color of the material applies, as for XCAFPrs_AISObject
+                const Quantity_ColorRGBA materialColor = faceMaterial.visMaterial->BaseColor();
+                faceColor = materialColor.GetRGB();
+                faceMaterial.transparency = 1.f - materialColor.Alpha();
+            }
+#endif
+
+            if (style.IsSetColorSurf()) {
+                faceColor = style.GetColorSurf();
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+                faceMaterial.transparency = 1.f - style.GetColorSurfRGBA().Alpha();
+#endif
+            }
+        }
+
+        auto itMaterial = std::find(data->vecMaterial.cbegin(), data->vecMaterial.cend(), faceMaterial);
+        const int materialIndex = int(itMaterial - data->vecMaterial.cbegin());
+        if (itMaterial == data->vecMaterial.cend())
+            data->vecMaterial.push_back(faceMaterial);
+
+        data->deflection = std::max(data->deflection, mesh->Deflection());
+        const gp_Trsf& trsfFace = locFace.Transformation();
+        const gp_Mat matFaceRotation = trsfFace.HVectorialPart();
+        const bool isFaceReversed = faceMesh.Orientation() == TopAbs_REVERSED;
+        const bool hasMeshNormals = mesh->HasNormals();
+        const std::vector<gp_XYZ> vecMeshNormal = !hasMeshNormals ? MeshUtils::nodeNormals(mesh) : std::vector<gp_XYZ>{};
+        const Graphic3d_Vec4ub color = toGraphicVec4ub(faceColor);
+        const int nodeOffset = int(data->vecNode.size());
+        for (int i = 1; i <= mesh->NbNodes(); ++i) {
+            gp_XYZ normal = hasMeshNormals ? MeshUtils::nodeNormal(mesh, i) : vecMeshNormal.at(i - 1);
+            normal = normal.Multiplied(matFaceRotation);
+            if (isFaceReversed)
+                normal.Reverse();
+
+            data->vecNode.push_back(toGraphicVec3(mesh->Node(i).Transformed(trsfFace).XYZ()));
+            data->vecNormal.push_back(toGraphicVec3(normal));
+            data->vecColor.push_back(color);
+        }
+
+        for (const Poly_Triangle& triangle : MeshUtils::contiguousTriangles(mesh)) {
+            int n1, n2, n3;
+            triangle.Get(n1, n2, n3);
+            if (isFaceReversed)
+                std::swap(n2, n3);
+
+            data->vecIndex.push_back(nodeOffset + n1 - 1);
+            data->vecIndex.push_back(nodeOffset + n2 - 1);
+            data->vecIndex.push_back(nodeOffset + n3 - 1);
+            data->vecTriangleMaterial.push_back(materialIndex);
+        }
+    }
+
+    // Face boundaries, as presented by XCAFPrs_AISObject
+    const OccHandle<Graphic3d_ArrayOfSegments> boundaries = StdPrs_ShadedShape::FillFaceBoundaries(shapeMesh);
+    if (!boundaries.IsNull()) {
+        auto fnAddBoundaryNode = [&](int iVertex) {
+            data->vecBoundaryNode.push_back(toGraphicVec3(boundaries->Vertice(iVertex).XYZ()));
+        };
+        if (boundaries->EdgeNumber() > 0) {
+            for (int i = 1; i <= boundaries->EdgeNumber(); ++i)
+                fnAddBoundaryNode(boundaries->Edge(i));
+        }
+        else {
+            for (int i = 1; i <= boundaries->VertexNumber(); ++i)
+                fnAddBoundaryNode(i);
+        }
+    }
+
+    // Only vertex positions are required by sensitive entities
+    const int nodeCount = int(data->vecNode.size());
+    const int indexCount = int(data->vecIndex.size());
+    if (withSensitiveTriangles && indexCount > 0) {
+        data->triangles = new Graphic3d_ArrayOfTriangles(nodeCount, indexCount, false/*normals*/, false/*colors*/);
+        for (const Graphic3d_Vec3& node : data->vecNode)
+            data->triangles->AddVertex(node.x(), node.y(), node.z());
+
+        for (int index : data->vecIndex)
+            data->triangles->AddEdge(index + 1);
+    }
+}
+
+std::pair<const void*, float> GraphicsCompositeObject::FaceMaterial::key() const
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+    return { this->visMaterial.get(), this->transparency };
+#else
+    return { nullptr, this->transparency };
+#endif
+}
+
+int GraphicsCompositeObject::appendInstance(const TDF_Label& label, const gp_Trsf& trsf)
+{
+    const int index = this->instanceCount();
+    Instance instance;
+    instance.label = label;
+    instance.trsf = trsf;
+    instance.owner = new GraphicsInstanceOwner(this, index);
+    m_vecInstance.push_back(std::move(instance));
+    this->invalidateArraysCache();
+    return index;
+}
+
+void GraphicsCompositeObject::fillHighlightPresentation(
+        const Handle(Prs3d_Presentation)& pres, const Handle(Prs3d_Drawer)& style, Span<const int> spanInstance) const
+{
+    if (spanInstance.empty())
+        return;
+
+    // Flat color, drawn without polygon offset so it covers the shaded triangles of the instances
+    Graphic3d_MaterialAspect material(Graphic3d_NOM_PLASTER);
+    material.SetColor(style->Color());
+    material.SetTransparency(float(style->Transparency()));
+    OccHandle<Graphic3d_AspectFillArea3d> fillAspect = new Graphic3d_AspectFillArea3d;
+    fillAspect->SetInteriorStyle(Aspect_IS_SOLID);
+    fillAspect->SetInteriorColor(style->Color());
+    fillAspect->SetFrontMaterial(material);
+    fillAspect->SetBackMaterial(material);
+    fillAspect->SetShadingModel(Graphic3d_TOSM_UNLIT);
+    fillAspect->SetPolygonOffsets(Aspect_POM_Off);
+    this->addHighlightTriangles(pres, fillAspect, spanInstance);
+
+    const Graphic3d_ZLayerId zlayer = style->ZLayer();
+    pres->SetZLayer(zlayer != Graphic3d_ZLayerId_UNKNOWN ? zlayer : this->ZLayer());
+}
+
+} // namespace Mayo
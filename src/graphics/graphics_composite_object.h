@@ -0,0 +1,176 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/occ_handle.h"
+#include "../base/span.h"
+#include "../base/tkernel_utils.h"
+
+#include <AIS_InteractiveObject.hxx>
+#include <Graphic3d_ArrayOfTriangles.hxx>
+#include <Graphic3d_AspectFillArea3d.hxx>
+#include <Graphic3d_Vec3.hxx>
+#include <Graphic3d_Vec4.hxx>
+#include <Prs3d_Drawer.hxx>
+#include <Prs3d_Presentation.hxx>
+#include <PrsMgr_PresentationManager.hxx>
+#include <SelectMgr_EntityOwner.hxx>
+#include <SelectMgr_Selection.hxx>
+#include <SelectMgr_SequenceOfOwner.hxx>
+#include <TDF_Label.hxx>
+#include <TopoDS_Shape.hxx>
+#include <gp_Trsf.hxx>
+
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+#  include <Prs3d_Projector.hxx>
+#else
+#  include <XCAFDoc_VisMaterial.hxx>
+#endif
+
+#include <utility>
+#include <vector>
+
+namespace Mayo {
+
+// Entity owner identifying an instance of a GraphicsCompositeObject
+class GraphicsInstanceOwner : public SelectMgr_EntityOwner {
+public:
+    GraphicsInstanceOwner(const Handle(SelectMgr_SelectableObject)& object, int instanceIndex)
+        : SelectMgr_EntityOwner(object),
+          m_instanceIndex(instanceIndex)
+    {}
+
+    int instanceIndex() const { return m_instanceIndex; }
+
+    DEFINE_STANDARD_RTTI_INLINE(GraphicsInstanceOwner, SelectMgr_EntityOwner)
+
+private:
+    int m_instanceIndex = -1;
+};
+
+// Base of the graphics objects presenting many placed shapes("instances") with a few draw calls
+// instead of one graphics object per instance
+// Each instance has its own entity owner(see GraphicsInstanceOwner), so instances can be selected
+// and highlighted individually. Highlighting draws the triangles of the owner instances with the
+// highlight style, on top of the merged presentation
+class GraphicsCompositeObject : public AIS_InteractiveObject {
+public:
+    // Instances, Redisplay() and selection recomputation have to be requested so changes take effect
+    // Moving or hiding instances doesn't rebuild the primitive arrays already built, their vertices
+    // are updated in place by next Redisplay()
+    int instanceCount() const { return int(m_vecInstance.size()); }
+    int visibleInstanceCount() const;
+
+    // Shape label presented by an instance
+    const TDF_Label& instanceLabel(int index) const { return m_vecInstance.at(index).label; }
+
+    const gp_Trsf& instanceTransformation(int index) const { return m_vecInstance.at(index).trsf; }
+    void setInstanceTransformation(int index, const gp_Trsf& trsf);
+
+    bool isInstanceVisible(int index) const { return m_vecInstance.at(index).visible; }
+    void setInstanceVisible(int index, bool on);
+
+    const OccHandle<GraphicsInstanceOwner>& instanceOwner(int index) const { return m_vecInstance.at(index).owner; }
+
+    // Extracts again triangles, colors and face boundaries of the presented shapes, typically needed
+    // when shape triangulations were replaced. Redisplay() has to be called afterwards
+    virtual void loadTriangles() = 0;
+
+    // -- from AIS_InteractiveObject
+    bool AcceptDisplayMode(const int mode) const override;
+    void ComputeSelection(const Handle(SelectMgr_Selection)& sel, const int mode) override;
+
+    // -- from SelectMgr_SelectableObject
+    void HilightSelected(
+            const Handle(PrsMgr_PresentationManager)& pm,
+            const SelectMgr_SequenceOfOwner& seqOwner
+    ) override;
+    void HilightOwnerWithColor(
+            const Handle(PrsMgr_PresentationManager)& pm,
+            const Handle(Prs3d_Drawer)& style,
+            const Handle(SelectMgr_EntityOwner)& owner
+    ) override;
+
+    DEFINE_STANDARD_RTTI_INLINE(GraphicsCompositeObject, AIS_InteractiveObject)
+
+protected:
+    GraphicsCompositeObject();
+
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+    void Compute(const Handle(Prs3d_Projector)&, const Handle(Prs3d_Presentation)&) override {}
+#endif
+
+    // Material of faces, as specified by their XCAF style
+    struct FaceMaterial {
+        float transparency = 0.f;
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+        OccHandle<XCAFDoc_VisMaterial> visMaterial; // Null if the style has no material
+#endif
+
+        bool operator==(const FaceMaterial& other) const { return this->key() == other.key(); }
+        bool operator<(const FaceMaterial& other) const { return this->key() < other.key(); }
+
+    private:
+        std::pair<const void*, float> key() const;
+    };
+
+    // Triangles, colors and face boundaries of a shape, expressed in the coordinate system of the shape
+    struct ShapeTriangles {
+        double deflection = 0.;
+        std::vector<Graphic3d_Vec3> vecNode;
+        std::vector<Graphic3d_Vec3> vecNormal;
+        std::vector<Graphic3d_Vec4ub> vecColor;
+        std::vector<int> vecIndex; // Three node indices(0-based) per triangle
+        std::vector<FaceMaterial> vecMaterial; // Distinct materials of the faces
+        std::vector<int> vecTriangleMaterial; // Index in 'vecMaterial' of the face owning each triangle
+        std::vector<Graphic3d_Vec3> vecBoundaryNode; // Face boundaries, two nodes per segment
+        OccHandle<Graphic3d_ArrayOfTriangles> triangles; // Vertex positions for sensitive entities
+    };
+
+    // Extracts the triangles of 'shapeMesh' with the styles of shape 'label'
+    // Faces of 'shapeMesh' are explored in lockstep with the faces of 'label' shape, the former
+    // providing the triangulations and the latter the styles
+    static void loadShapeTriangles(
+            ShapeTriangles* data, const TDF_Label& label, const TopoDS_Shape& shapeMesh, bool withSensitiveTriangles
+    );
+
+    int appendInstance(const TDF_Label& label, const gp_Trsf& trsf);
+
+    // Triangles of the sensitive entity of an instance, expressed in the coordinate system of the
+    // instance shape. Null if the instance isn't selectable
+    virtual OccHandle<Graphic3d_ArrayOfTriangles> instanceSensitiveTriangles(int index) const = 0;
+
+    // Adds to 'pres' the triangles of instances 'spanInstance' drawn with 'fillAspect'
+    virtual void addHighlightTriangles(
+            const Handle(Prs3d_Presentation)& pres,
+            const OccHandle<Graphic3d_AspectFillArea3d>& fillAspect,
+            Span<const int> spanInstance
+    ) const = 0;
+
+    // Called when instances were added or shown, primitive arrays have to be rebuilt
+    virtual void invalidateArraysCache() = 0;
+
+    // Called when instances were moved or hidden, primitive arrays can be kept but their vertices
+    // have to be updated(see isInstanceVisible() and instanceTransformation())
+    virtual void invalidateArraysPlacement() = 0;
+
+private:
+    struct Instance {
+        TDF_Label label;
+        gp_Trsf trsf;
+        bool visible = true;
+        OccHandle<GraphicsInstanceOwner> owner;
+    };
+
+    void fillHighlightPresentation(
+            const Handle(Prs3d_Presentation)& pres, const Handle(Prs3d_Drawer)& style, Span<const int> spanInstance
+    ) const;
+
+    std::vector<Instance> m_vecInstance;
+};
+
+} // namespace Mayo
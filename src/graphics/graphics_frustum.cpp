@@ -0,0 +1,79 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "graphics_frustum.h"
+
+#include "../base/unit_system.h"
+
+#include <Graphic3d_Mat4d.hxx>
+#include <gp_Vec.hxx>
+
+#include <cmath>
+
+namespace Mayo {
+
+GraphicsFrustum::GraphicsFrustum(const OccHandle<Graphic3d_Camera>& camera, int viewportHeight)
+    : m_camera(camera),
+      m_viewportHeight(viewportHeight)
+{
+    const double halfFovy = UnitSystem::radians(0.5 * camera->FOVy() * Quantity_Degree);
+    m_tanHalfFovy = std::tan(halfFovy);
+
+    // Clip space is [-1,1] along each axis, so each plane is the sum or the difference of the last
+    // row of the view-projection matrix with one of the other rows
+    const Graphic3d_Mat4d matViewProj = camera->ProjectionMatrix() * camera->OrientationMatrix();
+    const Graphic3d_Vec4d rowW = matViewProj.GetRow(3);
+    for (int i = 0; i < 3; ++i) {
+        const Graphic3d_Vec4d row = matViewProj.GetRow(i);
+        m_planes.at(2 * i) = rowW + row;
+        m_planes.at(2 * i + 1) = rowW - row;
+    }
+}
+
+bool GraphicsFrustum::isOutside(const Bnd_Box& box) const
+{
+    if (box.IsVoid())
+        return true;
+
+    return this->isOutside(box.CornerMin().XYZ(), box.CornerMax().XYZ());
+}
+
+bool GraphicsFrustum::isOutside(const gp_XYZ& pntMin, const gp_XYZ& pntMax) const
+{
+    // Box is outside if its corner the most advanced along the normal of a plane is behind it
+    for (const Graphic3d_Vec4d& plane : m_planes) {
+        const double x = plane.x() >= 0 ? pntMax.X() : pntMin.X();
+        const double y = plane.y() >= 0 ? pntMax.Y() : pntMin.Y();
+        const double z = plane.z() >= 0 ? pntMax.Z() : pntMin.Z();
+        if (plane.x() * x + plane.y() * y + plane.z() * z + plane.w() < 0)
+            return true;
+    }
+
+    return false;
+}
+
+double GraphicsFrustum::pixelsPerUnit(const gp_XYZ& pnt) const
+{
+    // Height of the view volume at the depth of 'pnt', in model units
+    double viewVolumeHeight = m_camera->ViewDimensions().Y();
+    if (!m_camera->IsOrthographic()) {
+        const double depth = gp_Vec(m_camera->Eye().XYZ(), pnt).Dot(gp_Vec(m_camera->Direction()));
+        viewVolumeHeight = 2 * depth * m_tanHalfFovy;
+    }
+
+    return viewVolumeHeight > 0 ? m_viewportHeight / viewVolumeHeight : 0.;
+}
+
+double GraphicsFrustum::projectedSize(const gp_XYZ& pntMin, const gp_XYZ& pntMax) const
+{
+    const double pixelsPerUnit = this->pixelsPerUnit((pntMin + pntMax) / 2.);
+    if (pixelsPerUnit <= 0)
+        return 0.;
+
+    return (pntMax - pntMin).Modulus() * pixelsPerUnit;
+}
+
+} // namespace Mayo
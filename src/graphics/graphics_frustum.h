@@ -0,0 +1,48 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/occ_handle.h"
+
+#include <Bnd_Box.hxx>
+#include <Graphic3d_Camera.hxx>
+#include <Graphic3d_Vec4.hxx>
+#include <gp_XYZ.hxx>
+
+#include <array>
+
+namespace Mayo {
+
+// Provides culling tests against the view volume of a camera
+// Planes of the view volume are extracted from the projection and orientation matrices of the
+// camera. Box test is conservative: a box close to an edge of the view volume might be reported
+// inside although being outside
+class GraphicsFrustum {
+public:
+    // 'viewportHeight' is the height of the view in pixels, needed by size computations
+    GraphicsFrustum(const OccHandle<Graphic3d_Camera>& camera, int viewportHeight);
+
+    const OccHandle<Graphic3d_Camera>& camera() const { return m_camera; }
+
+    bool isOutside(const Bnd_Box& box) const;
+    bool isOutside(const gp_XYZ& pntMin, const gp_XYZ& pntMax) const;
+
+    // Count of pixels covered by a length of one model unit located at 'pnt' and parallel to the
+    // view plane. Returns zero if 'pnt' is behind the camera
+    double pixelsPerUnit(const gp_XYZ& pnt) const;
+
+    // Approximate size in pixels of the box projected on the view, derived from its diagonal
+    double projectedSize(const gp_XYZ& pntMin, const gp_XYZ& pntMax) const;
+
+private:
+    OccHandle<Graphic3d_Camera> m_camera;
+    int m_viewportHeight = 0;
+    double m_tanHalfFovy = 0.;
+    std::array<Graphic3d_Vec4d, 6> m_planes; // Normals point inside the view volume
+};
+
+} // namespace Mayo
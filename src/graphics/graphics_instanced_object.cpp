@@ -0,0 +1,386 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "graphics_instanced_object.h"
+
+#include "../base/xcaf.h"
+
+#include <AIS_DisplayMode.hxx>
+#include <Graphic3d_AspectLine3d.hxx>
+#include <Graphic3d_Group.hxx>
+#include <Graphic3d_IndexBuffer.hxx>
+#include <OSD_Parallel.hxx>
+#include <Prs3d_LineAspect.hxx>
+#include <Prs3d_ShadingAspect.hxx>
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace Mayo {
+
+namespace {
+
+// Maximum count of vertices in a primitive array, instances are batched to keep below this limit
+constexpr int MaxBatchVertexCount = 1 << 22;
+
+gp_XYZ toXYZ(const Graphic3d_Vec3& vec)
+{
+    return gp_XYZ(vec.x(), vec.y(), vec.z());
+}
+
+} // namespace
+
+GraphicsInstancedObject::GraphicsInstancedObject(const TDF_Label& label)
+    : m_label(label),
+      m_vecLevel(1)
+{
+    this->loadTriangles();
+}
+
+int GraphicsInstancedObject::addInstance(const gp_Trsf& trsf)
+{
+    m_vecInstanceLevel.push_back(0);
+    return this->appendInstance(m_label, trsf);
+}
+
+void GraphicsInstancedObject::addLevelOfDetail(const TopoDS_Shape& shape)
+{
+    if (shape.IsNull())
+        return;
+
+    Prototype proto;
+    proto.shape = shape;
+    this->loadPrototype(&proto);
+    if (proto.vecIndex.empty())
+        return;
+
+    m_vecLevel.push_back(std::move(proto));
+    this->invalidateArraysCache();
+}
+
+int GraphicsInstancedObject::levelOfDetail(double maxDeflection) const
+{
+    int levelFinest = 0;
+    int levelFound = -1;
+    for (int level = 0; level < this->levelOfDetailCount(); ++level) {
+        const double deflection = m_vecLevel.at(level).deflection;
+        if (deflection < m_vecLevel.at(levelFinest).deflection)
+            levelFinest = level;
+
+        if (deflection <= maxDeflection && (levelFound < 0 || deflection > m_vecLevel.at(levelFound).deflection))
+            levelFound = level;
+    }
+
+    return levelFound >= 0 ? levelFound : levelFinest;
+}
+
+void GraphicsInstancedObject::setInstanceLevelOfDetail(int index, int level)
+{
+    m_vecInstanceLevel.at(index) = std::clamp(level, 0, this->levelOfDetailCount() - 1);
+}
+
+void GraphicsInstancedObject::Compute(
+        const Handle(PrsMgr_PresentationManager)&,
+        const Handle(Prs3d_Presentation)& pres,
+        const int mode)
+{
+    const bool showTriangles = mode == AIS_Shaded;
+    const bool showBoundaries = mode == AIS_WireFrame || myDrawer->FaceBoundaryDraw();
+    std::vector<int> vecInstanceIndex(this->instanceCount());
+    std::iota(vecInstanceIndex.begin(), vecInstanceIndex.end(), 0);
+    std::vector<std::vector<int>> vecLevelInstances = this->instancesPerLevel(vecInstanceIndex);
+    std::vector<const LevelArrays*> vecArrays;
+    for (int level = 0; level < this->levelOfDetailCount(); ++level) {
+        std::vector<int>& vecLevelInstanceIndex = vecLevelInstances.at(level);
+        const bool hasVisibleInstance = std::any_of(
+                    vecLevelInstanceIndex.cbegin(), vecLevelInstanceIndex.cend(), [=](int index) {
+            return this->isInstanceVisible(index);
+        });
+        if (!hasVisibleInstance)
+            continue;
+
+        LevelArrays* arrays = this->findLevelArrays(level, std::move(vecLevelInstanceIndex));
+        if (arrays->isPlacementInvalid) {
+            this->placeLevelArrays(arrays, level);
+            arrays->isPlacementInvalid = false;
+        }
+
+        this->fillLevelArrays(arrays, level, showTriangles, showBoundaries);
+        vecArrays.push_back(arrays);
+    }
+
+    if (showTriangles) {
+        OccHandle<Graphic3d_Group> groupTriangles;
+        for (const LevelArrays* arrays : vecArrays) {
+            for (const OccHandle<Graphic3d_ArrayOfTriangles>& triangles : arrays->vecTriangles) {
+                if (!groupTriangles) {
+                    groupTriangles = pres->NewGroup();
+                    groupTriangles->SetGroupPrimitivesAspect(myDrawer->ShadingAspect()->Aspect());
+                }
+
+                groupTriangles->AddPrimitiveArray(triangles);
+            }
+        }
+    }
+
+    if (showBoundaries) {
+        OccHandle<Graphic3d_AspectLine3d> lineAspect = myDrawer->FaceBoundaryAspect()->Aspect();
+        const std::vector<Graphic3d_Vec4ub>& vecColor = m_vecLevel.front().vecColor;
+        if (mode == AIS_WireFrame && !vecColor.empty()) {
+            const Graphic3d_Vec4ub& color = vecColor.front();
+            lineAspect = new Graphic3d_AspectLine3d(
+                        Quantity_Color(color.r() / 255., color.g() / 255., color.b() / 255., Quantity_TOC_RGB),
+                        Aspect_TOL_SOLID,
+                        1.
+            );
+        }
+
+        OccHandle<Graphic3d_Group> groupBoundaries;
+        for (const LevelArrays* arrays : vecArrays) {
+            for (const OccHandle<Graphic3d_ArrayOfSegments>& boundaries : arrays->vecBoundaries) {
+                if (!groupBoundaries) {
+                    groupBoundaries = pres->NewGroup();
+                    groupBoundaries->SetGroupPrimitivesAspect(lineAspect);
+                }
+
+                groupBoundaries->AddPrimitiveArray(boundaries);
+            }
+        }
+    }
+}
+
+void GraphicsInstancedObject::loadTriangles()
+{
+    for (Prototype& proto : m_vecLevel)
+        this->loadPrototype(&proto);
+
+    this->invalidateArraysCache();
+}
+
+void GraphicsInstancedObject::loadPrototype(Prototype* proto) const
+{
+    const TopoDS_Shape shapeLevel = proto->shape;
+    const TopoDS_Shape shape = XCaf::shape(m_label);
+    const TopoDS_Shape shapeMesh = !shapeLevel.IsNull() ? shapeLevel.Located(shape.Location()) : shape;
+    // Sensitive triangles are only needed for the finest level
+    loadShapeTriangles(proto, m_label, shapeMesh, shapeLevel.IsNull()/*withSensitiveTriangles*/);
+}
+
+OccHandle<Graphic3d_ArrayOfTriangles> GraphicsInstancedObject::instanceSensitiveTriangles(int) const
+{
+    return m_vecLevel.front().triangles;
+}
+
+void GraphicsInstancedObject::invalidateArraysCache()
+{
+    m_vecLevelArraysCache.assign(m_vecLevel.size(), {});
+}
+
+void GraphicsInstancedObject::invalidateArraysPlacement()
+{
+    for (std::vector<LevelArrays>& vecArrays : m_vecLevelArraysCache) {
+        for (LevelArrays& arrays : vecArrays)
+            arrays.isPlacementInvalid = true;
+    }
+}
+
+std::vector<std::vector<int>> GraphicsInstancedObject::instancesPerLevel(Span<const int> spanInstance) const
+{
+    std::vector<std::vector<int>> vecLevelInstances(m_vecLevel.size());
+    for (int index : spanInstance)
+        vecLevelInstances.at(m_vecInstanceLevel.at(index)).push_back(index);
+
+    return vecLevelInstances;
+}
+
+GraphicsInstancedObject::LevelArrays* GraphicsInstancedObject::findLevelArrays(int level, std::vector<int> vecInstance)
+{
+    constexpr size_t MaxCachedArraysPerLevel = 2;
+    std::vector<LevelArrays>& vecArrays = m_vecLevelArraysCache.at(level);
+    auto itArrays = std::find_if(vecArrays.begin(), vecArrays.end(), [&](const LevelArrays& arrays) {
+        return arrays.vecInstance == vecInstance;
+    });
+    if (itArrays == vecArrays.end()) {
+        if (vecArrays.size() >= MaxCachedArraysPerLevel)
+            vecArrays.pop_back();
+
+        LevelArrays arrays;
+        arrays.vecInstance = std::move(vecInstance);
+        vecArrays.insert(vecArrays.begin(), std::move(arrays));
+    }
+    else {
+        std::rotate(vecArrays.begin(), itArrays, itArrays + 1);
+    }
+
+    return &vecArrays.front();
+}
+
+std::vector<std::vector<int>> GraphicsInstancedObject::instanceBatches(
+        Span<const int> spanInstance, int prototypeVertexCount)
+{
+    std::vector<std::vector<int>> vecBatch;
+    if (prototypeVertexCount <= 0)
+        return vecBatch;
+
+    const auto batchInstanceCount = size_t(std::max(1, MaxBatchVertexCount / prototypeVertexCount));
+    for (size_t i = 0; i < spanInstance.size(); i += batchInstanceCount) {
+        const Span<const int> spanBatch = spanInstance.subspan(i, std::min(batchInstanceCount, spanInstance.size() - i));
+        vecBatch.emplace_back(spanBatch.begin(), spanBatch.end());
+    }
+
+    return vecBatch;
+}
+
+void GraphicsInstancedObject::fillLevelArrays(LevelArrays* arrays, int level, bool withTriangles, bool withBoundaries) const
+{
+    const Prototype& proto = m_vecLevel.at(level);
+    const Span<const int> spanInstance = arrays->vecInstance;
+    if (withTriangles && !arrays->hasTriangles) {
+        if (!proto.vecIndex.empty()) {
+            const int nodeCount = int(proto.vecNode.size());
+            for (std::vector<int>& vecInstanceIndex : instanceBatches(spanInstance, nodeCount)) {
+                arrays->vecTriangles.push_back(this->createTriangles(level, vecInstanceIndex, true/*withColors*/));
+                arrays->vecTrianglesBatch.push_back(std::move(vecInstanceIndex));
+            }
+        }
+
+        arrays->hasTriangles = true;
+    }
+
+    if (withBoundaries && !arrays->hasBoundaries) {
+        const int nodeCount = int(proto.vecBoundaryNode.size());
+        for (std::vector<int>& vecInstanceIndex : instanceBatches(spanInstance, nodeCount)) {
+            arrays->vecBoundaries.push_back(this->createBoundaries(level, vecInstanceIndex));
+            arrays->vecBoundariesBatch.push_back(std::move(vecInstanceIndex));
+        }
+
+        arrays->hasBoundaries = true;
+    }
+}
+
+void GraphicsInstancedObject::placeLevelArrays(LevelArrays* arrays, int level) const
+{
+    for (size_t i = 0; i < arrays->vecTriangles.size(); ++i)
+        this->setTrianglesVertices(arrays->vecTriangles.at(i), level, arrays->vecTrianglesBatch.at(i), false/*withColors*/);
+
+    for (size_t i = 0; i < arrays->vecBoundaries.size(); ++i)
+        this->setBoundariesVertices(arrays->vecBoundaries.at(i), level, arrays->vecBoundariesBatch.at(i));
+}
+
+OccHandle<Graphic3d_ArrayOfTriangles>
+GraphicsInstancedObject::createTriangles(int level, Span<const int> spanInstance, bool withColors) const
+{
+    const Prototype& proto = m_vecLevel.at(level);
+    const int instanceCount = int(spanInstance.size());
+    const int nodeCount = int(proto.vecNode.size());
+    const int indexCount = int(proto.vecIndex.size());
+    OccHandle<Graphic3d_ArrayOfTriangles> triangles = new Graphic3d_ArrayOfTriangles(
+                instanceCount * nodeCount, instanceCount * indexCount, true/*normals*/, withColors
+    );
+    // Element counts are set first so vertices and indices can be set concurrently
+    triangles->Attributes()->NbElements = instanceCount * nodeCount;
+    triangles->Indices()->NbElements = instanceCount * indexCount;
+    this->setTrianglesVertices(triangles, level, spanInstance, withColors);
+    return triangles;
+}
+
+void GraphicsInstancedObject::setTrianglesVertices(
+        const OccHandle<Graphic3d_ArrayOfTriangles>& triangles,
+        int level,
+        Span<const int> spanInstance,
+        bool withColors) const
+{
+    const Prototype& proto = m_vecLevel.at(level);
+    const int instanceCount = int(spanInstance.size());
+    const int nodeCount = int(proto.vecNode.size());
+    const int indexCount = int(proto.vecIndex.size());
+    const OccHandle<Graphic3d_IndexBuffer>& indices = triangles->Indices();
+    OSD_Parallel::For(0, instanceCount, [&](int i) {
+        const gp_Trsf& trsf = this->instanceTransformation(spanInstance[i]);
+        const gp_Mat matRotation = trsf.HVectorialPart();
+        // Mirroring transformation reverses the orientation of the triangles
+        const bool isMirrored = trsf.IsNegative();
+        const double normalSign = isMirrored ? -1. : 1.;
+        const int vertexOffset = i * nodeCount;
+        for (int j = 0; j < nodeCount; ++j) {
+            gp_XYZ node = toXYZ(proto.vecNode[j]);
+            trsf.Transforms(node);
+            const gp_XYZ normal = toXYZ(proto.vecNormal[j]).Multiplied(matRotation) * normalSign;
+            triangles->SetVertice(vertexOffset + j + 1, gp_Pnt(node));
+            triangles->SetVertexNormal(vertexOffset + j + 1, normal.X(), normal.Y(), normal.Z());
+            if (withColors)
+                triangles->SetVertexColor(vertexOffset + j + 1, proto.vecColor[j]);
+        }
+
+        // Triangles of a hidden instance are collapsed, so the array doesn't have to be rebuilt
+        const bool isVisible = this->isInstanceVisible(spanInstance[i]);
+        const int indexOffset = i * indexCount;
+        for (int j = 0; j + 2 < indexCount; j += 3) {
+            int n1 = proto.vecIndex[j];
+            int n2 = proto.vecIndex[j + 1];
+            int n3 = proto.vecIndex[j + 2];
+            if (!isVisible)
+                n2 = n3 = n1;
+            else if (isMirrored)
+                std::swap(n2, n3);
+
+            indices->SetIndex(indexOffset + j, vertexOffset + n1);
+            indices->SetIndex(indexOffset + j + 1, vertexOffset + n2);
+            indices->SetIndex(indexOffset + j + 2, vertexOffset + n3);
+        }
+    }, instanceCount < 2/*isForceSingleThreadExecution*/);
+}
+
+OccHandle<Graphic3d_ArrayOfSegments>
+GraphicsInstancedObject::createBoundaries(int level, Span<const int> spanInstance) const
+{
+    const Prototype& proto = m_vecLevel.at(level);
+    const int instanceCount = int(spanInstance.size());
+    const int nodeCount = int(proto.vecBoundaryNode.size());
+    OccHandle<Graphic3d_ArrayOfSegments> segments = new Graphic3d_ArrayOfSegments(instanceCount * nodeCount);
+    segments->Attributes()->NbElements = instanceCount * nodeCount;
+    this->setBoundariesVertices(segments, level, spanInstance);
+    return segments;
+}
+
+void GraphicsInstancedObject::setBoundariesVertices(
+        const OccHandle<Graphic3d_ArrayOfSegments>& segments, int level, Span<const int> spanInstance) const
+{
+    const Prototype& proto = m_vecLevel.at(level);
+    const int instanceCount = int(spanInstance.size());
+    const int nodeCount = int(proto.vecBoundaryNode.size());
+    OSD_Parallel::For(0, instanceCount, [&](int i) {
+        const gp_Trsf& trsf = this->instanceTransformation(spanInstance[i]);
+        // Segments of a hidden instance are collapsed into a point, so they aren't drawn
+        const bool isVisible = this->isInstanceVisible(spanInstance[i]);
+        for (int j = 0; j < nodeCount; ++j) {
+            gp_XYZ node = toXYZ(proto.vecBoundaryNode[isVisible ? j : 0]);
+            trsf.Transforms(node);
+            segments->SetVertice(i * nodeCount + j + 1, gp_Pnt(node));
+        }
+    }, instanceCount < 2/*isForceSingleThreadExecution*/);
+}
+
+void GraphicsInstancedObject::addHighlightTriangles(
+        const Handle(Prs3d_Presentation)& pres,
+        const OccHandle<Graphic3d_AspectFillArea3d>& fillAspect,
+        Span<const int> spanInstance) const
+{
+    if (m_vecLevel.front().vecIndex.empty())
+        return;
+
+    // Instances are highlighted with the level they are drawn with
+    OccHandle<Graphic3d_Group> group = pres->NewGroup();
+    group->SetGroupPrimitivesAspect(fillAspect);
+    const std::vector<std::vector<int>> vecLevelInstances = this->instancesPerLevel(spanInstance);
+    for (int level = 0; level < this->levelOfDetailCount(); ++level) {
+        if (!vecLevelInstances.at(level).empty())
+            group->AddPrimitiveArray(this->createTriangles(level, vecLevelInstances.at(level), false/*withColors*/));
+    }
+}
+
+} // namespace Mayo
@@ -0,0 +1,122 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "graphics_composite_object.h"
+
+#include <Graphic3d_ArrayOfSegments.hxx>
+
+namespace Mayo {
+
+// Graphics object presenting all the instances of a shape "prototype"(ie the product of assembly
+// components) with a few draw calls instead of one graphics object per instance
+// Triangles, normals and colors of the prototype are extracted once from its triangulation, then
+// replicated in parallel with the transformation of each instance into a primitive array
+// Instances are batched so that each primitive array doesn't exceed a reasonable vertex count
+// Instances can be selected and highlighted individually(see GraphicsCompositeObject), sensitive
+// entities of instances share the prototype vertex buffer
+// Supported display modes are AIS_WireFrame and AIS_Shaded(with optional face boundaries)
+// The prototype can have levels of detail(LOD), ie coarser triangulations, and each instance is
+// drawn with its own level. Selection always uses the finest level
+class GraphicsInstancedObject : public GraphicsCompositeObject {
+public:
+    // 'label' is the prototype shape, it must be meshed
+    GraphicsInstancedObject(const TDF_Label& label);
+
+    const TDF_Label& label() const { return m_label; }
+
+    // Redisplay() and selection recomputation have to be requested so changes take effect
+    int addInstance(const gp_Trsf& trsf);
+
+    // Count of vertices of the prototype triangles(finest level)
+    int prototypeNodeCount() const { return int(m_vecLevel.front().vecNode.size()); }
+
+    // Extracts again triangles, colors and face boundaries of the prototype levels
+    void loadTriangles() override;
+
+    // Levels of detail, ordered as added. Level 0 is the triangulation of the prototype shape
+    // 'shape' is a copy of the prototype shape meshed with a coarser deflection(see MeshLodEngine),
+    // colors are taken from the prototype faces
+    void addLevelOfDetail(const TopoDS_Shape& shape);
+    int levelOfDetailCount() const { return int(m_vecLevel.size()); }
+
+    // Maximum chordal deflection of the triangulations of a level
+    double levelOfDetailDeflection(int level) const { return m_vecLevel.at(level).deflection; }
+
+    // Coarsest level whose deflection doesn't exceed 'maxDeflection', finest level if none
+    int levelOfDetail(double maxDeflection) const;
+
+    // Level drawn for an instance, Redisplay() has to be called so changes take effect
+    int instanceLevelOfDetail(int index) const { return m_vecInstanceLevel.at(index); }
+    void setInstanceLevelOfDetail(int index, int level);
+
+    DEFINE_STANDARD_RTTI_INLINE(GraphicsInstancedObject, GraphicsCompositeObject)
+
+protected:
+    void Compute(
+            const Handle(PrsMgr_PresentationManager)& pm,
+            const Handle(Prs3d_Presentation)& pres,
+            const int mode) override;
+
+    // -- from GraphicsCompositeObject
+    OccHandle<Graphic3d_ArrayOfTriangles> instanceSensitiveTriangles(int index) const override;
+    void addHighlightTriangles(
+            const Handle(Prs3d_Presentation)& pres,
+            const OccHandle<Graphic3d_AspectFillArea3d>& fillAspect,
+            Span<const int> spanInstance
+    ) const override;
+    void invalidateArraysCache() override;
+    void invalidateArraysPlacement() override;
+
+private:
+    // Prototype triangles, colors and face boundaries of a level of detail
+    // Sensitive triangles of level 0 are shared by the sensitive entities of instances
+    struct Prototype : ShapeTriangles {
+        TopoDS_Shape shape; // Null for level 0
+    };
+
+    // Primitive arrays of the instances drawn with the same level, each array being a batch of instances
+    // Hidden instances are part of the arrays(collapsed), so hiding an instance doesn't rebuild them
+    struct LevelArrays {
+        std::vector<int> vecInstance; // Instances drawn with the arrays, ordered by index
+        bool isPlacementInvalid = false;
+        std::vector<OccHandle<Graphic3d_ArrayOfTriangles>> vecTriangles;
+        std::vector<std::vector<int>> vecTrianglesBatch; // Instances of each item of 'vecTriangles'
+        std::vector<OccHandle<Graphic3d_ArrayOfSegments>> vecBoundaries;
+        std::vector<std::vector<int>> vecBoundariesBatch; // Instances of each item of 'vecBoundaries'
+        bool hasTriangles = false;
+        bool hasBoundaries = false;
+    };
+
+    void loadPrototype(Prototype* proto) const;
+    std::vector<std::vector<int>> instancesPerLevel(Span<const int> spanInstance) const;
+    static std::vector<std::vector<int>> instanceBatches(Span<const int> spanInstance, int prototypeVertexCount);
+    LevelArrays* findLevelArrays(int level, std::vector<int> vecInstance);
+    void fillLevelArrays(LevelArrays* arrays, int level, bool withTriangles, bool withBoundaries) const;
+    void placeLevelArrays(LevelArrays* arrays, int level) const;
+    OccHandle<Graphic3d_ArrayOfTriangles> createTriangles(int level, Span<const int> spanInstance, bool withColors) const;
+    void setTrianglesVertices(
+            const OccHandle<Graphic3d_ArrayOfTriangles>& triangles,
+            int level,
+            Span<const int> spanInstance,
+            bool withColors
+    ) const;
+    OccHandle<Graphic3d_ArrayOfSegments> createBoundaries(int level, Span<const int> spanInstance) const;
+    void setBoundariesVertices(
+            const OccHandle<Graphic3d_ArrayOfSegments>& segments, int level, Span<const int> spanInstance
+    ) const;
+
+    TDF_Label m_label;
+    std::vector<Prototype> m_vecLevel; // Never empty
+    std::vector<int> m_vecInstanceLevel; // Level drawn for each instance
+    // Arrays cached for each level, most recently used first. Only the levels whose instances
+    // changed are rebuilt, and switching back and forth between two states(eg coarsest level forced
+    // during view dynamic actions) doesn't rebuild them
+    std::vector<std::vector<LevelArrays>> m_vecLevelArraysCache;
+};
+
+} // namespace Mayo
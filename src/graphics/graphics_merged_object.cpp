@@ -0,0 +1,589 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "graphics_merged_object.h"
+
+#include "../base/bnd_utils.h"
+#include "../base/mesh_edge_engine.h"
+#include "../base/xcaf.h"
+
+#include <AIS_DisplayMode.hxx>
+#include <BRep_Builder.hxx>
+#include <Graphic3d_Group.hxx>
+#include <Graphic3d_IndexBuffer.hxx>
+#include <Graphic3d_MaterialAspect.hxx>
+#include <OSD_Parallel.hxx>
+#include <Prs3d_LineAspect.hxx>
+#include <Prs3d_ShadingAspect.hxx>
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+#  include <StdPrs_HLRPolyShape.hxx>
+#  include <StdPrs_HLRShape.hxx>
+#endif
+#include <TopoDS_Compound.hxx>
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <utility>
+
+namespace Mayo {
+
+namespace {
+
+// Maximum count of vertices in a primitive array, parts are batched to keep below this limit
+constexpr int MaxBatchVertexCount = 1 << 22;
+
+gp_XYZ toXYZ(const Graphic3d_Vec3& vec)
+{
+    return gp_XYZ(vec.x(), vec.y(), vec.z());
+}
+
+Graphic3d_Vec3 toGraphicVec3(const gp_XYZ& coords)
+{
+    return Graphic3d_Vec3(float(coords.X()), float(coords.Y()), float(coords.Z()));
+}
+
+// Ranges [first, last) of consecutive items whose sum of vertex counts doesn't exceed
+// MaxBatchVertexCount, unless the range is a single item
+std::vector<std::pair<int, int>> batchRanges(const std::vector<int>& vecVertexCount)
+{
+    std::vector<std::pair<int, int>> vecRange;
+    const int itemCount = int(vecVertexCount.size());
+    int first = 0;
+    int vertexCount = 0;
+    for (int i = 0; i < itemCount; ++i) {
+        if (i > first && vertexCount + vecVertexCount.at(i) > MaxBatchVertexCount) {
+            vecRange.emplace_back(first, i);
+            first = i;
+            vertexCount = 0;
+        }
+
+        vertexCount += vecVertexCount.at(i);
+    }
+
+    if (first < itemCount)
+        vecRange.emplace_back(first, itemCount);
+
+    return vecRange;
+}
+
+} // namespace
+
+GraphicsMergedObject::GraphicsMergedObject(EdgeRendering edgeRendering)
+    : m_edgeRendering(edgeRendering)
+{
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+    if (m_edgeRendering == EdgeRendering::ScreenSpace)
+        m_edgeRendering = EdgeRendering::Extracted; // Silhouette outline isn't supported
+#endif
+    // Hidden line removal is computed for each view projection, as for XCAFPrs_AISObject
+    this->SetTypeOfPresentation(PrsMgr_TOP_ProjectorDependent);
+}
+
+int GraphicsMergedObject::addInstance(const TDF_Label& label, const gp_Trsf& trsf)
+{
+    auto itShape = m_mapLabelShape.find(label);
+    if (itShape == m_mapLabelShape.cend()) {
+        Shape shape;
+        shape.label = label;
+        loadShape(&shape);
+        itShape = m_mapLabelShape.insert({ label, int(m_vecShape.size()) }).first;
+        m_vecShape.push_back(std::move(shape));
+    }
+
+    m_vecInstanceShape.push_back(itShape->second);
+    return this->appendInstance(label, trsf);
+}
+
+void GraphicsMergedObject::loadTriangles()
+{
+    for (Shape& shape : m_vecShape)
+        loadShape(&shape);
+
+    this->invalidateArraysCache();
+}
+
+std::vector<std::vector<int>> GraphicsMergedObject::spatialChunks(Span<const Bnd_Box> spanBox, int maxChunkSize)
+{
+    std::vector<std::vector<int>> vecChunk;
+    const int itemCount = int(spanBox.size());
+    if (itemCount == 0)
+        return vecChunk;
+
+    std::vector<gp_XYZ> vecCenter;
+    vecCenter.reserve(itemCount);
+    for (const Bnd_Box& bndBox : spanBox)
+        vecCenter.push_back(!bndBox.IsVoid() ? BndBoxCoords::get(bndBox).center().XYZ() : gp_XYZ());
+
+    std::vector<int> vecIndex(itemCount);
+    std::iota(vecIndex.begin(), vecIndex.end(), 0);
+    maxChunkSize = std::max(1, maxChunkSize);
+    std::vector<std::pair<int, int>> stackRange{ { 0, itemCount } };
+    while (!stackRange.empty()) {
+        const auto [first, last] = stackRange.back();
+        stackRange.pop_back();
+        if (last - first <= maxChunkSize) {
+            vecChunk.emplace_back(vecIndex.begin() + first, vecIndex.begin() + last);
+            continue;
+        }
+
+        Bnd_Box bndBoxCenters;
+        for (int i = first; i < last; ++i)
+            bndBoxCenters.Add(gp_Pnt(vecCenter.at(vecIndex.at(i))));
+
+        const BndBoxCoords coords = BndBoxCoords::get(bndBoxCenters);
+        const gp_XYZ extent(coords.xmax - coords.xmin, coords.ymax - coords.ymin, coords.zmax - coords.zmin);
+        int axis = 3;
+        if (extent.X() >= extent.Y() && extent.X() >= extent.Z())
+            axis = 1;
+        else if (extent.Y() >= extent.Z())
+            axis = 2;
+
+        const int middle = first + (last - first) / 2;
+        std::nth_element(
+                    vecIndex.begin() + first, vecIndex.begin() + middle, vecIndex.begin() + last,
+                    [&](int lhs, int rhs) { return vecCenter.at(lhs).Coord(axis) < vecCenter.at(rhs).Coord(axis); }
+        );
+        stackRange.push_back({ middle, last });
+        stackRange.push_back({ first, middle });
+    }
+
+    return vecChunk;
+}
+
+void GraphicsMergedObject::Compute(
+        const Handle(PrsMgr_PresentationManager)&,
+        const Handle(Prs3d_Presentation)& pres,
+        const int mode)
+{
+    const bool showTriangles = mode == AIS_Shaded;
+    const bool showEdges = mode == AIS_Shaded && myDrawer->FaceBoundaryDraw();
+    const bool showBoundaries = showEdges && m_edgeRendering != EdgeRendering::ScreenSpace;
+    const bool showColoredBoundaries = mode == AIS_WireFrame; // Drawn with the color of each part
+    this->fillArrays(showTriangles, showBoundaries, showColoredBoundaries);
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+    if (m_edgeRendering == EdgeRendering::ScreenSpace && myDrawer->HasOwnShadingAspect()) {
+        // Material aspects are copies of the shading aspect, they get the silhouette settings
+        const OccHandle<Graphic3d_AspectFillArea3d>& aspect = myDrawer->ShadingAspect()->Aspect();
+        const OccHandle<Graphic3d_AspectLine3d>& edgeAspect = myDrawer->FaceBoundaryAspect()->Aspect();
+        aspect->SetDrawSilhouette(showEdges);
+        aspect->SetEdgeColor(edgeAspect->Color());
+        aspect->SetEdgeWidth(edgeAspect->Width());
+    }
+#endif
+
+    if (showTriangles) {
+        for (const MaterialArrays& material : m_arraysCache.vecMaterial) {
+            OccHandle<Graphic3d_Group> group = pres->NewGroup();
+            group->SetGroupPrimitivesAspect(this->materialAspect(material.material));
+            for (const OccHandle<Graphic3d_ArrayOfTriangles>& triangles : material.vecTriangles)
+                group->AddPrimitiveArray(triangles);
+        }
+    }
+
+    const std::vector<SegmentsBatch>& vecBoundaries =
+            showColoredBoundaries ? m_arraysCache.vecColoredBoundaries : m_arraysCache.vecBoundaries;
+    if ((showBoundaries || showColoredBoundaries) && !vecBoundaries.empty()) {
+        OccHandle<Graphic3d_Group> group = pres->NewGroup();
+        group->SetGroupPrimitivesAspect(myDrawer->FaceBoundaryAspect()->Aspect());
+        for (const SegmentsBatch& boundaries : vecBoundaries)
+            group->AddPrimitiveArray(boundaries.segments);
+    }
+}
+
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+void GraphicsMergedObject::computeHLR(
+        const Handle(Graphic3d_Camera)& camera,
+        const Handle(TopLoc_Datum3D)& trsf,
+        const Handle(Prs3d_Presentation)& pres)
+{
+    this->addHiddenLines(camera, !trsf.IsNull() ? trsf->Transformation() : gp_Trsf(), pres);
+}
+#elif OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+void GraphicsMergedObject::computeHLR(
+        const Handle(Graphic3d_Camera)& camera,
+        const Handle(Geom_Transformation)& trsf,
+        const Handle(Prs3d_Presentation)& pres)
+{
+    this->addHiddenLines(camera, !trsf.IsNull() ? trsf->Trsf() : gp_Trsf(), pres);
+}
+#endif
+
+OccHandle<Graphic3d_ArrayOfTriangles> GraphicsMergedObject::instanceSensitiveTriangles(int index) const
+{
+    return this->instanceShape(index).data.triangles;
+}
+
+void GraphicsMergedObject::addHighlightTriangles(
+        const Handle(Prs3d_Presentation)& pres,
+        const OccHandle<Graphic3d_AspectFillArea3d>& fillAspect,
+        Span<const int> spanInstance) const
+{
+    std::vector<TrianglesItem> vecItem;
+    for (int index : spanInstance)
+        vecItem.push_back({ index, &this->instanceShape(index), nullptr });
+
+    const OccHandle<Graphic3d_ArrayOfTriangles> triangles = this->createTriangles(vecItem, false/*withColors*/);
+    if (triangles.IsNull())
+        return;
+
+    OccHandle<Graphic3d_Group> group = pres->NewGroup();
+    group->SetGroupPrimitivesAspect(fillAspect);
+    group->AddPrimitiveArray(triangles);
+}
+
+void GraphicsMergedObject::invalidateArraysCache()
+{
+    m_arraysCache = {};
+    m_isArraysCachePlacementInvalid = false;
+}
+
+void GraphicsMergedObject::invalidateArraysPlacement()
+{
+    m_isArraysCachePlacementInvalid = true;
+}
+
+int GraphicsMergedObject::TrianglesItem::nodeCount() const
+{
+    return subMesh && !subMesh->isWholeShape ? int(subMesh->vecNode.size()) : int(shape->data.vecNode.size());
+}
+
+int GraphicsMergedObject::TrianglesItem::node(int i) const
+{
+    return subMesh && !subMesh->isWholeShape ? subMesh->vecNode[i] : i;
+}
+
+Span<const int> GraphicsMergedObject::TrianglesItem::indices() const
+{
+    return subMesh && !subMesh->isWholeShape ? subMesh->vecIndex : shape->data.vecIndex;
+}
+
+void GraphicsMergedObject::loadShape(Shape* shape) const
+{
+    const TopoDS_Shape topoShape = XCaf::shape(shape->label);
+    loadShapeTriangles(&shape->data, shape->label, topoShape, true/*withSensitiveTriangles*/);
+    if (m_edgeRendering == EdgeRendering::Extracted) {
+        // Face boundaries are replaced by the edges provided by MeshEdgeEngine
+        shape->data.vecBoundaryNode.clear();
+        const auto edges = MeshEdgeEngine::instance().edges(topoShape);
+        if (edges) {
+            const gp_Trsf& trsf = topoShape.Location().Transformation();
+            for (const auto* vecNode : { &edges->vecBoundaryNode, &edges->vecSharpNode }) {
+                for (gp_XYZ node : *vecNode) {
+                    trsf.Transforms(node);
+                    shape->data.vecBoundaryNode.push_back(toGraphicVec3(node));
+                }
+            }
+        }
+    }
+
+    shape->vecSubMesh.clear();
+    const ShapeTriangles& data = shape->data;
+    if (data.vecMaterial.size() == 1) {
+        // Most common case, no need to split the shape triangles
+        SubMesh subMesh;
+        subMesh.material = data.vecMaterial.front();
+        subMesh.isWholeShape = true;
+        shape->vecSubMesh.push_back(std::move(subMesh));
+        return;
+    }
+
+    const int triangleCount = int(data.vecTriangleMaterial.size());
+    std::vector<int> vecSubMeshNode(data.vecNode.size()); // Index of shape nodes in the current sub-mesh
+    for (int materialIndex = 0; materialIndex < int(data.vecMaterial.size()); ++materialIndex) {
+        SubMesh subMesh;
+        subMesh.material = data.vecMaterial.at(materialIndex);
+        std::fill(vecSubMeshNode.begin(), vecSubMeshNode.end(), -1);
+        for (int i = 0; i < triangleCount; ++i) {
+            if (data.vecTriangleMaterial.at(i) != materialIndex)
+                continue;
+
+            for (int j = 0; j < 3; ++j) {
+                const int node = data.vecIndex.at(3 * i + j);
+                if (vecSubMeshNode.at(node) < 0) {
+                    vecSubMeshNode.at(node) = int(subMesh.vecNode.size());
+                    subMesh.vecNode.push_back(node);
+                }
+
+                subMesh.vecIndex.push_back(vecSubMeshNode.at(node));
+            }
+        }
+
+        shape->vecSubMesh.push_back(std::move(subMesh));
+    }
+}
+
+void GraphicsMergedObject::fillArrays(bool withTriangles, bool withBoundaries, bool withColoredBoundaries)
+{
+    if (m_isArraysCachePlacementInvalid) {
+        this->placeArrays();
+        m_isArraysCachePlacementInvalid = false;
+    }
+
+    std::vector<int> vecVisibleInstance;
+    for (int i = 0; i < this->instanceCount(); ++i) {
+        if (this->isInstanceVisible(i))
+            vecVisibleInstance.push_back(i);
+    }
+
+    if (withTriangles && !m_arraysCache.hasTriangles) {
+        // Sub-meshes of the visible parts are grouped by material
+        std::map<FaceMaterial, std::vector<TrianglesItem>> mapMaterialItems;
+        for (int index : vecVisibleInstance) {
+            const Shape& shape = this->instanceShape(index);
+            for (const SubMesh& subMesh : shape.vecSubMesh)
+                mapMaterialItems[subMesh.material].push_back({ index, &shape, &subMesh });
+        }
+
+        for (const auto& [faceMaterial, vecItem] : mapMaterialItems) {
+            MaterialArrays material;
+            material.material = faceMaterial;
+            std::vector<int> vecVertexCount;
+            for (const TrianglesItem& item : vecItem)
+                vecVertexCount.push_back(item.nodeCount());
+
+            const Span<const TrianglesItem> spanItem = vecItem;
+            for (const auto& [first, last] : batchRanges(vecVertexCount)) {
+                const Span<const TrianglesItem> spanBatch = spanItem.subspan(first, last - first);
+                auto triangles = this->createTriangles(spanBatch, true/*withColors*/);
+                if (!triangles.IsNull()) {
+                    material.vecTriangles.push_back(triangles);
+                    material.vecTrianglesBatch.emplace_back(spanBatch.begin(), spanBatch.end());
+                }
+            }
+
+            if (!material.vecTriangles.empty())
+                m_arraysCache.vecMaterial.push_back(std::move(material));
+        }
+
+        m_arraysCache.hasTriangles = true;
+    }
+
+    auto fnCreateBoundaries = [&](bool withColors) {
+        std::vector<SegmentsBatch> vecBoundaries;
+        std::vector<int> vecVertexCount;
+        for (int index : vecVisibleInstance)
+            vecVertexCount.push_back(int(this->instanceShape(index).data.vecBoundaryNode.size()));
+
+        const Span<const int> spanInstance = vecVisibleInstance;
+        for (const auto& [first, last] : batchRanges(vecVertexCount)) {
+            const Span<const int> spanBatch = spanInstance.subspan(first, last - first);
+            auto boundaries = this->createBoundaries(spanBatch, withColors);
+            if (!boundaries.IsNull())
+                vecBoundaries.push_back({ boundaries, std::vector<int>(spanBatch.begin(), spanBatch.end()) });
+        }
+
+        return vecBoundaries;
+    };
+
+    if (withBoundaries && !m_arraysCache.hasBoundaries) {
+        m_arraysCache.vecBoundaries = fnCreateBoundaries(false/*withColors*/);
+        m_arraysCache.hasBoundaries = true;
+    }
+
+    if (withColoredBoundaries && !m_arraysCache.hasColoredBoundaries) {
+        m_arraysCache.vecColoredBoundaries = fnCreateBoundaries(true/*withColors*/);
+        m_arraysCache.hasColoredBoundaries = true;
+    }
+}
+
+void GraphicsMergedObject::placeArrays()
+{
+    for (const MaterialArrays& material : m_arraysCache.vecMaterial) {
+        for (size_t i = 0; i < material.vecTriangles.size(); ++i)
+            this->setTrianglesVertices(material.vecTriangles.at(i), material.vecTrianglesBatch.at(i), false/*withColors*/);
+    }
+
+    for (const SegmentsBatch& boundaries : m_arraysCache.vecBoundaries)
+        this->setBoundariesVertices(boundaries.segments, boundaries.vecInstance, false/*withColors*/);
+
+    for (const SegmentsBatch& boundaries : m_arraysCache.vecColoredBoundaries)
+        this->setBoundariesVertices(boundaries.segments, boundaries.vecInstance, false/*withColors*/);
+}
+
+OccHandle<Graphic3d_AspectFillArea3d> GraphicsMergedObject::materialAspect(const FaceMaterial& material) const
+{
+    const OccHandle<Graphic3d_AspectFillArea3d>& aspect = myDrawer->ShadingAspect()->Aspect();
+    bool hasVisMaterial = false;
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+    hasVisMaterial = !material.visMaterial.IsNull();
+#endif
+    if (!hasVisMaterial && material.transparency <= 0.f)
+        return aspect;
+
+    OccHandle<Graphic3d_AspectFillArea3d> aspectMaterial = new Graphic3d_AspectFillArea3d(*aspect);
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+    // Same as XCAFPrs_AISObject, faces without XCAF material keep the material of the drawer
+    if (hasVisMaterial)
+        material.visMaterial->FillAspect(aspectMaterial);
+#endif
+
+    if (material.transparency > 0.f) {
+        Graphic3d_MaterialAspect frontMaterial = aspectMaterial->FrontMaterial();
+        frontMaterial.SetTransparency(material.transparency);
+        aspectMaterial->SetFrontMaterial(frontMaterial);
+        aspectMaterial->SetBackMaterial(frontMaterial);
+    }
+
+    return aspectMaterial;
+}
+
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+void GraphicsMergedObject::addHiddenLines(
+        const Handle(Graphic3d_Camera)& camera, const gp_Trsf& trsf, const Handle(Prs3d_Presentation)& pres) const
+{
+    // Visible parts are gathered in a compound computed at once, as AIS_Shape does for its shape
+    TopoDS_Compound compound;
+    BRep_Builder builder;
+    builder.MakeCompound(compound);
+    bool isCompoundEmpty = true;
+    for (int i = 0; i < this->instanceCount(); ++i) {
+        if (!this->isInstanceVisible(i))
+            continue;
+
+        const TopoDS_Shape shape = XCaf::shape(this->instanceLabel(i));
+        if (!shape.IsNull()) {
+            builder.Add(compound, shape.Moved(TopLoc_Location(trsf * this->instanceTransformation(i))));
+            isCompoundEmpty = false;
+        }
+    }
+
+    if (isCompoundEmpty)
+        return;
+
+    if (myDrawer->TypeOfHLR() == Prs3d_TOH_Algo) {
+        StdPrs_HLRShape builderHLR;
+        builderHLR.ComputeHLR(pres, compound, myDrawer, camera);
+    }
+    else {
+        StdPrs_HLRPolyShape builderHLR;
+        builderHLR.ComputeHLR(pres, compound, myDrawer, camera);
+    }
+}
+#endif
+
+OccHandle<Graphic3d_ArrayOfTriangles>
+GraphicsMergedObject::createTriangles(Span<const TrianglesItem> spanItem, bool withColors) const
+{
+    int vertexCount = 0;
+    int indexCount = 0;
+    for (const TrianglesItem& item : spanItem) {
+        vertexCount += item.nodeCount();
+        indexCount += int(item.indices().size());
+    }
+
+    if (indexCount == 0)
+        return {};
+
+    OccHandle<Graphic3d_ArrayOfTriangles> triangles = new Graphic3d_ArrayOfTriangles(
+                vertexCount, indexCount, true/*normals*/, withColors
+    );
+    // Element counts are set first so vertices and indices can be set concurrently
+    triangles->Attributes()->NbElements = vertexCount;
+    triangles->Indices()->NbElements = indexCount;
+    this->setTrianglesVertices(triangles, spanItem, withColors);
+    return triangles;
+}
+
+void GraphicsMergedObject::setTrianglesVertices(
+        const OccHandle<Graphic3d_ArrayOfTriangles>& triangles, Span<const TrianglesItem> spanItem, bool withColors) const
+{
+    // Offsets of the vertices and indices of each item in the primitive array
+    const int itemCount = int(spanItem.size());
+    std::vector<int> vecVertexOffset(itemCount + 1, 0);
+    std::vector<int> vecIndexOffset(itemCount + 1, 0);
+    for (int i = 0; i < itemCount; ++i) {
+        vecVertexOffset.at(i + 1) = vecVertexOffset.at(i) + spanItem[i].nodeCount();
+        vecIndexOffset.at(i + 1) = vecIndexOffset.at(i) + int(spanItem[i].indices().size());
+    }
+
+    const OccHandle<Graphic3d_IndexBuffer>& indices = triangles->Indices();
+    OSD_Parallel::For(0, itemCount, [&](int i) {
+        const TrianglesItem& item = spanItem[i];
+        const ShapeTriangles& data = item.shape->data;
+        const gp_Trsf& trsf = this->instanceTransformation(item.instanceIndex);
+        const gp_Mat matRotation = trsf.HVectorialPart();
+        // Mirroring transformation reverses the orientation of the triangles
+        const bool isMirrored = trsf.IsNegative();
+        const double normalSign = isMirrored ? -1. : 1.;
+        const int vertexOffset = vecVertexOffset.at(i);
+        const int nodeCount = item.nodeCount();
+        for (int j = 0; j < nodeCount; ++j) {
+            const int node = item.node(j);
+            gp_XYZ coords = toXYZ(data.vecNode[node]);
+            trsf.Transforms(coords);
+            const gp_XYZ normal = toXYZ(data.vecNormal[node]).Multiplied(matRotation) * normalSign;
+            triangles->SetVertice(vertexOffset + j + 1, gp_Pnt(coords));
+            triangles->SetVertexNormal(vertexOffset + j + 1, normal.X(), normal.Y(), normal.Z());
+            if (withColors)
+                triangles->SetVertexColor(vertexOffset + j + 1, data.vecColor[node]);
+        }
+
+        // Triangles of a hidden part are collapsed, so the array doesn't have to be rebuilt
+        const bool isVisible = this->isInstanceVisible(item.instanceIndex);
+        const Span<const int> spanIndex = item.indices();
+        const int indexOffset = vecIndexOffset.at(i);
+        for (int j = 0; j + 2 < int(spanIndex.size()); j += 3) {
+            int n1 = spanIndex[j];
+            int n2 = spanIndex[j + 1];
+            int n3 = spanIndex[j + 2];
+            if (!isVisible)
+                n2 = n3 = n1;
+            else if (isMirrored)
+                std::swap(n2, n3);
+
+            indices->SetIndex(indexOffset + j, vertexOffset + n1);
+            indices->SetIndex(indexOffset + j + 1, vertexOffset + n2);
+            indices->SetIndex(indexOffset + j + 2, vertexOffset + n3);
+        }
+    }, itemCount < 2/*isForceSingleThreadExecution*/);
+}
+
+OccHandle<Graphic3d_ArrayOfSegments>
+GraphicsMergedObject::createBoundaries(Span<const int> spanInstance, bool withColors) const
+{
+    int vertexCount = 0;
+    for (int index : spanInstance)
+        vertexCount += int(this->instanceShape(index).data.vecBoundaryNode.size());
+
+    if (vertexCount == 0)
+        return {};
+
+    OccHandle<Graphic3d_ArrayOfSegments> segments = new Graphic3d_ArrayOfSegments(vertexCount, 0, withColors);
+    segments->Attributes()->NbElements = vertexCount;
+    this->setBoundariesVertices(segments, spanInstance, withColors);
+    return segments;
+}
+
+void GraphicsMergedObject::setBoundariesVertices(
+        const OccHandle<Graphic3d_ArrayOfSegments>& segments, Span<const int> spanInstance, bool withColors) const
+{
+    const int instanceCount = int(spanInstance.size());
+    std::vector<int> vecVertexOffset(instanceCount + 1, 0);
+    for (int i = 0; i < instanceCount; ++i) {
+        const int nodeCount = int(this->instanceShape(spanInstance[i]).data.vecBoundaryNode.size());
+        vecVertexOffset.at(i + 1) = vecVertexOffset.at(i) + nodeCount;
+    }
+
+    OSD_Parallel::For(0, instanceCount, [&](int i) {
+        const ShapeTriangles& data = this->instanceShape(spanInstance[i]).data;
+        const gp_Trsf& trsf = this->instanceTransformation(spanInstance[i]);
+        // Segments of a hidden part are collapsed into a point, so they aren't drawn
+        const bool isVisible = this->isInstanceVisible(spanInstance[i]);
+        // Boundaries of a part are drawn with the color of its first face
+        const Graphic3d_Vec4ub color = !data.vecColor.empty() ? data.vecColor.front() : Graphic3d_Vec4ub(255, 255, 255, 255);
+        const int vertexOffset = vecVertexOffset.at(i);
+        for (int j = 0; j < int(data.vecBoundaryNode.size()); ++j) {
+            gp_XYZ coords = toXYZ(data.vecBoundaryNode[isVisible ? j : 0]);
+            trsf.Transforms(coords);
+            segments->SetVertice(vertexOffset + j + 1, gp_Pnt(coords));
+            if (withColors)
+                segments->SetVertexColor(vertexOffset + j + 1, color);
+        }
+    }, instanceCount < 2/*isForceSingleThreadExecution*/);
+}
+
+} // namespace Mayo
@@ -0,0 +1,162 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "graphics_composite_object.h"
+#include "../base/caf_utils.h"
+
+#include <Bnd_Box.hxx>
+#include <Graphic3d_ArrayOfSegments.hxx>
+#include <Graphic3d_Camera.hxx>
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+#  include <TopLoc_Datum3D.hxx>
+#elif OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+#  include <Geom_Transformation.hxx>
+#endif
+
+#include <unordered_map>
+
+namespace Mayo {
+
+// Graphics object merging the triangles of many shapes("parts", eg the components of a static
+// assembly) into a few primitive arrays per material, so they are drawn with a few draw calls
+// instead of several per part
+// Materials are told apart by the XCAF material and transparency of faces: faces with the same
+// material share primitive arrays drawn with a single aspect, colors being vertex attributes
+// Triangles of a shape are extracted once and shared by all the parts presenting that shape
+// Parts are instances of GraphicsCompositeObject, so they can be selected and highlighted individually
+// Supported display modes are AIS_WireFrame and AIS_Shaded(with optional face boundaries), hidden
+// line removal is computed when enabled in the view(see PrsMgr_TOP_ProjectorDependent)
+// The renderer culls the object as a whole, so merged parts should be close to each other(see spatialChunks())
+class GraphicsMergedObject : public GraphicsCompositeObject {
+public:
+    // Controls how edges are drawn in AIS_Shaded mode with face boundaries
+    enum class EdgeRendering {
+        FaceBoundaries, // Face boundaries computed by OpenCascade for each presentation
+        Extracted, // Boundary and sharp edges derived once from triangulations, see MeshEdgeEngine
+        ScreenSpace // Silhouette outline drawn by the GPU, no edge geometry at all
+    };
+
+    GraphicsMergedObject(EdgeRendering edgeRendering = EdgeRendering::FaceBoundaries);
+
+    // 'label' is the shape of the part, it must be meshed
+    // Redisplay() and selection recomputation have to be requested so changes take effect
+    int addInstance(const TDF_Label& label, const gp_Trsf& trsf);
+
+    // Extracts again triangles, colors and face boundaries of the part shapes
+    void loadTriangles() override;
+
+    // Splits the items whose bounding boxes are 'spanBox' into chunks of nearby items, each chunk
+    // having at most 'maxChunkSize' items. Chunks are made of indices in 'spanBox'
+    // Items are recursively split at the median of their box centers along the longest axis
+    static std::vector<std::vector<int>> spatialChunks(Span<const Bnd_Box> spanBox, int maxChunkSize);
+
+    DEFINE_STANDARD_RTTI_INLINE(GraphicsMergedObject, GraphicsCompositeObject)
+
+protected:
+    void Compute(
+            const Handle(PrsMgr_PresentationManager)& pm,
+            const Handle(Prs3d_Presentation)& pres,
+            const int mode) override;
+
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    void computeHLR(
+            const Handle(Graphic3d_Camera)& camera,
+            const Handle(TopLoc_Datum3D)& trsf,
+            const Handle(Prs3d_Presentation)& pres) override;
+#elif OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+    void computeHLR(
+            const Handle(Graphic3d_Camera)& camera,
+            const Handle(Geom_Transformation)& trsf,
+            const Handle(Prs3d_Presentation)& pres) override;
+#endif
+
+    // -- from GraphicsCompositeObject
+    OccHandle<Graphic3d_ArrayOfTriangles> instanceSensitiveTriangles(int index) const override;
+    void addHighlightTriangles(
+            const Handle(Prs3d_Presentation)& pres,
+            const OccHandle<Graphic3d_AspectFillArea3d>& fillAspect,
+            Span<const int> spanInstance
+    ) const override;
+    void invalidateArraysCache() override;
+    void invalidateArraysPlacement() override;
+
+private:
+    // Triangles of a shape having the same material
+    struct SubMesh {
+        FaceMaterial material;
+        bool isWholeShape = false; // All the shape triangles, then 'vecNode' and 'vecIndex' are empty
+        std::vector<int> vecNode; // Indices of the shape nodes used by the sub-mesh
+        std::vector<int> vecIndex; // Three indices(0-based, in 'vecNode') per triangle
+    };
+
+    struct Shape {
+        TDF_Label label;
+        ShapeTriangles data;
+        std::vector<SubMesh> vecSubMesh;
+    };
+
+    // Triangles of a shape(or of one of its sub-meshes) placed by the transformation of a part
+    struct TrianglesItem {
+        int instanceIndex;
+        const Shape* shape;
+        const SubMesh* subMesh; // Null for all the shape triangles
+
+        int nodeCount() const;
+        int node(int i) const;
+        Span<const int> indices() const;
+    };
+
+    struct MaterialArrays {
+        FaceMaterial material;
+        std::vector<OccHandle<Graphic3d_ArrayOfTriangles>> vecTriangles;
+        std::vector<std::vector<TrianglesItem>> vecTrianglesBatch; // Items of each array of 'vecTriangles'
+    };
+
+    // Instances of each array of segments
+    struct SegmentsBatch {
+        OccHandle<Graphic3d_ArrayOfSegments> segments;
+        std::vector<int> vecInstance;
+    };
+
+    struct Arrays {
+        std::vector<MaterialArrays> vecMaterial;
+        std::vector<SegmentsBatch> vecBoundaries;
+        std::vector<SegmentsBatch> vecColoredBoundaries; // Wireframe mode
+        bool hasTriangles = false;
+        bool hasBoundaries = false;
+        bool hasColoredBoundaries = false;
+    };
+
+    void loadShape(Shape* shape) const;
+    const Shape& instanceShape(int index) const { return m_vecShape.at(m_vecInstanceShape.at(index)); }
+    void fillArrays(bool withTriangles, bool withBoundaries, bool withColoredBoundaries);
+    void placeArrays();
+    OccHandle<Graphic3d_AspectFillArea3d> materialAspect(const FaceMaterial& material) const;
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+    void addHiddenLines(
+            const Handle(Graphic3d_Camera)& camera, const gp_Trsf& trsf, const Handle(Prs3d_Presentation)& pres
+    ) const;
+#endif
+    OccHandle<Graphic3d_ArrayOfTriangles> createTriangles(Span<const TrianglesItem> spanItem, bool withColors) const;
+    void setTrianglesVertices(
+            const OccHandle<Graphic3d_ArrayOfTriangles>& triangles, Span<const TrianglesItem> spanItem, bool withColors
+    ) const;
+    OccHandle<Graphic3d_ArrayOfSegments> createBoundaries(Span<const int> spanInstance, bool withColors) const;
+    void setBoundariesVertices(
+            const OccHandle<Graphic3d_ArrayOfSegments>& segments, Span<const int> spanInstance, bool withColors
+    ) const;
+
+    std::vector<Shape> m_vecShape;
+    std::unordered_map<TDF_Label, int> m_mapLabelShape; // Index in 'm_vecShape'
+    std::vector<int> m_vecInstanceShape; // Index in 'm_vecShape' of each instance
+    EdgeRendering m_edgeRendering = EdgeRendering::FaceBoundaries;
+    Arrays m_arraysCache;
+    bool m_isArraysCachePlacementInvalid = false;
+};
+
+} // namespace Mayo
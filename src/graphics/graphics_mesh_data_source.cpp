@@ -8,11 +8,11 @@
 
 #include "../base/mesh_utils.h"
 
+#include <OSD_Parallel.hxx>
 #include <Precision.hxx>
 #include <Standard_Type.hxx>
-#include <TColgp_SequenceOfXYZ.hxx>
-#include <TColStd_DataMapOfIntegerInteger.hxx>
-#include <TColStd_DataMapOfIntegerReal.hxx>
+
+#include <cmath>
 
 namespace Mayo {
 
@@ -20,45 +20,13 @@ GraphicsMeshDataSource::GraphicsMeshDataSource(const Handle_Poly_Triangulation&
     : m_mesh(mesh)
 {
     if (!m_mesh.IsNull()) {
-        const int lenCoords = m_mesh->NbNodes();
-        m_nodeCoords = new TColStd_HArray2OfReal(1, lenCoords, 1, 3);
-
-        for(int i = 1; i <= lenCoords; ++i) {
+        m_spanTriangle = MeshUtils::contiguousTriangles(m_mesh);
+        // Packed maps store contiguous IDs as bit blocks, so they are compact
+        for (int i = 1; i <= m_mesh->NbNodes(); ++i)
             m_nodes.Add(i);
-            const gp_XYZ xyz = m_mesh->Node(i).XYZ();
-            m_nodeCoords->SetValue(i, 1, xyz.X());
-            m_nodeCoords->SetValue(i, 2, xyz.Y());
-            m_nodeCoords->SetValue(i, 3, xyz.Z());
-        }
 
-        const Poly_Array1OfTriangle& aSeq = MeshUtils::triangles(m_mesh);
-        const int lenTriangles = aSeq.Length();
-        m_elemNormals = new TColStd_HArray2OfReal(1, lenTriangles, 1, 3);
-        m_elemNodes = new TColStd_HArray2OfInteger(1, lenTriangles, 1, 3);
-
-        for(int i = 1; i <= lenTriangles; ++i ) {
+        for (int i = 1; i <= int(m_spanTriangle.size()); ++i)
             m_elements.Add(i);
-            const Poly_Triangle& aTri = aSeq(i);
-
-            int V[3];
-            aTri.Get(V[0], V[1], V[2]);
-
-            const gp_Vec aV1(m_mesh->Node(V[0]), m_mesh->Node(V[1]));
-            const gp_Vec aV2(m_mesh->Node(V[1]), m_mesh->Node(V[2]));
-
-            gp_Vec aN = aV1.Crossed(aV2);
-            if (aN.SquareMagnitude() > Precision::SquareConfusion())
-                aN.Normalize();
-            else
-                aN.SetCoord(0.0, 0.0, 0.0);
-
-            for (int j = 0; j < 3; ++j)
-                m_elemNodes->SetValue(i, j+1, V[j]);
-
-            m_elemNormals->SetValue (i, 1, aN.X());
-            m_elemNormals->SetValue (i, 2, aN.Y());
-            m_elemNormals->SetValue (i, 3, aN.Z());
-        }
     }
 }
 
@@ -76,10 +44,13 @@ bool GraphicsMeshDataSource::GetGeom(
         if (ID >= 1 && ID <= m_elements.Extent()) {
             Type = MeshVS_ET_Face;
             NbNodes = 3;
-            for (int i = 1, k = 1; i <= 3; ++i) {
-                const int IdxNode = m_elemNodes->Value(ID, i);
-                for (int j = 1; j <= 3; ++j, ++k)
-                    Coords(k) = m_nodeCoords->Value(IdxNode, j);
+            int nodes[3];
+            m_spanTriangle[ID - 1].Get(nodes[0], nodes[1], nodes[2]);
+            for (int i = 0, k = Coords.Lower(); i < 3; ++i, k += 3) {
+                const gp_Pnt pnt = m_mesh->Node(nodes[i]);
+                Coords(k) = pnt.X();
+                Coords(k + 1) = pnt.Y();
+                Coords(k + 2) = pnt.Z();
             }
 
             return true;
@@ -92,9 +63,11 @@ bool GraphicsMeshDataSource::GetGeom(
             Type = MeshVS_ET_Node;
             NbNodes = 1;
 
-            Coords(1) = m_nodeCoords->Value(ID, 1);
-            Coords(2) = m_nodeCoords->Value(ID, 2);
-            Coords(3) = m_nodeCoords->Value(ID, 3);
+            const gp_Pnt pnt = m_mesh->Node(ID);
+            const int k = Coords.Lower();
+            Coords(k) = pnt.X();
+            Coords(k + 1) = pnt.Y();
+            Coords(k + 2) = pnt.Z();
             return true;
         }
 
@@ -115,9 +88,7 @@ bool GraphicsMeshDataSource::GetNodesByElement(const int ID, TColStd_Array1OfInt
 
     if (ID >= 1 && ID <= m_elements.Extent() && theNodeIDs.Length() >= 3) {
         const int aLow = theNodeIDs.Lower();
-        theNodeIDs(aLow)     = m_elemNodes->Value(ID, 1);
-        theNodeIDs(aLow + 1) = m_elemNodes->Value(ID, 2);
-        theNodeIDs(aLow + 2) = m_elemNodes->Value(ID, 3);
+        m_spanTriangle[ID - 1].Get(theNodeIDs(aLow), theNodeIDs(aLow + 1), theNodeIDs(aLow + 2));
         return true;
     }
 
@@ -130,13 +101,62 @@ bool GraphicsMeshDataSource::GetNormal(const int Id, const int Max, double& nx,
         return false;
 
     if (Id >= 1 && Id <= m_elements.Extent() && Max >= 3) {
-        nx = m_elemNormals->Value(Id, 1);
-        ny = m_elemNormals->Value(Id, 2);
-        nz = m_elemNormals->Value(Id, 3);
+        std::call_once(m_elementNormalsFlag, [this]{ this->computeElementNormals(); });
+        const Graphic3d_Vec3& normal = m_vecElementNormal.at(Id - 1);
+        nx = normal.x();
+        ny = normal.y();
+        nz = normal.z();
         return true;
     }
 
     return false;
 }
 
+bool GraphicsMeshDataSource::GetNodeNormal(
+        const int RankNode, const int ElementId, double& nx, double& ny, double& nz) const
+{
+    // Only normals stored in the triangulation are provided, MeshVS falls back to element normals
+    if (m_mesh.IsNull() || !m_mesh->HasNormals())
+        return false;
+
+    if (ElementId >= 1 && ElementId <= m_elements.Extent() && RankNode >= 1 && RankNode <= 3) {
+        const int node = m_spanTriangle[ElementId - 1].Value(RankNode);
+#if OCC_VERSION_HEX >= 0x070600
+        const gp_Dir normal = m_mesh->Normal(node);
+        nx = normal.X();
+        ny = normal.Y();
+        nz = normal.Z();
+#else
+        const TShort_Array1OfShortReal& normals = m_mesh->Normals();
+        nx = normals.Value(3 * node - 2);
+        ny = normals.Value(3 * node - 1);
+        nz = normals.Value(3 * node);
+#endif
+        return true;
+    }
+
+    return false;
+}
+
+void GraphicsMeshDataSource::computeElementNormals() const
+{
+    std::vector<gp_XYZ> vecNodeCopy;
+    const Span<const gp_XYZ> spanNode = MeshUtils::contiguousNodes(m_mesh, &vecNodeCopy);
+    std::vector<gp_XYZ> vecNormal(m_spanTriangle.size());
+    MeshUtils::batchTriangleNormals({ spanNode, m_spanTriangle }, vecNormal);
+
+    const int triangleCount = int(vecNormal.size());
+    m_vecElementNormal.resize(triangleCount);
+    OSD_Parallel::For(0, triangleCount, [&](int i) {
+        const gp_XYZ& normal = vecNormal.at(i);
+        const double sqLength = normal.SquareModulus();
+        if (sqLength > Precision::SquareConfusion()) {
+            const double length = std::sqrt(sqLength);
+            m_vecElementNormal.at(i) = Graphic3d_Vec3(
+                        float(normal.X() / length), float(normal.Y() / length), float(normal.Z() / length)
+            );
+        }
+    }, triangleCount < 1024/*isForceSingleThreadExecution*/);
+}
+
 } // namespace Mayo
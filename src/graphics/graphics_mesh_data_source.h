@@ -10,15 +10,21 @@
 // -- Basically the same as XSDRAWSTLVRML_DataSource but it allows to be free of TKXSDRAW
 // --
 
+#include "../base/span.h"
+
+#include <Graphic3d_Vec3.hxx>
 #include <MeshVS_DataSource.hxx>
 #include <MeshVS_EntityType.hxx>
 #include <Poly_Triangulation.hxx>
 #include <TColStd_PackedMapOfInteger.hxx>
-#include <TColStd_HArray2OfInteger.hxx>
-#include <TColStd_HArray2OfReal.hxx>
+
+#include <mutex>
+#include <vector>
 
 namespace Mayo {
 
+// Zero-copy view over a Poly_Triangulation object: nodes and triangles are read directly from the
+// triangulation. Triangle normals are computed on first request, with MeshUtils batch functions
 class GraphicsMeshDataSource : public MeshVS_DataSource {
 public:
     GraphicsMeshDataSource(const Handle_Poly_Triangulation& mesh);
@@ -30,14 +36,17 @@ public:
     const TColStd_PackedMapOfInteger& GetAllNodes() const override { return m_nodes; }
     const TColStd_PackedMapOfInteger& GetAllElements() const override { return m_elements; }
     bool GetNormal(const int Id, const int Max, double& nx, double& ny, double& nz) const override;
+    bool GetNodeNormal(const int RankNode, const int ElementId, double& nx, double& ny, double& nz) const override;
 
 private:
-  Handle_Poly_Triangulation m_mesh;
-  TColStd_PackedMapOfInteger m_nodes;
-  TColStd_PackedMapOfInteger m_elements;
-  Handle_TColStd_HArray2OfInteger m_elemNodes;
-  Handle_TColStd_HArray2OfReal m_nodeCoords;
-  Handle_TColStd_HArray2OfReal m_elemNormals;
+    void computeElementNormals() const;
+
+    Handle_Poly_Triangulation m_mesh;
+    Span<const Poly_Triangle> m_spanTriangle;
+    TColStd_PackedMapOfInteger m_nodes;
+    TColStd_PackedMapOfInteger m_elements;
+    mutable std::vector<Graphic3d_Vec3> m_vecElementNormal;
+    mutable std::once_flag m_elementNormalsFlag;
 };
 
 } // namespace Mayo
@@ -0,0 +1,246 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "graphics_mesh_object.h"
+
+#include "../base/caf_utils.h"
+#include "../base/cpp_utils.h"
+#include "../base/mesh_utils.h"
+#include "../base/triangulation_annex_data.h"
+#include "../base/xcaf.h"
+
+#include <BRep_Tool.hxx>
+
+#include <Graphic3d_ArrayOfPoints.hxx>
+#include <Graphic3d_AspectFillArea3d.hxx>
+#include <Graphic3d_AspectMarker3d.hxx>
+#include <Graphic3d_Group.hxx>
+#include <Graphic3d_IndexBuffer.hxx>
+#include <Graphic3d_MaterialAspect.hxx>
+#include <Graphic3d_Vec3.hxx>
+#include <OSD_Parallel.hxx>
+#include <Select3D_SensitiveTriangulation.hxx>
+#include <SelectMgr_EntityOwner.hxx>
+#include <TopoDS.hxx>
+
+#include <algorithm>
+
+namespace Mayo {
+
+namespace {
+
+constexpr int ChunkSize = 16384;
+
+// Calls 'fn(first, last)' on chunks of range [0, count[, chunks are processed in parallel
+template<typename Function>
+void parallelForChunks(int count, Function fn)
+{
+    const int chunkCount = (count + ChunkSize - 1) / ChunkSize;
+    OSD_Parallel::For(0, chunkCount, [&](int iChunk) {
+        const int first = iChunk * ChunkSize;
+        fn(first, std::min(first + ChunkSize, count));
+    }, chunkCount < 2/*isForceSingleThreadExecution*/);
+}
+
+Graphic3d_Vec3 toGraphicVec3(const gp_XYZ& coords)
+{
+    return Graphic3d_Vec3(float(coords.X()), float(coords.Y()), float(coords.Z()));
+}
+
+} // namespace
+
+GraphicsMeshObject::GraphicsMeshObject(
+        const OccHandle<Poly_Triangulation>& mesh, Span<const Quantity_Color> spanNodeColor)
+{
+    this->setTriangulation(mesh, spanNodeColor);
+}
+
+GraphicsMeshObject::GraphicsMeshObject(const TDF_Label& label)
+    : m_label(label)
+{
+    this->syncWithLabel();
+}
+
+void GraphicsMeshObject::setTriangulation(
+        const OccHandle<Poly_Triangulation>& mesh, Span<const Quantity_Color> spanNodeColor)
+{
+    m_mesh = mesh;
+    m_indexedTriangles.Nullify();
+    m_vecNodeColor.clear();
+    if (!mesh.IsNull() && CppUtils::cmpEqual(spanNodeColor.size(), mesh->NbNodes())) {
+        m_vecNodeColor.reserve(spanNodeColor.size());
+        for (const Quantity_Color& color : spanNodeColor) {
+            m_vecNodeColor.emplace_back(
+                        Standard_Byte(color.Red() * 255.),
+                        Standard_Byte(color.Green() * 255.),
+                        Standard_Byte(color.Blue() * 255.),
+                        Standard_Byte(255)
+            );
+        }
+    }
+}
+
+void GraphicsMeshObject::syncWithLabel()
+{
+    if (m_label.IsNull() || !XCaf::isShape(m_label))
+        return;
+
+    const TopoDS_Shape shape = XCaf::shape(m_label);
+    if (shape.ShapeType() != TopAbs_FACE)
+        return;
+
+    TopLoc_Location locFace;
+    const OccHandle<Poly_Triangulation>& mesh = BRep_Tool::Triangulation(TopoDS::Face(shape), locFace);
+    if (mesh == m_mesh)
+        return;
+
+    auto attrMeshData = CafUtils::findAttribute<TriangulationAnnexData>(m_label);
+    this->setTriangulation(mesh, attrMeshData ? attrMeshData->nodeColors() : Span<const Quantity_Color>{});
+}
+
+bool GraphicsMeshObject::AcceptDisplayMode(const int mode) const
+{
+    return mode == DisplayMode_Wireframe || mode == DisplayMode_Shaded || mode == DisplayMode_Shrink;
+}
+
+void GraphicsMeshObject::ComputeSelection(const Handle(SelectMgr_Selection)& sel, const int mode)
+{
+    this->syncWithLabel();
+    if (mode != 0 || m_mesh.IsNull() || m_mesh->NbTriangles() == 0)
+        return;
+
+    // Select3D_SensitiveTriangulation builds a BVH over the triangles
+    OccHandle<SelectMgr_EntityOwner> owner = new SelectMgr_EntityOwner(this);
+    sel->Add(new Select3D_SensitiveTriangulation(owner, m_mesh, TopLoc_Location(), true/*interior*/));
+}
+
+void GraphicsMeshObject::Compute(
+        const Handle(PrsMgr_PresentationManager)&,
+        const Handle(Prs3d_Presentation)& pres,
+        const int mode)
+{
+    this->syncWithLabel();
+    if (m_mesh.IsNull() || m_mesh->NbTriangles() == 0)
+        return;
+
+    Graphic3d_MaterialAspect material(m_material);
+    material.SetColor(m_color);
+    OccHandle<Graphic3d_AspectFillArea3d> fillAspect = new Graphic3d_AspectFillArea3d;
+    fillAspect->SetInteriorStyle(mode == DisplayMode_Wireframe ? Aspect_IS_EMPTY : Aspect_IS_SOLID);
+    fillAspect->SetInteriorColor(m_color);
+    fillAspect->SetFrontMaterial(material);
+    fillAspect->SetBackMaterial(material);
+    fillAspect->SetEdgeColor(m_edgeColor);
+    if (mode == DisplayMode_Wireframe || m_showEdges)
+        fillAspect->SetEdgeOn();
+    else
+        fillAspect->SetEdgeOff();
+
+    OccHandle<Graphic3d_Group> groupTriangles = pres->NewGroup();
+    groupTriangles->SetGroupPrimitivesAspect(fillAspect);
+    if (mode == DisplayMode_Shrink)
+        groupTriangles->AddPrimitiveArray(this->createShrinkedTriangles());
+    else
+        groupTriangles->AddPrimitiveArray(this->indexedTriangles());
+
+    if (m_showNodes) {
+        const int nodeCount = m_mesh->NbNodes();
+        OccHandle<Graphic3d_ArrayOfPoints> points = new Graphic3d_ArrayOfPoints(nodeCount);
+        points->Attributes()->NbElements = nodeCount; // Vertices are then set concurrently
+        parallelForChunks(nodeCount, [&](int first, int last) {
+            for (int i = first; i < last; ++i)
+                points->SetVertice(i + 1, m_mesh->Node(i + 1));
+        });
+
+        OccHandle<Graphic3d_Group> groupNodes = pres->NewGroup();
+        groupNodes->SetGroupPrimitivesAspect(new Graphic3d_AspectMarker3d(Aspect_TOM_POINT, m_edgeColor, 1.));
+        groupNodes->AddPrimitiveArray(points);
+    }
+}
+
+const OccHandle<Graphic3d_ArrayOfTriangles>& GraphicsMeshObject::indexedTriangles()
+{
+    if (!m_indexedTriangles.IsNull())
+        return m_indexedTriangles;
+
+    const int nodeCount = m_mesh->NbNodes();
+    const Span<const Poly_Triangle> spanTriangle = MeshUtils::contiguousTriangles(m_mesh);
+    const int triangleCount = int(spanTriangle.size());
+    const bool hasMeshNormals = m_mesh->HasNormals();
+    const bool hasColors = this->hasNodeColors();
+    std::vector<gp_XYZ> vecNodeNormal;
+    if (!hasMeshNormals)
+        vecNodeNormal = MeshUtils::nodeNormals(m_mesh);
+
+    OccHandle<Graphic3d_ArrayOfTriangles> triangles = new Graphic3d_ArrayOfTriangles(
+                nodeCount, 3 * triangleCount, true/*normals*/, hasColors
+    );
+    // Element counts are set first so vertices and indices can be set concurrently
+    triangles->Attributes()->NbElements = nodeCount;
+    triangles->Indices()->NbElements = 3 * triangleCount;
+    parallelForChunks(nodeCount, [&](int first, int last) {
+        for (int i = first; i < last; ++i) {
+            triangles->SetVertice(i + 1, m_mesh->Node(i + 1));
+            const Graphic3d_Vec3 normal =
+                    toGraphicVec3(hasMeshNormals ? MeshUtils::nodeNormal(m_mesh, i + 1) : vecNodeNormal.at(i));
+            triangles->SetVertexNormal(i + 1, normal.x(), normal.y(), normal.z());
+            if (hasColors)
+                triangles->SetVertexColor(i + 1, m_vecNodeColor.at(i));
+        }
+    });
+
+    const OccHandle<Graphic3d_IndexBuffer>& indices = triangles->Indices();
+    parallelForChunks(triangleCount, [&](int first, int last) {
+        for (int i = first; i < last; ++i) {
+            int n1, n2, n3;
+            spanTriangle[i].Get(n1, n2, n3);
+            indices->SetIndex(3 * i, n1 - 1);
+            indices->SetIndex(3 * i + 1, n2 - 1);
+            indices->SetIndex(3 * i + 2, n3 - 1);
+        }
+    });
+
+    m_indexedTriangles = triangles;
+    return m_indexedTriangles;
+}
+
+OccHandle<Graphic3d_ArrayOfTriangles> GraphicsMeshObject::createShrinkedTriangles() const
+{
+    // Each triangle has its own vertices, scaled around the triangle centroid
+    const Span<const Poly_Triangle> spanTriangle = MeshUtils::contiguousTriangles(m_mesh);
+    const int triangleCount = int(spanTriangle.size());
+    const bool hasColors = this->hasNodeColors();
+    OccHandle<Graphic3d_ArrayOfTriangles> triangles = new Graphic3d_ArrayOfTriangles(
+                3 * triangleCount, 0, true/*normals*/, hasColors
+    );
+    triangles->Attributes()->NbElements = 3 * triangleCount;
+    parallelForChunks(triangleCount, [&](int first, int last) {
+        for (int i = first; i < last; ++i) {
+            int n[3];
+            spanTriangle[i].Get(n[0], n[1], n[2]);
+            const gp_XYZ pnts[] = {
+                m_mesh->Node(n[0]).XYZ(), m_mesh->Node(n[1]).XYZ(), m_mesh->Node(n[2]).XYZ()
+            };
+            const gp_XYZ center = (pnts[0] + pnts[1] + pnts[2]) / 3.;
+            gp_XYZ normal = (pnts[1] - pnts[0]).Crossed(pnts[2] - pnts[0]);
+            const double normalLength = normal.Modulus();
+            if (normalLength > 0)
+                normal /= normalLength;
+
+            for (int k = 0; k < 3; ++k) {
+                const int iVertex = 3 * i + k + 1;
+                triangles->SetVertice(iVertex, gp_Pnt(center + m_shrinkCoefficient * (pnts[k] - center)));
+                triangles->SetVertexNormal(iVertex, normal.X(), normal.Y(), normal.Z());
+                if (hasColors)
+                    triangles->SetVertexColor(iVertex, m_vecNodeColor.at(n[k] - 1));
+            }
+        }
+    });
+
+    return triangles;
+}
+
+} // namespace Mayo
@@ -0,0 +1,111 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/occ_handle.h"
+#include "../base/span.h"
+#include "../base/tkernel_utils.h"
+
+#include <AIS_InteractiveObject.hxx>
+#include <Graphic3d_ArrayOfTriangles.hxx>
+#include <Graphic3d_NameOfMaterial.hxx>
+#include <Graphic3d_Vec4.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Prs3d_Presentation.hxx>
+#include <PrsMgr_PresentationManager.hxx>
+#include <Quantity_Color.hxx>
+#include <SelectMgr_Selection.hxx>
+#include <TDF_Label.hxx>
+
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+#  include <Prs3d_Projector.hxx>
+#endif
+
+#include <vector>
+
+namespace Mayo {
+
+// Lightweight graphics object for meshes(triangulations), alternative to MeshVS_Mesh
+// Primitive arrays are filled straight from the triangulation in parallel, without intermediate
+// copy of the nodes and triangles. The indexed triangle array is built once and shared by the
+// display modes, so changing attributes(colors, edges, ...) doesn't rebuild it
+// Selection relies on Select3D_SensitiveTriangulation which uses a BVH over the triangles
+class GraphicsMeshObject : public AIS_InteractiveObject {
+public:
+    // Values are the same as MeshVS_DMF_WireFrame, MeshVS_DMF_Shading and MeshVS_DMF_Shrink
+    enum DisplayMode {
+        DisplayMode_Wireframe = 1,
+        DisplayMode_Shaded = 2,
+        DisplayMode_Shrink = 4
+    };
+
+    // 'spanNodeColor' is optional, otherwise it must provide a color for each node of 'mesh'
+    GraphicsMeshObject(const OccHandle<Poly_Triangulation>& mesh, Span<const Quantity_Color> spanNodeColor = {});
+
+    // Mesh entity stored in 'label', ie a face wrapping a triangulation with optional node colors(see
+    // TriangulationAnnexData)
+    // The triangulation is reloaded when the presentation is recomputed and the triangulation of the
+    // face was replaced meanwhile(eg by MeshPostProcess)
+    GraphicsMeshObject(const TDF_Label& label);
+
+    const OccHandle<Poly_Triangulation>& triangulation() const { return m_mesh; }
+    void setTriangulation(const OccHandle<Poly_Triangulation>& mesh, Span<const Quantity_Color> spanNodeColor = {});
+    bool hasNodeColors() const { return !m_vecNodeColor.empty(); }
+
+    // Attributes, Redisplay() has to be called so changes take effect
+    const Quantity_Color& color() const { return m_color; }
+    void setColor(const Quantity_Color& color) { m_color = color; }
+
+    const Quantity_Color& edgeColor() const { return m_edgeColor; }
+    void setEdgeColor(const Quantity_Color& color) { m_edgeColor = color; }
+
+    Graphic3d_NameOfMaterial material() const { return m_material; }
+    void setMaterial(Graphic3d_NameOfMaterial material) { m_material = material; }
+
+    bool showEdges() const { return m_showEdges; }
+    void setShowEdges(bool on) { m_showEdges = on; }
+
+    bool showNodes() const { return m_showNodes; }
+    void setShowNodes(bool on) { m_showNodes = on; }
+
+    double shrinkCoefficient() const { return m_shrinkCoefficient; }
+    void setShrinkCoefficient(double coeff) { m_shrinkCoefficient = coeff; }
+
+    // -- from AIS_InteractiveObject
+    bool AcceptDisplayMode(const int mode) const override;
+    void ComputeSelection(const Handle(SelectMgr_Selection)& sel, const int mode) override;
+
+    DEFINE_STANDARD_RTTI_INLINE(GraphicsMeshObject, AIS_InteractiveObject)
+
+protected:
+    void Compute(
+            const Handle(PrsMgr_PresentationManager)& pm,
+            const Handle(Prs3d_Presentation)& pres,
+            const int mode) override;
+
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+    void Compute(const Handle(Prs3d_Projector)&, const Handle(Prs3d_Presentation)&) override {}
+#endif
+
+private:
+    void syncWithLabel();
+    const OccHandle<Graphic3d_ArrayOfTriangles>& indexedTriangles();
+    OccHandle<Graphic3d_ArrayOfTriangles> createShrinkedTriangles() const;
+
+    TDF_Label m_label;
+    OccHandle<Poly_Triangulation> m_mesh;
+    std::vector<Graphic3d_Vec4ub> m_vecNodeColor;
+    OccHandle<Graphic3d_ArrayOfTriangles> m_indexedTriangles; // Built on first use
+    Quantity_Color m_color = Quantity_NOC_BISQUE;
+    Quantity_Color m_edgeColor = Quantity_NOC_BLACK;
+    Graphic3d_NameOfMaterial m_material = Graphic3d_NOM_PLASTER;
+    bool m_showEdges = false;
+    bool m_showNodes = false;
+    double m_shrinkCoefficient = 0.8;
+};
+
+} // namespace Mayo
@@ -14,6 +14,7 @@
 #include "../base/property_builtins.h"
 #include "../base/xcaf.h"
 #include "graphics_mesh_data_source.h"
+#include "graphics_mesh_object.h"
 #include "graphics_utils.h"
 
 #include <BRep_TFace.hxx>
@@ -27,7 +28,81 @@
 namespace Mayo {
 
 namespace {
+
 struct GraphicsMeshObjectDriverI18N { MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::GraphicsMeshObjectDriver) };
+
+// Display modes are shared by GraphicsMeshObject and MeshVS_Mesh objects
+static_assert(GraphicsMeshObject::DisplayMode_Wireframe == MeshVS_DMF_WireFrame);
+static_assert(GraphicsMeshObject::DisplayMode_Shaded == MeshVS_DMF_Shading);
+static_assert(GraphicsMeshObject::DisplayMode_Shrink == MeshVS_DMF_Shrink);
+
+// Attributes of mesh graphics objects, whatever their kind(GraphicsMeshObject or MeshVS_Mesh)
+struct MeshObjectAttributes {
+    static Quantity_Color color(const GraphicsObjectPtr& object) {
+        if (auto meshObject = OccHandle<GraphicsMeshObject>::DownCast(object))
+            return meshObject->color();
+
+        Quantity_Color color;
+        Handle_MeshVS_Mesh::DownCast(object)->GetDrawer()->GetColor(MeshVS_DA_InteriorColor, color);
+        return color;
+    }
+
+    static Quantity_Color edgeColor(const GraphicsObjectPtr& object) {
+        if (auto meshObject = OccHandle<GraphicsMeshObject>::DownCast(object))
+            return meshObject->edgeColor();
+
+        Quantity_Color color;
+        Handle_MeshVS_Mesh::DownCast(object)->GetDrawer()->GetColor(MeshVS_DA_EdgeColor, color);
+        return color;
+    }
+
+    static bool showEdges(const GraphicsObjectPtr& object) {
+        if (auto meshObject = OccHandle<GraphicsMeshObject>::DownCast(object))
+            return meshObject->showEdges();
+
+        bool on = false;
+        Handle_MeshVS_Mesh::DownCast(object)->GetDrawer()->GetBoolean(MeshVS_DA_ShowEdges, on);
+        return on;
+    }
+
+    static bool showNodes(const GraphicsObjectPtr& object) {
+        if (auto meshObject = OccHandle<GraphicsMeshObject>::DownCast(object))
+            return meshObject->showNodes();
+
+        bool on = false;
+        Handle_MeshVS_Mesh::DownCast(object)->GetDrawer()->GetBoolean(MeshVS_DA_DisplayNodes, on);
+        return on;
+    }
+
+    static void setColor(const GraphicsObjectPtr& object, const Quantity_Color& color) {
+        if (auto meshObject = OccHandle<GraphicsMeshObject>::DownCast(object))
+            meshObject->setColor(color);
+        else
+            Handle_MeshVS_Mesh::DownCast(object)->GetDrawer()->SetColor(MeshVS_DA_InteriorColor, color);
+    }
+
+    static void setEdgeColor(const GraphicsObjectPtr& object, const Quantity_Color& color) {
+        if (auto meshObject = OccHandle<GraphicsMeshObject>::DownCast(object))
+            meshObject->setEdgeColor(color);
+        else
+            Handle_MeshVS_Mesh::DownCast(object)->GetDrawer()->SetColor(MeshVS_DA_EdgeColor, color);
+    }
+
+    static void setShowEdges(const GraphicsObjectPtr& object, bool on) {
+        if (auto meshObject = OccHandle<GraphicsMeshObject>::DownCast(object))
+            meshObject->setShowEdges(on);
+        else
+            Handle_MeshVS_Mesh::DownCast(object)->GetDrawer()->SetBoolean(MeshVS_DA_ShowEdges, on);
+    }
+
+    static void setShowNodes(const GraphicsObjectPtr& object, bool on) {
+        if (auto meshObject = OccHandle<GraphicsMeshObject>::DownCast(object))
+            meshObject->setShowNodes(on);
+        else
+            Handle_MeshVS_Mesh::DownCast(object)->GetDrawer()->SetBoolean(MeshVS_DA_DisplayNodes, on);
+    }
+};
+
 } // namespace
 
 GraphicsMeshObjectDriver::GraphicsMeshObjectDriver()
@@ -65,6 +140,18 @@ GraphicsObjectPtr GraphicsMeshObjectDriver::createObject(const TDF_Label& label)
         }
     }
 
+    if (polyTri && defaultValues().presentation == Presentation::Direct) {
+        OccHandle<GraphicsMeshObject> object = new GraphicsMeshObject(label);
+        object->setShowEdges(defaultValues().showEdges);
+        object->setShowNodes(defaultValues().showNodes);
+        object->setColor(defaultValues().color);
+        object->setMaterial(defaultValues().material);
+        object->setEdgeColor(defaultValues().edgeColor);
+        object->SetDisplayMode(GraphicsMeshObject::DisplayMode_Shaded);
+        object->SetOwner(this);
+        return object;
+    }
+
     if (polyTri) {
         Handle_MeshVS_Mesh object = new MeshVS_Mesh;
         object->SetDataSource(new GraphicsMeshDataSource(polyTri));
@@ -89,6 +176,8 @@ GraphicsObjectPtr GraphicsMeshObjectDriver::createObject(const TDF_Label& label)
         );
         object->GetDrawer()->SetColor(MeshVS_DA_EdgeColor, defaultValues().edgeColor);
         object->GetDrawer()->SetBoolean(MeshVS_DA_ColorReflection, true);
+        // Node normals are provided by the data source only if the triangulation has normals
+        object->GetDrawer()->SetBoolean(MeshVS_DA_SmoothShading, polyTri->HasNormals());
         object->SetDisplayMode(MeshVS_DMF_Shading);
 
         //object->SetHilightMode(MeshVS_DMF_WireFrame);
@@ -117,29 +206,17 @@ Enumeration::Value GraphicsMeshObjectDriver::currentDisplayMode(const GraphicsOb
 class GraphicsMeshObjectDriver::ObjectProperties : public PropertyGroupSignals {
 public:
     ObjectProperties(Span<const GraphicsObjectPtr> spanObject)
+        : m_vecObject(spanObject.begin(), spanObject.end())
     {
         NCollection_Vec3<float> sumColor = {};
         NCollection_Vec3<float> sumEdgeColor = {};
         int countShowEdges = 0;
         int countShowNodes = 0;
         for (const GraphicsObjectPtr& object : spanObject) {
-            auto meshVisu = Handle_MeshVS_Mesh::DownCast(object);
-            // Color
-            Quantity_Color color;
-            meshVisu->GetDrawer()->GetColor(MeshVS_DA_InteriorColor, color);
-            sumColor += color;
-            // Edge color
-            meshVisu->GetDrawer()->GetColor(MeshVS_DA_EdgeColor, color);
-            sumEdgeColor += color;
-            // Show edges
-            bool boolVal;
-            meshVisu->GetDrawer()->GetBoolean(MeshVS_DA_ShowEdges, boolVal);
-            countShowEdges += boolVal ? 1 : 0;
-            // Show nodes
-            meshVisu->GetDrawer()->GetBoolean(MeshVS_DA_DisplayNodes, boolVal);
-            countShowNodes += boolVal ? 1 : 0;
-
-            m_vecMeshVisu.push_back(meshVisu);
+            sumColor += MeshObjectAttributes::color(object);
+            sumEdgeColor += MeshObjectAttributes::edgeColor(object);
+            countShowEdges += MeshObjectAttributes::showEdges(object) ? 1 : 0;
+            countShowNodes += MeshObjectAttributes::showNodes(object) ? 1 : 0;
         }
 
         auto fnCheckState = [&](int count) {
@@ -166,37 +243,37 @@ public:
 
         if (prop == &m_propertyShowEdges) {
             if (m_propertyShowEdges.value() != CheckState::Partially) {
-                for (const Handle_MeshVS_Mesh& meshVisu : m_vecMeshVisu) {
-                    meshVisu->GetDrawer()->SetBoolean(MeshVS_DA_ShowEdges, m_propertyShowEdges.value() == CheckState::On);
-                    fnRedisplay(meshVisu);
+                for (const GraphicsObjectPtr& object : m_vecObject) {
+                    MeshObjectAttributes::setShowEdges(object, m_propertyShowEdges.value() == CheckState::On);
+                    fnRedisplay(object);
                 }
             }
         }
         else if (prop == &m_propertyShowNodes) {
             if (m_propertyShowNodes.value() != CheckState::Partially) {
-                for (const Handle_MeshVS_Mesh& meshVisu : m_vecMeshVisu) {
-                    meshVisu->GetDrawer()->SetBoolean(MeshVS_DA_DisplayNodes, m_propertyShowNodes.value() == CheckState::On);
-                    fnRedisplay(meshVisu);
+                for (const GraphicsObjectPtr& object : m_vecObject) {
+                    MeshObjectAttributes::setShowNodes(object, m_propertyShowNodes.value() == CheckState::On);
+                    fnRedisplay(object);
                 }
             }
         }
         else if (prop == &m_propertyColor) {
-            for (const Handle_MeshVS_Mesh& meshVisu : m_vecMeshVisu) {
-                meshVisu->GetDrawer()->SetColor(MeshVS_DA_InteriorColor, m_propertyColor);
-                fnRedisplay(meshVisu);
+            for (const GraphicsObjectPtr& object : m_vecObject) {
+                MeshObjectAttributes::setColor(object, m_propertyColor);
+                fnRedisplay(object);
             }
         }
         else if (prop == &m_propertyEdgeColor) {
-            for (const Handle_MeshVS_Mesh& meshVisu : m_vecMeshVisu) {
-                meshVisu->GetDrawer()->SetColor(MeshVS_DA_EdgeColor, m_propertyEdgeColor);
-                fnRedisplay(meshVisu);
+            for (const GraphicsObjectPtr& object : m_vecObject) {
+                MeshObjectAttributes::setEdgeColor(object, m_propertyEdgeColor);
+                fnRedisplay(object);
             }
         }
 
         PropertyGroupSignals::onPropertyChanged(prop);
     }
 
-    std::vector<Handle_MeshVS_Mesh> m_vecMeshVisu;
+    std::vector<GraphicsObjectPtr> m_vecObject;
     PropertyOccColor m_propertyColor{ this, GraphicsMeshObjectDriverI18N::textId("color") };
     PropertyOccColor m_propertyEdgeColor{ this, GraphicsMeshObjectDriverI18N::textId("edgeColor") };
     PropertyCheckState m_propertyShowEdges{ this, GraphicsMeshObjectDriverI18N::textId("showEdges") };
@@ -27,7 +27,14 @@ public:
 
     static Support meshSupportStatus(const TDF_Label& label);
 
+    // Kind of graphics object created for meshes
+    enum class Presentation {
+        Direct, // GraphicsMeshObject, primitive arrays built straight from the triangulation
+        MeshVS // MeshVS_Mesh object
+    };
+
     struct DefaultValues {
+        Presentation presentation = Presentation::Direct;
         bool showEdges = false;
         bool showNodes = false;
         Graphic3d_NameOfMaterial material = Graphic3d_NOM_PLASTER;
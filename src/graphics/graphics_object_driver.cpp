@@ -32,6 +32,18 @@ GraphicsObjectDriverPtr GraphicsObjectDriver::getCommon(Span<const GraphicsObjec
     return commonGfxDriver;
 }
 
+void GraphicsObjectDriver::applyDisplayModeOnObjects(
+        Span<const GraphicsObjectPtr> spanObject, Enumeration::Value mode) const
+{
+    for (const GraphicsObjectPtr& object : spanObject)
+        this->applyDisplayMode(object, mode);
+}
+
+std::function<void()> GraphicsObjectDriver::prepareObjectJob(const GraphicsObjectPtr& /*object*/) const
+{
+    return {};
+}
+
 void GraphicsObjectDriver::throwIf_invalidDisplayMode(Enumeration::Value mode) const
 {
     if (this->displayModes().findIndexByValue(mode) == -1)
@@ -14,6 +14,7 @@
 
 #include <Standard_Transient.hxx>
 #include <TDF_Label.hxx>
+#include <functional>
 #include <memory>
 
 namespace Mayo {
@@ -34,10 +35,19 @@ public:
     Enumeration::Value defaultDisplayMode() const { return m_defaultDisplayMode; }
     const Enumeration& displayModes() const { return m_enumDisplayModes; }
     virtual void applyDisplayMode(GraphicsObjectPtr object, Enumeration::Value mode) const = 0;
+    // Same as applyDisplayMode() on each object, drivers can override to share work between objects
+    virtual void applyDisplayModeOnObjects(Span<const GraphicsObjectPtr> spanObject, Enumeration::Value mode) const;
     virtual Enumeration::Value currentDisplayMode(const GraphicsObjectPtr& object) const = 0;
 
     virtual std::unique_ptr<PropertyGroupSignals> properties(Span<const GraphicsObjectPtr> spanObject) const = 0;
 
+    // Returns the job computing data needed by the presentation of 'object', so its first display
+    // is faster. Called from the thread owning 'object'(see GraphicsObjectLoader::load()), so the
+    // state of 'object' and of its document is read there. The job is then run in a background
+    // thread before 'object' is added to a scene: it must only access the data it captured
+    // Default implementation returns an empty job
+    virtual std::function<void()> prepareObjectJob(const GraphicsObjectPtr& object) const;
+
     static GraphicsObjectDriverPtr get(const GraphicsObjectPtr& object);
     static GraphicsObjectDriverPtr getCommon(Span<const GraphicsObjectPtr> spanObject);
 
@@ -0,0 +1,133 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "graphics_object_loader.h"
+
+#include "graphics_object_driver.h"
+
+#include <OSD_Parallel.hxx>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Mayo {
+
+struct GraphicsObjectLoader::Private {
+    void startThread(GraphicsObjectLoader* loader)
+    {
+        if (!this->thread.joinable())
+            this->thread = std::thread([=]{ this->run(loader); });
+    }
+
+    void run(GraphicsObjectLoader* loader)
+    {
+        while (true) {
+            std::vector<PendingObject> vecPending;
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->condition.wait(lock, [=]{ return this->isStopRequested || !this->dequePendingObject.empty(); });
+                if (this->isStopRequested)
+                    return;
+
+                const auto count = std::min<size_t>(this->batchSize, this->dequePendingObject.size());
+                auto itEnd = this->dequePendingObject.begin() + count;
+                vecPending.assign(this->dequePendingObject.begin(), itEnd);
+                this->dequePendingObject.erase(this->dequePendingObject.begin(), itEnd);
+            }
+
+            const int objectCount = int(vecPending.size());
+            OSD_Parallel::For(0, objectCount, [&](int i) {
+                const PendingObject& pending = vecPending.at(i);
+                if (pending.fnPrepare)
+                    pending.fnPrepare();
+            }, objectCount < 2/*isForceSingleThreadExecution*/);
+
+            std::vector<GraphicsObjectPtr> vecObject;
+            vecObject.reserve(vecPending.size());
+            for (const PendingObject& pending : vecPending)
+                vecObject.push_back(pending.object);
+
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                if (this->isStopRequested)
+                    return;
+            }
+
+            loader->signalObjectsLoaded.send(vecObject);
+        }
+    }
+
+    struct PendingObject {
+        GraphicsObjectPtr object;
+        std::function<void()> fnPrepare; // See GraphicsObjectDriver::prepareObjectJob()
+    };
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<PendingObject> dequePendingObject;
+    int batchSize = 64;
+    bool isStopRequested = false;
+    std::thread thread;
+};
+
+GraphicsObjectLoader::GraphicsObjectLoader()
+    : d(std::make_unique<Private>())
+{
+}
+
+GraphicsObjectLoader::~GraphicsObjectLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(d->mutex);
+        d->isStopRequested = true;
+        d->dequePendingObject.clear();
+    }
+
+    d->condition.notify_all();
+    if (d->thread.joinable())
+        d->thread.join();
+}
+
+void GraphicsObjectLoader::load(Span<const GraphicsObjectPtr> spanObject)
+{
+    if (spanObject.empty())
+        return;
+
+    // Preparation jobs are created in the calling thread, which owns the objects
+    std::vector<Private::PendingObject> vecPending;
+    vecPending.reserve(spanObject.size());
+    for (const GraphicsObjectPtr& object : spanObject) {
+        auto driver = GraphicsObjectDriver::get(object);
+        vecPending.push_back({ object, driver ? driver->prepareObjectJob(object) : std::function<void()>{} });
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(d->mutex);
+        d->dequePendingObject.insert(d->dequePendingObject.end(), vecPending.begin(), vecPending.end());
+    }
+
+    d->startThread(this);
+    d->condition.notify_one();
+}
+
+int GraphicsObjectLoader::batchSize() const
+{
+    std::lock_guard<std::mutex> lock(d->mutex);
+    return d->batchSize;
+}
+
+void GraphicsObjectLoader::setBatchSize(int size)
+{
+    std::lock_guard<std::mutex> lock(d->mutex);
+    d->batchSize = std::max(size, 1);
+}
+
+} // namespace Mayo
@@ -0,0 +1,49 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/signal.h"
+#include "../base/span.h"
+#include "graphics_object_ptr.h"
+
+#include <memory>
+#include <vector>
+
+namespace Mayo {
+
+// Provides preparation of graphics objects in background before they are added to a GraphicsScene
+// Objects are prepared by the jobs of their driver(see GraphicsObjectDriver::prepareObjectJob()) in
+// parallel, then published in batches with signalObjectsLoaded. So the thread adding objects to the
+// scene only computes the presentations of ready objects, batch after batch, and stays responsive
+// while a big model appears
+// Objects are published in the order they were given to load()
+class GraphicsObjectLoader {
+public:
+    GraphicsObjectLoader();
+    ~GraphicsObjectLoader(); // Waits for the batch being prepared, pending objects are discarded
+
+    // Not copyable
+    GraphicsObjectLoader(const GraphicsObjectLoader&) = delete;
+    GraphicsObjectLoader& operator=(const GraphicsObjectLoader&) = delete;
+
+    // Must be called from the thread owning the objects, where preparation jobs are created
+    void load(Span<const GraphicsObjectPtr> spanObject);
+
+    // Maximum count of objects published at once
+    int batchSize() const;
+    void setBatchSize(int size);
+
+    // Emitted from a background thread, use Signal::connectSlot() to handle loaded objects in the
+    // thread of the connection
+    Signal<const std::vector<GraphicsObjectPtr>&> signalObjectsLoaded;
+
+private:
+    struct Private;
+    std::unique_ptr<Private> d;
+};
+
+} // namespace Mayo
@@ -0,0 +1,259 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "graphics_point_cloud_object.h"
+
+#include "graphics_frustum.h"
+
+#include <Graphic3d_Group.hxx>
+#include <Precision.hxx>
+#include <Prs3d_PointAspect.hxx>
+#include <Select3D_SensitiveBox.hxx>
+#include <SelectMgr_EntityOwner.hxx>
+
+#include <algorithm>
+#include <queue>
+
+namespace Mayo {
+
+GraphicsPointCloudObject::GraphicsPointCloudObject(const std::shared_ptr<const PointCloudOctree>& octree)
+    : m_octree(octree)
+{
+    // Same point aspect as AIS_PointCloud
+    myDrawer->SetPointAspect(new Prs3d_PointAspect(Aspect_TOM_POINT, Quantity_NOC_YELLOW, 1.));
+}
+
+void GraphicsPointCloudObject::selectNodes(
+        Span<const OccHandle<GraphicsPointCloudObject>> spanObject,
+        const GraphicsFrustum& frustum,
+        int64_t pointBudget)
+{
+    // Point spacing of a node projected on the view, negative if the node is outside the view volume
+    // Spacing is evaluated at the point of the node box nearest to the camera eye
+    const gp_XYZ eye = frustum.camera()->Eye().XYZ();
+    auto fnProjectedSpacing = [&](const GraphicsPointCloudObject* object, int nodeIndex) {
+        const PointCloudOctree::Node& node = object->m_octree->node(nodeIndex);
+        const gp_Trsf trsf = object->Transformation();
+        Bnd_Box bndBox;
+        bndBox.Update(
+                    node.cornerMin.X(), node.cornerMin.Y(), node.cornerMin.Z(),
+                    node.cornerMax.X(), node.cornerMax.Y(), node.cornerMax.Z()
+        );
+        if (trsf.Form() != gp_Identity)
+            bndBox = bndBox.Transformed(trsf);
+
+        if (frustum.isOutside(bndBox))
+            return -1.;
+
+        const gp_XYZ pntMin = bndBox.CornerMin().XYZ();
+        const gp_XYZ pntMax = bndBox.CornerMax().XYZ();
+        const gp_XYZ pntNearest(
+                    std::clamp(eye.X(), pntMin.X(), pntMax.X()),
+                    std::clamp(eye.Y(), pntMin.Y(), pntMax.Y()),
+                    std::clamp(eye.Z(), pntMin.Z(), pntMax.Z())
+        );
+        const double pixelsPerUnit = frustum.pixelsPerUnit(pntNearest);
+        if (pixelsPerUnit <= 0)
+            return Precision::Infinite(); // Camera eye is close to the node
+
+        return node.spacing * std::abs(trsf.ScaleFactor()) * pixelsPerUnit;
+    };
+
+    struct Candidate {
+        double projectedSpacing;
+        int objectIndex;
+        int nodeIndex;
+    };
+    auto fnCandidateLess = [](const Candidate& lhs, const Candidate& rhs) {
+        return lhs.projectedSpacing < rhs.projectedSpacing;
+    };
+    std::priority_queue<Candidate, std::vector<Candidate>, decltype(fnCandidateLess)> queueCandidate(fnCandidateLess);
+    for (int i = 0; i < int(spanObject.size()); ++i) {
+        const GraphicsPointCloudObject* object = spanObject[i].get();
+        if (object->m_octree && object->m_octree->nodeCount() > 0) {
+            const double projectedSpacing = fnProjectedSpacing(object, 0);
+            if (projectedSpacing >= 0)
+                queueCandidate.push({ projectedSpacing, i, 0 });
+        }
+    }
+
+    // Nodes are selected coarsest first, children are candidates only if the points of their parent
+    // are more than one pixel apart
+    constexpr double minProjectedSpacing = 1.;
+    std::vector<std::vector<int>> vecObjectSelectedNodes(spanObject.size());
+    int64_t pointCount = 0;
+    while (!queueCandidate.empty()) {
+        const Candidate candidate = queueCandidate.top();
+        queueCandidate.pop();
+        const GraphicsPointCloudObject* object = spanObject[candidate.objectIndex].get();
+        const PointCloudOctree::Node& node = object->m_octree->node(candidate.nodeIndex);
+        if (pointCount + node.pointCount > pointBudget)
+            break;
+
+        pointCount += node.pointCount;
+        vecObjectSelectedNodes.at(candidate.objectIndex).push_back(candidate.nodeIndex);
+        if (candidate.projectedSpacing < minProjectedSpacing)
+            continue;
+
+        for (int childIndex : node.children) {
+            if (childIndex < 0)
+                continue;
+
+            const double projectedSpacing = fnProjectedSpacing(object, childIndex);
+            if (projectedSpacing >= 0)
+                queueCandidate.push({ projectedSpacing, candidate.objectIndex, childIndex });
+        }
+    }
+
+    for (int i = 0; i < int(spanObject.size()); ++i) {
+        GraphicsPointCloudObject* object = spanObject[i].get();
+        std::lock_guard<std::mutex> lock(object->m_mutex);
+        object->setSelectedNodes(std::move(vecObjectSelectedNodes.at(i)), pointBudget);
+    }
+}
+
+std::vector<int> GraphicsPointCloudObject::missingNodes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<int> vecNode;
+    for (int nodeIndex : m_vecSelectedNode) {
+        if (m_mapLoadedNode.find(nodeIndex) == m_mapLoadedNode.cend())
+            vecNode.push_back(nodeIndex);
+    }
+
+    return vecNode;
+}
+
+void GraphicsPointCloudObject::setNodePoints(int index, const OccHandle<Graphic3d_ArrayOfPoints>& points)
+{
+    if (!points)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mapLoadedNode.insert_or_assign(index, LoadedNode{ points, m_selectionStamp });
+}
+
+bool GraphicsPointCloudObject::isPresentationOutdated() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return this->drawableNodes() != m_vecDrawnNode;
+}
+
+int64_t GraphicsPointCloudObject::drawnPointCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_drawnPointCount;
+}
+
+void GraphicsPointCloudObject::ComputeSelection(const Handle(SelectMgr_Selection)& sel, const int /*mode*/)
+{
+    const Bnd_Box bndBox = m_octree ? m_octree->boundingBox() : Bnd_Box();
+    if (bndBox.IsVoid())
+        return;
+
+    auto owner = new SelectMgr_EntityOwner(this);
+    sel->Add(new Select3D_SensitiveBox(owner, bndBox));
+}
+
+void GraphicsPointCloudObject::Compute(
+        const Handle(PrsMgr_PresentationManager)&,
+        const Handle(Prs3d_Presentation)& pres,
+        const int mode)
+{
+    if (mode != 0 || !m_octree)
+        return;
+
+    std::vector<OccHandle<Graphic3d_ArrayOfPoints>> vecPoints;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_vecDrawnNode = this->drawableNodes();
+        m_drawnPointCount = 0;
+        for (int nodeIndex : m_vecDrawnNode) {
+            const OccHandle<Graphic3d_ArrayOfPoints>& points = m_mapLoadedNode.at(nodeIndex).points;
+            m_drawnPointCount += points->VertexNumber();
+            vecPoints.push_back(points);
+        }
+    }
+
+    // One group per node, so the renderer can cull the nodes individually
+    const Handle(Graphic3d_AspectMarker3d)& aspect = myDrawer->PointAspect()->Aspect();
+    for (const OccHandle<Graphic3d_ArrayOfPoints>& points : vecPoints) {
+        Handle(Graphic3d_Group) group = pres->NewGroup();
+        group->SetGroupPrimitivesAspect(aspect);
+        group->AddPrimitiveArray(points);
+    }
+
+    // Presentation bounds are the ones of the whole point cloud, whatever the nodes loaded
+    const Bnd_Box bndBox = m_octree->boundingBox();
+    if (!bndBox.IsVoid()) {
+        const gp_Pnt pntMin = bndBox.CornerMin();
+        const gp_Pnt pntMax = bndBox.CornerMax();
+        Handle(Graphic3d_Group) group = pres->NewGroup();
+        group->SetMinMaxValues(
+                    float(pntMin.X()), float(pntMin.Y()), float(pntMin.Z()),
+                    float(pntMax.X()), float(pntMax.Y()), float(pntMax.Z())
+        );
+    }
+}
+
+std::vector<int> GraphicsPointCloudObject::drawableNodes() const
+{
+    // Note: m_mutex is locked by the caller
+    std::vector<int> vecNode;
+    for (int nodeIndex : m_vecSelectedNode) {
+        if (m_mapLoadedNode.find(nodeIndex) != m_mapLoadedNode.cend())
+            vecNode.push_back(nodeIndex);
+    }
+
+    std::sort(vecNode.begin(), vecNode.end());
+    return vecNode;
+}
+
+void GraphicsPointCloudObject::setSelectedNodes(std::vector<int> vecNode, int64_t cacheMaxPointCount)
+{
+    // Note: m_mutex is locked by the caller
+    m_vecSelectedNode = std::move(vecNode);
+    ++m_selectionStamp;
+    for (int nodeIndex : m_vecSelectedNode) {
+        auto itLoaded = m_mapLoadedNode.find(nodeIndex);
+        if (itLoaded != m_mapLoadedNode.end())
+            itLoaded->second.lastSelection = m_selectionStamp;
+    }
+
+    // Evict the loaded nodes not selected for the longest time, until the count of points of the
+    // nodes not selected is within the cache limit
+    struct UnselectedNode {
+        int index;
+        uint64_t lastSelection;
+        int pointCount;
+    };
+    std::vector<UnselectedNode> vecUnselected;
+    int64_t unselectedPointCount = 0;
+    for (const auto& [nodeIndex, loadedNode] : m_mapLoadedNode) {
+        if (loadedNode.lastSelection != m_selectionStamp) {
+            const int pointCount = loadedNode.points->VertexNumber();
+            vecUnselected.push_back({ nodeIndex, loadedNode.lastSelection, pointCount });
+            unselectedPointCount += pointCount;
+        }
+    }
+
+    if (unselectedPointCount <= cacheMaxPointCount)
+        return;
+
+    std::sort(vecUnselected.begin(), vecUnselected.end(), [](const UnselectedNode& lhs, const UnselectedNode& rhs) {
+        return lhs.lastSelection < rhs.lastSelection;
+    });
+    for (const UnselectedNode& node : vecUnselected) {
+        if (unselectedPointCount <= cacheMaxPointCount)
+            break;
+
+        // Points of a drawn node are still referenced by the presentation until it's recomputed
+        m_mapLoadedNode.erase(node.index);
+        unselectedPointCount -= node.pointCount;
+    }
+}
+
+} // namespace Mayo
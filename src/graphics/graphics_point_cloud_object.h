@@ -0,0 +1,105 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/occ_handle.h"
+#include "../base/point_cloud_octree.h"
+#include "../base/span.h"
+#include "../base/tkernel_utils.h"
+
+#include <AIS_InteractiveObject.hxx>
+#include <Graphic3d_ArrayOfPoints.hxx>
+#include <Prs3d_Presentation.hxx>
+#include <PrsMgr_PresentationManager.hxx>
+#include <SelectMgr_Selection.hxx>
+
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+#  include <Prs3d_Projector.hxx>
+#endif
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Mayo {
+
+class GraphicsFrustum;
+
+// Graphics object streaming the points of a PointCloudOctree
+// Only the nodes selected for the current view(see selectNodes()) are drawn, provided their points
+// were loaded(see setNodePoints()), so memory usage is bounded by the point budget whatever the
+// size of the point cloud. Loaded nodes not selected anymore are kept in a cache, up to the point
+// budget, so they can be drawn again without reading the octree file
+// The object is selectable as a whole, through the bounding box of the point cloud
+class GraphicsPointCloudObject : public AIS_InteractiveObject {
+public:
+    GraphicsPointCloudObject(const std::shared_ptr<const PointCloudOctree>& octree);
+
+    const std::shared_ptr<const PointCloudOctree>& octree() const { return m_octree; }
+
+    // Selects the nodes to be drawn by the objects 'spanObject', sharing a budget of 'pointBudget'
+    // points. Nodes outside the view volume are skipped. Nodes are refined in order of decreasing
+    // point spacing projected on the view, until the spacing is less than one pixel or the budget
+    // is exhausted. Objects are expected to be displayed in the view of 'frustum'
+    static void selectNodes(
+            Span<const OccHandle<GraphicsPointCloudObject>> spanObject,
+            const GraphicsFrustum& frustum,
+            int64_t pointBudget
+    );
+
+    // Selected nodes whose points aren't loaded yet, coarsest first
+    std::vector<int> missingNodes() const;
+
+    // Stores the points of node 'index' read from the octree file. Can be called from any thread
+    // Redisplay() has to be called so loaded points get drawn
+    void setNodePoints(int index, const OccHandle<Graphic3d_ArrayOfPoints>& points);
+
+    // Whether the presentation doesn't draw all the selected nodes loaded, or draws nodes not
+    // selected anymore
+    bool isPresentationOutdated() const;
+
+    // Count of points drawn by the current presentation
+    int64_t drawnPointCount() const;
+
+    // -- from AIS_InteractiveObject
+    bool AcceptDisplayMode(const int mode) const override { return mode == 0; }
+    void ComputeSelection(const Handle(SelectMgr_Selection)& sel, const int mode) override;
+
+    DEFINE_STANDARD_RTTI_INLINE(GraphicsPointCloudObject, AIS_InteractiveObject)
+
+protected:
+    void Compute(
+            const Handle(PrsMgr_PresentationManager)& pm,
+            const Handle(Prs3d_Presentation)& pres,
+            const int mode) override;
+
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+    void Compute(const Handle(Prs3d_Projector)&, const Handle(Prs3d_Presentation)&) override {}
+#endif
+
+private:
+    struct LoadedNode {
+        OccHandle<Graphic3d_ArrayOfPoints> points;
+        uint64_t lastSelection = 0; // Stamp of the last selection including the node
+    };
+
+    // Note: m_mutex must be locked by the caller
+    std::vector<int> drawableNodes() const;
+    void setSelectedNodes(std::vector<int> vecNode, int64_t cacheMaxPointCount);
+
+    std::shared_ptr<const PointCloudOctree> m_octree;
+    std::vector<int> m_vecSelectedNode; // Coarsest first
+    std::unordered_map<int, LoadedNode> m_mapLoadedNode;
+    std::vector<int> m_vecDrawnNode; // Sorted
+    int64_t m_drawnPointCount = 0;
+    uint64_t m_selectionStamp = 0;
+    mutable std::mutex m_mutex;
+};
+
+} // namespace Mayo
@@ -9,12 +9,110 @@
 #include "../base/caf_utils.h"
 #include "../base/label_data.h"
 #include "../base/point_cloud_data.h"
+#include "graphics_point_cloud_object.h"
 
 #include <AIS_PointCloud.hxx>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 namespace Mayo {
 
+struct GraphicsPointCloudObjectDriver::NodeStreaming {
+    struct Job {
+        OccHandle<GraphicsPointCloudObject> object;
+        int nodeIndex;
+    };
+
+    ~NodeStreaming() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->isStopRequested = true;
+        }
+
+        this->condition.notify_all();
+        for (std::thread& thread : this->vecThread)
+            thread.join();
+    }
+
+    // Loading is bound by file reads, so a few threads are enough
+    void startThreads(GraphicsPointCloudObjectDriver* driver) {
+        if (!this->vecThread.empty())
+            return;
+
+        constexpr unsigned threadCount = 2;
+        for (unsigned i = 0; i < threadCount; ++i)
+            this->vecThread.emplace_back([=]{ this->runJobs(driver); });
+    }
+
+    void eraseJobs(const GraphicsPointCloudObject* object) {
+        // Note: this->mutex is locked by the caller
+        auto itEnd = std::remove_if(this->queueJob.begin(), this->queueJob.end(), [=](const Job& job) {
+            return job.object.get() == object;
+        });
+        this->queueJob.erase(itEnd, this->queueJob.end());
+    }
+
+    bool hasJobs(const GraphicsPointCloudObject* object) const {
+        // Note: this->mutex is locked by the caller
+        return std::any_of(this->queueJob.cbegin(), this->queueJob.cend(), [=](const Job& job) {
+            return job.object.get() == object;
+        });
+    }
+
+    void runJobs(GraphicsPointCloudObjectDriver* driver) {
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->condition.wait(lock, [=]{ return this->isStopRequested || !this->queueJob.empty(); });
+                if (this->isStopRequested)
+                    return;
+
+                job = std::move(this->queueJob.front());
+                this->queueJob.pop_front();
+            }
+
+            const auto points = job.object->octree()->readNodePoints(job.nodeIndex);
+            job.object->setNodePoints(job.nodeIndex, points);
+            bool isRefineRequired = false;
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                int64_t& loadedPointCount = this->mapLoadedPointCount[job.object.get()];
+                loadedPointCount += points ? points->VertexNumber() : 0;
+                const int64_t minPointCount = std::max<int64_t>(
+                            job.object->drawnPointCount(), PointCloudOctree::MaxNodePointCount
+                );
+                isRefineRequired = !this->hasJobs(job.object.get()) || loadedPointCount >= minPointCount;
+                if (isRefineRequired)
+                    this->mapLoadedPointCount.erase(job.object.get());
+            }
+
+            if (isRefineRequired)
+                driver->signalNodesLoaded.send(job.object);
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<Job> queueJob;
+    // Count of points loaded per object since last emission of signalNodesLoaded
+    std::unordered_map<const GraphicsPointCloudObject*, int64_t> mapLoadedPointCount;
+    bool isStopRequested = false;
+    std::vector<std::thread> vecThread;
+};
+
 GraphicsPointCloudObjectDriver::GraphicsPointCloudObjectDriver()
+    : m_nodeStreaming(std::make_unique<NodeStreaming>())
+{
+}
+
+GraphicsPointCloudObjectDriver::~GraphicsPointCloudObjectDriver()
 {
 }
 
@@ -27,6 +125,12 @@ GraphicsObjectPtr GraphicsPointCloudObjectDriver::createObject(const TDF_Label&
 {
     if (findLabelDataFlags(label) & LabelData_HasPointCloudData) {
         auto attrPointCloudData = CafUtils::findAttribute<PointCloudData>(label);
+        if (attrPointCloudData->octree()) {
+            auto object = new GraphicsPointCloudObject(attrPointCloudData->octree());
+            object->SetOwner(this);
+            return object;
+        }
+
         auto object = new AIS_PointCloud;
         object->SetPoints(attrPointCloudData->points());
         object->SetOwner(this);
@@ -56,6 +160,33 @@ GraphicsPointCloudObjectDriver::properties(Span<const GraphicsObjectPtr> spanObj
     return {};
 }
 
+void GraphicsPointCloudObjectDriver::requestNodes(const GraphicsObjectPtr& object) const
+{
+    auto gfxPointCloud = OccHandle<GraphicsPointCloudObject>::DownCast(object);
+    if (!gfxPointCloud)
+        return;
+
+    const std::vector<int> vecNodeIndex = gfxPointCloud->missingNodes();
+    std::lock_guard<std::mutex> lock(m_nodeStreaming->mutex);
+    m_nodeStreaming->eraseJobs(gfxPointCloud.get());
+    if (vecNodeIndex.empty())
+        return;
+
+    for (int nodeIndex : vecNodeIndex)
+        m_nodeStreaming->queueJob.push_back({ gfxPointCloud, nodeIndex });
+
+    m_nodeStreaming->startThreads(const_cast<GraphicsPointCloudObjectDriver*>(this));
+    m_nodeStreaming->condition.notify_all();
+}
+
+void GraphicsPointCloudObjectDriver::cancelNodes(const GraphicsObjectPtr& object) const
+{
+    std::lock_guard<std::mutex> lock(m_nodeStreaming->mutex);
+    auto gfxPointCloud = OccHandle<GraphicsPointCloudObject>::DownCast(object);
+    m_nodeStreaming->eraseJobs(gfxPointCloud.get());
+    m_nodeStreaming->mapLoadedPointCount.erase(gfxPointCloud.get());
+}
+
 GraphicsPointCloudObjectDriver::Support GraphicsPointCloudObjectDriver::pointCloudSupportStatus(const TDF_Label& label)
 {
     const LabelDataFlags flags = findLabelDataFlags(label);
@@ -7,6 +7,9 @@
 #pragma once
 
 #include "graphics_object_driver.h"
+#include "../base/signal.h"
+
+#include <memory>
 
 namespace Mayo {
 
@@ -16,9 +19,12 @@ DEFINE_STANDARD_HANDLE(GraphicsPointCloudObjectDriver, GraphicsObjectDriver)
 using GraphicsPointCloudObjectDriverPtr = Handle(GraphicsPointCloudObjectDriver);
 
 // Provides creation and configuration of graphics objects for point clouds
+// Point clouds stored in an octree(see PointCloudData::octree()) are displayed with a
+// GraphicsPointCloudObject, whose nodes are loaded from the octree file by background threads
 class GraphicsPointCloudObjectDriver : public GraphicsObjectDriver {
 public:
     GraphicsPointCloudObjectDriver();
+    ~GraphicsPointCloudObjectDriver();
 
     Support supportStatus(const TDF_Label& label) const override;
     GraphicsObjectPtr createObject(const TDF_Label& label) const override;
@@ -28,7 +34,26 @@ public:
 
     static Support pointCloudSupportStatus(const TDF_Label& label);
 
+    // Node streaming
+    // Schedules loading of the nodes selected by GraphicsPointCloudObject 'object' but not loaded
+    // yet, coarsest first. Nodes previously scheduled for 'object' are discarded
+    // Does nothing if 'object' isn't a GraphicsPointCloudObject
+    void requestNodes(const GraphicsObjectPtr& object) const;
+
+    // Cancels pending loading of the nodes of 'object'(eg 'object' was erased meanwhile)
+    void cancelNodes(const GraphicsObjectPtr& object) const;
+
+    // Signal emitted(from a background thread) when loaded nodes of 'object' are ready to be drawn
+    // Emission is throttled so the presentation of 'object' is refined in a few steps: the signal
+    // is emitted when all the scheduled nodes are loaded, or when the count of loaded points exceeds
+    // the count of points currently drawn
+    mutable Signal<GraphicsObjectPtr> signalNodesLoaded;
+
     DEFINE_STANDARD_RTTI_INLINE(GraphicsPointCloudObjectDriver, GraphicsObjectDriver)
+
+private:
+    struct NodeStreaming;
+    std::unique_ptr<NodeStreaming> m_nodeStreaming;
 };
 
 } // namespace Mayo
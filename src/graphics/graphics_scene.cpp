@@ -7,13 +7,23 @@
 #include "graphics_scene.h"
 
 #include "../base/tkernel_utils.h"
+#include "graphics_frustum.h"
 #include "graphics_utils.h"
 
+#include <BVH_BinnedBuilder.hxx>
+#include <BVH_PrimitiveSet.hxx>
 #include <Graphic3d_GraphicDriver.hxx>
+#include <Precision.hxx>
 #include <V3d_TypeOfOrientation.hxx>
 #include <V3d_AmbientLight.hxx>
 #include <V3d_DirectionalLight.hxx>
 
+#include <algorithm>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace Mayo {
 
 // Defined in graphics_create_driver.cpp
@@ -86,12 +96,153 @@ public:
 
 DEFINE_STANDARD_HANDLE(InteractiveContext, AIS_InteractiveContext)
 
+struct ObjectBox {
+    GraphicsObjectPtr object;
+    BVH_Box<double, 3> box;
+};
+
+// BVH over the bounding boxes of graphics objects
+class ObjectBoxSet : public BVH_PrimitiveSet<double, 3> {
+public:
+    ObjectBoxSet()
+        : BVH_PrimitiveSet<double, 3>(new BVH_BinnedBuilder<double, 3>(4/*leafNodeSize*/, 32/*maxTreeDepth*/))
+    {}
+
+    std::vector<ObjectBox> vecObjectBox; // Reordered when the BVH is built
+
+    // -- from BVH_PrimitiveSet
+    int Size() const override { return int(vecObjectBox.size()); }
+    BVH_Box<double, 3> Box(const int index) const override { return vecObjectBox.at(index).box; }
+    double Center(const int index, const int axis) const override
+    {
+        const BVH_Box<double, 3>& box = vecObjectBox.at(index).box;
+        return 0.5 * (box.CornerMin()[axis] + box.CornerMax()[axis]);
+    }
+
+    void Swap(const int index1, const int index2) override
+    {
+        std::swap(vecObjectBox.at(index1), vecObjectBox.at(index2));
+    }
+};
+
+gp_XYZ toXYZ(const BVH_Vec3d& vec)
+{
+    return gp_XYZ(vec.x(), vec.y(), vec.z());
+}
+
 } // namespace
 
 class GraphicsScene::Private {
 public:
+    // Changes of an object collected during a batch of updates
+    struct PendingUpdate {
+        GraphicsObjectPtr object;
+        std::optional<bool> visible;
+        std::optional<gp_Trsf> trsf;
+        std::optional<int> displayMode;
+        bool recomputePresentation = false;
+        bool recomputeSelection = false;
+    };
+
+    PendingUpdate& pendingUpdate(const GraphicsObjectPtr& object)
+    {
+        auto [it, isInserted] = m_mapPendingUpdate.try_emplace(object.get());
+        if (isInserted) {
+            it->second.object = object;
+            m_vecPendingObject.push_back(object.get());
+        }
+
+        return it->second;
+    }
+
+    const PendingUpdate* findPendingUpdate(const GraphicsObjectPtr& object) const
+    {
+        auto it = m_mapPendingUpdate.find(object.get());
+        return it != m_mapPendingUpdate.cend() ? &it->second : nullptr;
+    }
+
+    // BVH of the object boxes, rebuilt on demand after changes
+    const opencascade::handle<ObjectBoxSet>& objectBoxSet()
+    {
+        if (m_isObjectBoxSetDirty) {
+            m_objectBoxSet->vecObjectBox.clear();
+            m_objectBoxSet->vecObjectBox.reserve(m_mapObjectBox.size());
+            for (const auto& [ptr, objectBox] : m_mapObjectBox)
+                m_objectBoxSet->vecObjectBox.push_back(objectBox);
+
+            m_objectBoxSet->MarkDirty();
+            m_isObjectBoxSetDirty = false;
+        }
+
+        return m_objectBoxSet;
+    }
+
+    // Calls fn(objectBox) for each object box not outside 'frustum'
+    template<typename Function>
+    void foreachObjectBoxInside(const GraphicsFrustum& frustum, Function fn)
+    {
+        const opencascade::handle<ObjectBoxSet>& boxSet = this->objectBoxSet();
+        if (boxSet->Size() == 0)
+            return;
+
+        // Visit the BVH nodes intersecting the view volume
+        const opencascade::handle<BVH_Tree<double, 3>>& tree = boxSet->BVH();
+        std::vector<int> stackNode = { 0 };
+        while (!stackNode.empty()) {
+            const int iNode = stackNode.back();
+            stackNode.pop_back();
+            if (frustum.isOutside(toXYZ(tree->MinPoint(iNode)), toXYZ(tree->MaxPoint(iNode))))
+                continue;
+
+            if (!tree->IsOuter(iNode)) {
+                stackNode.push_back(tree->Child<0>(iNode));
+                stackNode.push_back(tree->Child<1>(iNode));
+                continue;
+            }
+
+            for (int i = tree->BegPrimitive(iNode); i <= tree->EndPrimitive(iNode); ++i) {
+                const ObjectBox& objectBox = boxSet->vecObjectBox.at(i);
+                if (!frustum.isOutside(toXYZ(objectBox.box.CornerMin()), toXYZ(objectBox.box.CornerMax())))
+                    fn(objectBox);
+            }
+        }
+    }
+
+    // Objects hidden in a view by GraphicsScene::updateViewCulling()
+    struct ViewCulling {
+        Handle_V3d_View view;
+        std::unordered_map<const AIS_InteractiveObject*, GraphicsObjectPtr> mapCulledObject;
+    };
+
+    ViewCulling* findViewCulling(const Handle_V3d_View& view)
+    {
+        auto it = std::find_if(
+                    m_vecViewCulling.begin(), m_vecViewCulling.end(),
+                    [&](const ViewCulling& culling) { return culling.view == view; }
+        );
+        return it != m_vecViewCulling.end() ? &(*it) : nullptr;
+    }
+
+    // Shows again 'object' in all the views it was culled from
+    void uncullObject(const GraphicsObjectPtr& object)
+    {
+        for (ViewCulling& culling : m_vecViewCulling) {
+            if (culling.mapCulledObject.erase(object.get()) != 0)
+                m_aisContext->SetViewAffinity(object, culling.view, true);
+        }
+    }
+
     opencascade::handle<InteractiveContext> m_aisContext;
     std::unordered_set<const AIS_InteractiveObject*> m_setClipPlaneSensitive;
+    std::unordered_map<const AIS_InteractiveObject*, ObjectBox> m_mapObjectBox;
+    opencascade::handle<ObjectBoxSet> m_objectBoxSet = new ObjectBoxSet;
+    bool m_isObjectBoxSetDirty = false;
+    std::vector<ViewCulling> m_vecViewCulling;
+    int m_cullingMinimumSize = 0;
+    int m_updateDepth = 0;
+    bool m_isRedrawPending = false;
+    std::unordered_map<const AIS_InteractiveObject*, PendingUpdate> m_mapPendingUpdate;
+    std::vector<const AIS_InteractiveObject*> m_vecPendingObject; // Order of first change
     bool m_isRedrawBlocked = false;
     SelectionMode m_selectionMode = SelectionMode::Single;
 };
@@ -114,7 +265,11 @@ GraphicsScene::~GraphicsScene()
 
 opencascade::handle<V3d_View> GraphicsScene::createV3dView()
 {
-    return this->v3dViewer()->CreateView();
+    opencascade::handle<V3d_View> view = this->v3dViewer()->CreateView();
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 2, 0)
+    view->ChangeRenderingParams().FrustumCullingState = Graphic3d_RenderingParams::FrustumCulling_On;
+#endif
+    return view;
 }
 
 const opencascade::handle<V3d_Viewer>& GraphicsScene::v3dViewer() const
@@ -160,8 +315,13 @@ void GraphicsScene::addObject(const GraphicsObjectPtr& object, AddObjectFlags fl
 
 void GraphicsScene::eraseObject(const GraphicsObjectPtr& object)
 {
+    d->uncullObject(object);
     GraphicsUtils::AisContext_eraseObject(d->m_aisContext, object);
     d->m_setClipPlaneSensitive.erase(object.get());
+    if (d->m_mapObjectBox.erase(object.get()) != 0)
+        d->m_isObjectBoxSetDirty = true;
+
+    d->m_mapPendingUpdate.erase(object.get());
 }
 
 void GraphicsScene::redraw()
@@ -169,6 +329,11 @@ void GraphicsScene::redraw()
     if (d->m_isRedrawBlocked)
         return;
 
+    if (d->m_updateDepth > 0) {
+        d->m_isRedrawPending = true;
+        return;
+    }
+
     //d->m_aisContext->UpdateCurrentViewer();
     for (auto itView = this->v3dViewer()->DefinedViewIterator(); itView.More(); itView.Next())
         this->signalRedrawRequested.send(itView.Value());
@@ -179,6 +344,11 @@ void GraphicsScene::redraw(const Handle_V3d_View& view)
     if (d->m_isRedrawBlocked)
         return;
 
+    if (d->m_updateDepth > 0) {
+        d->m_isRedrawPending = true;
+        return;
+    }
+
     for (auto itView = this->v3dViewer()->DefinedViewIterator(); itView.More(); itView.Next()) {
         if (itView.Value() == view) {
             this->signalRedrawRequested.send(view);
@@ -197,9 +367,74 @@ void GraphicsScene::blockRedraw(bool on)
     d->m_isRedrawBlocked = on;
 }
 
+void GraphicsScene::beginUpdate()
+{
+    ++d->m_updateDepth;
+}
+
+void GraphicsScene::endUpdate()
+{
+    if (d->m_updateDepth == 0 || --d->m_updateDepth > 0)
+        return;
+
+    for (const AIS_InteractiveObject* ptr : d->m_vecPendingObject) {
+        auto it = d->m_mapPendingUpdate.find(ptr);
+        if (it == d->m_mapPendingUpdate.end())
+            continue; // Object erased meanwhile
+
+        // Objects to be hidden are erased first and objects to be shown are displayed last, so
+        // presentations aren't computed for display modes or locations about to change
+        const Private::PendingUpdate& update = it->second;
+        const GraphicsObjectPtr& object = update.object;
+        const bool isVisible = d->m_aisContext->IsDisplayed(object);
+        if (update.visible && !*update.visible && isVisible)
+            GraphicsUtils::AisContext_setObjectVisible(d->m_aisContext, object, false);
+
+        if (update.displayMode)
+            d->m_aisContext->SetDisplayMode(object, *update.displayMode, false);
+
+        if (update.trsf)
+            d->m_aisContext->SetLocation(object, *update.trsf);
+
+        if (update.recomputePresentation)
+            d->m_aisContext->Redisplay(object, false);
+
+        if (update.visible && *update.visible && !isVisible)
+            GraphicsUtils::AisContext_setObjectVisible(d->m_aisContext, object, true);
+
+        if (update.recomputeSelection)
+            d->m_aisContext->RecomputeSelectionOnly(object);
+
+        d->m_mapPendingUpdate.erase(it);
+    }
+
+    d->m_mapPendingUpdate.clear();
+    d->m_vecPendingObject.clear();
+    if (d->m_isRedrawPending) {
+        d->m_isRedrawPending = false;
+        this->redraw();
+    }
+}
+
+bool GraphicsScene::isUpdating() const
+{
+    return d->m_updateDepth > 0;
+}
+
 void GraphicsScene::recomputeObjectPresentation(const GraphicsObjectPtr& object)
 {
-    d->m_aisContext->Redisplay(object, false);
+    if (d->m_updateDepth > 0 && object)
+        d->pendingUpdate(object).recomputePresentation = true;
+    else
+        d->m_aisContext->Redisplay(object, false);
+}
+
+void GraphicsScene::recomputeObjectSelection(const GraphicsObjectPtr& object)
+{
+    if (d->m_updateDepth > 0 && object)
+        d->pendingUpdate(object).recomputeSelection = true;
+    else
+        d->m_aisContext->RecomputeSelectionOnly(object);
 }
 
 void GraphicsScene::activateObjectSelection(const GraphicsObjectPtr& object, int mode)
@@ -234,7 +469,10 @@ void GraphicsScene::clearSelectionFilters()
 
 void GraphicsScene::setObjectDisplayMode(const GraphicsObjectPtr& object, int displayMode)
 {
-    d->m_aisContext->SetDisplayMode(object, displayMode, false);
+    if (d->m_updateDepth > 0 && object)
+        d->pendingUpdate(object).displayMode = displayMode;
+    else
+        d->m_aisContext->SetDisplayMode(object, displayMode, false);
 }
 
 bool GraphicsScene::isObjectClipPlaneSensitive(const GraphicsObjectPtr& object) const
@@ -258,22 +496,173 @@ void GraphicsScene::setObjectClipPlaneSensitive(const GraphicsObjectPtr& object,
 
 bool GraphicsScene::isObjectVisible(const GraphicsObjectPtr& object) const
 {
+    const Private::PendingUpdate* update = d->findPendingUpdate(object);
+    if (update && update->visible)
+        return *update->visible;
+
     return d->m_aisContext->IsDisplayed(object);
 }
 
 void GraphicsScene::setObjectVisible(const GraphicsObjectPtr& object, bool on)
 {
-    GraphicsUtils::AisContext_setObjectVisible(d->m_aisContext, object, on);
+    if (d->m_updateDepth > 0 && object)
+        d->pendingUpdate(object).visible = on;
+    else
+        GraphicsUtils::AisContext_setObjectVisible(d->m_aisContext, object, on);
 }
 
 gp_Trsf GraphicsScene::objectTransformation(const GraphicsObjectPtr& object) const
 {
+    const Private::PendingUpdate* update = d->findPendingUpdate(object);
+    if (update && update->trsf)
+        return *update->trsf;
+
     return d->m_aisContext->Location(object);
 }
 
 void GraphicsScene::setObjectTransformation(const GraphicsObjectPtr &object, const gp_Trsf &trsf)
 {
-    d->m_aisContext->SetLocation(object, trsf);
+    if (d->m_updateDepth > 0 && object)
+        d->pendingUpdate(object).trsf = trsf;
+    else
+        d->m_aisContext->SetLocation(object, trsf);
+}
+
+void GraphicsScene::setObjectBoundingBox(const GraphicsObjectPtr& object, const Bnd_Box& box)
+{
+    if (object.IsNull())
+        return;
+
+    if (box.IsVoid()) {
+        if (d->m_mapObjectBox.erase(object.get()) != 0)
+            d->m_isObjectBoxSetDirty = true;
+
+        d->uncullObject(object);
+
+        return;
+    }
+
+    const gp_XYZ pntMin = box.CornerMin().XYZ();
+    const gp_XYZ pntMax = box.CornerMax().XYZ();
+    const BVH_Box<double, 3> bvhBox(
+                BVH_Vec3d(pntMin.X(), pntMin.Y(), pntMin.Z()),
+                BVH_Vec3d(pntMax.X(), pntMax.Y(), pntMax.Z())
+    );
+    d->m_mapObjectBox.insert_or_assign(object.get(), ObjectBox{ object, bvhBox });
+    d->m_isObjectBoxSetDirty = true;
+}
+
+int GraphicsScene::cullingMinimumSize() const
+{
+    return d->m_cullingMinimumSize;
+}
+
+void GraphicsScene::setCullingMinimumSize(int pixels)
+{
+    d->m_cullingMinimumSize = std::max(pixels, 0);
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 2, 0)
+    Graphic3d_ZLayerSettings settings = this->v3dViewer()->ZLayerSettings(Graphic3d_ZLayerId_Default);
+    settings.SetCullingSize(d->m_cullingMinimumSize > 0 ? d->m_cullingMinimumSize : Precision::Infinite());
+    this->v3dViewer()->SetZLayerSettings(Graphic3d_ZLayerId_Default, settings);
+#endif
+}
+
+bool GraphicsScene::updateViewCulling(const Handle_V3d_View& view)
+{
+    if (view.IsNull())
+        return false;
+
+    Private::ViewCulling* culling = d->findViewCulling(view);
+    if (!culling) {
+        d->m_vecViewCulling.push_back({ view, {} });
+        culling = &d->m_vecViewCulling.back();
+    }
+
+    const GraphicsFrustum frustum(view->Camera(), 0/*viewportHeight*/);
+    std::unordered_set<const AIS_InteractiveObject*> setInsideObject;
+    d->foreachObjectBoxInside(frustum, [&](const ObjectBox& objectBox) {
+        setInsideObject.insert(objectBox.object.get());
+    });
+
+    bool isChanged = false;
+    // Show again the objects back inside the view volume or no longer having a box
+    for (auto it = culling->mapCulledObject.begin(); it != culling->mapCulledObject.end(); ) {
+        const bool isInside =
+                setInsideObject.find(it->first) != setInsideObject.cend()
+                || d->m_mapObjectBox.find(it->first) == d->m_mapObjectBox.cend();
+        if (isInside) {
+            d->m_aisContext->SetViewAffinity(it->second, view, true);
+            it = culling->mapCulledObject.erase(it);
+            isChanged = true;
+        }
+        else {
+            ++it;
+        }
+    }
+
+    // Hide the objects outside the view volume
+    for (const auto& [ptr, objectBox] : d->m_mapObjectBox) {
+        if (setInsideObject.find(ptr) != setInsideObject.cend())
+            continue;
+
+        auto [it, isInserted] = culling->mapCulledObject.try_emplace(ptr, objectBox.object);
+        if (isInserted) {
+            d->m_aisContext->SetViewAffinity(objectBox.object, view, false);
+            isChanged = true;
+        }
+    }
+
+    return isChanged;
+}
+
+bool GraphicsScene::clearViewCulling(const Handle_V3d_View& view)
+{
+    Private::ViewCulling* culling = d->findViewCulling(view);
+    if (!culling || culling->mapCulledObject.empty())
+        return false;
+
+    for (const auto& [ptr, object] : culling->mapCulledObject)
+        d->m_aisContext->SetViewAffinity(object, view, true);
+
+    culling->mapCulledObject.clear();
+    return true;
+}
+
+GraphicsScene::CullingStats GraphicsScene::cullingStats(const Handle_V3d_View& view) const
+{
+    CullingStats stats;
+    if (view.IsNull())
+        return stats;
+
+    int viewWidth = 0;
+    int viewHeight = 0;
+    if (!view->Window().IsNull())
+        view->Window()->Size(viewWidth, viewHeight);
+
+    for (const auto& [ptr, objectBox] : d->m_mapObjectBox) {
+        if (this->isObjectVisible(objectBox.object))
+            ++stats.objectCount;
+    }
+
+    const GraphicsFrustum frustum(view->Camera(), viewHeight);
+    int insideCount = 0;
+    d->foreachObjectBoxInside(frustum, [&](const ObjectBox& objectBox) {
+        if (!this->isObjectVisible(objectBox.object))
+            return;
+
+        ++insideCount;
+        if (d->m_cullingMinimumSize > 0 && viewHeight > 0) {
+            const gp_XYZ pntMin = toXYZ(objectBox.box.CornerMin());
+            const gp_XYZ pntMax = toXYZ(objectBox.box.CornerMax());
+            if (frustum.projectedSize(pntMin, pntMax) < d->m_cullingMinimumSize)
+                ++stats.sizeCulledCount;
+        }
+    });
+
+    stats.frustumCulledCount = stats.objectCount - insideCount;
+    const Private::ViewCulling* culling = d->findViewCulling(view);
+    stats.viewCulledCount = culling ? int(culling->mapCulledObject.size()) : 0;
+    return stats;
 }
 
 GraphicsOwnerPtr GraphicsScene::firstSelectedOwner() const
@@ -375,4 +764,15 @@ GraphicsSceneRedrawBlocker::~GraphicsSceneRedrawBlocker()
     m_scene->blockRedraw(m_isRedrawBlockedOnEntry);
 }
 
+GraphicsSceneUpdateBatch::GraphicsSceneUpdateBatch(GraphicsScene* scene)
+    : m_scene(scene)
+{
+    scene->beginUpdate();
+}
+
+GraphicsSceneUpdateBatch::~GraphicsSceneUpdateBatch()
+{
+    m_scene->endUpdate();
+}
+
 } // namespace Mayo
@@ -11,6 +11,7 @@
 #include "graphics_owner_ptr.h"
 
 #include <AIS_InteractiveContext.hxx>
+#include <Bnd_Box.hxx>
 #include <V3d_Viewer.hxx>
 #include <V3d_View.hxx>
 #include <unordered_set>
@@ -51,7 +52,19 @@ public:
     bool isRedrawBlocked() const;
     void blockRedraw(bool on);
 
+    // Batched updates
+    // Between beginUpdate() and endUpdate(), changes of object visibility, transformation and display
+    // mode as well as presentation/selection recomputations and redraws are collected instead of
+    // being applied. The outermost endUpdate() applies them in one pass, each object being updated
+    // at most once, followed by a single redraw if any was requested
+    // Queries of object visibility and transformation take pending changes into account
+    // See also GraphicsSceneUpdateBatch
+    void beginUpdate();
+    void endUpdate();
+    bool isUpdating() const;
+
     void recomputeObjectPresentation(const GraphicsObjectPtr& object);
+    void recomputeObjectSelection(const GraphicsObjectPtr& object);
 
     void activateObjectSelection(const GraphicsObjectPtr& object, int mode);
     void deactivateObjectSelection(const GraphicsObjectPtr& object, int mode);
@@ -72,6 +85,34 @@ public:
     gp_Trsf objectTransformation(const GraphicsObjectPtr& object) const;
     void setObjectTransformation(const GraphicsObjectPtr& object, const gp_Trsf& trsf);
 
+    // Bounding box of an object in world coordinates, used for culling queries
+    // Boxes are kept in a BVH, so objects outside the view volume are found without testing each of
+    // them. A void box removes the object from culling queries
+    void setObjectBoundingBox(const GraphicsObjectPtr& object, const Bnd_Box& box);
+
+    // Hides in 'view' the objects whose bounding box is outside the view volume, so they aren't
+    // submitted to the renderer for that view. The BVH of object boxes is visited, objects culled by
+    // a previous call and now inside the view volume are shown again
+    // Returns true if the set of objects culled in 'view' changed, the view has then to be redrawn
+    bool updateViewCulling(const Handle_V3d_View& view);
+
+    // Shows again in 'view' all the objects culled by updateViewCulling()
+    // Useful during dynamic actions, the view volume being then changed without further culling
+    bool clearViewCulling(const Handle_V3d_View& view);
+
+    // Minimum size in pixels of the objects drawn, smaller objects are skipped by the renderer
+    // Zero means all objects are drawn
+    int cullingMinimumSize() const;
+    void setCullingMinimumSize(int pixels);
+
+    struct CullingStats {
+        int objectCount = 0; // Visible objects having a bounding box
+        int frustumCulledCount = 0; // Visible objects outside the view volume
+        int viewCulledCount = 0; // Objects currently hidden in the view by updateViewCulling()
+        int sizeCulledCount = 0; // Visible objects inside the view volume but smaller than the culling size
+    };
+    CullingStats cullingStats(const Handle_V3d_View& view) const;
+
     enum class SelectionMode {
         None, Single, Multi
     };
@@ -130,6 +171,21 @@ private:
     bool m_isRedrawBlockedOnEntry = false;
 };
 
+// Begins a batch of updates of a GraphicsScene on construction, ends it on destruction
+class GraphicsSceneUpdateBatch {
+public:
+    GraphicsSceneUpdateBatch(GraphicsScene* scene);
+    ~GraphicsSceneUpdateBatch();
+
+    GraphicsSceneUpdateBatch(const GraphicsSceneUpdateBatch&) = delete;
+    GraphicsSceneUpdateBatch(GraphicsSceneUpdateBatch&&) = delete;
+    GraphicsSceneUpdateBatch& operator=(const GraphicsSceneUpdateBatch&) = delete;
+    GraphicsSceneUpdateBatch& operator=(GraphicsSceneUpdateBatch&&) = delete;
+
+private:
+    GraphicsScene* m_scene = nullptr;
+};
+
 
 
 
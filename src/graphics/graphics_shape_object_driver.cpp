@@ -6,24 +6,287 @@
 
 #include "graphics_shape_object_driver.h"
 
+#include "../base/bnd_utils.h"
 #include "../base/brep_utils.h"
 #include "../base/caf_utils.h"
+#include "../base/document.h"
 #include "../base/triangulation_annex_data.h"
 #include "../base/label_data.h"
+#include "../base/mesh_edge_engine.h"
+#include "../base/tkernel_utils.h"
 #include "../base/xcaf.h"
 #include "graphics_utils.h"
 
 #include <AIS_ConnectedInteractive.hxx>
 #include <AIS_DisplayMode.hxx>
+#include <AIS_InteractiveContext.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRepTools.hxx>
+#include <BRep_Tool.hxx>
+#include <Graphic3d_ArrayOfSegments.hxx>
+#include <Graphic3d_Group.hxx>
+#include <Prs3d_IsoAspect.hxx>
+#include <Prs3d_ShadingAspect.hxx>
+#include <Precision.hxx>
+#include <StdPrs_ToolTriangulatedShape.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
 #include <XCAFPrs_AISObject.hxx>
 
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 namespace Mayo {
 
 namespace {
+
 struct GraphicsShapeObjectDriverI18N { MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::GraphicsShapeObjectDriver) };
+
+// AIS_Shape display mode presenting the bounding box of the shape
+constexpr int AisShape_BoundingBoxMode = 2;
+
+// Returns the object actually holding the shape presentation(ie the "product" for instances)
+Handle_XCAFPrs_AISObject productObject(const GraphicsObjectPtr& object)
+{
+    auto aisLink = Handle_AIS_ConnectedInteractive::DownCast(object);
+    if (aisLink && aisLink->HasConnection())
+        return Handle_XCAFPrs_AISObject::DownCast(aisLink->ConnectedTo());
+
+    return Handle_XCAFPrs_AISObject::DownCast(object);
+}
+
+bool isPlaceholderObject(const Handle_XCAFPrs_AISObject& product)
+{
+    return product && product->DisplayMode() == AisShape_BoundingBoxMode;
+}
+
+// XCAF object drawing edges in shaded mode as specified by GraphicsShapeObjectDriver::EdgeRendering
+// Face boundaries computed by OpenCascade are disabled for the shaded presentation, and replaced by
+// either the edges provided by MeshEdgeEngine or the silhouette outline of the shading aspect
+class GraphicsShapeObject : public XCAFPrs_AISObject {
+public:
+    using EdgeRendering = GraphicsShapeObjectDriver::EdgeRendering;
+
+    GraphicsShapeObject(const TDF_Label& label, EdgeRendering edgeRendering)
+        : XCAFPrs_AISObject(label),
+          m_edgeRendering(edgeRendering)
+    {
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+        if (m_edgeRendering == EdgeRendering::ScreenSpace)
+            m_edgeRendering = EdgeRendering::Extracted; // Silhouette outline isn't supported
+#endif
+    }
+
+    DEFINE_STANDARD_RTTI_INLINE(GraphicsShapeObject, XCAFPrs_AISObject)
+
+protected:
+    void Compute(
+            const Handle(PrsMgr_PresentationManager)& pm,
+            const Handle(Prs3d_Presentation)& pres,
+            const int mode) override
+    {
+        if (mode != AIS_Shaded || m_edgeRendering == EdgeRendering::FaceBoundaries) {
+            XCAFPrs_AISObject::Compute(pm, pres, mode);
+            return;
+        }
+
+        const bool showEdges = myDrawer->FaceBoundaryDraw();
+        myDrawer->SetFaceBoundaryDraw(false);
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+        if (m_edgeRendering == EdgeRendering::ScreenSpace && myDrawer->HasOwnShadingAspect()) {
+            // Styles of the XCAF object copy the shading aspect of its drawer
+            const Handle(Graphic3d_AspectFillArea3d)& aspect = myDrawer->ShadingAspect()->Aspect();
+            const Handle(Graphic3d_AspectLine3d)& edgeAspect = myDrawer->FaceBoundaryAspect()->Aspect();
+            aspect->SetDrawSilhouette(showEdges);
+            aspect->SetEdgeColor(edgeAspect->Color());
+            aspect->SetEdgeWidth(edgeAspect->Width());
+        }
+#endif
+
+        XCAFPrs_AISObject::Compute(pm, pres, mode);
+        myDrawer->SetFaceBoundaryDraw(showEdges);
+        if (showEdges && m_edgeRendering == EdgeRendering::Extracted)
+            this->addExtractedEdges(pres);
+    }
+
+private:
+    void addExtractedEdges(const Handle(Prs3d_Presentation)& pres) const
+    {
+        const TopoDS_Shape shape = this->Shape();
+        const auto edges = MeshEdgeEngine::instance().edges(shape);
+        if (!edges)
+            return;
+
+        const int nodeCount = int(edges->vecBoundaryNode.size() + edges->vecSharpNode.size());
+        if (nodeCount == 0)
+            return;
+
+        const gp_Trsf& trsf = shape.Location().Transformation();
+        Handle(Graphic3d_ArrayOfSegments) segments = new Graphic3d_ArrayOfSegments(nodeCount);
+        for (const auto* vecNode : { &edges->vecBoundaryNode, &edges->vecSharpNode }) {
+            for (const gp_XYZ& node : *vecNode)
+                segments->AddVertex(gp_Pnt(node).Transformed(trsf));
+        }
+
+        Handle(Graphic3d_Group) group = pres->NewGroup();
+        group->SetGroupPrimitivesAspect(myDrawer->FaceBoundaryAspect()->Aspect());
+        group->AddPrimitiveArray(segments);
+    }
+
+    EdgeRendering m_edgeRendering = EdgeRendering::FaceBoundaries;
+};
+
+// Mutex guarding the computation of the normals of a triangulation, triangulations being possibly
+// shared by several products prepared concurrently
+std::mutex& triangulationMutex(const Poly_Triangulation* triangulation)
+{
+    static std::mutex arrayMutex[64];
+    return arrayMutex[std::hash<const Poly_Triangulation*>{}(triangulation) % std::size(arrayMutex)];
+}
+
 } // namespace
 
+struct GraphicsShapeObjectDriver::LazyMeshing {
+    struct Job {
+        TopoDS_Shape shape;
+        gp_Pnt center;
+    };
+
+    // Item of the priority queue of pending jobs, items are ordered by distance to camera eye
+    // Items aren't removed on job cancellation or update, so they are checked against the actual
+    // pending jobs when popped
+    struct QueueItem {
+        double sqrDistance;
+        Handle_XCAFPrs_AISObject product;
+        bool operator<(const QueueItem& other) const { return sqrDistance > other.sqrDistance; }
+    };
+
+    void pushQueueItem(const Handle_XCAFPrs_AISObject& product, const Job& job) {
+        this->queueJob.push_back({ job.center.SquareDistance(this->eye), product });
+        std::push_heap(this->queueJob.begin(), this->queueJob.end());
+    }
+
+    // Rebuilds the priority queue from the pending jobs, needed when camera eye has moved
+    void rebuildQueue() {
+        this->queueJob.clear();
+        this->queueJob.reserve(this->mapPendingJob.size());
+        for (const auto& [product, job] : this->mapPendingJob)
+            this->queueJob.push_back({ job.center.SquareDistance(this->eye), product });
+
+        std::make_heap(this->queueJob.begin(), this->queueJob.end());
+        this->isQueueOutdated = false;
+    }
+
+    // Pops the pending job nearest to camera eye, requires lock on 'mutex'
+    std::pair<Handle_XCAFPrs_AISObject, Job> popNearestJob() {
+        // Obsolete items have accumulated, rebuild queue to release them
+        if (this->isQueueOutdated || this->queueJob.size() > 2 * this->mapPendingJob.size() + 64)
+            this->rebuildQueue();
+
+        while (!this->queueJob.empty()) {
+            std::pop_heap(this->queueJob.begin(), this->queueJob.end());
+            const QueueItem item = std::move(this->queueJob.back());
+            this->queueJob.pop_back();
+            auto itJob = this->mapPendingJob.find(item.product);
+            if (itJob == this->mapPendingJob.end())
+                continue; // Job cancelled or already popped with a nearer item
+
+            std::pair<Handle_XCAFPrs_AISObject, Job> job = { itJob->first, std::move(itJob->second) };
+            this->mapPendingJob.erase(itJob);
+            return job;
+        }
+
+        return {};
+    }
+
+    ~LazyMeshing() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->isStopRequested = true;
+        }
+
+        this->condition.notify_all();
+        for (std::thread& thread : this->vecThread)
+            thread.join();
+    }
+
+    void startThreads(GraphicsShapeObjectDriver* driver) {
+        if (!this->vecThread.empty())
+            return;
+
+        const unsigned threadCount = std::max(1u, std::thread::hardware_concurrency() / 2);
+        for (unsigned i = 0; i < threadCount; ++i)
+            this->vecThread.emplace_back([=]{ this->runJobs(driver); });
+    }
+
+    void runJobs(GraphicsShapeObjectDriver* driver) {
+        while (true) {
+            Handle_XCAFPrs_AISObject product;
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->condition.wait(lock, [=]{ return this->isStopRequested || !this->mapPendingJob.empty(); });
+                if (this->isStopRequested)
+                    return;
+
+                std::tie(product, job) = this->popNearestJob();
+                if (!product)
+                    continue;
+
+                this->setRunningProduct.insert(product);
+            }
+
+            BRepMeshFunction fnMesh;
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                fnMesh = this->fnMesh;
+            }
+
+            // Mesh a copy of the shape, geometry is shared as the mesher doesn't modify it
+            // Triangulations are attached to the actual shape by applyDisplayModeOnObjects(), in the
+            // thread of the graphics objects, so they are never written while being read
+            constexpr bool copyGeom = false;
+            constexpr bool copyMesh = false;
+            const TopoDS_Shape shapeMeshed = BRepBuilderAPI_Copy(job.shape, copyGeom, copyMesh).Shape();
+            if (fnMesh)
+                fnMesh(shapeMeshed);
+
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                if (this->setRunningProduct.erase(product) == 0)
+                    continue; // Discarded meanwhile, see discardMesh()
+
+                this->mapMeshedProduct.insert_or_assign(product, shapeMeshed);
+            }
+
+            driver->signalObjectMeshed.send(product);
+        }
+    }
+
+    BRepMeshFunction fnMesh;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::unordered_map<Handle_XCAFPrs_AISObject, Job> mapPendingJob;
+    std::vector<QueueItem> queueJob; // Binary heap, see std::push_heap()
+    bool isQueueOutdated = false;
+    std::unordered_set<Handle_XCAFPrs_AISObject> setRunningProduct;
+    // Products meshed but not yet switched from placeholder, mapped to the meshed shape copy
+    std::unordered_map<Handle_XCAFPrs_AISObject, TopoDS_Shape> mapMeshedProduct;
+    gp_Pnt eye;
+    bool isStopRequested = false;
+    std::vector<std::thread> vecThread;
+};
+
 GraphicsShapeObjectDriver::GraphicsShapeObjectDriver()
+    : m_lazyMeshing(std::make_unique<LazyMeshing>())
 {
     this->setDisplayModes({
         { DisplayMode_Wireframe, GraphicsShapeObjectDriverI18N::textId("Shape_Wireframe") },
@@ -34,6 +297,10 @@ GraphicsShapeObjectDriver::GraphicsShapeObjectDriver()
     this->setDefaultDisplayMode(DisplayMode_ShadedWithFaceBoundary);
 }
 
+GraphicsShapeObjectDriver::~GraphicsShapeObjectDriver()
+{
+}
+
 GraphicsObjectDriver::Support GraphicsShapeObjectDriver::supportStatus(const TDF_Label& label) const
 {
     return shapeSupportStatus(label);
@@ -42,34 +309,115 @@ GraphicsObjectDriver::Support GraphicsShapeObjectDriver::supportStatus(const TDF
 GraphicsObjectPtr GraphicsShapeObjectDriver::createObject(const TDF_Label& label) const
 {
     if (XCaf::isShape(label)) {
-        auto object = new XCAFPrs_AISObject(label);
+        auto object = new GraphicsShapeObject(label, m_edgeRendering);
         object->SetDisplayMode(AIS_Shaded);
         object->SetMaterial(Graphic3d_NOM_PLASTER);
         object->Attributes()->SetFaceBoundaryDraw(true);
         object->Attributes()->SetFaceBoundaryAspect(
                     new Prs3d_LineAspect(Quantity_NOC_BLACK, Aspect_TOL_SOLID, 1.)
         );
-        object->Attributes()->SetIsoOnTriangulation(true);
+        if (m_edgeRendering == EdgeRendering::FaceBoundaries) {
+            object->Attributes()->SetIsoOnTriangulation(true);
+        }
+        else {
+            // Isolines are a significant part of presentation time and of drawn lines
+            object->Attributes()->SetUIsoAspect(new Prs3d_IsoAspect(Quantity_NOC_GRAY, Aspect_TOL_SOLID, 1., 0));
+            object->Attributes()->SetVIsoAspect(new Prs3d_IsoAspect(Quantity_NOC_GRAY, Aspect_TOL_SOLID, 1., 0));
+        }
+
         //object->Attributes()->SetShadingModel(Graphic3d_TypeOfShadingModel_Pbr, true/*overrideDefaults*/);
         object->SetOwner(this);
+        if (this->isLazyMeshingEnabled() && !BRepTools::Triangulation(XCaf::shape(label), Precision::Infinite())) {
+            // Placeholder until shape gets meshed in background. Auto-triangulation is disabled so
+            // presentation/selection computation won't mesh the shape in the current thread
+            object->SetDisplayMode(AisShape_BoundingBoxMode);
+            object->Attributes()->SetAutoTriangulation(false);
+        }
+
         return object;
     }
 
     return {};
 }
 
+OccHandle<GraphicsMergedObject> GraphicsShapeObjectDriver::createMergedObject() const
+{
+    OccHandle<GraphicsMergedObject> object = new GraphicsMergedObject(m_edgeRendering);
+    object->SetDisplayMode(AIS_Shaded);
+    object->SetMaterial(Graphic3d_NOM_PLASTER);
+    object->Attributes()->SetFaceBoundaryDraw(true);
+    object->Attributes()->SetFaceBoundaryAspect(
+                new Prs3d_LineAspect(Quantity_NOC_BLACK, Aspect_TOL_SOLID, 1.)
+    );
+    object->SetOwner(this);
+    return object;
+}
+
 void GraphicsShapeObjectDriver::applyDisplayMode(GraphicsObjectPtr object, Enumeration::Value mode) const
 {
-    this->throwIf_differentDriver(object);
+    this->applyDisplayModeOnObjects(Span<const GraphicsObjectPtr>(&object, 1), mode);
+}
+
+void GraphicsShapeObjectDriver::applyDisplayModeOnObjects(
+        Span<const GraphicsObjectPtr> spanObject, Enumeration::Value mode) const
+{
+    this->throwIf_differentDriver(spanObject);
     this->throwIf_invalidDisplayMode(mode);
 
-    if (mode == this->currentDisplayMode(object))
-        return;
+    AIS_InteractiveContext* context = nullptr;
+    std::vector<GraphicsObjectPtr> vecObject;
+    for (const GraphicsObjectPtr& object : spanObject) {
+        if (mode == this->currentDisplayMode(object))
+            continue;
+
+        context = GraphicsUtils::AisObject_contextPtr(object);
+        if (!context)
+            continue;
 
-    AIS_InteractiveContext* context = GraphicsUtils::AisObject_contextPtr(object);
-    if (!context)
+        const Handle_XCAFPrs_AISObject product = productObject(object);
+        if (isPlaceholderObject(product)) {
+            TopoDS_Shape shapeMeshed;
+            {
+                std::lock_guard<std::mutex> lock(m_lazyMeshing->mutex);
+                auto itMeshed = m_lazyMeshing->mapMeshedProduct.find(product);
+                if (itMeshed == m_lazyMeshing->mapMeshedProduct.end())
+                    continue; // Mesh not ready, keep bounding box placeholder
+
+                shapeMeshed = itMeshed->second;
+                m_lazyMeshing->mapMeshedProduct.erase(itMeshed);
+            }
+
+            // Mesh is ready, attach it to the shape and restore regular presentation of the product
+            const TopoDS_Shape shape = XCaf::shape(product->GetLabel());
+            {
+                const DocumentPtr doc = Document::findFrom(product->GetLabel());
+                std::unique_lock<std::shared_mutex> lock;
+                if (!doc.IsNull())
+                    lock = std::unique_lock<std::shared_mutex>(doc->shapeMutex());
+
+                BRepUtils::transferMesh(shapeMeshed, shape);
+            }
+
+            MeshEdgeEngine::instance().invalidate(shape);
+            product->Attributes()->SetAutoTriangulation(true);
+            if (product != object)
+                product->SetDisplayMode(AIS_Shaded);
+        }
+
+        if (object->DisplayMode() == AisShape_BoundingBoxMode) {
+            // Switch from bounding box placeholder
+            context->SetDisplayMode(object, AIS_Shaded, false);
+            context->RecomputeSelectionOnly(object);
+        }
+
+        vecObject.push_back(object);
+    }
+
+    if (vecObject.empty())
         return;
 
+    // Hidden line removal is a state of the context and its views, so it's applied once whatever
+    // the count of objects: switching the computed mode of a view recomputes all its presentations
     auto fnSetViewComputedMode = [=](bool on) {
         for (auto it = context->CurrentViewer()->DefinedViewIterator(); it.More(); it.Next())
             it.Value()->SetComputedMode(on);
@@ -79,13 +427,15 @@ void GraphicsShapeObjectDriver::applyDisplayMode(GraphicsObjectPtr object, Enume
         context->DefaultDrawer()->SetTypeOfHLR(Prs3d_TOH_PolyAlgo);
         context->DefaultDrawer()->EnableDrawHiddenLine();
         fnSetViewComputedMode(true);
+        return;
     }
-    else {
-        context->DefaultDrawer()->SetTypeOfHLR(Prs3d_TOH_NotSet);
-        context->DefaultDrawer()->DisableDrawHiddenLine();
-        fnSetViewComputedMode(false);
-        const AIS_DisplayMode aisDispMode = mode == DisplayMode_Wireframe ? AIS_WireFrame : AIS_Shaded;
-        const bool showFaceBounds = mode == DisplayMode_ShadedWithFaceBoundary;
+
+    context->DefaultDrawer()->SetTypeOfHLR(Prs3d_TOH_NotSet);
+    context->DefaultDrawer()->DisableDrawHiddenLine();
+    fnSetViewComputedMode(false);
+    const AIS_DisplayMode aisDispMode = mode == DisplayMode_Wireframe ? AIS_WireFrame : AIS_Shaded;
+    const bool showFaceBounds = mode == DisplayMode_ShadedWithFaceBoundary;
+    for (const GraphicsObjectPtr& object : vecObject) {
         if (object->DisplayMode() != aisDispMode)
             context->SetDisplayMode(object, aisDispMode, false);
 
@@ -103,6 +453,31 @@ void GraphicsShapeObjectDriver::applyDisplayMode(GraphicsObjectPtr object, Enume
     }
 }
 
+std::function<void()> GraphicsShapeObjectDriver::prepareObjectJob(const GraphicsObjectPtr& object) const
+{
+    // Shaded presentation needs normals at triangulation nodes, computing them is a significant
+    // part of the presentation time
+    const Handle_XCAFPrs_AISObject product = productObject(object);
+    if (!product || isPlaceholderObject(product))
+        return {};
+
+    // Shape is taken from the document now, the job then only accesses triangulations of its faces
+    const TopoDS_Shape shape = XCaf::shape(product->GetLabel());
+    return [=]{
+        for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+            const TopoDS_Face& face = TopoDS::Face(expl.Current());
+            TopLoc_Location locFace;
+            const Handle_Poly_Triangulation& triangulation = BRep_Tool::Triangulation(face, locFace);
+            if (triangulation.IsNull() || triangulation->HasNormals())
+                continue;
+
+            std::lock_guard<std::mutex> lock(triangulationMutex(triangulation.get()));
+            if (!triangulation->HasNormals())
+                StdPrs_ToolTriangulatedShape::ComputeNormals(face, triangulation);
+        }
+    };
+}
+
 Enumeration::Value GraphicsShapeObjectDriver::currentDisplayMode(const GraphicsObjectPtr& object) const
 {
     this->throwIf_differentDriver(object);
@@ -130,6 +505,84 @@ GraphicsShapeObjectDriver::properties(Span<const GraphicsObjectPtr> spanObject)
     return {};
 }
 
+void GraphicsShapeObjectDriver::setLazyMeshingFunction(BRepMeshFunction fn)
+{
+    std::lock_guard<std::mutex> lock(m_lazyMeshing->mutex);
+    m_lazyMeshing->fnMesh = std::move(fn);
+}
+
+bool GraphicsShapeObjectDriver::isLazyMeshingEnabled() const
+{
+    std::lock_guard<std::mutex> lock(m_lazyMeshing->mutex);
+    return bool(m_lazyMeshing->fnMesh);
+}
+
+void GraphicsShapeObjectDriver::requestMesh(const GraphicsObjectPtr& object, const gp_Pnt& eye) const
+{
+    const Handle_XCAFPrs_AISObject product = productObject(object);
+    if (!isPlaceholderObject(product))
+        return;
+
+    const Bnd_Box bndBox = GraphicsUtils::AisObject_boundingBox(object);
+    const gp_Pnt center = !bndBox.IsVoid() ? BndBoxCoords::get(bndBox).center() : gp_Pnt{};
+    std::lock_guard<std::mutex> lock(m_lazyMeshing->mutex);
+    if (!eye.IsEqual(m_lazyMeshing->eye, 0.)) {
+        m_lazyMeshing->eye = eye;
+        m_lazyMeshing->isQueueOutdated = true;
+    }
+
+    if (m_lazyMeshing->mapMeshedProduct.find(product) != m_lazyMeshing->mapMeshedProduct.cend())
+        return; // Already meshed
+
+    if (m_lazyMeshing->setRunningProduct.find(product) != m_lazyMeshing->setRunningProduct.cend())
+        return; // Meshing in progress
+
+    auto itJob = m_lazyMeshing->mapPendingJob.find(product);
+    if (itJob != m_lazyMeshing->mapPendingJob.end()) {
+        // Already requested(eg by another instance), keep the instance nearest to eye
+        if (center.SquareDistance(eye) < itJob->second.center.SquareDistance(eye)) {
+            itJob->second.center = center;
+            m_lazyMeshing->pushQueueItem(product, itJob->second);
+        }
+
+        return;
+    }
+
+    const LazyMeshing::Job& job =
+            m_lazyMeshing->mapPendingJob.insert({ product, { XCaf::shape(product->GetLabel()), center } }).first->second;
+    m_lazyMeshing->pushQueueItem(product, job);
+    m_lazyMeshing->startThreads(const_cast<GraphicsShapeObjectDriver*>(this));
+    m_lazyMeshing->condition.notify_one();
+}
+
+bool GraphicsShapeObjectDriver::cancelMesh(const GraphicsObjectPtr& object) const
+{
+    const Handle_XCAFPrs_AISObject product = productObject(object);
+    if (!isPlaceholderObject(product))
+        return false;
+
+    // Queue item of the job is left, it's skipped when popped
+    std::lock_guard<std::mutex> lock(m_lazyMeshing->mutex);
+    return m_lazyMeshing->mapPendingJob.erase(product) != 0;
+}
+
+GraphicsObjectPtr GraphicsShapeObjectDriver::meshedProductObject(const GraphicsObjectPtr& object)
+{
+    return productObject(object);
+}
+
+void GraphicsShapeObjectDriver::discardMesh(const GraphicsObjectPtr& object) const
+{
+    const Handle_XCAFPrs_AISObject product = productObject(object);
+    if (!isPlaceholderObject(product))
+        return;
+
+    this->cancelMesh(object);
+    std::lock_guard<std::mutex> lock(m_lazyMeshing->mutex);
+    m_lazyMeshing->setRunningProduct.erase(product);
+    m_lazyMeshing->mapMeshedProduct.erase(product);
+}
+
 GraphicsObjectDriver::Support GraphicsShapeObjectDriver::shapeSupportStatus(const TDF_Label& label)
 {
     const LabelDataFlags flags = findLabelDataFlags(label);
@@ -6,7 +6,15 @@
 
 #pragma once
 
+#include "graphics_merged_object.h"
 #include "graphics_object_driver.h"
+#include "../base/signal.h"
+
+#include <gp_Pnt.hxx>
+#include <functional>
+#include <memory>
+
+class TopoDS_Shape;
 
 namespace Mayo {
 
@@ -18,12 +26,15 @@ using GraphicsShapeObjectDriverPtr = Handle(GraphicsShapeObjectDriver);
 class GraphicsShapeObjectDriver : public GraphicsObjectDriver {
 public:
     GraphicsShapeObjectDriver();
+    ~GraphicsShapeObjectDriver();
 
     Support supportStatus(const TDF_Label& label) const override;
     GraphicsObjectPtr createObject(const TDF_Label& label) const override;
     void applyDisplayMode(GraphicsObjectPtr object, Enumeration::Value mode) const override;
+    void applyDisplayModeOnObjects(Span<const GraphicsObjectPtr> spanObject, Enumeration::Value mode) const override;
     Enumeration::Value currentDisplayMode(const GraphicsObjectPtr& object) const override;
     std::unique_ptr<PropertyGroupSignals> properties(Span<const GraphicsObjectPtr> spanObject) const override;
+    std::function<void()> prepareObjectJob(const GraphicsObjectPtr& object) const override;
 
     static Support shapeSupportStatus(const TDF_Label& label);
 
@@ -34,7 +45,63 @@ public:
         DisplayMode_ShadedWithFaceBoundary
     };
 
+    // Lazy meshing
+    // When enabled, BRep shapes not yet meshed are displayed as a bounding box placeholder and get
+    // meshed once their graphics object is visible(see requestMesh()). Meshing jobs are executed by
+    // background threads, pending jobs nearest to the camera eye are executed first
+    // Function 'fn' computes the mesh of a shape, lazy meshing is disabled if 'fn' is empty
+    using BRepMeshFunction = std::function<void(const TopoDS_Shape&)>;
+    void setLazyMeshingFunction(BRepMeshFunction fn);
+    bool isLazyMeshingEnabled() const;
+
+    // Schedules meshing of the shape displayed by 'object', if 'object' is a placeholder
+    // 'eye' is the current camera eye location, used to prioritize pending jobs
+    void requestMesh(const GraphicsObjectPtr& object, const gp_Pnt& eye) const;
+
+    // Cancels pending meshing job of 'object'(eg 'object' was hidden meanwhile)
+    // Returns true if a pending job was actually cancelled
+    bool cancelMesh(const GraphicsObjectPtr& object) const;
+
+    // Returns the product object whose shape is meshed for 'object', ie the connected product if
+    // 'object' is an instance, otherwise 'object' itself
+    // Instances of the same product share a single meshing job
+    static GraphicsObjectPtr meshedProductObject(const GraphicsObjectPtr& object);
+
+    // Cancels meshing of 'object' and discards its mesh not yet applied with applyDisplayMode()
+    // Must be called when 'object' is erased, the driver holding the objects being meshed
+    void discardMesh(const GraphicsObjectPtr& object) const;
+
+    // Signal emitted(from a background thread) when the shape displayed by 'object' has been
+    // meshed. Placeholder graphics objects can then be switched to regular display mode with
+    // applyDisplayMode(), which attaches the computed mesh to the shape
+    mutable Signal<GraphicsObjectPtr> signalObjectMeshed;
+
+    // Static scene
+    // When enabled, parts of assemblies not presented with instancing are merged into a few
+    // GraphicsMergedObject instead of one graphics object per part, which cuts the count of draw
+    // calls. Parts can still be selected, highlighted, shown and hidden individually
+    // Applies to graphics objects created afterwards
+    void setStaticSceneEnabled(bool on) { m_isStaticSceneEnabled = on; }
+    bool isStaticSceneEnabled() const { return m_isStaticSceneEnabled; }
+
+    // Creates a merged object without any part, configured as objects returned by createObject()
+    OccHandle<GraphicsMergedObject> createMergedObject() const;
+
+    // Edge rendering
+    // Controls how edges are drawn in DisplayMode_ShadedWithFaceBoundary mode. Modes other than
+    // FaceBoundaries don't compute isolines either
+    // Applies to graphics objects created afterwards
+    using EdgeRendering = GraphicsMergedObject::EdgeRendering;
+    void setEdgeRendering(EdgeRendering mode) { m_edgeRendering = mode; }
+    EdgeRendering edgeRendering() const { return m_edgeRendering; }
+
     DEFINE_STANDARD_RTTI_INLINE(GraphicsShapeObjectDriver, GraphicsObjectDriver)
+
+private:
+    struct LazyMeshing;
+    std::unique_ptr<LazyMeshing> m_lazyMeshing;
+    bool m_isStaticSceneEnabled = false;
+    EdgeRendering m_edgeRendering = EdgeRendering::FaceBoundaries;
 };
 
 } // namespace Mayo
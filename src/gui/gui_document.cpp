@@ -8,12 +8,20 @@
 
 #include "../base/application.h"
 #include "../base/application_item.h"
+#include "../base/bnd_box_engine.h"
 #include "../base/bnd_utils.h"
 #include "../base/caf_utils.h"
 #include "../base/cpp_utils.h"
 #include "../base/document.h"
 #include "../base/math_utils.h"
+#include "../base/mesh_lod_engine.h"
 #include "../base/tkernel_utils.h"
+#include "../graphics/graphics_frustum.h"
+#include "../graphics/graphics_instanced_object.h"
+#include "../graphics/graphics_merged_object.h"
+#include "../graphics/graphics_point_cloud_object.h"
+#include "../graphics/graphics_point_cloud_object_driver.h"
+#include "../graphics/graphics_shape_object_driver.h"
 #include "../graphics/graphics_utils.h"
 #include "../gui/gui_application.h"
 
@@ -22,11 +30,15 @@
 #endif
 #include <AIS_ConnectedInteractive.hxx>
 #include <AIS_Trihedron.hxx>
+#include <BRepTools.hxx>
 #include <Geom_Axis2Placement.hxx>
 #include <Graphic3d_GraphicDriver.hxx>
+#include <Precision.hxx>
 #include <V3d_TypeOfOrientation.hxx>
+#include <XCAFPrs_AISObject.hxx>
 
 #include <cmath>
+#include <unordered_set>
 
 namespace Mayo {
 
@@ -65,6 +77,34 @@ static GuiDocument::GradientBackground& defaultGradientBackground()
     return defaultGradientBackground;
 }
 
+static int& defaultInstancingThreshold()
+{
+    static int threshold = 16;
+    return threshold;
+}
+
+static double& defaultLevelOfDetailPixelError()
+{
+    static double pixelError = 1.;
+    return pixelError;
+}
+
+static int& defaultCullingMinimumSize()
+{
+    static int pixels = 0;
+    return pixels;
+}
+
+static int& defaultPointCloudPointBudget()
+{
+    static int count = 5'000'000;
+    return count;
+}
+
+// Maximum count of parts merged into a GraphicsMergedObject when static scene is enabled, chunks
+// are small enough so the renderer can cull the ones out of the view volume
+constexpr int StaticSceneChunkSize = 256;
+
 } // namespace Internal
 
 GuiDocument::GuiDocument(const DocumentPtr& doc, GuiApplication* guiApp)
@@ -100,8 +140,31 @@ GuiDocument::GuiDocument(const DocumentPtr& doc, GuiApplication* guiApp)
     );
     //m_v3dView->SetShadingModel(Graphic3d_TOSM_PBR);
 
+    m_gfxScene.setCullingMinimumSize(GuiDocument::defaultCullingMinimumSize());
     m_cameraAnimation->setView(m_v3dView);
 
+    for (const GraphicsObjectDriverPtr& driver : guiApp->graphicsObjectDrivers()) {
+        auto shapeDriver = Handle_GraphicsShapeObjectDriver::DownCast(driver);
+        if (shapeDriver) {
+            m_vecLazyMeshingConnection.push_back(
+                shapeDriver->signalObjectMeshed.connectSlot(&GuiDocument::onGraphicsObjectMeshed, this)
+            );
+        }
+
+        auto pointCloudDriver = Handle_GraphicsPointCloudObjectDriver::DownCast(driver);
+        if (pointCloudDriver) {
+            m_vecPointCloudStreamingConnection.push_back(
+                pointCloudDriver->signalNodesLoaded.connectSlot(&GuiDocument::onPointCloudNodesLoaded, this)
+            );
+        }
+    }
+
+    // Background loading requires loaded objects to be handled in the current thread
+    if (getGlobalSignalThreadHelper()) {
+        m_gfxObjectLoaderConnection =
+                m_gfxObjectLoader.signalObjectsLoaded.connectSlot(&GuiDocument::onGraphicsObjectsLoaded, this);
+    }
+
     for (int i = 0; i < doc->entityCount(); ++i)
         this->mapEntity(doc->entityTreeNodeId(i));
 
@@ -149,6 +212,14 @@ void GuiDocument::setDevicePixelRatio(double ratio)
 
 GuiDocument::~GuiDocument()
 {
+    for (SignalConnectionHandle& connection : m_vecLazyMeshingConnection)
+        connection.disconnect();
+
+    for (SignalConnectionHandle& connection : m_vecPointCloudStreamingConnection)
+        connection.disconnect();
+
+    m_gfxObjectLoaderConnection.disconnect();
+
     delete m_cameraAnimation;
 }
 
@@ -170,6 +241,30 @@ void GuiDocument::foreachGraphicsObject(
     });
 }
 
+void GuiDocument::recomputeGraphicsObjects(TreeNodeId entityTreeNodeId)
+{
+    const GraphicsEntity* gfxEntity = this->findGraphicsEntity(entityTreeNodeId);
+    if (!gfxEntity)
+        return;
+
+    for (const GraphicsEntity::Object& object : gfxEntity->vecObject) {
+        // Presentation of a connected instance is computed from the presentation of its product
+        auto gfxLink = Handle_AIS_ConnectedInteractive::DownCast(object.ptr);
+        if (gfxLink && gfxLink->HasConnection())
+            gfxLink->ConnectedTo()->SetToUpdate();
+
+        auto gfxComposite = OccHandle<GraphicsCompositeObject>::DownCast(object.ptr);
+        if (gfxComposite) {
+            gfxComposite->loadTriangles();
+            m_gfxScene.recomputeObjectSelection(object.ptr);
+        }
+
+        m_gfxScene.recomputeObjectPresentation(object.ptr);
+    }
+
+    m_gfxScene.redraw();
+}
+
 TreeNodeId GuiDocument::nodeFromGraphicsObject(const GraphicsObjectPtr& gfxObject) const
 {
     if (!gfxObject)
@@ -184,6 +279,27 @@ TreeNodeId GuiDocument::nodeFromGraphicsObject(const GraphicsObjectPtr& gfxObjec
     return 0;
 }
 
+TreeNodeId GuiDocument::nodeFromGraphicsOwner(const GraphicsOwnerPtr& gfxOwner) const
+{
+    if (!gfxOwner)
+        return 0;
+
+    auto gfxObject = GraphicsObjectPtr::DownCast(gfxOwner->Selectable());
+    auto instanceOwner = OccHandle<GraphicsInstanceOwner>::DownCast(gfxOwner);
+    if (!instanceOwner)
+        return this->nodeFromGraphicsObject(gfxObject);
+
+    for (const GraphicsEntity& gfxEntity : m_vecGraphicsEntity) {
+        auto itObject = gfxEntity.mapCompositeObject.find(gfxObject);
+        if (itObject != gfxEntity.mapCompositeObject.cend()) {
+            const GraphicsEntity::Object& object = gfxEntity.vecObject.at(itObject->second);
+            return object.vecInstance.at(instanceOwner->instanceIndex()).treeNodeId;
+        }
+    }
+
+    return 0;
+}
+
 void GuiDocument::toggleItemSelected(const ApplicationItem& appItem)
 {
     const DocumentPtr doc = appItem.document();
@@ -199,8 +315,18 @@ void GuiDocument::toggleItemSelected(const ApplicationItem& appItem)
 
         traverseTree(docTreeNode.id(), doc->modelTree(), [=](TreeNodeId id) {
             GraphicsObjectPtr gfxObject = CppUtils::findValue(id, gfxEntity->mapTreeNodeGfxObject);
-            if (gfxObject)
+            if (!gfxObject)
+                return;
+
+            auto itInstance = gfxEntity->mapTreeNodeInstance.find(id);
+            if (itInstance != gfxEntity->mapTreeNodeInstance.cend()) {
+                auto gfxComposite = OccHandle<GraphicsCompositeObject>::DownCast(gfxObject);
+                if (gfxComposite->isInstanceVisible(itInstance->second))
+                    m_gfxScene.toggleOwnerSelection(gfxComposite->instanceOwner(itInstance->second));
+            }
+            else {
                 m_gfxScene.toggleOwnerSelection(gfxObject->GlobalSelOwner());
+            }
         });
     }
 }
@@ -226,12 +352,16 @@ void GuiDocument::setActiveDisplayMode(const GraphicsObjectDriverPtr& driver, in
         return;
 
     m_mapGfxDriverDisplayMode.insert_or_assign(driver, mode);
+    // Objects are passed all at once, so the driver can share work between them
+    std::vector<GraphicsObjectPtr> vecObject;
     for (const TreeNodeId entityNodeId : m_document->modelTree().roots()) {
         this->foreachGraphicsObject(entityNodeId, [&](GraphicsObjectPtr object) {
             if (GraphicsObjectDriver::get(object) == driver)
-                driver->applyDisplayMode(object, mode);
+                vecObject.push_back(object);
         });
     }
+
+    driver->applyDisplayModeOnObjects(vecObject, mode);
 }
 
 CheckState GuiDocument::nodeVisibleState(TreeNodeId nodeId) const
@@ -242,84 +372,134 @@ CheckState GuiDocument::nodeVisibleState(TreeNodeId nodeId) const
 
 void GuiDocument::setNodeVisible(TreeNodeId nodeId, bool on)
 {
-    auto itNode = m_mapTreeNodeCheckState.find(nodeId);
-    if (itNode == m_mapTreeNodeCheckState.end())
-        return; // Error: unknown tree node
+    this->setNodesVisible(Span<const TreeNodeId>(&nodeId, 1), on);
+}
 
+void GuiDocument::setNodesVisible(Span<const TreeNodeId> spanNodeId, bool on)
+{
     const CheckState nodeVisibleState = on ? CheckState::On : CheckState::Off;
-    if (itNode->second == nodeVisibleState)
-        return; // Same visible state
-
-    // Helper data/function to keep track of all the nodes whose visibility state are altered
-    std::unordered_map<TreeNodeId, CheckState> mapNodeIdVisibleState;
-    auto fnSetNodeVisibleState = [&](TreeNodeId id, CheckState state) {
-        auto it = m_mapTreeNodeCheckState.find(id);
-        if (it == m_mapTreeNodeCheckState.cend()) {
-            m_mapTreeNodeCheckState[id] = state;
-            mapNodeIdVisibleState[id] = state;
-        }
-        else if (it->second != state) {
-            it->second = state;
-            mapNodeIdVisibleState[id] = state;
-        }
-    };
+    std::vector<TreeNodeId> vecNodeId;
+    for (TreeNodeId nodeId : spanNodeId) {
+        auto itNode = m_mapTreeNodeCheckState.find(nodeId);
+        if (itNode != m_mapTreeNodeCheckState.cend() && itNode->second != nodeVisibleState)
+            vecNodeId.push_back(nodeId); // Skip unknown tree nodes and same visible state
+    }
+
+    if (vecNodeId.empty())
+        return;
 
-    // Recursive show/hide of the input node graphics
+    // Keep track of all the nodes whose visibility state are altered
+    MapVisibilityByTreeNodeId mapNodeIdVisibleState;
     const Tree<TDF_Label>& docModelTree = m_document->modelTree();
-    traverseTree(nodeId, docModelTree , [=](TreeNodeId id) {
-        fnSetNodeVisibleState(id, nodeVisibleState);
-    });
-    this->foreachGraphicsObject(nodeId, [=](GraphicsObjectPtr gfxObject) {
-        GraphicsUtils::AisObject_setVisible(gfxObject, on);
-    });
+    {   // Graphics changes of all the nodes are applied in one pass
+        GraphicsSceneUpdateBatch updateBatch(&m_gfxScene);
+        std::vector<OccHandle<GraphicsCompositeObject>> vecGfxCompositeChanged;
+        // Products whose pending meshing job was cancelled by hidden objects
+        std::unordered_set<const AIS_InteractiveObject*> setMeshCancelledProduct;
+        for (TreeNodeId nodeId : vecNodeId) {
+            // Recursive show/hide of the input node graphics
+            traverseTree(nodeId, docModelTree , [&](TreeNodeId id) {
+                this->setNodeVisibleState(id, nodeVisibleState, &mapNodeIdVisibleState);
+            });
+            const GraphicsEntity* gfxEntity = this->findGraphicsEntity(docModelTree.nodeRoot(nodeId));
+            traverseTree(nodeId, docModelTree, [&](TreeNodeId id) {
+                GraphicsObjectPtr gfxObject = gfxEntity ? CppUtils::findValue(id, gfxEntity->mapTreeNodeGfxObject) : GraphicsObjectPtr{};
+                if (!gfxObject)
+                    return;
 
-    // Keep selection state of the input node: in case the node graphics are "shown" back again then
-    // AIS object selection status is lost
-    const ApplicationItem appItem({ m_document, nodeId });
-    bool isAppItemSelected = m_guiApp->selectionModel()->isSelected(appItem);
-    if (!isAppItemSelected) { // Check if a parent is selected
-        TreeNodeId parentId = docModelTree.nodeParent(nodeId);
-        while (parentId != 0 && !isAppItemSelected) {
-            const ApplicationItem parentAppItem({ m_document, parentId });
-            isAppItemSelected = m_guiApp->selectionModel()->isSelected(parentAppItem);
-            parentId = docModelTree.nodeParent(parentId);
+                auto itInstance = gfxEntity->mapTreeNodeInstance.find(id);
+                if (itInstance != gfxEntity->mapTreeNodeInstance.cend()) {
+                    // Instance visibility is handled by the composite object itself
+                    auto gfxComposite = OccHandle<GraphicsCompositeObject>::DownCast(gfxObject);
+                    gfxComposite->setInstanceVisible(itInstance->second, on);
+                    auto itChanged = std::find(vecGfxCompositeChanged.cbegin(), vecGfxCompositeChanged.cend(), gfxComposite);
+                    if (itChanged == vecGfxCompositeChanged.cend())
+                        vecGfxCompositeChanged.push_back(gfxComposite);
+
+                    return;
+                }
+
+                m_gfxScene.setObjectVisible(gfxObject, on);
+                if (on) {
+                    this->requestGraphicsObjectMesh(gfxObject);
+                }
+                else {
+                    auto shapeDriver = Handle_GraphicsShapeObjectDriver::DownCast(GraphicsObjectDriver::get(gfxObject));
+                    if (shapeDriver && shapeDriver->cancelMesh(gfxObject))
+                        setMeshCancelledProduct.insert(GraphicsShapeObjectDriver::meshedProductObject(gfxObject).get());
+                }
+            });
         }
-    }
 
-    if (on && isAppItemSelected)
-        this->toggleItemSelected(appItem);
+        for (const OccHandle<GraphicsCompositeObject>& gfxComposite : vecGfxCompositeChanged) {
+            m_gfxScene.setObjectVisible(gfxComposite, gfxComposite->visibleInstanceCount() > 0);
+            m_gfxScene.recomputeObjectPresentation(gfxComposite);
+            m_gfxScene.recomputeObjectSelection(gfxComposite);
+        }
 
-    // Keep selection state of input node children
-    traverseTree(nodeId, docModelTree, [=](TreeNodeId id) {
-        if (id != nodeId) {
-            const ApplicationItem childAppItem({ m_document, id });
-            if (on && m_guiApp->selectionModel()->isSelected(childAppItem))
-                this->toggleItemSelected(childAppItem);
+        if (!setMeshCancelledProduct.empty()) {
+            // Meshing jobs are shared by instances of the same product, so the ones still visible
+            // have to be requested again
+            for (const GraphicsEntity& gfxEntity : m_vecGraphicsEntity) {
+                for (const GraphicsEntity::Object& object : gfxEntity.vecObject) {
+                    const GraphicsObjectPtr product = GraphicsShapeObjectDriver::meshedProductObject(object.ptr);
+                    const bool isMeshCancelled = setMeshCancelledProduct.find(product.get()) != setMeshCancelledProduct.cend();
+                    if (isMeshCancelled && m_gfxScene.isObjectVisible(object.ptr))
+                        this->requestGraphicsObjectMesh(object.ptr);
+                }
+            }
         }
-    });
+    }
+
+    for (TreeNodeId nodeId : vecNodeId) {
+        // Keep selection state of the input node: in case the node graphics are "shown" back again
+        // then AIS object selection status is lost
+        const ApplicationItem appItem({ m_document, nodeId });
+        bool isAppItemSelected = m_guiApp->selectionModel()->isSelected(appItem);
+        if (!isAppItemSelected) { // Check if a parent is selected
+            TreeNodeId parentId = docModelTree.nodeParent(nodeId);
+            while (parentId != 0 && !isAppItemSelected) {
+                const ApplicationItem parentAppItem({ m_document, parentId });
+                isAppItemSelected = m_guiApp->selectionModel()->isSelected(parentAppItem);
+                parentId = docModelTree.nodeParent(parentId);
+            }
+        }
+
+        if (on && isAppItemSelected)
+            this->toggleItemSelected(appItem);
 
-    // Parent nodes check state
-    TreeNodeId parentId = docModelTree.nodeParent(nodeId);
-    while (parentId != 0) {
-        int childCount = 0;
-        int checkedCount = 0;
-        int uncheckedCount = 0;
-        visitDirectChildren(parentId, docModelTree, [&](TreeNodeId id) {
-            ++childCount;
-            const CheckState childState = this->nodeVisibleState(id);
-            if (childState == CheckState::On)
-                ++checkedCount;
-            else if (childState == CheckState::Off)
-                ++uncheckedCount;
+        // Keep selection state of input node children
+        traverseTree(nodeId, docModelTree, [=](TreeNodeId id) {
+            if (id != nodeId) {
+                const ApplicationItem childAppItem({ m_document, id });
+                if (on && m_guiApp->selectionModel()->isSelected(childAppItem))
+                    this->toggleItemSelected(childAppItem);
+            }
         });
-        CheckState parentVisibleState = CheckState::Partially;
-        if (checkedCount == childCount)
-            parentVisibleState = CheckState::On;
-        else if (uncheckedCount == childCount)
-            parentVisibleState = CheckState::Off;
 
-        fnSetNodeVisibleState(parentId, parentVisibleState);
-        parentId = docModelTree.nodeParent(parentId);
+        // Parent nodes check state
+        TreeNodeId parentId = docModelTree.nodeParent(nodeId);
+        while (parentId != 0) {
+            int childCount = 0;
+            int checkedCount = 0;
+            int uncheckedCount = 0;
+            visitDirectChildren(parentId, docModelTree, [&](TreeNodeId id) {
+                ++childCount;
+                const CheckState childState = this->nodeVisibleState(id);
+                if (childState == CheckState::On)
+                    ++checkedCount;
+                else if (childState == CheckState::Off)
+                    ++uncheckedCount;
+            });
+            CheckState parentVisibleState = CheckState::Partially;
+            if (checkedCount == childCount)
+                parentVisibleState = CheckState::On;
+            else if (uncheckedCount == childCount)
+                parentVisibleState = CheckState::Off;
+
+            this->setNodeVisibleState(parentId, parentVisibleState, &mapNodeIdVisibleState);
+            parentId = docModelTree.nodeParent(parentId);
+        }
     }
 
     // Notify all node visibility changes
@@ -327,19 +507,89 @@ void GuiDocument::setNodeVisible(TreeNodeId nodeId, bool on)
         this->signalNodesVisibilityChanged.send(mapNodeIdVisibleState);
 }
 
+void GuiDocument::setNodeVisibleState(TreeNodeId nodeId, CheckState state, MapVisibilityByTreeNodeId* mapChanged)
+{
+    auto it = m_mapTreeNodeCheckState.find(nodeId);
+    if (it == m_mapTreeNodeCheckState.cend()) {
+        m_mapTreeNodeCheckState[nodeId] = state;
+        (*mapChanged)[nodeId] = state;
+    }
+    else if (it->second != state) {
+        it->second = state;
+        (*mapChanged)[nodeId] = state;
+    }
+}
+
 void GuiDocument::setExplodingFactor(double t)
 {
+    if (t == m_explodingFactor)
+        return;
+
+    // Transformations of all the objects are applied in one pass, with a single redraw
+    GraphicsSceneUpdateBatch updateBatch(&m_gfxScene);
     m_explodingFactor = t;
     for (const GraphicsEntity& entity : m_vecGraphicsEntity) {
-        const gp_Pnt entityCenter = BndBoxCoords::get(entity.bndBox).center();
         for (const GraphicsEntity::Object& object : entity.vecObject) {
-            const gp_Vec vecDirection(entityCenter, BndBoxCoords::get(object.bndBox).center());
+            auto gfxComposite = OccHandle<GraphicsCompositeObject>::DownCast(object.ptr);
+            if (gfxComposite) {
+                // Instances are moved individually, then vertices of the merged presentation are
+                // updated in place. Selection is recomputed once interactive exploding ends
+                Bnd_Box bndBox;
+                for (int i = 0; i < gfxComposite->instanceCount(); ++i) {
+                    const GraphicsEntity::Object::Instance& instance = object.vecInstance.at(i);
+                    gp_Trsf trsfMove;
+                    trsfMove.SetTranslation(2 * t * instance.explodingDirection);
+                    gfxComposite->setInstanceTransformation(i, trsfMove * instance.trsfOriginal);
+                    if (!instance.bndBox.IsVoid())
+                        BndUtils::add(&bndBox, instance.bndBox.Transformed(trsfMove));
+                }
+
+                m_gfxScene.recomputeObjectPresentation(object.ptr);
+                if (!m_isExplodingInteractive)
+                    m_gfxScene.recomputeObjectSelection(object.ptr);
+
+                m_gfxScene.setObjectBoundingBox(object.ptr, bndBox);
+                continue;
+            }
+
             gp_Trsf trsfMove;
-            trsfMove.SetTranslation(2 * t * vecDirection);
+            trsfMove.SetTranslation(2 * t * object.explodingDirection);
             m_gfxScene.setObjectTransformation(object.ptr, trsfMove * object.trsfOriginal);
+            if (!object.bndBox.IsVoid())
+                m_gfxScene.setObjectBoundingBox(object.ptr, object.bndBox.Transformed(trsfMove));
         }
     }
 
+    if (!m_isExplodingInteractive)
+        this->updateLevelsOfDetail();
+
+    m_gfxScene.redraw();
+}
+
+void GuiDocument::setExplodingInteractive(bool on)
+{
+    if (on == m_isExplodingInteractive)
+        return;
+
+    m_isExplodingInteractive = on;
+    if (on) {
+        // Exploded objects might move inside the view volume, view culling is updated on release
+        if (m_gfxScene.clearViewCulling(m_v3dView))
+            m_gfxScene.redraw();
+
+        return;
+    }
+
+    // Apply the updates skipped during interactive exploding
+    GraphicsSceneUpdateBatch updateBatch(&m_gfxScene);
+    for (const GraphicsEntity& entity : m_vecGraphicsEntity) {
+        for (const GraphicsEntity::Object& object : entity.vecObject) {
+            if (!OccHandle<GraphicsCompositeObject>::DownCast(object.ptr).IsNull())
+                m_gfxScene.recomputeObjectSelection(object.ptr);
+        }
+    }
+
+    this->updateLevelsOfDetail();
     m_gfxScene.redraw();
 }
 
@@ -511,6 +761,137 @@ void GuiDocument::setDefaultGradientBackground(const GradientBackground& gradien
     Internal::defaultGradientBackground() = gradientBkgnd;
 }
 
+int GuiDocument::defaultInstancingThreshold()
+{
+    return Internal::defaultInstancingThreshold();
+}
+
+void GuiDocument::setDefaultInstancingThreshold(int count)
+{
+    Internal::defaultInstancingThreshold() = count;
+}
+
+double GuiDocument::defaultLevelOfDetailPixelError()
+{
+    return Internal::defaultLevelOfDetailPixelError();
+}
+
+void GuiDocument::setDefaultLevelOfDetailPixelError(double pixelError)
+{
+    Internal::defaultLevelOfDetailPixelError() = pixelError;
+}
+
+int GuiDocument::defaultCullingMinimumSize()
+{
+    return Internal::defaultCullingMinimumSize();
+}
+
+void GuiDocument::setDefaultCullingMinimumSize(int pixels)
+{
+    Internal::defaultCullingMinimumSize() = pixels;
+}
+
+int GuiDocument::defaultPointCloudPointBudget()
+{
+    return Internal::defaultPointCloudPointBudget();
+}
+
+void GuiDocument::setDefaultPointCloudPointBudget(int count)
+{
+    Internal::defaultPointCloudPointBudget() = count;
+}
+
+void GuiDocument::updateLevelsOfDetail()
+{
+    if (m_v3dView->Window().IsNull())
+        return;
+
+    int viewWidth = 0;
+    int viewHeight = 0;
+    m_v3dView->Window()->Size(viewWidth, viewHeight);
+    if (viewHeight <= 0)
+        return;
+
+    // Objects outside the view volume aren't submitted to the renderer, except during dynamic
+    // actions where the view volume keeps changing
+    bool isViewChanged = false;
+    if (m_isCoarsestLevelOfDetailForced || m_isExplodingInteractive)
+        isViewChanged = m_gfxScene.clearViewCulling(m_v3dView);
+    else
+        isViewChanged = m_gfxScene.updateViewCulling(m_v3dView);
+
+    const GraphicsFrustum frustum(m_v3dView->Camera(), viewHeight);
+    const double pixelError = GuiDocument::defaultLevelOfDetailPixelError();
+    std::vector<OccHandle<GraphicsPointCloudObject>> vecGfxPointCloud;
+    for (const GraphicsEntity& gfxEntity : m_vecGraphicsEntity) {
+        for (const GraphicsEntity::Object& object : gfxEntity.vecObject) {
+            auto gfxPointCloud = OccHandle<GraphicsPointCloudObject>::DownCast(object.ptr);
+            if (gfxPointCloud && m_gfxScene.isObjectVisible(object.ptr))
+                vecGfxPointCloud.push_back(gfxPointCloud);
+
+            auto gfxInstanced = OccHandle<GraphicsInstancedObject>::DownCast(object.ptr);
+            if (!gfxInstanced || gfxInstanced->levelOfDetailCount() < 2)
+                continue;
+
+            bool isObjectChanged = false;
+            for (int i = 0; i < gfxInstanced->instanceCount(); ++i) {
+                const GraphicsEntity::Object::Instance& instance = object.vecInstance.at(i);
+                int level = 0;
+                if (m_isCoarsestLevelOfDetailForced) {
+                    level = gfxInstanced->levelOfDetail(Precision::Infinite());
+                }
+                else if (!instance.bndBox.IsVoid()) {
+                    const gp_Vec vecMove = 2 * m_explodingFactor * instance.explodingDirection;
+                    const gp_XYZ pntMin = instance.bndBox.CornerMin().XYZ() + vecMove.XYZ();
+                    const gp_XYZ pntMax = instance.bndBox.CornerMax().XYZ() + vecMove.XYZ();
+                    const double pixelsPerUnit = frustum.pixelsPerUnit((pntMin + pntMax) / 2.);
+                    if (frustum.isOutside(pntMin, pntMax))
+                        level = gfxInstanced->levelOfDetail(Precision::Infinite());
+                    else if (pixelsPerUnit > Precision::Confusion())
+                        level = gfxInstanced->levelOfDetail(pixelError / pixelsPerUnit);
+                }
+
+                if (level != gfxInstanced->instanceLevelOfDetail(i)) {
+                    gfxInstanced->setInstanceLevelOfDetail(i, level);
+                    isObjectChanged = true;
+                }
+            }
+
+            if (isObjectChanged) {
+                m_gfxScene.recomputeObjectPresentation(object.ptr);
+                isViewChanged = true;
+            }
+        }
+    }
+
+    // Nodes of point clouds are kept as is during dynamic actions, loaded nodes being drawn anyway
+    if (!m_isCoarsestLevelOfDetailForced && !vecGfxPointCloud.empty()) {
+        GraphicsPointCloudObject::selectNodes(vecGfxPointCloud, frustum, GuiDocument::defaultPointCloudPointBudget());
+        for (const OccHandle<GraphicsPointCloudObject>& gfxPointCloud : vecGfxPointCloud) {
+            auto pointCloudDriver = Handle_GraphicsPointCloudObjectDriver::DownCast(GraphicsObjectDriver::get(gfxPointCloud));
+            if (pointCloudDriver)
+                pointCloudDriver->requestNodes(gfxPointCloud);
+
+            if (gfxPointCloud->isPresentationOutdated()) {
+                m_gfxScene.recomputeObjectPresentation(gfxPointCloud);
+                isViewChanged = true;
+            }
+        }
+    }
+
+    if (isViewChanged)
+        m_gfxScene.redraw();
+}
+
+void GuiDocument::setCoarsestLevelOfDetailForced(bool on)
+{
+    if (on == m_isCoarsestLevelOfDetailForced)
+        return;
+
+    m_isCoarsestLevelOfDetailForced = on;
+    this->updateLevelsOfDetail();
+}
+
 void GuiDocument::onDocumentEntityAdded(TreeNodeId entityTreeNodeId)
 {
     this->mapEntity(entityTreeNodeId);
@@ -542,10 +923,7 @@ void GuiDocument::onGraphicsSelectionChanged()
 
     std::vector<ApplicationItem> vecSelected;
     m_gfxScene.foreachSelectedOwner([&](const GraphicsOwnerPtr& gfxOwner) {
-        auto gfxObject = GraphicsObjectPtr::DownCast(
-                    gfxOwner ? gfxOwner->Selectable() : Handle_SelectMgr_SelectableObject()
-        );
-        const TreeNodeId nodeId = this->nodeFromGraphicsObject(gfxObject);
+        const TreeNodeId nodeId = this->nodeFromGraphicsOwner(gfxOwner);
         if (nodeId != 0) {
             const ApplicationItem appItem({ m_document, nodeId });
             vecSelected.push_back(std::move(appItem));
@@ -569,12 +947,119 @@ void GuiDocument::onGraphicsSelectionChanged()
         appSelectionModel->remove(vecRemoved);
 }
 
+void GuiDocument::onGraphicsObjectMeshed(const GraphicsObjectPtr& gfxProduct)
+{
+    // 'gfxProduct' might be displayed directly or through connected instances
+    bool isDocumentObject = false;
+    for (const GraphicsEntity& gfxEntity : m_vecGraphicsEntity) {
+        for (const GraphicsEntity::Object& object : gfxEntity.vecObject) {
+            auto gfxLink = Handle_AIS_ConnectedInteractive::DownCast(object.ptr);
+            if (object.ptr == gfxProduct || (gfxLink && gfxLink->ConnectedTo() == gfxProduct)) {
+                auto driver = GraphicsObjectDriver::get(object.ptr);
+                driver->applyDisplayMode(object.ptr, this->activeDisplayMode(driver));
+                isDocumentObject = true;
+            }
+        }
+    }
+
+    if (isDocumentObject)
+        m_gfxScene.redraw();
+}
+
+void GuiDocument::onPointCloudNodesLoaded(const GraphicsObjectPtr& gfxPointCloud)
+{
+    auto gfxObject = OccHandle<GraphicsPointCloudObject>::DownCast(gfxPointCloud);
+    if (!gfxObject || !gfxObject->isPresentationOutdated())
+        return;
+
+    // 'gfxPointCloud' might have been erased meanwhile
+    for (const GraphicsEntity& gfxEntity : m_vecGraphicsEntity) {
+        for (const GraphicsEntity::Object& object : gfxEntity.vecObject) {
+            if (object.ptr == gfxPointCloud) {
+                m_gfxScene.recomputeObjectPresentation(gfxPointCloud);
+                m_gfxScene.redraw();
+                return;
+            }
+        }
+    }
+}
+
+void GuiDocument::onGraphicsObjectsLoaded(const std::vector<GraphicsObjectPtr>& vecObject)
+{
+    GraphicsSceneUpdateBatch updateBatch(&m_gfxScene);
+    std::vector<GraphicsObjectPtr> vecObjectAdded;
+    for (const GraphicsObjectPtr& object : vecObject) {
+        if (m_setLoadingObject.erase(object.get()) == 0)
+            continue; // Entity unmapped meanwhile
+
+        m_gfxScene.addObject(object);
+        vecObjectAdded.push_back(object);
+        // Node might have been hidden while the object was loading
+        bool isVisible = true;
+        for (const GraphicsEntity& gfxEntity : m_vecGraphicsEntity) {
+            auto itTreeNode = gfxEntity.mapGfxObjectTreeNode.find(object);
+            if (itTreeNode != gfxEntity.mapGfxObjectTreeNode.cend()) {
+                isVisible = this->nodeVisibleState(itTreeNode->second) != CheckState::Off;
+                break;
+            }
+        }
+
+        if (!isVisible)
+            m_gfxScene.setObjectVisible(object, false);
+    }
+
+    this->applyActiveDisplayModes(vecObjectAdded);
+    m_gfxScene.redraw();
+}
+
+void GuiDocument::applyActiveDisplayModes(Span<const GraphicsObjectPtr> spanObject)
+{
+    // Group objects by driver, keeping their order
+    std::vector<std::pair<GraphicsObjectDriverPtr, std::vector<GraphicsObjectPtr>>> vecDriverObjects;
+    for (const GraphicsObjectPtr& object : spanObject) {
+        auto driver = GraphicsObjectDriver::get(object);
+        if (!driver)
+            continue;
+
+        auto itDriver = std::find_if(
+                    vecDriverObjects.begin(), vecDriverObjects.end(),
+                    [&](const auto& driverObjects) { return driverObjects.first == driver; }
+        );
+        if (itDriver == vecDriverObjects.end())
+            itDriver = vecDriverObjects.insert(vecDriverObjects.end(), { driver, {} });
+
+        itDriver->second.push_back(object);
+    }
+
+    for (const auto& [driver, vecObject] : vecDriverObjects)
+        driver->applyDisplayModeOnObjects(vecObject, this->activeDisplayMode(driver));
+}
+
+void GuiDocument::requestGraphicsObjectMesh(const GraphicsObjectPtr& gfxObject)
+{
+    auto shapeDriver = Handle_GraphicsShapeObjectDriver::DownCast(GraphicsObjectDriver::get(gfxObject));
+    if (shapeDriver && shapeDriver->isLazyMeshingEnabled())
+        shapeDriver->requestMesh(gfxObject, m_v3dView->Camera()->Eye());
+}
+
 void GuiDocument::mapEntity(TreeNodeId entityTreeNodeId)
 {
     const Tree<TDF_Label>& docModelTree = m_document->modelTree();
     GraphicsEntity gfxEntity;
     gfxEntity.treeNodeId = entityTreeNodeId;
     std::unordered_map<TDF_Label, GraphicsObjectPtr> mapLabelGfxProduct;
+    // Instances sharing the graphics of their product, graphics objects are created once all the
+    // instances are known so the products with many instances can be presented with instancing
+    struct ProductInstance {
+        TreeNodeId treeNodeId;
+        TopLoc_Location location;
+    };
+    std::unordered_map<GraphicsObjectPtr, std::vector<ProductInstance>> mapGfxProductInstances;
+    std::vector<GraphicsObjectPtr> vecGfxProductWithInstances;
+    auto fnHasLevelsOfDetail = [](const GraphicsObjectPtr& gfxProduct) {
+        auto xcafProduct = Handle_XCAFPrs_AISObject::DownCast(gfxProduct);
+        return xcafProduct && MeshLodEngine::instance().hasLevels(XCaf::shape(xcafProduct->GetLabel()));
+    };
 
     traverseTree(entityTreeNodeId, docModelTree, [&](TreeNodeId id) {
         const TDF_Label nodeLabel = docModelTree.nodeData(id);
@@ -601,17 +1086,24 @@ void GuiDocument::mapEntity(TreeNodeId entityTreeNodeId)
                     gfxEntity.vecObject.push_back(gfxObject);
                 }
                 else {
-                    auto gfxInstance = new AIS_ConnectedInteractive;
-                    gfxInstance->Connect(gfxProduct, XCaf::shapeAbsoluteLocation(docModelTree, id));
-                    gfxInstance->SetDisplayMode(gfxProduct->DisplayMode());
-                    gfxInstance->Attributes()->SetFaceBoundaryDraw(gfxProduct->Attributes()->FaceBoundaryDraw());
-                    gfxInstance->SetOwner(gfxProduct->GetOwner());
-                    gfxEntity.vecObject.push_back(GraphicsObjectPtr(gfxInstance));
+                    std::vector<ProductInstance>& vecInstance = mapGfxProductInstances[gfxProduct];
+                    if (vecInstance.empty())
+                        vecGfxProductWithInstances.push_back(gfxProduct);
+
+                    const TreeNodeId instanceNodeId = XCaf::isShapeReference(parentNodeLabel) ? parentNodeId : id;
+                    vecInstance.push_back({ instanceNodeId, XCaf::shapeAbsoluteLocation(docModelTree, id) });
+                    return;
                 }
 
                 if (XCaf::isShapeReference(parentNodeLabel))
                     id = docModelTree.nodeParent(id);
             }
+            else if (fnHasLevelsOfDetail(gfxProduct)) {
+                // Single instance, so the product is drawn with its levels of detail
+                mapGfxProductInstances[gfxProduct].push_back({ id, TopLoc_Location() });
+                vecGfxProductWithInstances.push_back(gfxProduct);
+                return;
+            }
             else {
                 gfxEntity.vecObject.push_back(gfxProduct);
             }
@@ -622,27 +1114,200 @@ void GuiDocument::mapEntity(TreeNodeId entityTreeNodeId)
         }
     });
 
+    // Parts to be merged into GraphicsMergedObject chunks(static scene)
+    struct StaticPart {
+        TreeNodeId treeNodeId;
+        TDF_Label label;
+        gp_Trsf trsf;
+    };
+    std::vector<StaticPart> vecStaticPart;
+    GraphicsShapeObjectDriverPtr staticSceneDriver;
+
+    const int instancingThreshold = GuiDocument::defaultInstancingThreshold();
+    for (const GraphicsObjectPtr& gfxProduct : vecGfxProductWithInstances) {
+        const std::vector<ProductInstance>& vecInstance = mapGfxProductInstances.at(gfxProduct);
+        auto xcafProduct = Handle_XCAFPrs_AISObject::DownCast(gfxProduct);
+        auto shapeDriver = Handle_GraphicsShapeObjectDriver::DownCast(GraphicsObjectDriver::get(gfxProduct));
+        // Instancing and merging require the shape to be meshed, lazy meshing placeholders aren't supported
+        const bool isProductMeshed =
+                xcafProduct && BRepTools::Triangulation(XCaf::shape(xcafProduct->GetLabel()), Precision::Infinite());
+        const bool hasLevelsOfDetail = fnHasLevelsOfDetail(gfxProduct);
+        const bool useInstancing =
+                ((instancingThreshold > 0 && CppUtils::cmpGreaterEqual(vecInstance.size(), instancingThreshold))
+                 || hasLevelsOfDetail)
+                && isProductMeshed;
+        const bool useStaticScene = shapeDriver && shapeDriver->isStaticSceneEnabled() && isProductMeshed;
+        if (useInstancing) {
+            OccHandle<GraphicsInstancedObject> gfxInstanced = new GraphicsInstancedObject(xcafProduct->GetLabel());
+            gfxInstanced->SetMaterial(gfxProduct->Material());
+            gfxInstanced->SetDisplayMode(gfxProduct->DisplayMode());
+            gfxInstanced->Attributes()->SetFaceBoundaryDraw(gfxProduct->Attributes()->FaceBoundaryDraw());
+            gfxInstanced->Attributes()->SetFaceBoundaryAspect(gfxProduct->Attributes()->FaceBoundaryAspect());
+            gfxInstanced->SetOwner(gfxProduct->GetOwner());
+            if (hasLevelsOfDetail) {
+                const TopoDS_Shape shapeProduct = XCaf::shape(xcafProduct->GetLabel());
+                for (const TopoDS_Shape& shapeLevel : MeshLodEngine::instance().levels(shapeProduct))
+                    gfxInstanced->addLevelOfDetail(shapeLevel);
+            }
+
+            GraphicsEntity::Object object(gfxInstanced);
+            for (const ProductInstance& instance : vecInstance) {
+                const int instanceIndex = gfxInstanced->addInstance(instance.location.Transformation());
+                object.vecInstance.push_back({ instance.treeNodeId, {}, {}, {} });
+                gfxEntity.mapTreeNodeGfxObject.insert({ instance.treeNodeId, gfxInstanced });
+                gfxEntity.mapTreeNodeInstance.insert({ instance.treeNodeId, instanceIndex });
+            }
+
+            gfxEntity.mapCompositeObject.insert({ gfxInstanced, int(gfxEntity.vecObject.size()) });
+            gfxEntity.vecObject.push_back(std::move(object));
+        }
+        else if (useStaticScene) {
+            for (const ProductInstance& instance : vecInstance)
+                vecStaticPart.push_back({ instance.treeNodeId, xcafProduct->GetLabel(), instance.location.Transformation() });
+
+            staticSceneDriver = shapeDriver;
+        }
+        else {
+            for (const ProductInstance& instance : vecInstance) {
+                auto gfxInstance = new AIS_ConnectedInteractive;
+                gfxInstance->Connect(gfxProduct, instance.location);
+                gfxInstance->SetDisplayMode(gfxProduct->DisplayMode());
+                gfxInstance->Attributes()->SetFaceBoundaryDraw(gfxProduct->Attributes()->FaceBoundaryDraw());
+                gfxInstance->SetOwner(gfxProduct->GetOwner());
+                gfxEntity.vecObject.push_back(GraphicsObjectPtr(gfxInstance));
+                gfxEntity.mapTreeNodeGfxObject.insert({ instance.treeNodeId, gfxInstance });
+                gfxEntity.mapGfxObjectTreeNode.insert({ gfxInstance, instance.treeNodeId });
+            }
+        }
+    }
+
+    // Bounding boxes of shape products are computed once(and cached by BndBoxEngine), then placed
+    // with the location of each instance
+    std::unordered_map<TDF_Label, Bnd_Box> mapProductBndBox;
+    auto fnProductBndBox = [&](const TDF_Label& productLabel) {
+        auto it = mapProductBndBox.find(productLabel);
+        if (it != mapProductBndBox.cend())
+            return it->second;
+
+        const Bnd_Box bndBox = BndBoxEngine::instance().get(productLabel, BndBoxEngine::Mode::Triangulation);
+        mapProductBndBox.insert({ productLabel, bndBox });
+        return bndBox;
+    };
+
+    // Static scene parts are merged by chunks of nearby parts, each chunk being a separate graphics
+    // object so the renderer still culls the chunks out of the view volume
+    if (!vecStaticPart.empty()) {
+        std::vector<Bnd_Box> vecPartBndBox;
+        for (const StaticPart& part : vecStaticPart) {
+            const Bnd_Box bndBox = fnProductBndBox(part.label);
+            vecPartBndBox.push_back(!bndBox.IsVoid() ? bndBox.Transformed(part.trsf) : bndBox);
+        }
+
+        for (const std::vector<int>& vecPartIndex : GraphicsMergedObject::spatialChunks(vecPartBndBox, Internal::StaticSceneChunkSize)) {
+            OccHandle<GraphicsMergedObject> gfxMerged = staticSceneDriver->createMergedObject();
+            GraphicsEntity::Object object(gfxMerged);
+            for (int partIndex : vecPartIndex) {
+                const StaticPart& part = vecStaticPart.at(partIndex);
+                const int instanceIndex = gfxMerged->addInstance(part.label, part.trsf);
+                object.vecInstance.push_back({ part.treeNodeId, {}, {}, {} });
+                gfxEntity.mapTreeNodeGfxObject.insert({ part.treeNodeId, gfxMerged });
+                gfxEntity.mapTreeNodeInstance.insert({ part.treeNodeId, instanceIndex });
+            }
+
+            gfxEntity.mapCompositeObject.insert({ gfxMerged, int(gfxEntity.vecObject.size()) });
+            gfxEntity.vecObject.push_back(std::move(object));
+        }
+    }
+
+    // Objects of shapes are loaded in background(their bounding box is known without presentation),
+    // other objects are added right now
+    const bool isLoaderEnabled = m_gfxObjectLoaderConnection.isActive();
+    std::vector<GraphicsObjectPtr> vecObjectToLoad;
+    std::vector<GraphicsObjectPtr> vecObjectAdded;
     for (const GraphicsEntity::Object& object : gfxEntity.vecObject) {
+        auto gfxLink = Handle_AIS_ConnectedInteractive::DownCast(object.ptr);
+        const GraphicsObjectPtr gfxProduct = gfxLink ? gfxLink->ConnectedTo() : object.ptr;
+        // Composite objects have no preparation job, their presentation is computed right now
+        const bool isShapeObject = !Handle_XCAFPrs_AISObject::DownCast(gfxProduct).IsNull();
+        if (isLoaderEnabled && isShapeObject) {
+            vecObjectToLoad.push_back(object.ptr);
+            m_setLoadingObject.insert(object.ptr.get());
+            continue;
+        }
+
         m_gfxScene.addObject(object.ptr);
-        auto driver = GraphicsObjectDriver::get(object.ptr);
-        if (driver)
-            driver->applyDisplayMode(object.ptr, this->activeDisplayMode(driver));
+        vecObjectAdded.push_back(object.ptr);
     }
 
+    this->applyActiveDisplayModes(vecObjectAdded);
+
     for (GraphicsEntity::Object& object : gfxEntity.vecObject) {
-        object.bndBox = GraphicsUtils::AisObject_boundingBox(object.ptr);
+        auto gfxLink = Handle_AIS_ConnectedInteractive::DownCast(object.ptr);
+        const GraphicsObjectPtr gfxProduct = gfxLink ? gfxLink->ConnectedTo() : object.ptr;
+        auto gfxComposite = OccHandle<GraphicsCompositeObject>::DownCast(object.ptr);
+        if (gfxComposite) {
+            object.bndBox.SetVoid();
+            for (int i = 0; i < gfxComposite->instanceCount(); ++i) {
+                GraphicsEntity::Object::Instance& instance = object.vecInstance.at(i);
+                const Bnd_Box productBndBox = fnProductBndBox(gfxComposite->instanceLabel(i));
+                instance.trsfOriginal = gfxComposite->instanceTransformation(i);
+                if (!productBndBox.IsVoid())
+                    instance.bndBox = productBndBox.Transformed(instance.trsfOriginal);
+
+                BndUtils::add(&object.bndBox, instance.bndBox);
+            }
+        }
+        else if (auto xcafProduct = Handle_XCAFPrs_AISObject::DownCast(gfxProduct)) {
+            object.bndBox = fnProductBndBox(xcafProduct->GetLabel());
+            if (!object.bndBox.IsVoid() && object.ptr->HasTransformation())
+                object.bndBox = object.bndBox.Transformed(object.ptr->LocalTransformation());
+        }
+        else {
+            object.bndBox = GraphicsUtils::AisObject_boundingBox(object.ptr);
+        }
+
         object.trsfOriginal = m_gfxScene.objectTransformation(object.ptr);
+        m_gfxScene.setObjectBoundingBox(object.ptr, object.bndBox);
         BndUtils::add(&gfxEntity.bndBox, object.bndBox);
     }
 
+    // Directions used by setExplodingFactor()
+    if (!gfxEntity.bndBox.IsVoid()) {
+        const gp_Pnt entityCenter = BndBoxCoords::get(gfxEntity.bndBox).center();
+        for (GraphicsEntity::Object& object : gfxEntity.vecObject) {
+            if (!object.bndBox.IsVoid())
+                object.explodingDirection = gp_Vec(entityCenter, BndBoxCoords::get(object.bndBox).center());
+
+            for (GraphicsEntity::Object::Instance& instance : object.vecInstance) {
+                if (!instance.bndBox.IsVoid())
+                    instance.explodingDirection = gp_Vec(entityCenter, BndBoxCoords::get(instance.bndBox).center());
+            }
+        }
+    }
+
     m_gfxScene.redraw();
 
     traverseTree(entityTreeNodeId, docModelTree, [=](TreeNodeId id) {
         m_mapTreeNodeCheckState.insert({ id, CheckState::On });
     });
 
-    GraphicsUtils::V3dView_fitAll(m_v3dView);
+    if (vecObjectToLoad.empty()) {
+        GraphicsUtils::V3dView_fitAll(m_v3dView);
+    }
+    else {
+        // Loading objects aren't displayed yet, so view is fitted to the known bounding boxes
+        Bnd_Box bndBoxFit = m_gfxBoundingBox;
+        BndUtils::add(&bndBoxFit, gfxEntity.bndBox);
+        if (!bndBoxFit.IsVoid())
+            m_v3dView->FitAll(bndBoxFit, 0.01, false/*dontUpdateView*/);
+    }
+
+    for (const GraphicsEntity::Object& object : gfxEntity.vecObject)
+        this->requestGraphicsObjectMesh(object.ptr);
+
     m_vecGraphicsEntity.push_back(std::move(gfxEntity));
+    this->updateLevelsOfDetail();
+    m_gfxObjectLoader.load(vecObjectToLoad);
 }
 
 void GuiDocument::unmapEntity(TreeNodeId entityTreeNodeId)
@@ -652,8 +1317,18 @@ void GuiDocument::unmapEntity(TreeNodeId entityTreeNodeId)
         if (!ptrItem)
             return;
 
-        for (const GraphicsEntity::Object& object : ptrItem->vecObject)
+        for (const GraphicsEntity::Object& object : ptrItem->vecObject) {
+            auto shapeDriver = Handle_GraphicsShapeObjectDriver::DownCast(GraphicsObjectDriver::get(object.ptr));
+            if (shapeDriver)
+                shapeDriver->discardMesh(object.ptr);
+
+            auto pointCloudDriver = Handle_GraphicsPointCloudObjectDriver::DownCast(GraphicsObjectDriver::get(object.ptr));
+            if (pointCloudDriver)
+                pointCloudDriver->cancelNodes(object.ptr);
+
             m_gfxScene.eraseObject(object.ptr);
+            m_setLoadingObject.erase(object.ptr.get());
+        }
 
         const auto indexItem = ptrItem - &m_vecGraphicsEntity.front();
         m_vecGraphicsEntity.erase(m_vecGraphicsEntity.begin() + indexItem);
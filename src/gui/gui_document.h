@@ -11,6 +11,7 @@
 #include "../base/signal.h"
 #include "../base/tkernel_utils.h"
 #include "../graphics/graphics_object_driver.h"
+#include "../graphics/graphics_object_loader.h"
 #include "../graphics/graphics_scene.h"
 #include "../graphics/graphics_view_ptr.h"
 #include "v3d_view_camera_animation.h"
@@ -18,9 +19,11 @@
 #include <Aspect_TypeOfTriedronPosition.hxx>
 #include <Bnd_Box.hxx>
 #include <V3d_View.hxx>
+#include <gp_Vec.hxx>
 #include <functional>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace Mayo {
@@ -59,9 +62,17 @@ public:
     // This also includes all children(deep node traversal)
     void foreachGraphicsObject(TreeNodeId nodeId, const std::function<void(GraphicsObjectPtr)>& fn) const;
 
+    // Recomputes the presentations of all graphics objects of entity 'entityTreeNodeId' and redraws
+    // Typically needed when the underlying data was modified, eg shape triangulations were refined
+    void recomputeGraphicsObjects(TreeNodeId entityTreeNodeId);
+
     // Finds the tree node id associated to graphics object
     TreeNodeId nodeFromGraphicsObject(const GraphicsObjectPtr& gfxObject) const;
 
+    // Finds the tree node id associated to graphics owner, taking care of owners identifying an
+    // instance of a GraphicsCompositeObject
+    TreeNodeId nodeFromGraphicsOwner(const GraphicsOwnerPtr& gfxOwner) const;
+
     // Toggles selected status of an application item(doesn't affect Application's selection model)
     void toggleItemSelected(const ApplicationItem& appItem);
 
@@ -75,10 +86,18 @@ public:
     // -- Visible state of document's tree nodes
     CheckState nodeVisibleState(TreeNodeId nodeId) const;
     void setNodeVisible(TreeNodeId nodeId, bool on);
+    // Same as setNodeVisible() on each node, but graphics are updated in one pass and
+    // signalNodesVisibilityChanged is emitted once
+    void setNodesVisible(Span<const TreeNodeId> spanNodeId, bool on);
 
     // -- Exploding
     double explodingFactor() const { return m_explodingFactor; }
     void setExplodingFactor(double t); // Must be in [0,1]
+    // Exploding is interactive while the factor is continuously changed(eg slider being dragged),
+    // then only presentations are updated. Selection of the instances of GraphicsCompositeObject
+    // and levels of detail are updated once interactive exploding ends
+    bool isExplodingInteractive() const { return m_isExplodingInteractive; }
+    void setExplodingInteractive(bool on);
 
     // -- Visibility of trihedron at world origin
     bool isOriginTrihedronVisible() const;
@@ -114,6 +133,42 @@ public:
     static const GradientBackground& defaultGradientBackground();
     static void setDefaultGradientBackground(const GradientBackground& gradientBkgnd);
 
+    // -- Instancing
+    // Products having at least 'count' instances in a document entity are displayed with a single
+    // GraphicsInstancedObject instead of one graphics object per instance. Zero disables instancing
+    // Applies to entities mapped afterwards
+    static int defaultInstancingThreshold();
+    static void setDefaultInstancingThreshold(int count);
+
+    // -- Levels of detail
+    // Products having levels of detail(see MeshLodEngine) are displayed with a GraphicsInstancedObject
+    // whatever their count of instances. Each instance is drawn with the coarsest level whose chordal
+    // deflection projected on the view doesn't exceed the pixel error
+    // Objects outside the view volume are also culled from the view, see GraphicsScene::updateViewCulling()
+    // Levels and culling have to be updated when the view camera changes
+    void updateLevelsOfDetail();
+    // Coarsest levels are drawn whatever the pixel error, typically during view dynamic actions
+    bool isCoarsestLevelOfDetailForced() const { return m_isCoarsestLevelOfDetailForced; }
+    void setCoarsestLevelOfDetailForced(bool on);
+
+    static double defaultLevelOfDetailPixelError();
+    static void setDefaultLevelOfDetailPixelError(double pixelError);
+
+    // -- Culling
+    // Objects outside the view volume are skipped by the renderer, instances of a GraphicsInstancedObject
+    // outside the view volume are drawn with their coarsest level of detail
+    // Objects whose projected size is less than the minimum size(in pixels) aren't drawn, zero draws
+    // all objects. Applies to documents created afterwards
+    static int defaultCullingMinimumSize();
+    static void setDefaultCullingMinimumSize(int pixels);
+
+    // -- Point clouds
+    // Point clouds stored in an octree(see PointCloudData::octree()) are streamed: nodes are selected
+    // coarsest first for the current view, sharing the point budget among all the point clouds of
+    // the document, then loaded in background. Selection is updated along with the levels of detail
+    static int defaultPointCloudPointBudget();
+    static void setDefaultPointCloudPointBudget(int count);
+
     // Signals
     using MapVisibilityByTreeNodeId = std::unordered_map<TreeNodeId, CheckState>;
     mutable Signal<const MapVisibilityByTreeNodeId&> signalNodesVisibilityChanged;
@@ -126,6 +181,14 @@ private:
     void onDocumentEntityAdded(TreeNodeId entityTreeNodeId);
     void onDocumentEntityAboutToBeDestroyed(TreeNodeId entityTreeNodeId);
     void onGraphicsSelectionChanged();
+    void onGraphicsObjectMeshed(const GraphicsObjectPtr& gfxProduct);
+    void onPointCloudNodesLoaded(const GraphicsObjectPtr& gfxPointCloud);
+    void onGraphicsObjectsLoaded(const std::vector<GraphicsObjectPtr>& vecObject);
+    void requestGraphicsObjectMesh(const GraphicsObjectPtr& gfxObject);
+    // Applies to objects the active display mode of their driver, objects being passed to each
+    // driver all at once with GraphicsObjectDriver::applyDisplayModeOnObjects()
+    void applyActiveDisplayModes(Span<const GraphicsObjectPtr> spanObject);
+    void setNodeVisibleState(TreeNodeId nodeId, CheckState state, MapVisibilityByTreeNodeId* mapChanged);
 
     void mapEntity(TreeNodeId entityTreeNodeId);
     void unmapEntity(TreeNodeId entityTreeNodeId);
@@ -136,12 +199,25 @@ private:
             GraphicsObjectPtr ptr;
             gp_Trsf trsfOriginal;
             Bnd_Box bndBox;
+            gp_Vec explodingDirection; // From center of entity box to center of object box
+
+            // Placement of each instance when 'ptr' is a GraphicsCompositeObject, items are ordered
+            // by instance index
+            struct Instance {
+                TreeNodeId treeNodeId;
+                gp_Trsf trsfOriginal;
+                Bnd_Box bndBox;
+                gp_Vec explodingDirection;
+            };
+            std::vector<Instance> vecInstance;
         };
 
         TreeNodeId treeNodeId;
         std::vector<Object> vecObject;
         std::unordered_map<TreeNodeId, GraphicsObjectPtr> mapTreeNodeGfxObject;
         std::unordered_map<GraphicsObjectPtr, TreeNodeId> mapGfxObjectTreeNode;
+        std::unordered_map<TreeNodeId, int> mapTreeNodeInstance; // Instance index in its GraphicsCompositeObject
+        std::unordered_map<GraphicsObjectPtr, int> mapCompositeObject; // Index in 'vecObject' of GraphicsCompositeObject items
         Bnd_Box bndBox;
     };
 
@@ -168,6 +244,16 @@ private:
     std::unordered_map<TreeNodeId, CheckState> m_mapTreeNodeCheckState;
 
     double m_explodingFactor = 0.;
+    bool m_isExplodingInteractive = false;
+    bool m_isCoarsestLevelOfDetailForced = false;
+
+    std::vector<SignalConnectionHandle> m_vecLazyMeshingConnection;
+    std::vector<SignalConnectionHandle> m_vecPointCloudStreamingConnection;
+
+    // Objects of shapes are prepared in background, then added to the scene batch after batch
+    GraphicsObjectLoader m_gfxObjectLoader;
+    std::unordered_set<const AIS_InteractiveObject*> m_setLoadingObject;
+    SignalConnectionHandle m_gfxObjectLoaderConnection;
 };
 
 } // namespace Mayo
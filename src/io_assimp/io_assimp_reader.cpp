@@ -10,6 +10,7 @@
 #include "../base/cpp_utils.h"
 #include "../base/document.h"
 #include "../base/filepath_conv.h"
+#include "../base/image_texture_cache.h"
 #include "../base/math_utils.h"
 #include "../base/mesh_utils.h"
 #include "../base/messenger.h"
@@ -26,12 +27,14 @@
 
 #include <fmt/format.h>
 
+#include <atomic>
 #include <cassert>
 #include <iostream>
 
 #include <gp_Trsf.hxx>
 #include <BRep_Builder.hxx>
 #include <Image_Texture.hxx>
+#include <OSD_Parallel.hxx>
 #include <Poly_Triangulation.hxx>
 #include <TDataStd_Name.hxx>
 #include <XCAFDoc_VisMaterial.hxx>
@@ -135,18 +138,16 @@ Quantity_Color toOccColor(const aiColor4D& color, Quantity_TypeOfColor colorType
 }
 
 // Create an OpenCascade Image_Texture object from assimp texture
+// The texture object is shared with any other texture having the same contents
 Handle(Image_Texture) createOccTexture(const aiTexture* texture)
 {
     const auto textureWidth = texture->mWidth;
     const auto textureHeight = texture->mHeight;
     const auto textureSize = textureHeight == 0 ? textureWidth : 4 * textureWidth * textureHeight;
-    Handle(NCollection_Buffer) buff = new NCollection_Buffer(
-        NCollection_BaseAllocator::CommonBaseAllocator(),
-        textureSize
+    auto textureData = reinterpret_cast<const uint8_t*>(texture->pcData);
+    return ImageTextureCache::global().findOrCreate(
+        Span<const uint8_t>(textureData, textureSize), texture->mFilename.C_Str()
     );
-    auto textureData = reinterpret_cast<const Standard_Byte*>(texture->pcData);
-    std::copy(textureData, textureData + textureSize, buff->ChangeData());
-    return new Image_Texture(buff, texture->mFilename.C_Str());
 }
 
 // Create an OpenCascade Poly_Triangulation object from assimp mesh
@@ -234,6 +235,7 @@ bool AssimpReader::readFile(const FilePath& filepath, TaskProgress* progress)
     m_mapNodeData.clear();
     m_mapEmbeddedTexture.clear();
     m_mapFileTexture.clear();
+    ImageTextureCache::global().purgeUnused();
 
     const unsigned flags =
             aiProcess_Triangulate
@@ -276,22 +278,28 @@ bool AssimpReader::readFile(const FilePath& filepath, TaskProgress* progress)
     // Create OpenCascade elements from the assimp meshes
     //     mesh of triangles -> Poly_Triangulation
     //     mesh lines -> Poly_Polygon3D
+    // Meshes are independent from each other so conversion is run in parallel. This is done once
+    // for all here, transfer() then just has to wire locations and materials
     m_vecTriangulation.resize(m_scene->mNumMeshes);
     std::fill(m_vecTriangulation.begin(), m_vecTriangulation.end(), nullptr);
-    for (unsigned i = 0; i < m_scene->mNumMeshes; ++i) {
+    std::atomic<bool> hasLinePrimitives = false;
+    std::atomic<bool> hasUnsupportedPrimitives = false;
+    OSD_Parallel::For(0, CppUtils::safeStaticCast<int>(m_scene->mNumMeshes), [&](int i) {
         const aiMesh* mesh = m_scene->mMeshes[i];
-        if (mesh->mPrimitiveTypes & aiPrimitiveType_TRIANGLE) {
-            auto triangulation = createOccTriangulation(mesh);
-            m_vecTriangulation.at(i) = triangulation;
-        }
-        else if (mesh->mPrimitiveTypes & aiPrimitiveType_LINE) {
-            // TODO Create and add a Poly_Polygon3D object
-            this->messenger()->emitWarning(AssimpReaderI18N::textIdTr("LINE primitives not supported yet"));
-        }
-        else {
-            this->messenger()->emitWarning(AssimpReaderI18N::textIdTr("Some primitive not supported"));
-        }
-    }
+        if (mesh->mPrimitiveTypes & aiPrimitiveType_TRIANGLE)
+            m_vecTriangulation.at(i) = createOccTriangulation(mesh);
+        else if (mesh->mPrimitiveTypes & aiPrimitiveType_LINE)
+            hasLinePrimitives = true; // TODO Create and add a Poly_Polygon3D object
+        else
+            hasUnsupportedPrimitives = true;
+    });
+
+    // Messenger might not be thread-safe, so report warnings once conversion is done
+    if (hasLinePrimitives)
+        this->messenger()->emitWarning(AssimpReaderI18N::textIdTr("LINE primitives not supported yet"));
+
+    if (hasUnsupportedPrimitives)
+        this->messenger()->emitWarning(AssimpReaderI18N::textIdTr("Some primitive not supported"));
 
     for (unsigned i = 0; i < m_scene->mNumTextures; ++i) {
         const aiTexture* texture = m_scene->mTextures[i];
@@ -410,7 +418,7 @@ Handle(Image_Texture) AssimpReader::findOccTexture(
 
     // Could find an existing filepath for the texture
     if (ptrTextureFilepath) {
-        Handle(Image_Texture) texture = new Image_Texture(filepathTo<TCollection_AsciiString>(*ptrTextureFilepath));
+        Handle(Image_Texture) texture = ImageTextureCache::global().findOrCreate(*ptrTextureFilepath);
         // Cache texture
         m_mapFileTexture.insert({ strFilepath, texture });
         return texture;
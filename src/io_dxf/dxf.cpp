@@ -24,8 +24,24 @@
 #include "../base/filepath.h"
 #include "dxf.h"
 
+#include <fast_float/fast_float.h>
 #include <iostream>
 
+#ifdef _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
 namespace {
 
 class ScopedCLocale {
@@ -69,32 +85,39 @@ template<typename T> bool isStringToErrorValue(T value)
 }
 
 template<typename T>
-T stringToNumeric(const std::string& line, StringToErrorMode errorMode)
+T stringToNumeric(std::string_view line, StringToErrorMode errorMode)
 {
-#if __cpp_lib_to_chars
     T value;
-    auto [ptr, err] = std::from_chars(line.c_str(), line.c_str() + line.size(), value);
-    if (err == std::errc())
-        return value;
+    const char* first = line.data();
+    const char* last = line.data() + line.size();
+    bool ok = false;
+    if constexpr(std::is_same_v<T, double>) {
+        // fast_float is used whatever std::from_chars() supports floating-point types or not
+        // Leading '+' is rejected by from_chars() but accepted by std::stod()
+        if (first != last && *first == '+')
+            ++first;
+
+        ok = fast_float::from_chars(first, last, value).ec == std::errc();
+    }
+    else {
+#if __cpp_lib_to_chars
+        ok = std::from_chars(first, last, value).ec == std::errc();
 #else
-    try {
-        if constexpr(std::is_same_v<T, int>) {
-            return std::stoi(line);
-        }
-        else if constexpr(std::is_same_v<T, unsigned>) {
-            return std::stoul(line);
-        }
-        else if constexpr(std::is_same_v<T, double>) {
-            return std::stod(line);
-        }
-        else {
-            if (errorMode == StringToErrorMode::ReturnErrorValue)
-                return std::numeric_limits<T>::max();
-            else
-                throw std::runtime_error("Failed to fetch numeric value from line:\n" + line);
+        try {
+            const std::string str(line);
+            if constexpr(std::is_same_v<T, int>)
+                value = std::stoi(str);
+            else if constexpr(std::is_same_v<T, unsigned>)
+                value = std::stoul(str);
+
+            ok = true;
+        } catch (...) {
         }
-    } catch (...) {
 #endif
+    }
+
+    if (ok)
+        return value;
 
     if (errorMode == StringToErrorMode::ReturnErrorValue) {
         return std::numeric_limits<T>::max();
@@ -108,33 +131,223 @@ T stringToNumeric(const std::string& line, StringToErrorMode errorMode)
         else if constexpr(std::is_same_v<T, double>)
             strTypeName = "double";
 
-        throw std::runtime_error("Failed to fetch " + strTypeName + " value from line:\n" + line);
-    }
-
-#ifndef __cpp_lib_to_chars
+        throw std::runtime_error("Failed to fetch " + strTypeName + " value from line:\n" + std::string(line));
     }
-#endif
 }
 
-int stringToInt(const std::string& line, StringToErrorMode errorMode)
+int stringToInt(std::string_view line, StringToErrorMode errorMode)
 {
     return stringToNumeric<int>(line, errorMode);
 }
 
-unsigned stringToUnsigned(const std::string& line, StringToErrorMode errorMode)
+unsigned stringToUnsigned(std::string_view line, StringToErrorMode errorMode)
 {
     return stringToNumeric<unsigned>(line, errorMode);
 }
 
-double stringToDouble(const std::string& line, StringToErrorMode errorMode)
+double stringToDouble(std::string_view line, StringToErrorMode errorMode)
 {
     return stringToNumeric<double>(line, errorMode);
 }
 
+FileLineReader::FileLineReader(const char* filepath)
+{
+    if (this->mapFile(filepath))
+        return;
+
+    // Fallback: load the whole file contents in memory
+    // 'filepath' is UTF8-encoded, see mapFile()
+    const Mayo::FilePath fp = std_filesystem::u8path(filepath);
+    std::ifstream ifs(fp, std::ios::in | std::ios::binary);
+    if (!ifs)
+        return;
+
+    const auto fileSize = Mayo::filepathFileSize(fp);
+    if (fileSize > 0) {
+        m_buffer.resize(fileSize);
+        ifs.read(m_buffer.data(), m_buffer.size());
+        m_buffer.resize(ifs.gcount());
+    }
+
+    if (!m_buffer.empty()) {
+        m_begin = m_buffer.data();
+        m_end = m_begin + m_buffer.size();
+        m_pos = m_begin;
+    }
+    else {
+        m_isOpenEmpty = true;
+    }
+}
+
+FileLineReader::~FileLineReader()
+{
+    this->unmapFile();
+}
+
+std::string_view FileLineReader::readLine()
+{
+    if (m_pos == m_end) {
+        m_eof = true;
+        return {};
+    }
+
+    auto itEol = static_cast<const char*>(std::memchr(m_pos, '\n', m_end - m_pos));
+    if (!itEol) {
+        // Last line doesn't end with '\n'
+        const std::string_view line(m_pos, m_end - m_pos);
+        m_pos = m_end;
+        m_eof = true;
+        return line;
+    }
+
+    const std::string_view line(m_pos, itEol - m_pos);
+    m_pos = itEol + 1;
+    return line;
+}
+
+bool FileLineReader::mapFile(const char* filepath)
+{
+#ifdef _WIN32
+    const Mayo::FilePath fp = std_filesystem::u8path(filepath);
+    HANDLE hFile = CreateFileW(
+        fp.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr
+    );
+    if (hFile == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart <= 0) {
+        CloseHandle(hFile);
+        return false;
+    }
+
+    HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(hFile);
+    if (!hMapping)
+        return false;
+
+    void* address = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(hMapping); // Mapped view keeps a reference on the file mapping object
+    if (!address)
+        return false;
+
+    m_mapAddress = address;
+    m_mapSize = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+    const int fd = ::open(filepath, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat fileStat = {};
+    if (::fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode) || fileStat.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* address = ::mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // Mapping stays valid after file descriptor is closed
+    if (address == MAP_FAILED)
+        return false;
+
+#  ifdef MADV_SEQUENTIAL
+    ::madvise(address, fileStat.st_size, MADV_SEQUENTIAL);
+#  endif
+    m_mapAddress = address;
+    m_mapSize = static_cast<std::size_t>(fileStat.st_size);
+#endif
+
+    m_begin = static_cast<const char*>(m_mapAddress);
+    m_end = m_begin + m_mapSize;
+    m_pos = m_begin;
+    return true;
+}
+
+void FileLineReader::unmapFile()
+{
+    if (!m_mapAddress)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_mapAddress);
+#else
+    ::munmap(m_mapAddress, m_mapSize);
+#endif
+    m_mapAddress = nullptr;
+    m_mapSize = 0;
+}
+
 } // namespace DxfPrivate
 
 using namespace DxfPrivate;
 
+namespace {
+
+// Type of DXF objects handled by CDxfRead::ReadObject()
+enum class DxfObjectType {
+    Unknown,
+    Arc, Block, Circle, Dimension, Ellipse, Insert, Layer, Line, LwPolyline, MText, Point,
+    Polyline, Section, Solid, Face3d, Spline, Style, Text, Table, EndSec
+};
+
+// Maps object name to its type with a switch over the first character, this avoids the hashing
+// and allocations required by a std::unordered_map<std::string, ...> lookup
+DxfObjectType toDxfObjectType(std::string_view name)
+{
+    if (name.empty())
+        return DxfObjectType::Unknown;
+
+    switch (name.front()) {
+    case '3':
+        if (name == "3DFACE") return DxfObjectType::Face3d;
+        break;
+    case 'A':
+        if (name == "ARC") return DxfObjectType::Arc;
+        break;
+    case 'B':
+        if (name == "BLOCK") return DxfObjectType::Block;
+        break;
+    case 'C':
+        if (name == "CIRCLE") return DxfObjectType::Circle;
+        break;
+    case 'D':
+        if (name == "DIMENSION") return DxfObjectType::Dimension;
+        break;
+    case 'E':
+        if (name == "ELLIPSE") return DxfObjectType::Ellipse;
+        if (name == "ENDSEC") return DxfObjectType::EndSec;
+        break;
+    case 'I':
+        if (name == "INSERT") return DxfObjectType::Insert;
+        break;
+    case 'L':
+        if (name == "LINE") return DxfObjectType::Line;
+        if (name == "LWPOLYLINE") return DxfObjectType::LwPolyline;
+        if (name == "LAYER") return DxfObjectType::Layer;
+        break;
+    case 'M':
+        if (name == "MTEXT") return DxfObjectType::MText;
+        break;
+    case 'P':
+        if (name == "POINT") return DxfObjectType::Point;
+        if (name == "POLYLINE") return DxfObjectType::Polyline;
+        break;
+    case 'S':
+        if (name == "SECTION") return DxfObjectType::Section;
+        if (name == "SOLID") return DxfObjectType::Solid;
+        if (name == "SPLINE") return DxfObjectType::Spline;
+        if (name == "STYLE") return DxfObjectType::Style;
+        break;
+    case 'T':
+        if (name == "TEXT") return DxfObjectType::Text;
+        if (name == "TABLE") return DxfObjectType::Table;
+        break;
+    }
+
+    return DxfObjectType::Unknown;
+}
+
+} // namespace
+
 Base::Vector3d toVector3d(const double* a)
 {
     Base::Vector3d result;
@@ -1891,7 +2104,7 @@ void CDxfWrite::writeObjectsSection()
 }
 
 CDxfRead::CDxfRead(const char* filepath)
-    : m_ifs(filepath)
+    : m_reader(filepath)
 {
     // start the file
     m_fail = false;
@@ -1903,10 +2116,8 @@ CDxfRead::CDxfRead(const char* filepath)
 
     m_version = RUnknown;
 
-    if (!m_ifs)
+    if (!m_reader.isOpen())
         m_fail = true;
-    else
-        m_ifs.imbue(std::locale::classic());
 }
 
 CDxfRead::~CDxfRead()
@@ -1987,7 +2198,7 @@ bool CDxfRead::ReadLine()
     DxfCoords e = {};
     bool hidden = false;
 
-    while (!m_ifs.eof()) {
+    while (!m_reader.eof()) {
         get_line();
         const int n = stringToInt(m_str, StringToErrorMode::ReturnErrorValue);
         if (n == 0) {
@@ -2046,7 +2257,7 @@ bool CDxfRead::ReadPoint()
 {
     DxfCoords s = {};
 
-    while (!m_ifs.eof()) {
+    while (!m_reader.eof()) {
         get_line();
         const int n = stringToInt(m_str, StringToErrorMode::ReturnErrorValue);
         if (n == 0) {
@@ -2104,7 +2315,7 @@ bool CDxfRead::ReadArc()
     double z_extrusion_dir = 1.0;
     bool hidden = false;
     
-    while (!m_ifs.eof()) {
+    while (!m_reader.eof()) {
         get_line();
         const int n = stringToInt(m_str, StringToErrorMode::ReturnErrorValue);
         if (n == 0) {
@@ -2175,7 +2386,7 @@ bool CDxfRead::ReadSpline()
     int controlPointCount = 0;
     int fitPointCount = 0;
 
-    while (!m_ifs.eof()) {
+    while (!m_reader.eof()) {
         get_line();
         const int n = stringToInt(m_str, StringToErrorMode::ReturnErrorValue);
         if (n == 0) {
@@ -2257,7 +2468,7 @@ bool CDxfRead::ReadCircle()
     DxfCoords c = {}; // centre
     bool hidden = false;
 
-    while (!m_ifs.eof()) {
+    while (!m_reader.eof()) {
         get_line();
         const int n = stringToInt(m_str, StringToErrorMode::ReturnErrorValue);
         if (n == 0) {
@@ -2312,7 +2523,7 @@ bool CDxfRead::ReadMText()
     bool withinAcadColumns = false;
     bool withinAcadDefinedHeight = false;
 
-    while (!m_ifs.eof()) {
+    while (!m_reader.eof()) {
         get_line();
         const int n = stringToInt(m_str, StringToErrorMode::ReturnErrorValue);
         if (n == 0) {
@@ -2468,7 +2679,7 @@ bool CDxfRead::ReadText()
 {
     Dxf_TEXT text;
 
-    while (!m_ifs.eof()) {
+    while (!m_reader.eof()) {
         get_line();
         const int n = stringToInt(m_str, StringToErrorMode::ReturnErrorValue);
         if (n == 0) {
@@ -2486,7 +2697,7 @@ bool CDxfRead::ReadText()
             text.height = mm(stringToDouble(m_str));
             break;
         case 1:
-            text.str = this->toUtf8(m_str);
+            text.str = this->toUtf8(std::string(m_str));
             break;
         case 50:
             text.rotationAngle = stringToDouble(m_str);
@@ -2535,7 +2746,7 @@ bool CDxfRead::ReadEllipse()
     double start = 0; //start of arc
     double end = 0;  // end of arc
 
-    while (!m_ifs.eof()) {
+    while (!m_reader.eof()) {
         get_line();
         const int n = stringToInt(m_str, StringToErrorMode::ReturnErrorValue);
         if (n == 0) {
@@ -2669,7 +2880,7 @@ bool CDxfRead::ReadLwPolyLine()
     int flags;
     bool next_item_found = false;
 
-    while (!m_ifs.eof() && !next_item_found) {
+    while (!m_reader.eof() && !next_item_found) {
         get_line();
         const int n = stringToInt(m_str);
         if (isStringToErrorValue(n)) {
@@ -2677,8 +2888,6 @@ bool CDxfRead::ReadLwPolyLine()
             return false;
         }
 
-        std::istringstream ss;
-        ss.imbue(std::locale::classic());
         switch (n){
         case 0:
             // next item found
@@ -2702,41 +2911,37 @@ bool CDxfRead::ReadLwPolyLine()
                 x_found = false;
                 y_found = false;
             }
-            ss.str(m_str);
-            ss >> x;
-            x = mm(x);
-            if (ss.fail()) {
+            x = stringToDouble(m_str, StringToErrorMode::ReturnErrorValue);
+            if (isStringToErrorValue(x)) {
                 return false;
             }
+            x = mm(x);
             x_found = true;
             break;
         case 20:
             // y
             get_line();
-            ss.str(m_str);
-            ss >> y;
-            y = mm(y);
-            if (ss.fail()) {
+            y = stringToDouble(m_str, StringToErrorMode::ReturnErrorValue);
+            if (isStringToErrorValue(y)) {
                 return false;
             }
+            y = mm(y);
             y_found = true;
             break;
         case 38:
             // elevation
             get_line();
-            ss.str(m_str);
-            ss >> z;
-            z = mm(z);
-            if (ss.fail()) {
+            z = stringToDouble(m_str, StringToErrorMode::ReturnErrorValue);
+            if (isStringToErrorValue(z)) {
                 return false;
             }
+            z = mm(z);
             break;
         case 42:
             // bulge
             get_line();
-            ss.str(m_str);
-            ss >> bulge;
-            if (ss.fail()) {
+            bulge = stringToDouble(m_str, StringToErrorMode::ReturnErrorValue);
+            if (isStringToErrorValue(bulge)) {
                 return false;
             }
             bulge_found = true;
@@ -2770,7 +2975,7 @@ bool CDxfRead::ReadVertex(Dxf_VERTEX* vertex)
 {
     bool x_found = false;
     bool y_found = false;
-    while (!m_ifs.eof()) {
+    while (!m_reader.eof()) {
         get_line();
         const int n = stringToInt(m_str, StringToErrorMode::ReturnErrorValue);
         if (n == 0) {
@@ -2832,7 +3037,7 @@ bool CDxfRead::ReadVertex(Dxf_VERTEX* vertex)
 bool CDxfRead::Read3dFace()
 {
     Dxf_3DFACE face;
-    while (!m_ifs.eof()) {
+    while (!m_reader.eof()) {
         get_line();
         const int n = stringToInt(m_str, StringToErrorMode::ReturnErrorValue);
         if (n == 0) {
@@ -2876,7 +3081,7 @@ bool CDxfRead::ReadSolid()
 {
     Dxf_SOLID solid;
 
-    while (!m_ifs.eof()) {
+    while (!m_reader.eof()) {
         get_line();
         const int n = stringToInt(m_str, StringToErrorMode::ReturnErrorValue);
         if (n == 0) {
@@ -2948,7 +3153,7 @@ bool CDxfRead::ReadEndSec()
 bool CDxfRead::ReadPolyLine()
 {
     Dxf_POLYLINE polyline;
-    while (!m_ifs.eof()) {
+    while (!m_reader.eof()) {
         get_line();
         const int n = stringToInt(m_str, StringToErrorMode::ReturnErrorValue);
         if (isStringToErrorValue(n)) {
@@ -3082,7 +3287,7 @@ bool CDxfRead::ReadInsert()
 {
     Dxf_INSERT insert;
 
-    while (!m_ifs.eof()) {
+    while (!m_reader.eof()) {
         get_line();
         const int n = stringToInt(m_str, StringToErrorMode::ReturnErrorValue);
         if (n == 0) {
@@ -3147,7 +3352,7 @@ bool CDxfRead::ReadDimension()
     DxfCoords p = {}; // dimpoint
     double rot = -1.0; // rotation
 
-    while (!m_ifs.eof()) {
+    while (!m_reader.eof()) {
         get_line();
         const int n = stringToInt(m_str, StringToErrorMode::ReturnErrorValue);
         if (n == 0) {
@@ -3198,7 +3403,7 @@ bool CDxfRead::ReadDimension()
 
 bool CDxfRead::ReadBlockInfo()
 {
-    while (!m_ifs.eof()) {
+    while (!m_reader.eof()) {
         get_line();
         const int n = stringToInt(m_str, StringToErrorMode::ReturnErrorValue);
         if (isStringToErrorValue(n)) {
@@ -3227,31 +3432,37 @@ bool CDxfRead::ReadBlockInfo()
 
 void CDxfRead::get_line()
 {
-    if (!m_unused_line.empty()) {
+    if (m_has_unused_line) {
         m_str = m_unused_line;
-        m_unused_line.clear();
+        m_has_unused_line = false;
         return;
     }
 
-    std::getline(m_ifs, m_str);
-    m_gcount = m_str.size();
+    std::string_view line = m_reader.readLine();
+    m_gcount = line.size();
     ++m_line_nb;
 
-    // Erase leading whitespace characters
-    auto itNonSpace = m_str.begin();
-    while (itNonSpace != m_str.end()) {
-        if (!std::isspace(*itNonSpace))
+    // Skip leading whitespace characters
+    auto itNonSpace = line.begin();
+    while (itNonSpace != line.end()) {
+        if (!std::isspace(static_cast<unsigned char>(*itNonSpace)))
             break;
 
         ++itNonSpace;
     }
 
-    m_str.erase(m_str.begin(), itNonSpace);
+    // No copy, the line is a view on the contents of the file reader
+    line.remove_prefix(itNonSpace - line.begin());
+    m_str = line;
 }
 
-void CDxfRead::put_line(const std::string& value)
+void CDxfRead::put_line(std::string_view value)
 {
-    m_unused_line = value;
+    // 'value' might be a view on m_unused_line
+    if (value.data() != m_unused_line.data())
+        m_unused_line.assign(value.data(), value.size());
+
+    m_has_unused_line = true;
 }
 
 bool CDxfRead::ReadInsUnits()
@@ -3285,7 +3496,7 @@ bool CDxfRead::ReadLayer()
     std::string layername;
     ColorIndex_t colorIndex = -1;
 
-    while (!m_ifs.eof()) {
+    while (!m_reader.eof()) {
         get_line();
         const int n = stringToInt(m_str, StringToErrorMode::ReturnErrorValue);
         if (n == 0) {
@@ -3332,7 +3543,7 @@ bool CDxfRead::ReadStyle()
 {
     Dxf_STYLE style;
 
-    while (!m_ifs.eof()) {
+    while (!m_reader.eof()) {
         get_line();
         const int n = stringToInt(m_str, StringToErrorMode::ReturnErrorValue);
         if (n == 0) {
@@ -3459,6 +3670,53 @@ void CDxfRead::HandleCommonGroupCode(int n)
     }
 }
 
+bool CDxfRead::ReadHeaderVariable(bool* ptrIsHeaderVariable)
+{
+    *ptrIsHeaderVariable = true;
+    if (m_str == "$INSUNITS")
+        return ReadInsUnits();
+    else if (m_str == "$MEASUREMENT")
+        return ReadMeasurement();
+    else if (m_str == "$ACADVER")
+        return ReadAcadVer();
+    else if (m_str == "$DWGCODEPAGE")
+        return ReadDwgCodePage();
+
+    *ptrIsHeaderVariable = false;
+    return true;
+}
+
+bool CDxfRead::ReadObject(bool* ptrIsObjectHandled)
+{
+    *ptrIsObjectHandled = true;
+    switch (toDxfObjectType(m_str)) {
+    case DxfObjectType::Arc: return ReadArc();
+    case DxfObjectType::Block: return ReadBlockInfo();
+    case DxfObjectType::Circle: return ReadCircle();
+    case DxfObjectType::Dimension: return ReadDimension();
+    case DxfObjectType::Ellipse: return ReadEllipse();
+    case DxfObjectType::Insert: return ReadInsert();
+    case DxfObjectType::Layer: return ReadLayer();
+    case DxfObjectType::Line: return ReadLine();
+    case DxfObjectType::LwPolyline: return ReadLwPolyLine();
+    case DxfObjectType::MText: return ReadMText();
+    case DxfObjectType::Point: return ReadPoint();
+    case DxfObjectType::Polyline: return ReadPolyLine();
+    case DxfObjectType::Section: return ReadSection();
+    case DxfObjectType::Solid: return ReadSolid();
+    case DxfObjectType::Face3d: return Read3dFace();
+    case DxfObjectType::Spline: return ReadSpline();
+    case DxfObjectType::Style: return ReadStyle();
+    case DxfObjectType::Text: return ReadText();
+    case DxfObjectType::Table: return ReadTable();
+    case DxfObjectType::EndSec: return ReadEndSec();
+    case DxfObjectType::Unknown: break;
+    }
+
+    *ptrIsObjectHandled = false;
+    return true;
+}
+
 void CDxfRead::DoRead(bool ignore_errors)
 {
     m_ignore_errors = ignore_errors;
@@ -3466,45 +3724,17 @@ void CDxfRead::DoRead(bool ignore_errors)
     if (m_fail)
         return;
 
-    std::unordered_map<std::string, std::function<bool()>> mapHeaderVarHandler;
-    mapHeaderVarHandler.insert({ "$INSUNITS", [=]{ return ReadInsUnits(); } });
-    mapHeaderVarHandler.insert({ "$MEASUREMENT", [=]{ return ReadMeasurement(); } });
-    mapHeaderVarHandler.insert({ "$ACADVER", [=]{ return ReadAcadVer(); } });
-    mapHeaderVarHandler.insert({ "$DWGCODEPAGE", [=]{ return ReadDwgCodePage(); } });
-
-    std::unordered_map<std::string, std::function<bool()>> mapEntityHandler;
-    mapEntityHandler.insert({ "ARC", [=]{ return ReadArc(); } });
-    mapEntityHandler.insert({ "BLOCK", [=]{ return ReadBlockInfo(); } });
-    mapEntityHandler.insert({ "CIRCLE", [=]{ return ReadCircle(); } });
-    mapEntityHandler.insert({ "DIMENSION", [=]{ return ReadDimension(); } });
-    mapEntityHandler.insert({ "ELLIPSE", [=]{ return ReadEllipse(); } });
-    mapEntityHandler.insert({ "INSERT", [=]{ return ReadInsert(); } });
-    mapEntityHandler.insert({ "LAYER", [=]{ return ReadLayer(); } });
-    mapEntityHandler.insert({ "LINE", [=]{ return ReadLine(); } });
-    mapEntityHandler.insert({ "LWPOLYLINE", [=]{ return ReadLwPolyLine(); } });
-    mapEntityHandler.insert({ "MTEXT", [=]{ return ReadMText(); } });
-    mapEntityHandler.insert({ "POINT", [=]{ return ReadPoint(); } });
-    mapEntityHandler.insert({ "POLYLINE", [=]{ return ReadPolyLine(); } });
-    mapEntityHandler.insert({ "SECTION", [=]{ return ReadSection(); } });
-    mapEntityHandler.insert({ "SOLID", [=]{ return ReadSolid(); } });
-    mapEntityHandler.insert({ "3DFACE", [=]{ return Read3dFace(); } });
-    mapEntityHandler.insert({ "SPLINE", [=]{ return ReadSpline(); } });
-    mapEntityHandler.insert({ "STYLE", [=]{ return ReadStyle(); } });
-    mapEntityHandler.insert({ "TEXT", [=]{ return ReadText(); } });
-    mapEntityHandler.insert({ "TABLE", [=]{ return ReadTable(); } });
-    mapEntityHandler.insert({ "ENDSEC", [=]{ return ReadEndSec(); } });
-
     get_line();
 
     ScopedCLocale _(LC_NUMERIC);
-    while (!m_ifs.eof()) {
+    while (!m_reader.eof()) {
         m_ColorIndex = ColorBylayer; // Default
 
-        {   // Handle header variable
-            auto itHandler = mapHeaderVarHandler.find(m_str);
-            if (itHandler != mapHeaderVarHandler.cend()) {
-                const auto& fn = itHandler->second;
-                if (fn())
+        if (!m_str.empty() && m_str.front() == '$') { // Handle header variable
+            bool isHeaderVariable = false;
+            const bool okRead = ReadHeaderVariable(&isHeaderVariable);
+            if (isHeaderVariable) {
+                if (okRead)
                     continue;
                 else
                     return;
@@ -3516,22 +3746,21 @@ void CDxfRead::DoRead(bool ignore_errors)
             if (m_str == "0")
                 get_line(); // Skip again
 
-            auto itHandler = mapEntityHandler.find(m_str);
-            if (itHandler != mapEntityHandler.cend()) {
-                const auto& fn = itHandler->second;
-                bool okRead = false;
-                std::string exceptionMsg;
-                try {
-                    okRead = fn();
-                } catch (const std::runtime_error& err) {
-                    exceptionMsg = err.what();
-                }
+            bool isObjectHandled = false;
+            bool okRead = false;
+            std::string exceptionMsg;
+            try {
+                okRead = ReadObject(&isObjectHandled);
+            } catch (const std::runtime_error& err) {
+                exceptionMsg = err.what();
+            }
 
+            if (isObjectHandled) {
                 if (okRead) {
                     continue;
                 }
                 else {
-                    std::string errMsg = "DXF::DoRead() - Failed to read " + m_str;
+                    std::string errMsg = "DXF::DoRead() - Failed to read " + std::string(m_str);
                     if (!exceptionMsg.empty())
                         errMsg += "\nError: " + exceptionMsg;
 
@@ -590,31 +590,67 @@ namespace DxfPrivate {
 enum class StringToErrorMode { Throw = 0x1, ReturnErrorValue = 0x2 };
 
 double stringToDouble(
-    const std::string& line,
+    std::string_view line,
     StringToErrorMode errorMode = StringToErrorMode::Throw
 );
 
 int stringToInt(
-    const std::string& line,
+    std::string_view line,
     StringToErrorMode errorMode = StringToErrorMode::Throw
 );
 
 unsigned stringToUnsigned(
-    const std::string& line,
+    std::string_view line,
     StringToErrorMode errorMode = StringToErrorMode::Throw
 );
 
+// Provides sequential reading of text lines from a file
+// File contents are memory-mapped when possible, otherwise they are loaded in a memory buffer
+// readLine() follows the semantics of std::getline() so this class can be used as a drop-in
+// replacement of std::ifstream for line-by-line reading
+class FileLineReader {
+public:
+    FileLineReader(const char* filepath);
+    ~FileLineReader();
+
+    FileLineReader(const FileLineReader&) = delete;
+    FileLineReader& operator=(const FileLineReader&) = delete;
+
+    bool isOpen() const { return m_begin != nullptr || m_isOpenEmpty; }
+
+    // Same as std::istream::eof(): returns true once a read operation reached end of contents
+    bool eof() const { return m_eof; }
+
+    // Returns the next line without the end-of-line '\n' character
+    // The returned view is valid until this FileLineReader object is destroyed
+    std::string_view readLine();
+
+private:
+    bool mapFile(const char* filepath);
+    void unmapFile();
+
+    const char* m_begin = nullptr;
+    const char* m_end = nullptr;
+    const char* m_pos = nullptr;
+    bool m_eof = false;
+    bool m_isOpenEmpty = false;
+    void* m_mapAddress = nullptr;
+    std::size_t m_mapSize = 0;
+    std::vector<char> m_buffer; // Used when memory mapping failed
+};
+
 } // namespace DxfPrivate
 
 // derive a class from this and implement it's virtual functions
 class CDxfRead
 {
 private:
-    std::ifstream m_ifs;
+    DxfPrivate::FileLineReader m_reader;
 
     bool m_fail;
-    std::string m_str;
+    std::string_view m_str; // Current line, view on the contents of m_reader or on m_unused_line
     std::string m_unused_line;
+    bool m_has_unused_line = false;
     eDxfUnits_t m_eUnits;
     bool m_measurement_inch;
     std::string m_layer_name;
@@ -676,6 +712,9 @@ private:
     bool ReadDimension();
     bool ReadBlockInfo();
 
+    bool ReadHeaderVariable(bool* ptrIsHeaderVariable);
+    bool ReadObject(bool* ptrIsObjectHandled);
+
     bool ResolveEncoding();
 
     template<unsigned XCode = 10, unsigned YCode = 20, unsigned ZCode = 30>
@@ -705,7 +744,7 @@ private:
 
     void HandleCommonGroupCode(int n);
 
-    void put_line(const std::string& value);
+    void put_line(std::string_view value);
     void ResolveColorIndex();
 
     void ReportError_readInteger(const char* context);
@@ -45,6 +45,7 @@
 #include <gp_Circ.hxx>
 #include <gp_Elips.hxx>
 #include <gp_Trsf.hxx>
+#include <OSD_Parallel.hxx>
 
 #include <fmt/format.h>
 #include <algorithm>
@@ -107,6 +108,14 @@ private:
     std::uintmax_t m_fileReadSize = 0;
     Resource_FormatType m_srcEncoding = Resource_ANSI;
 
+    // Chain of connected straight segments, pending for conversion to a polygonal edge
+    struct PendingPolyline {
+        ColorIndex_t aci = 0;
+        std::vector<gp_Pnt> points;
+    };
+    // Mapping from layer name -> polylines pending for conversion
+    std::unordered_map<std::string, std::vector<PendingPolyline>> m_layerPendingPolylines;
+
 protected:
     void get_line() override;
     bool setSourceEncoding(const std::string& codepage) override;
@@ -119,6 +128,10 @@ public:
     void setParameters(const DxfReader::Parameters& params) { m_params = params; }
     const auto& layers() const { return m_layers; }
 
+    // Converts all pending polylines into polygonal edges(see Parameters::fastLinearEdges)
+    // Conversion is run in parallel for each layer
+    void flushPendingPolylines();
+
     // CDxfRead's virtual functions
     void OnReadLine(const DxfCoords& s, const DxfCoords& e, bool hidden) override;
     void OnReadPolyline(const Dxf_POLYLINE& polyline) override;
@@ -142,6 +155,9 @@ public:
 
     gp_Pnt toPnt(const DxfCoords& coords) const;
     void addShape(const TopoDS_Shape& shape);
+    void addPolylineSegment(const gp_Pnt& p0, const gp_Pnt& p1);
+    void flushPendingPolylines(const std::string& layerName);
+    static void addPolylineEdges(const std::vector<PendingPolyline>& vecPolyline, std::vector<DxfReader::Entity>* ptrVecEntity);
 
     TopoDS_Face makeFace(const Dxf_QuadBase& quad) const;
 };
@@ -160,6 +176,12 @@ public:
                     textIdTr("Group all objects within a layer into a single compound shape"));
         this->fontNameForTextObjects.setDescription(
                     textIdTr("Name of the font to be used when creating shape for text objects"));
+        this->fastLinearEdges.setDescription(
+                    textIdTr("Fast import mode for large drawings\n\n"
+                             "Connected straight segments(lines and polylines) of a layer are "
+                             "collected into polygonal edges instead of creating one geometric edge "
+                             "per segment. Geometric edges are still created for curves(arcs, "
+                             "circles, ellipses, splines)"));
     }
 
     void restoreDefaults() override {
@@ -168,12 +190,14 @@ public:
         this->importAnnotations.setValue(params.importAnnotations);
         this->groupLayers.setValue(params.groupLayers);
         this->fontNameForTextObjects.setValue(0);
+        this->fastLinearEdges.setValue(params.fastLinearEdges);
     }
 
     PropertyDouble scaling{ this, textId("scaling") };
     PropertyBool importAnnotations{ this, textId("importAnnotations") };
     PropertyBool groupLayers{ this, textId("groupLayers") };
     PropertyEnumeration fontNameForTextObjects{ this, textId("fontNameForTextObjects"), &systemFontNames() };
+    PropertyBool fastLinearEdges{ this, textId("fastLinearEdges") };
 };
 
 bool DxfReader::readFile(const FilePath& filepath, TaskProgress* progress)
@@ -183,6 +207,7 @@ bool DxfReader::readFile(const FilePath& filepath, TaskProgress* progress)
     internalReader.setParameters(m_params);
     internalReader.setMessenger(this->messenger() ? this->messenger() : &Messenger::null());
     internalReader.DoRead();
+    internalReader.flushPendingPolylines();
     m_layers = std::move(internalReader.layers());
     return !internalReader.Failed();
 }
@@ -314,6 +339,7 @@ void DxfReader::applyProperties(const PropertyGroup* group)
         m_params.importAnnotations = ptr->importAnnotations;
         m_params.groupLayers = ptr->groupLayers;
         m_params.fontNameForTextObjects = ptr->fontNameForTextObjects.name();
+        m_params.fastLinearEdges = ptr->fastLinearEdges;
     }
 }
 
@@ -417,6 +443,11 @@ void DxfReader::Internal::OnReadLine(const DxfCoords& s, const DxfCoords& e, boo
     if (p0.IsEqual(p1, Precision::Confusion()))
         return;
 
+    if (m_params.fastLinearEdges) {
+        this->addPolylineSegment(p0, p1);
+        return;
+    }
+
     const TopoDS_Edge edge = BRepBuilderAPI_MakeEdge(p0, p1);
     this->addShape(edge);
 }
@@ -730,6 +761,14 @@ void DxfReader::Internal::OnReadSpline(const Dxf_SPLINE& spline)
 void DxfReader::Internal::OnReadInsert(const Dxf_INSERT& ins)
 {
     const std::string prefix = "BLOCKS " + ins.blockName + " ";
+    if (m_params.fastLinearEdges) {
+        // Block entities are about to be instantiated so they must be complete
+        for (const auto& [layerName, vecPolyline] : m_layerPendingPolylines) {
+            if (startsWith(layerName, prefix))
+                this->flushPendingPolylines(layerName);
+        }
+    }
+
     for (const auto& [k, vecEntity] : m_layers) {
         if (!startsWith(k, prefix))
             continue; // Skip
@@ -867,6 +906,70 @@ void DxfReader::Internal::addShape(const TopoDS_Shape& shape)
     }
 }
 
+void DxfReader::Internal::addPolylineSegment(const gp_Pnt& p0, const gp_Pnt& p1)
+{
+    std::vector<PendingPolyline>& vecPolyline = m_layerPendingPolylines[this->LayerName()];
+    if (!vecPolyline.empty()) {
+        // Extend last polyline if segment is connected to it
+        PendingPolyline& polyline = vecPolyline.back();
+        if (polyline.aci == m_ColorIndex && polyline.points.back().IsEqual(p0, Precision::Confusion())) {
+            polyline.points.push_back(p1);
+            return;
+        }
+    }
+
+    PendingPolyline newPolyline;
+    newPolyline.aci = m_ColorIndex;
+    newPolyline.points = { p0, p1 };
+    vecPolyline.push_back(std::move(newPolyline));
+}
+
+void DxfReader::Internal::flushPendingPolylines(const std::string& layerName)
+{
+    auto itFound = m_layerPendingPolylines.find(layerName);
+    if (itFound == m_layerPendingPolylines.end() || itFound->second.empty())
+        return;
+
+    Internal::addPolylineEdges(itFound->second, &m_layers[layerName]);
+    itFound->second.clear();
+}
+
+void DxfReader::Internal::flushPendingPolylines()
+{
+    // Make sure target layers exist before parallel processing, so m_layers isn't modified
+    // concurrently
+    using LayerPolylinesEntities = std::pair<const std::vector<PendingPolyline>*, std::vector<DxfReader::Entity>*>;
+    std::vector<LayerPolylinesEntities> vecLayerData;
+    for (const auto& [layerName, vecPolyline] : m_layerPendingPolylines) {
+        if (!vecPolyline.empty())
+            vecLayerData.push_back({ &vecPolyline, &m_layers[layerName] });
+    }
+
+    const int layerCount = CppUtils::safeStaticCast<int>(vecLayerData.size());
+    OSD_Parallel::For(0, layerCount, [&](int i) {
+        const LayerPolylinesEntities& layerData = vecLayerData.at(i);
+        Internal::addPolylineEdges(*layerData.first, layerData.second);
+    });
+
+    m_layerPendingPolylines.clear();
+}
+
+void DxfReader::Internal::addPolylineEdges(
+        const std::vector<PendingPolyline>& vecPolyline, std::vector<DxfReader::Entity>* ptrVecEntity
+    )
+{
+    ptrVecEntity->reserve(ptrVecEntity->size() + vecPolyline.size());
+    for (const PendingPolyline& polyline : vecPolyline) {
+        const int nodeCount = CppUtils::safeStaticCast<int>(polyline.points.size());
+        MeshUtils::Polygon3dBuilder polygonBuilder(nodeCount);
+        for (int i = 0; i < nodeCount; ++i)
+            polygonBuilder.setNode(i + 1, polyline.points.at(i));
+
+        polygonBuilder.finalize();
+        ptrVecEntity->push_back({ polyline.aci, BRepUtils::makeEdge(polygonBuilder.get()) });
+    }
+}
+
 TopoDS_Face DxfReader::Internal::makeFace(const Dxf_QuadBase& quad) const
 {
     const gp_Pnt p1 = this->toPnt(quad.corner1);
@@ -28,6 +28,7 @@ public:
         bool importAnnotations = true;
         bool groupLayers = true;
         std::string fontNameForTextObjects = "Arial";
+        bool fastLinearEdges = false;
     };
     Parameters& parameters() { return m_params; }
     const Parameters& constParameters() const { return m_params; }
@@ -17,6 +17,7 @@
 #include "../base/occ_progress_indicator.h"
 #include "../base/property_builtins.h"
 #include "../base/property_enumeration.h"
+#include "../base/string_conv.h"
 #include "../base/task_progress.h"
 #include "../base/tkernel_utils.h"
 #include "../graphics/graphics_scene.h"
@@ -28,8 +29,15 @@
 #include <Image_AlienPixMap.hxx>
 #include <V3d_View.hxx>
 
+#include <fmt/format.h>
 #include <gsl/util>
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <deque>
 #include <limits>
+#include <mutex>
+#include <thread>
 #include <unordered_set>
 
 namespace Mayo {
@@ -59,6 +67,12 @@ public:
         this->cameraOrientation.setDescription(
                     ImageWriterI18N::textIdTr("Camera orientation expressed in Z-up convention as a unit vector"));
         this->cameraProjection.mutableEnumeration().changeTrContext(ImageWriterI18N::textIdContext());
+        this->batchMode.setDescription(
+                    ImageWriterI18N::textIdTr("Render each item into its own image file, named after the "
+                                              "target file suffixed with item and view names"));
+        this->batchAxisViews.setDescription(
+                    ImageWriterI18N::textIdTr("Batch mode: also render the six axis-aligned views(front, back, "
+                                              "left, right, top, bottom) of each item"));
     }
 
     void restoreDefaults() override {
@@ -68,6 +82,8 @@ public:
         this->backgroundColor.setValue(defaults.backgroundColor);
         this->cameraOrientation.setValue(defaults.cameraOrientation);
         this->cameraProjection.setValue(defaults.cameraProjection);
+        this->batchMode.setValue(defaults.batchMode);
+        this->batchAxisViews.setValue(defaults.batchAxisViews);
     }
 
     PropertyInt width{ this, ImageWriterI18N::textId("width") };
@@ -75,6 +91,8 @@ public:
     PropertyOccColor backgroundColor{ this, ImageWriterI18N::textId("backgroundColor") };
     PropertyOccVec cameraOrientation{ this, ImageWriterI18N::textId("cameraOrientation") };
     PropertyEnum<CameraProjection> cameraProjection{ this, ImageWriterI18N::textId("cameraProjection") };
+    PropertyBool batchMode{ this, ImageWriterI18N::textId("batchMode") };
+    PropertyBool batchAxisViews{ this, ImageWriterI18N::textId("batchAxisViews") };
 };
 
 namespace {
@@ -84,6 +102,98 @@ bool isVectorNull(const gp_Vec& vec)
     return vec.IsEqual({}, Precision::Confusion(), Precision::Angular());
 }
 
+// Saves images to files with a fixed count of worker threads
+// The count of pending images is bounded to keep memory usage under control: save() blocks while
+// the queue is full
+class ImageFileSaver {
+public:
+    ImageFileSaver()
+    {
+        const unsigned threadCount = std::clamp(std::thread::hardware_concurrency(), 1u, 4u);
+        m_maxPendingCount = 2 * threadCount;
+        for (unsigned i = 0; i < threadCount; ++i)
+            m_vecThread.emplace_back([=]{ this->run(); });
+    }
+
+    ~ImageFileSaver()
+    {
+        this->waitForFinished();
+    }
+
+    void save(const Handle_Image_AlienPixMap& pixmap, const FilePath& filepath)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_conditionNotFull.wait(lock, [=]{ return m_queueJob.size() < m_maxPendingCount; });
+        m_queueJob.push_back({ pixmap, filepath });
+        m_conditionNotEmpty.notify_one();
+    }
+
+    // Saves the pending images and stops the worker threads
+    void waitForFinished()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_isFinishRequested = true;
+        }
+
+        m_conditionNotEmpty.notify_all();
+        for (std::thread& thread : m_vecThread)
+            thread.join();
+
+        m_vecThread.clear();
+    }
+
+    // Valid after waitForFinished()
+    const std::vector<FilePath>& failedFilepaths() const { return m_vecFailedFilepath; }
+
+private:
+    struct Job {
+        Handle_Image_AlienPixMap pixmap;
+        FilePath filepath;
+    };
+
+    void run()
+    {
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_conditionNotEmpty.wait(lock, [=]{ return m_isFinishRequested || !m_queueJob.empty(); });
+                if (m_queueJob.empty())
+                    return;
+
+                job = std::move(m_queueJob.front());
+                m_queueJob.pop_front();
+                m_conditionNotFull.notify_one();
+            }
+
+            if (!job.pixmap->Save(filepathTo<TCollection_AsciiString>(job.filepath))) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_vecFailedFilepath.push_back(job.filepath);
+            }
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_conditionNotEmpty;
+    std::condition_variable m_conditionNotFull;
+    std::deque<Job> m_queueJob;
+    size_t m_maxPendingCount = 0;
+    bool m_isFinishRequested = false;
+    std::vector<std::thread> m_vecThread;
+    std::vector<FilePath> m_vecFailedFilepath;
+};
+
+// Returns 'str' with all characters not suitable for a filename replaced by underscores
+std::string toFilenamePart(std::string_view str)
+{
+    std::string part(str);
+    std::replace_if(part.begin(), part.end(), [](char c) {
+        return !std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_' && c != '.';
+    }, '_');
+    return part;
+}
+
 } // namespace
 
 ImageWriter::ImageWriter(GuiApplication* guiApp)
@@ -106,6 +216,9 @@ bool ImageWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
     if (isVectorNull(m_params.cameraOrientation))
         this->messenger()->emitError(ImageWriterI18N::textIdTr("Camera orientation vector must not be null"));
 
+    if (m_params.batchMode)
+        return this->writeBatchFiles(filepath, progress);
+
     // Create 3D view
     GraphicsScene gfxScene;
     Handle_V3d_View view = ImageWriter::createV3dView(&gfxScene, m_params);
@@ -140,6 +253,107 @@ bool ImageWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
     return okSave;
 }
 
+bool ImageWriter::writeBatchFiles(const FilePath& filepath, TaskProgress* progress)
+{
+    struct BatchView {
+        std::string_view name;
+        V3d_TypeOfOrientation orientation;
+    };
+    const BatchView axisViews[] = {
+        { "front", V3d_Yneg }, { "back", V3d_Ypos }, { "left", V3d_Xneg },
+        { "right", V3d_Xpos }, { "top", V3d_Zpos }, { "bottom", V3d_Zneg }
+    };
+    const Span<const BatchView> spanAxisViews = m_params.batchAxisViews ? Span<const BatchView>(axisViews) : Span<const BatchView>{};
+
+    // Single 3D view reused for all items, so the OpenGL context is created once
+    GraphicsScene gfxScene;
+    Handle_V3d_View view = ImageWriter::createV3dView(&gfxScene, m_params);
+    const gp_Vec mainViewOrientation = !isVectorNull(m_params.cameraOrientation) ? m_params.cameraOrientation : gp_Vec(1, -1, 1);
+
+    // Offscreen framebuffer shared by all renderings, V3d_View::ToPixMap() would otherwise create
+    // and release a framebuffer at each call
+    Handle_Standard_Transient fbo = view->View()->FBOCreate(m_params.width, m_params.height);
+    view->View()->SetFBO(fbo);
+
+    // Images are encoded and saved by a fixed count of worker threads, while next images are rendered
+    ImageFileSaver imageSaver;
+    auto _ = gsl::finally([&]{
+        imageSaver.waitForFinished();
+        view->View()->SetFBO({});
+        view->View()->FBORelease(fbo);
+    });
+
+    const std::string filepathStem = filepath.stem().u8string();
+    const std::string filepathExtension = filepath.extension().u8string();
+    std::unordered_set<std::string> setItemName;
+    bool okRender = true;
+    const int itemCount = CppUtils::safeStaticCast<int>(m_vecAppItem.size());
+    for (const ApplicationItem& appItem : m_vecAppItem) {
+        const auto itemIndex = &appItem - &m_vecAppItem.front();
+        if (TaskProgress::isAbortRequested(progress))
+            break;
+
+        // Create graphics objects of the item
+        std::vector<GraphicsObjectPtr> vecGfxObject;
+        std::string itemName;
+        if (appItem.isDocument()) {
+            const DocumentPtr doc = appItem.document();
+            itemName = doc->name();
+            for (int i = 0; i < doc->entityCount(); ++i)
+                vecGfxObject.push_back(m_guiApp->createGraphicsObject(doc->entityLabel(i)));
+        }
+        else if (appItem.isDocumentTreeNode()) {
+            const TDF_Label labelNode = appItem.documentTreeNode().label();
+            itemName = to_stdString(CafUtils::labelAttrStdName(labelNode));
+            vecGfxObject.push_back(m_guiApp->createGraphicsObject(labelNode));
+        }
+
+        // Item names must be unique as they are part of the image filenames
+        itemName = toFilenamePart(itemName);
+        if (itemName.empty() || setItemName.find(itemName) != setItemName.cend())
+            itemName += fmt::format("{}item{}", itemName.empty() ? "" : "_", itemIndex);
+
+        setItemName.insert(itemName);
+
+        for (const GraphicsObjectPtr& gfxObject : vecGfxObject)
+            gfxScene.addObject(gfxObject);
+
+        auto fnRenderView = [&](std::string_view viewName) {
+            GraphicsUtils::V3dView_fitAll(view);
+            Handle_Image_AlienPixMap pixmap = ImageWriter::createImage(view);
+            if (!pixmap) {
+                okRender = false;
+                return;
+            }
+
+            const std::string imageFilename = fmt::format("{}_{}_{}{}", filepathStem, itemName, viewName, filepathExtension);
+            imageSaver.save(pixmap, filepath.parent_path() / filepathFrom(imageFilename));
+        };
+
+        view->SetProj(mainViewOrientation.X(), mainViewOrientation.Y(), mainViewOrientation.Z());
+        fnRenderView("view");
+        for (const BatchView& axisView : spanAxisViews) {
+            view->SetProj(axisView.orientation);
+            fnRenderView(axisView.name);
+        }
+
+        for (const GraphicsObjectPtr& gfxObject : vecGfxObject)
+            gfxScene.eraseObject(gfxObject);
+
+        progress->setValue(MathUtils::toPercent(itemIndex + 1, 0, itemCount));
+    }
+
+    // Wait for all images to be saved
+    imageSaver.waitForFinished();
+    for (const FilePath& failedFilepath : imageSaver.failedFilepaths()) {
+        this->messenger()->emitError(
+            fmt::format(ImageWriterI18N::textIdTr("Failed to write image '{}'"), failedFilepath.u8string())
+        );
+    }
+
+    return okRender && imageSaver.failedFilepaths().empty();
+}
+
 std::unique_ptr<PropertyGroup> ImageWriter::createProperties(PropertyGroup* parentGroup)
 {
     return std::make_unique<Properties>(parentGroup);
@@ -154,6 +368,8 @@ void ImageWriter::applyProperties(const PropertyGroup* params)
         m_params.backgroundColor = ptr->backgroundColor;
         m_params.cameraOrientation = ptr->cameraOrientation;
         m_params.cameraProjection = ptr->cameraProjection;
+        m_params.batchMode = ptr->batchMode;
+        m_params.batchAxisViews = ptr->batchAxisViews;
     }
 }
 
@@ -54,6 +54,11 @@ public:
         Quantity_Color backgroundColor = Quantity_NOC_BLACK;
         gp_Vec cameraOrientation = gp_Vec(1, -1, 1); // X+ Y- Z+
         CameraProjection cameraProjection = CameraProjection::Orthographic;
+        // Each transferred item is rendered into its own image file(s), named after the target
+        // file path suffixed with item and view names
+        bool batchMode = false;
+        // Batch mode: the six axis-aligned views are also rendered for each item
+        bool batchAxisViews = false;
     };
     Parameters& parameters() { return m_params; }
     const Parameters& constParameters() const { return m_params; }
@@ -65,6 +70,8 @@ public:
 
 private:
     class Properties;
+    bool writeBatchFiles(const FilePath& filepath, TaskProgress* progress);
+
     GuiApplication* m_guiApp = nullptr;
     Parameters m_params;
     std::vector<ApplicationItem> m_vecAppItem;
@@ -7,12 +7,17 @@
 #include "io_occ_base_mesh.h"
 
 #include "../base/document.h"
+#include "../base/image_texture_cache.h"
 #include "../base/occ_progress_indicator.h"
 #include "../base/task_progress.h"
 #include "../base/string_conv.h"
 #include "../base/tkernel_utils.h"
 
 #include <RWMesh_CafReader.hxx>
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+#  include <XCAFDoc_VisMaterial.hxx>
+#  include <XCAFDoc_VisMaterialTool.hxx>
+#endif
 
 namespace Mayo {
 namespace IO {
@@ -78,7 +83,17 @@ TDF_LabelSequence OccBaseMeshReader::transfer(DocumentPtr doc, TaskProgress* pro
     m_reader.SetDocument(doc);
     const TDF_LabelSequence seqMark = doc->xcaf().topLevelFreeShapes();
     Handle_Message_ProgressIndicator indicator = new OccProgressIndicator(progress);
+    ImageTextureCache::global().purgeUnused();
     m_reader.Perform(m_filepath.u8string().c_str(), TKernelUtils::start(indicator));
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+    // Replace textures created by the reader with shared ones, so models referencing the same
+    // image files(or same embedded images) don't duplicate texture data
+    TDF_LabelSequence seqMaterial;
+    doc->xcaf().visMaterialTool()->GetMaterials(seqMaterial);
+    for (const TDF_Label& labelMaterial : seqMaterial)
+        ImageTextureCache::global().shareTextures(doc->xcaf().visMaterialTool()->GetMaterial(labelMaterial));
+#endif
+
     return doc->xcaf().diffTopLevelFreeShapes(seqMark);
 }
 
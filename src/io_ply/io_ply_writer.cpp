@@ -14,6 +14,7 @@
 #include "../base/math_utils.h"
 #include "../base/mesh_access.h"
 #include "../base/messenger.h"
+#include "../base/point_cloud_octree.h"
 #include "../base/property_builtins.h"
 #include "../base/property_enumeration.h"
 #include "../base/task_progress.h"
@@ -286,7 +287,12 @@ void PlyWriter::addMesh(const IMeshAccess& mesh)
 
 void PlyWriter::addPointCloud(const PointCloudDataPtr& pntCloud)
 {
-    const Handle(Graphic3d_ArrayOfPoints)& points = pntCloud->points();
+    // Points streamed from an octree are all loaded, as the writer keeps all the nodes in memory
+    const Handle(Graphic3d_ArrayOfPoints) points =
+            pntCloud->octree() ? pntCloud->octree()->readAllPoints() : pntCloud->points();
+    if (points.IsNull())
+        return;
+
     const int pntCount = points->VertexNumber();
     for (int i = 1; i <= pntCount; ++i) {
         const Vertex vertex = PlyWriter::toVertex(points->Vertice(i));
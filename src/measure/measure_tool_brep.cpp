@@ -515,13 +515,7 @@ MeasureArea MeasureToolBRep::brepArea(const TopoDS_Shape& shape)
         const Handle_Poly_Triangulation& triangulation = BRep_Tool::Triangulation(face, loc);
         throwErrorIf<ErrorCode::NotGeometricOrTriangulationFace>(triangulation.IsNull());
         areaResult.value = MeshUtils::triangulationArea(triangulation) * Quantity_SquareMillimeter;
-
-        for (int i = 1; i <= triangulation->NbNodes(); ++i) {
-            const gp_Pnt node = triangulation->Node(i).Transformed(loc);
-            areaResult.middlePnt.Translate(node.XYZ());
-        }
-
-        areaResult.middlePnt.ChangeCoord().Divide(triangulation->NbNodes());
+        areaResult.middlePnt = gp_Pnt(MeshUtils::triangulationCentroid(triangulation)).Transformed(loc);
     }
 
     return areaResult;
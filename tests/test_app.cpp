@@ -17,8 +17,20 @@
 #include "../src/app/qtgui_utils.h"
 #include "../src/app/recent_files.h"
 #include "../src/app/theme.h"
+#include "../src/base/application.h"
+#include "../src/base/document.h"
+#include "../src/base/task_progress.h"
+#include "../src/base/xcaf.h"
+#include "../src/io_dxf/io_dxf.h"
 #include "../src/io_occ/io_occ.h"
 
+#include <BRep_Tool.hxx>
+#include <BRepBndLib.hxx>
+#include <Bnd_Box.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopoDS.hxx>
+
 #include <QtCore/QtDebug>
 #include <QtCore/QFile>
 #include <QtCore/QTemporaryFile>
@@ -27,6 +39,9 @@
 #include <QtGui/QPixmap>
 #include <QtTest/QSignalSpy>
 
+#include <gsl/util>
+#include <cmath>
+
 namespace Mayo {
 
 void TestApp::FilePathConv_test()
@@ -189,4 +204,54 @@ void TestApp::QtGuiUtils_test()
     QCOMPARE(QtGuiUtils::toQColor(occColorA), qtColorA);
 }
 
+void TestApp::IO_DxfFastLinearEdges_test()
+{
+    struct ImportResult {
+        int edgeCount = 0;
+        int polygonalEdgeCount = 0;
+        Bnd_Box bndBox;
+    };
+    auto fnImport = [](bool fastLinearEdges) {
+        ImportResult result;
+        auto app = Application::instance();
+        DocumentPtr doc = app->newDocument();
+        auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+        IO::DxfReader reader;
+        reader.parameters().fastLinearEdges = fastLinearEdges;
+        if (!reader.readFile("tests/inputs/sample.dxf", &TaskProgress::null()))
+            return result;
+
+        for (const TDF_Label& label : reader.transfer(doc, &TaskProgress::null())) {
+            const TopoDS_Shape shape = XCaf::shape(label);
+            TopTools_IndexedMapOfShape mapEdge;
+            TopExp::MapShapes(shape, TopAbs_EDGE, mapEdge);
+            result.edgeCount += mapEdge.Extent();
+            for (int i = 1; i <= mapEdge.Extent(); ++i) {
+                TopLoc_Location loc;
+                if (BRep_Tool::Polygon3D(TopoDS::Edge(mapEdge.FindKey(i)), loc))
+                    ++result.polygonalEdgeCount;
+            }
+
+            BRepBndLib::Add(shape, result.bndBox);
+        }
+
+        return result;
+    };
+
+    const ImportResult resultRegular = fnImport(false);
+    const ImportResult resultFast = fnImport(true);
+    QVERIFY(resultRegular.edgeCount > 0);
+    QVERIFY(!resultRegular.bndBox.IsVoid());
+
+    // The LINE entities of the sample don't share the same color, so they aren't merged into a
+    // single polygonal edge: edge count is the same but they are now polygonal
+    QCOMPARE(resultFast.edgeCount, resultRegular.edgeCount);
+    QVERIFY(resultFast.polygonalEdgeCount > resultRegular.polygonalEdgeCount);
+
+    // Imported geometry covers the same space
+    const double tolerance = 1e-4 * std::sqrt(resultRegular.bndBox.SquareExtent());
+    QVERIFY(resultFast.bndBox.CornerMin().IsEqual(resultRegular.bndBox.CornerMin(), tolerance));
+    QVERIFY(resultFast.bndBox.CornerMax().IsEqual(resultRegular.bndBox.CornerMax(), tolerance));
+}
+
 } // namespace Mayo
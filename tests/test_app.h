@@ -26,6 +26,8 @@ private slots:
     void StringConv_test();
 
     void QtGuiUtils_test();
+
+    void IO_DxfFastLinearEdges_test();
 };
 
 } // namespace Mayo
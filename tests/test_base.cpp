@@ -12,6 +12,9 @@
 #include "test_base.h"
 
 #include "../src/base/application.h"
+#include "../src/base/bnd_box_engine.h"
+#include "../src/base/bnd_utils.h"
+#include "../src/base/brep_mesh_cache.h"
 #include "../src/base/brep_utils.h"
 #include "../src/base/caf_utils.h"
 #include "../src/base/cpp_utils.h"
@@ -20,33 +23,53 @@
 #include "../src/base/filepath.h"
 #include "../src/base/filepath_conv.h"
 #include "../src/base/geom_utils.h"
+#include "../src/base/image_texture_cache.h"
 #include "../src/base/io_system.h"
 #include "../src/base/occ_static_variables_rollback.h"
 #include "../src/base/libtree.h"
+#include "../src/base/mass_properties.h"
+#include "../src/base/mesh_edge_engine.h"
+#include "../src/base/mesh_lod_engine.h"
+#include "../src/base/mesh_post_process.h"
 #include "../src/base/mesh_utils.h"
 #include "../src/base/meta_enum.h"
+#include "../src/base/point_cloud_octree.h"
 #include "../src/base/property_builtins.h"
 #include "../src/base/property_enumeration.h"
 #include "../src/base/property_value_conversion.h"
 #include "../src/base/string_conv.h"
 #include "../src/base/task_manager.h"
+#include "../src/base/tessellation_stats.h"
 #include "../src/base/tkernel_utils.h"
 #include "../src/base/unit.h"
 #include "../src/base/unit_system.h"
+#include "../src/io_dxf/dxf.h"
 #include "../src/io_dxf/io_dxf.h"
 #include "../src/io_occ/io_occ.h"
 #include "../src/io_ply/io_ply_reader.h"
 #include "../src/io_ply/io_ply_writer.h"
 
+#include <BRep_Builder.hxx>
 #include <BRep_Tool.hxx>
 #include <BRepAdaptor_Curve.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
 #include <BRepMesh_IncrementalMesh.hxx>
 #include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepPrimAPI_MakeCylinder.hxx>
 #include <GCPnts_TangentialDeflection.hxx>
 #include <Interface_ParamType.hxx>
 #include <Interface_Static.hxx>
 #include <NCollection_String.hxx>
+#include <Poly_PolygonOnTriangulation.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Precision.hxx>
+#include <TColgp_Array1OfPnt.hxx>
 #include <TopAbs_ShapeEnum.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Compound.hxx>
+#include <gp_Dir.hxx>
+#include <gp_Vec.hxx>
 
 #include <QtCore/QtDebug>
 #include <QtCore/QFile>
@@ -60,7 +83,9 @@
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <random>
 #include <sstream>
 #include <type_traits>
 #include <utility>
@@ -597,6 +622,61 @@ void TestBase::IO_bugGitHub166_test_data()
 #endif
 }
 
+void TestBase::IO_DxfFileLineReader_test()
+{
+    QFETCH(QString, strFilePath);
+
+    // Lines read must be the same as the ones read with std::getline() from std::ifstream, which
+    // was used by the original FreeCad's CDxfRead implementation
+    const std::string filepath = strFilePath.toStdString();
+    std::ifstream ifs(filepath, std::ios::in | std::ios::binary);
+    QVERIFY(ifs.is_open());
+    DxfPrivate::FileLineReader reader(filepath.c_str());
+    QVERIFY(reader.isOpen());
+    int lineCount = 0;
+    while (!ifs.eof()) {
+        std::string line;
+        std::getline(ifs, line);
+        QVERIFY(!reader.eof());
+        QCOMPARE(reader.readLine(), std::string_view(line));
+        QCOMPARE(reader.eof(), ifs.eof());
+        ++lineCount;
+    }
+
+    QVERIFY(lineCount > 0);
+
+    // Check the file can be imported
+    auto app = Application::instance();
+    DocumentPtr doc = app->newDocument();
+    const bool okImport = m_ioSystem->importInDocument()
+            .targetDocument(doc)
+            .withFilepath(filepath)
+            .execute();
+    QVERIFY(okImport);
+    QVERIFY(doc->entityCount() > 0);
+    app->closeDocument(doc);
+}
+
+void TestBase::IO_DxfFileLineReader_test_data()
+{
+    QTest::addColumn<QString>("strFilePath");
+
+    QTest::newRow("sample.dxf") << "tests/inputs/sample.dxf";
+    QTest::newRow("sample_crlf.dxf") << "tests/inputs/sample_crlf.dxf";
+}
+
+void TestBase::IO_DxfStringToNumeric_test()
+{
+    using namespace DxfPrivate;
+    QCOMPARE(stringToDouble("1.5"), 1.5);
+    QCOMPARE(stringToDouble("+1.5"), 1.5);
+    QCOMPARE(stringToDouble("-2e3"), -2000.);
+    QCOMPARE(stringToInt("42"), 42);
+    QCOMPARE(stringToDouble("abc", StringToErrorMode::ReturnErrorValue), std::numeric_limits<double>::max());
+    QCOMPARE(stringToInt("", StringToErrorMode::ReturnErrorValue), std::numeric_limits<int>::max());
+    QVERIFY_EXCEPTION_THROWN(stringToDouble("abc"), std::runtime_error);
+}
+
 void TestBase::DoubleToString_test()
 {
     std::optional<std::locale> frLocale = findFrLocale();
@@ -660,6 +740,420 @@ void TestBase::BRepUtils_test()
     }
 }
 
+void TestBase::BRepMeshCache_test()
+{
+    const FilePath dirPath = std_filesystem::temp_directory_path() / "mayo_test_brep_mesh_cache";
+    BRepMeshCache cache(dirPath, 16 * 1024 * 1024);
+    cache.clear();
+    auto _ = gsl::finally([&]{ cache.clear(); });
+
+    OccBRepMeshParameters params;
+    params.Deflection = 0.5;
+    params.Angle = 0.5;
+
+    // Store triangulations of a meshed shape, cylinder has a seam edge
+    const TopoDS_Shape shapeMeshed = BRepPrimAPI_MakeCylinder(10, 25);
+    const std::string key = BRepMeshCache::computeKey(shapeMeshed, params);
+    QVERIFY(!key.empty());
+    QVERIFY(!cache.load(shapeMeshed, key));
+    BRepUtils::computeMesh(shapeMeshed, params);
+    QCOMPARE(BRepMeshCache::computeKey(shapeMeshed, params), key); // Triangulations are ignored
+    QVERIFY(cache.store(shapeMeshed, key));
+    QVERIFY(cache.size() > 0);
+
+    // Same meshing parameters but different geometry
+    QVERIFY(BRepMeshCache::computeKey(BRepPrimAPI_MakeCylinder(10, 26), params) != key);
+
+    // Same geometry but different meshing parameters
+    OccBRepMeshParameters paramsOther = params;
+    paramsOther.Deflection = 0.1;
+    const TopoDS_Shape shapeCached = BRepPrimAPI_MakeCylinder(10, 25);
+    QVERIFY(BRepMeshCache::computeKey(shapeCached, paramsOther) != key);
+
+    // Same geometry and meshing parameters
+    QCOMPARE(BRepMeshCache::computeKey(shapeCached, params), key);
+    QVERIFY(cache.load(shapeCached, key));
+    TopExp_Explorer explMeshed(shapeMeshed, TopAbs_FACE);
+    TopExp_Explorer explCached(shapeCached, TopAbs_FACE);
+    for (; explMeshed.More() && explCached.More(); explMeshed.Next(), explCached.Next()) {
+        const TopoDS_Face& faceMeshed = TopoDS::Face(explMeshed.Current());
+        const TopoDS_Face& faceCached = TopoDS::Face(explCached.Current());
+        TopLoc_Location locMeshed;
+        TopLoc_Location locCached;
+        const auto& triangulationMeshed = BRep_Tool::Triangulation(faceMeshed, locMeshed);
+        const auto& triangulationCached = BRep_Tool::Triangulation(faceCached, locCached);
+        QVERIFY(!triangulationCached.IsNull());
+        QCOMPARE(triangulationCached->NbNodes(), triangulationMeshed->NbNodes());
+        QCOMPARE(triangulationCached->NbTriangles(), triangulationMeshed->NbTriangles());
+
+        // Discretization of edges is restored as well
+        TopExp_Explorer explEdgeMeshed(faceMeshed, TopAbs_EDGE);
+        TopExp_Explorer explEdgeCached(faceCached, TopAbs_EDGE);
+        for (; explEdgeMeshed.More() && explEdgeCached.More(); explEdgeMeshed.Next(), explEdgeCached.Next()) {
+            const TopoDS_Edge& edgeMeshed = TopoDS::Edge(explEdgeMeshed.Current());
+            const TopoDS_Edge& edgeCached = TopoDS::Edge(explEdgeCached.Current());
+            const auto polygonMeshed = BRep_Tool::PolygonOnTriangulation(edgeMeshed, triangulationMeshed, locMeshed);
+            const auto polygonCached = BRep_Tool::PolygonOnTriangulation(edgeCached, triangulationCached, locCached);
+            QCOMPARE(polygonCached.IsNull(), polygonMeshed.IsNull());
+            if (polygonCached)
+                QCOMPARE(polygonCached->NbNodes(), polygonMeshed->NbNodes());
+        }
+    }
+
+    // Eviction
+    cache.setMaxSize(0);
+    cache.evict();
+    QCOMPARE(cache.size(), uint64_t(0));
+    QVERIFY(!cache.load(BRepPrimAPI_MakeCylinder(10, 25), key));
+}
+
+void TestBase::TessellationStats_test()
+{
+    auto app = Application::instance();
+    DocumentPtr doc = app->newDocument();
+    auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+    const bool okImport = m_ioSystem->importInDocument()
+            .targetDocument(doc)
+            .withFilepath("tests/inputs/cube.step")
+            .execute();
+    QVERIFY(okImport);
+    QCOMPARE(doc->entityCount(), 1);
+
+    {   // Not meshed
+        const TessellationStats stats = TessellationStats::compute(doc);
+        QCOMPARE(int(stats.products().size()), 1);
+        QCOMPARE(stats.products().front().instanceCount, 1);
+        QCOMPARE(stats.total().faceCount, 6);
+        QCOMPARE(stats.total().meshedFaceCount, 0);
+        QCOMPARE(stats.total().triangleCount, int64_t(0));
+        QVERIFY(stats.total().meshingTime < 0);
+    }
+
+    OccBRepMeshParameters params;
+    params.Deflection = 0.5;
+    params.Angle = 0.5;
+    int meshingCallCount = 0;
+    auto fnMeshing = [&](const TopoDS_Shape& shape) {
+        ++meshingCallCount;
+        BRepUtils::computeMesh(shape, params);
+    };
+
+    {   // Not meshed, product gets meshed by the report
+        const TessellationStats stats = TessellationStats::compute(doc, fnMeshing);
+        QCOMPARE(meshingCallCount, 1);
+        QCOMPARE(stats.total().meshedFaceCount, 6);
+        QCOMPARE(stats.total().triangleCount, int64_t(12));
+        QVERIFY(stats.total().meshingTime >= 0);
+        // Document shape must be left untouched
+        QCOMPARE(TessellationStats::compute(doc).total().triangleCount, int64_t(0));
+    }
+
+    // Existing triangulations are reported, without meshing
+    BRepUtils::computeMesh(XCaf::shape(doc->entityLabel(0)), params);
+    meshingCallCount = 0;
+    const TessellationStats stats = TessellationStats::compute(doc, fnMeshing);
+    QCOMPARE(meshingCallCount, 0);
+    QCOMPARE(stats.total().meshedFaceCount, 6);
+    QCOMPARE(stats.total().triangleCount, int64_t(12));
+    QCOMPARE(stats.instancedTriangleCount(), int64_t(12));
+    QVERIFY(stats.total().nodeCount > 0);
+    QVERIFY(stats.total().memorySize > 0);
+    QVERIFY(stats.total().meshingTime < 0);
+    QCOMPARE(int(stats.faceTypes().size()), 1);
+    QCOMPARE(stats.faceTypes().front().name, std::string("Plane"));
+    QCOMPARE(stats.faceTypes().front().counters.triangleCount, int64_t(12));
+
+    // Export
+    auto format = TessellationStats::Format::Json;
+    QVERIFY(TessellationStats::formatFromFilePath("report.CSV", &format));
+    QCOMPARE(format, TessellationStats::Format::Csv);
+    QVERIFY(TessellationStats::formatFromFilePath("report.json", &format));
+    QCOMPARE(format, TessellationStats::Format::Json);
+    QVERIFY(!TessellationStats::formatFromFilePath("report.txt", &format));
+
+    const std::string strCsv = stats.toString(TessellationStats::Format::Csv);
+    QVERIFY(strCsv.find("category,name,instances,faces") == 0);
+    QVERIFY(strCsv.find("face_type,Plane,,6,6,12,") != std::string::npos);
+    const std::string strJson = stats.toString(TessellationStats::Format::Json);
+    QVERIFY(strJson.find("\"products\": [") != std::string::npos);
+    QVERIFY(strJson.find("\"instancedTriangles\": 12") != std::string::npos);
+}
+
+void TestBase::MassProperties_test()
+{
+    auto fnFuzzyCompare = [](double lhs, double rhs) {
+        return std::abs(lhs - rhs) <= 1e-6 * std::max(1., std::abs(rhs));
+    };
+
+    {   // Geometric box
+        const MassProperties props = MassPropertiesEngine::compute(BRepPrimAPI_MakeBox(10, 20, 30));
+        QVERIFY(fnFuzzyCompare(props.volume().value(), 6000));
+        QVERIFY(fnFuzzyCompare(props.area().value(), 2200));
+        QVERIFY(props.centroid().IsEqual(gp_Pnt(5, 10, 15), 1e-6));
+        QVERIFY(!props.hasMass);
+        // Ixx = m(dy^2 + dz^2)/12
+        QVERIFY(fnFuzzyCompare(props.inertia().Value(1, 1), 6000 * (20 * 20 + 30 * 30) / 12.));
+        QVERIFY(fnFuzzyCompare(props.inertia().Value(1, 2), 0.));
+
+        gp_Trsf trsf;
+        trsf.SetTranslation(gp_Vec(100, 0, 0));
+        const MassProperties propsMoved = props.transformed(trsf);
+        QVERIFY(fnFuzzyCompare(propsMoved.volume().value(), 6000));
+        QVERIFY(propsMoved.centroid().IsEqual(gp_Pnt(105, 10, 15), 1e-6));
+        QVERIFY(fnFuzzyCompare(propsMoved.inertia().Value(1, 1), props.inertia().Value(1, 1)));
+        QVERIFY(fnFuzzyCompare(propsMoved.inertia().Value(2, 2), props.inertia().Value(2, 2)));
+
+        MassProperties propsSum = props;
+        propsSum.add(propsMoved);
+        QVERIFY(fnFuzzyCompare(propsSum.volume().value(), 12000));
+        QVERIFY(propsSum.centroid().IsEqual(gp_Pnt(55, 10, 15), 1e-6));
+    }
+
+    {   // Compound of two instances of a box, both must be counted
+        const TopoDS_Shape shapeBox = BRepPrimAPI_MakeBox(10, 20, 30);
+        gp_Trsf trsf;
+        trsf.SetTranslation(gp_Vec(100, 0, 0));
+        TopoDS_Compound compound;
+        BRep_Builder builder;
+        builder.MakeCompound(compound);
+        builder.Add(compound, shapeBox);
+        builder.Add(compound, shapeBox.Moved(trsf));
+        const MassProperties props = MassPropertiesEngine::compute(compound);
+        QVERIFY(fnFuzzyCompare(props.volume().value(), 12000));
+        QVERIFY(fnFuzzyCompare(props.area().value(), 4400));
+        QVERIFY(props.centroid().IsEqual(gp_Pnt(55, 10, 15), 1e-6));
+    }
+
+    {   // Mass from density
+        const QuantityDensity density = 7.85 * Quantity_GramPerCubicCentimeter;
+        const MassProperties props = MassPropertiesEngine::compute(BRepPrimAPI_MakeBox(10, 10, 10), density);
+        QVERIFY(props.hasMass);
+        QVERIFY(fnFuzzyCompare(props.mass.value(), 0.00785));
+    }
+
+    // Document labels with cache
+    auto app = Application::instance();
+    DocumentPtr doc = app->newDocument();
+    auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+    const bool okImport = m_ioSystem->importInDocument()
+            .targetDocument(doc)
+            .withFilepath("tests/inputs/cube.step")
+            .execute();
+    QVERIFY(okImport);
+    QCOMPARE(doc->entityCount(), 1);
+
+    MassPropertiesEngine engine;
+    const TDF_Label labelEntity = doc->entityLabel(0);
+    const MassProperties props = engine.get(labelEntity);
+    QVERIFY(fnFuzzyCompare(props.volume().value(), 1000));
+    QVERIFY(fnFuzzyCompare(props.area().value(), 600));
+    QVERIFY(props.centroid().IsEqual(gp_Pnt(5, 5, 5), 1e-6));
+    QVERIFY(engine.cacheSize() > 0);
+    const int cacheSize = engine.cacheSize();
+    QVERIFY(fnFuzzyCompare(engine.get(labelEntity).volume().value(), 1000));
+    QCOMPARE(engine.cacheSize(), cacheSize);
+    engine.erase(doc);
+    QCOMPARE(engine.cacheSize(), 0);
+}
+
+void TestBase::BndBoxEngine_test()
+{
+    auto fnCheckBox = [](const Bnd_Box& box, const gp_Pnt& pntMin, const gp_Pnt& pntMax, double tol) {
+        const BndBoxCoords coords = BndBoxCoords::get(box);
+        return coords.minVertex().IsEqual(pntMin, tol) && coords.maxVertex().IsEqual(pntMax, tol);
+    };
+
+    BndBoxEngine engine;
+    const TopoDS_Shape shapeBox = BRepPrimAPI_MakeBox(10, 20, 30);
+    QVERIFY(fnCheckBox(BndBoxEngine::compute(shapeBox), gp_Pnt(0, 0, 0), gp_Pnt(10, 20, 30), 1e-6));
+    QVERIFY(fnCheckBox(engine.get(shapeBox), gp_Pnt(0, 0, 0), gp_Pnt(10, 20, 30), 1e-6));
+    QCOMPARE(engine.cacheSize(), 1);
+
+    // Compound of two instances of the box, box is computed once
+    gp_Trsf trsf;
+    trsf.SetTranslation(gp_Vec(100, 0, 0));
+    TopoDS_Compound compound;
+    BRep_Builder builder;
+    builder.MakeCompound(compound);
+    builder.Add(compound, shapeBox);
+    builder.Add(compound, shapeBox.Moved(trsf));
+    QVERIFY(fnCheckBox(engine.get(compound), gp_Pnt(0, 0, 0), gp_Pnt(110, 20, 30), 1e-6));
+    QCOMPARE(engine.cacheSize(), 2);
+    QVERIFY(fnCheckBox(engine.get(compound.Moved(trsf)), gp_Pnt(100, 0, 0), gp_Pnt(210, 20, 30), 1e-6));
+    QCOMPARE(engine.cacheSize(), 2);
+
+    // Triangulation mode is recomputed once a face triangulation is replaced in place
+    QVERIFY(fnCheckBox(engine.get(shapeBox, BndBoxEngine::Mode::Triangulation), gp_Pnt(0, 0, 0), gp_Pnt(10, 20, 30), 1e-6));
+    QCOMPARE(engine.cacheSize(), 3);
+    BRepMesh_IncrementalMesh mesher(shapeBox, 0.5);
+    QVERIFY(mesher.IsDone());
+    const TopoDS_Face faceBox = TopoDS::Face(TopExp_Explorer(shapeBox, TopAbs_FACE).Current());
+    TColgp_Array1OfPnt arrayNode(1, 3);
+    arrayNode.SetValue(1, gp_Pnt(0, 0, 0));
+    arrayNode.SetValue(2, gp_Pnt(50, 0, 0));
+    arrayNode.SetValue(3, gp_Pnt(0, 0, 1));
+    Poly_Array1OfTriangle arrayTriangle(1, 1);
+    arrayTriangle.SetValue(1, Poly_Triangle(1, 2, 3));
+    builder.UpdateFace(faceBox, new Poly_Triangulation(arrayNode, arrayTriangle));
+    QVERIFY(fnCheckBox(engine.get(shapeBox, BndBoxEngine::Mode::Triangulation), gp_Pnt(0, 0, 0), gp_Pnt(50, 20, 30), 1e-6));
+    QVERIFY(fnCheckBox(engine.get(shapeBox), gp_Pnt(0, 0, 0), gp_Pnt(10, 20, 30), 1e-6));
+    QCOMPARE(engine.cacheSize(), 3);
+
+    // Geometry mode is recomputed once a face tolerance is changed in place
+    builder.UpdateFace(faceBox, 1.);
+    const Bnd_Box boxTolerance = BndBoxEngine::compute(shapeBox);
+    QVERIFY(!fnCheckBox(boxTolerance, gp_Pnt(0, 0, 0), gp_Pnt(10, 20, 30), 0.5));
+    const BndBoxCoords coordsTolerance = BndBoxCoords::get(boxTolerance);
+    QVERIFY(fnCheckBox(engine.get(shapeBox), coordsTolerance.minVertex(), coordsTolerance.maxVertex(), 1e-6));
+
+    // Entries of shapes no longer referenced are purged
+    engine.clear();
+    engine.get(TopoDS_Shape(BRepPrimAPI_MakeBox(5, 5, 5)));
+    QCOMPARE(engine.cacheSize(), 1);
+    engine.purge();
+    QCOMPARE(engine.cacheSize(), 0);
+}
+
+void TestBase::MeshLodEngine_test()
+{
+    MeshLodEngine engine;
+    const TopoDS_Shape shapeCylinder = BRepPrimAPI_MakeCylinder(10, 20);
+    BRepMesh_IncrementalMesh mesherFine(shapeCylinder, 0.01);
+    QVERIFY(mesherFine.IsDone());
+    const TopoDS_Shape shapeCoarse = BRepBuilderAPI_Copy(shapeCylinder, false/*copyGeom*/, false/*copyMesh*/).Shape();
+    BRepMesh_IncrementalMesh mesherCoarse(shapeCoarse, 1.);
+    QVERIFY(mesherCoarse.IsDone());
+    QVERIFY(MeshLodEngine::triangleCount(shapeCoarse) > 0);
+    QVERIFY(MeshLodEngine::triangleCount(shapeCoarse) < MeshLodEngine::triangleCount(shapeCylinder));
+
+    QVERIFY(!engine.hasLevels(shapeCylinder));
+    engine.setLevels(shapeCylinder, { shapeCoarse });
+    QVERIFY(engine.hasLevels(shapeCylinder));
+    QCOMPARE(engine.cacheSize(), 1);
+
+    // Levels are shared by shapes having the same TShape, whatever their location
+    gp_Trsf trsf;
+    trsf.SetTranslation(gp_Vec(100, 0, 0));
+    const std::vector<TopoDS_Shape> vecLevel = engine.levels(shapeCylinder.Moved(trsf));
+    QCOMPARE(vecLevel.size(), size_t(1));
+    QVERIFY(vecLevel.front().IsSame(shapeCoarse));
+    engine.setLevels(shapeCylinder, {});
+    QCOMPARE(engine.cacheSize(), 0);
+
+    // Entries of shapes no longer referenced are purged
+    engine.setLevels(TopoDS_Shape(BRepPrimAPI_MakeBox(5, 5, 5)), { shapeCoarse });
+    QCOMPARE(engine.cacheSize(), 1);
+    engine.purge();
+    QCOMPARE(engine.cacheSize(), 0);
+}
+
+void TestBase::MeshEdgeEngine_test()
+{
+    MeshEdgeEngine engine;
+    const TopoDS_Shape shapeBox = BRepPrimAPI_MakeBox(10, 20, 30);
+    BRepMesh_IncrementalMesh mesher(shapeBox, 0.1);
+    QVERIFY(mesher.IsDone());
+
+    // Planar faces: only the face boundaries are found, each shared by two faces
+    const MeshEdgeEngine::Edges edgesBox = MeshEdgeEngine::computeEdges(shapeBox, engine.sharpAngle());
+    QVERIFY(edgesBox.vecSharpNode.empty());
+    QVERIFY(edgesBox.vecBoundaryNode.size() % 2 == 0);
+    QVERIFY(edgesBox.vecBoundaryNode.size() >= 2 * 12);
+    QVERIFY(edgesBox.vecBoundaryNode.size() <= 2 * 24);
+
+    // Seam edge of a cylinder isn't a boundary, its triangles being connected on the cylinder
+    const TopoDS_Shape shapeCylinder = BRepPrimAPI_MakeCylinder(5, 10);
+    BRepMesh_IncrementalMesh mesherCylinder(shapeCylinder, 0.1);
+    QVERIFY(mesherCylinder.IsDone());
+    const MeshEdgeEngine::Edges edgesCylinder = MeshEdgeEngine::computeEdges(shapeCylinder, engine.sharpAngle());
+    QVERIFY(!edgesCylinder.vecBoundaryNode.empty());
+    auto fnIsOnSeam = [](const gp_XYZ& node) {
+        // Seam of the cylinder lateral face is the line {x=radius, y=0}
+        return std::abs(node.X() - 5.) < Precision::Confusion() && std::abs(node.Y()) < Precision::Confusion();
+    };
+    for (size_t i = 0; i + 1 < edgesCylinder.vecBoundaryNode.size(); i += 2) {
+        const gp_XYZ& node1 = edgesCylinder.vecBoundaryNode.at(i);
+        const gp_XYZ& node2 = edgesCylinder.vecBoundaryNode.at(i + 1);
+        QVERIFY(!(fnIsOnSeam(node1) && fnIsOnSeam(node2)));
+    }
+
+    // Edges are shared by shapes having the same TShape, whatever their location
+    gp_Trsf trsf;
+    trsf.SetTranslation(gp_Vec(100, 0, 0));
+    const auto edges = engine.edges(shapeBox);
+    QVERIFY(edges);
+    QCOMPARE(edges->vecBoundaryNode.size(), edgesBox.vecBoundaryNode.size());
+    QCOMPARE(engine.edges(shapeBox.Moved(trsf)), edges);
+    QCOMPARE(engine.cacheSize(), 1);
+
+    // Changing the sharp angle invalidates cached edges
+    engine.setSharpAngle(engine.sharpAngle() / 2.);
+    QCOMPARE(engine.cacheSize(), 0);
+
+    // Entries of shapes no longer referenced are purged
+    engine.edges(TopoDS_Shape(BRepPrimAPI_MakeBox(5, 5, 5)));
+    QCOMPARE(engine.cacheSize(), 1);
+    engine.purge();
+    QCOMPARE(engine.cacheSize(), 0);
+}
+
+void TestBase::PointCloudOctree_test()
+{
+    // Enough points so the root node is subdivided
+    constexpr int pointCount = 200000;
+    OccHandle<Graphic3d_ArrayOfPoints> points = new Graphic3d_ArrayOfPoints(pointCount);
+    std::mt19937 randomEngine(42);
+    std::uniform_real_distribution<double> distribution(-50., 50.);
+    for (int i = 0; i < pointCount; ++i)
+        points->AddVertex(distribution(randomEngine), distribution(randomEngine), distribution(randomEngine));
+
+    const FilePath filepath = std_filesystem::temp_directory_path() / "mayo_test_point_cloud.pcoctree";
+    auto _ = gsl::finally([&]{ std_filesystem::remove(filepath); });
+    {
+        auto octree = PointCloudOctree::build(points, filepath);
+        QVERIFY(octree);
+        QCOMPARE(octree->pointCount(), uint64_t(pointCount));
+        QVERIFY(!octree->hasColors());
+        QVERIFY(octree->nodeCount() > 1);
+
+        // Each point is stored in a single node, nodes are less dense than their children
+        uint64_t nodePointCount = 0;
+        for (int i = 0; i < octree->nodeCount(); ++i) {
+            const PointCloudOctree::Node& node = octree->node(i);
+            nodePointCount += node.pointCount;
+            for (int childIndex : node.children) {
+                if (childIndex >= 0)
+                    QVERIFY(octree->node(childIndex).spacing < node.spacing);
+            }
+        }
+
+        QCOMPARE(nodePointCount, uint64_t(pointCount));
+        auto rootPoints = octree->readNodePoints(0);
+        QVERIFY(rootPoints);
+        QCOMPARE(rootPoints->VertexNumber(), int(octree->node(0).pointCount));
+    }
+
+    // Reopen file written previously
+    auto octree = PointCloudOctree::open(filepath);
+    QVERIFY(octree);
+    QCOMPARE(octree->pointCount(), uint64_t(pointCount));
+    QVERIFY(!octree->boundingBox().IsVoid());
+    auto allPoints = octree->readAllPoints();
+    QVERIFY(allPoints);
+    QCOMPARE(allPoints->VertexNumber(), pointCount);
+
+    // Key depends on the points
+    const std::string key = PointCloudOctree::computeKey(points);
+    QVERIFY(!key.empty());
+    QCOMPARE(PointCloudOctree::computeKey(points), key);
+    points->SetVertice(1, gp_Pnt(100, 100, 100));
+    QVERIFY(PointCloudOctree::computeKey(points) != key);
+    // Any point is taken into account, not only a subsample
+    const std::string keyPoint1 = PointCloudOctree::computeKey(points);
+    points->SetVertice(2, gp_Pnt(100, 100, 100));
+    QVERIFY(PointCloudOctree::computeKey(points) != keyPoint1);
+}
+
 void TestBase::CafUtils_test()
 {
     // TODO Add CafUtils::labelTag() test for multi-threaded safety
@@ -788,6 +1282,48 @@ void TestBase::MetaEnum_test()
     QCOMPARE(MetaEnum::nameWithoutPrefix(TopAbs_VERTEX, ""), "TopAbs_VERTEX");
 }
 
+void TestBase::ImageTextureCache_test()
+{
+    ImageTextureCache cache;
+    const uint8_t data1[] = { 0x89, 'P', 'N', 'G', 1, 2, 3, 4 };
+    const uint8_t data2[] = { 0x89, 'P', 'N', 'G', 5, 6, 7, 8 };
+
+    // Same contents should give same texture object
+    OccHandle<Image_Texture> texture1 = cache.findOrCreate(data1, "texture1");
+    OccHandle<Image_Texture> texture1Bis = cache.findOrCreate(data1, "texture1_bis");
+    OccHandle<Image_Texture> texture2 = cache.findOrCreate(data2, "texture2");
+    QVERIFY(!texture1.IsNull());
+    QCOMPARE(texture1, texture1Bis);
+    QVERIFY(texture1 != texture2);
+    QCOMPARE(cache.count(), 2);
+    QCOMPARE(cache.dataSize(), uint64_t(sizeof(data1) + sizeof(data2)));
+
+    // Sharing external texture with same contents should give cached texture
+    OccHandle<NCollection_Buffer> buffer2 = new NCollection_Buffer(
+        NCollection_BaseAllocator::CommonBaseAllocator(), sizeof(data2)
+    );
+    std::memcpy(buffer2->ChangeData(), data2, sizeof(data2));
+    QCOMPARE(cache.share(new Image_Texture(buffer2, "texture2_ext")), texture2);
+
+    // File textures
+    const FilePath fpInput = "tests/inputs/cube.step";
+    OccHandle<Image_Texture> texture3 = cache.findOrCreate(fpInput);
+    QCOMPARE(cache.findOrCreate(fpInput), texture3);
+    QCOMPARE(cache.share(new Image_Texture(filepathTo<TCollection_AsciiString>(fpInput))), texture3);
+    QCOMPARE(cache.count(), 3);
+
+    // Purge textures not referenced anymore
+    texture1.Nullify();
+    texture1Bis.Nullify();
+    cache.purgeUnused();
+    QCOMPARE(cache.count(), 2);
+    QCOMPARE(cache.dataSize(), uint64_t(sizeof(data2)));
+    texture2.Nullify();
+    texture3.Nullify();
+    cache.purgeUnused();
+    QCOMPARE(cache.count(), 0);
+}
+
 void TestBase::MeshUtils_test()
 {
     // Create box
@@ -850,6 +1386,195 @@ void TestBase::MeshUtils_test()
              double(2 * boxDx * boxDy + 2 * boxDy * boxDz + 2 * boxDx * boxDz));
 }
 
+void TestBase::MeshUtils_batch_test()
+{
+    // Random triangles, triangle count isn't a multiple of SIMD width so remainder loops are covered
+    std::mt19937 randomEngine(42);
+    std::uniform_real_distribution<double> coordDistrib(-50., 50.);
+    std::vector<gp_XYZ> vecNode;
+    for (int i = 0; i < 500; ++i)
+        vecNode.emplace_back(coordDistrib(randomEngine), coordDistrib(randomEngine), coordDistrib(randomEngine));
+
+    std::uniform_int_distribution<int> indexDistrib(1, int(vecNode.size()));
+    std::vector<Poly_Triangle> vecTriangle;
+    for (int i = 0; i < 1003; ++i)
+        vecTriangle.emplace_back(indexDistrib(randomEngine), indexDistrib(randomEngine), indexDistrib(randomEngine));
+
+    auto fnFuzzyCompare = [](double lhs, double rhs) {
+        return std::abs(lhs - rhs) <= 1e-9 * std::max(1., std::abs(rhs));
+    };
+    auto fnFuzzyCompareXYZ = [=](const gp_XYZ& lhs, const gp_XYZ& rhs) {
+        return fnFuzzyCompare(lhs.X(), rhs.X()) && fnFuzzyCompare(lhs.Y(), rhs.Y()) && fnFuzzyCompare(lhs.Z(), rhs.Z());
+    };
+
+    // Reference values computed one triangle at a time
+    double refArea = 0.;
+    double refVolume = 0.;
+    gp_XYZ refMoment;
+    for (const Poly_Triangle& tri : vecTriangle) {
+        const gp_XYZ& p1 = vecNode.at(tri.Value(1) - 1);
+        const gp_XYZ& p2 = vecNode.at(tri.Value(2) - 1);
+        const gp_XYZ& p3 = vecNode.at(tri.Value(3) - 1);
+        const double area = MeshUtils::triangleArea(p1, p2, p3);
+        refArea += area;
+        refVolume += MeshUtils::triangleSignedVolume(p1, p2, p3);
+        refMoment += (area / 3.) * (p1 + p2 + p3);
+    }
+
+    const MeshUtils::TriangleBatch batch{ vecNode, vecTriangle };
+    const MeshUtils::SimdInstructionSet simdInstructionSets[] = {
+        MeshUtils::SimdInstructionSet::None, MeshUtils::simdInstructionSet()
+    };
+    for (MeshUtils::SimdInstructionSet simd : simdInstructionSets) {
+        QVERIFY(fnFuzzyCompare(MeshUtils::batchArea(batch, simd), refArea));
+        QVERIFY(fnFuzzyCompare(MeshUtils::batchSignedVolume(batch, simd), refVolume));
+        QVERIFY(fnFuzzyCompareXYZ(MeshUtils::batchCentroid(batch, simd), refMoment / refArea));
+
+        std::vector<gp_XYZ> vecNormal(vecTriangle.size());
+        MeshUtils::batchTriangleNormals(batch, vecNormal, simd);
+        for (const Poly_Triangle& tri : vecTriangle) {
+            const gp_XYZ& p1 = vecNode.at(tri.Value(1) - 1);
+            const gp_XYZ& p2 = vecNode.at(tri.Value(2) - 1);
+            const gp_XYZ& p3 = vecNode.at(tri.Value(3) - 1);
+            const gp_XYZ& normal = vecNormal.at(&tri - &vecTriangle.front());
+            QVERIFY(fnFuzzyCompareXYZ(normal, (p2 - p1).Crossed(p3 - p1)));
+        }
+
+        // Check bounding box with node counts not multiple of SIMD width
+        for (int nodeCount : { 1, 2, 3, 5, 7, int(vecNode.size()) }) {
+            const Span<const gp_XYZ> spanNode(vecNode.data(), nodeCount);
+            gp_XYZ refMin = spanNode.front();
+            gp_XYZ refMax = spanNode.front();
+            for (const gp_XYZ& node : spanNode) {
+                refMin.SetCoord(std::min(refMin.X(), node.X()), std::min(refMin.Y(), node.Y()), std::min(refMin.Z(), node.Z()));
+                refMax.SetCoord(std::max(refMax.X(), node.X()), std::max(refMax.Y(), node.Y()), std::max(refMax.Z(), node.Z()));
+            }
+
+            gp_XYZ pntMin, pntMax;
+            QVERIFY(MeshUtils::batchBoundingBox(spanNode, &pntMin, &pntMax, simd));
+            QVERIFY(pntMin.IsEqual(refMin, 0.));
+            QVERIFY(pntMax.IsEqual(refMax, 0.));
+        }
+    }
+
+    QVERIFY(!MeshUtils::batchBoundingBox({}, nullptr, nullptr));
+    QCOMPARE(MeshUtils::batchArea({}), 0.);
+
+    // Normals at nodes of a single planar quad
+    Handle_Poly_Triangulation mesh = new Poly_Triangulation(4, 2, false);
+    MeshUtils::setNode(mesh, 1, gp_Pnt(0, 0, 0));
+    MeshUtils::setNode(mesh, 2, gp_Pnt(1, 0, 0));
+    MeshUtils::setNode(mesh, 3, gp_Pnt(1, 1, 0));
+    MeshUtils::setNode(mesh, 4, gp_Pnt(0, 1, 0));
+    MeshUtils::setTriangle(mesh, 1, { 1, 2, 3 });
+    MeshUtils::setTriangle(mesh, 2, { 1, 3, 4 });
+
+    {   // Nodes are viewed in the storage of the triangulation, without copy
+        std::vector<gp_XYZ> vecNodeCopy;
+        const Span<const gp_XYZ> spanNode = MeshUtils::contiguousNodes(mesh, &vecNodeCopy);
+        QCOMPARE(int(spanNode.size()), 4);
+        QVERIFY(vecNodeCopy.empty());
+        QVERIFY(spanNode[2].IsEqual(gp_XYZ(1, 1, 0), 0.));
+    }
+
+    MeshUtils::computeNormals(mesh);
+    QVERIFY(mesh->HasNormals());
+    QVERIFY(MeshUtils::triangulationCentroid(mesh).IsEqual(gp_XYZ(0.5, 0.5, 0), 1e-9));
+#if OCC_VERSION_HEX >= 0x070600
+    for (int i = 1; i <= mesh->NbNodes(); ++i)
+        QVERIFY(mesh->Normal(i).IsEqual(gp_Dir(0, 0, 1), 1e-6));
+#endif
+}
+
+void TestBase::MeshPostProcess_test()
+{
+    // Triangle soup of a unit cube, each triangle has its own nodes
+    const TopoDS_Shape shapeBox = BRepPrimAPI_MakeBox(1, 1, 1);
+    BRepMesh_IncrementalMesh mesher(shapeBox, 0.1);
+    std::vector<gp_Pnt> vecSoupNode;
+    BRepUtils::forEachSubFace(shapeBox, [&](const TopoDS_Face& face) {
+        TopLoc_Location locFace;
+        const Handle_Poly_Triangulation& faceMesh = BRep_Tool::Triangulation(face, locFace);
+        for (const Poly_Triangle& tri : MeshUtils::triangles(faceMesh)) {
+            int n1, n2, n3;
+            tri.Get(n1, n2, n3);
+            if (face.Orientation() == TopAbs_REVERSED)
+                std::swap(n2, n3);
+
+            for (int n : { n1, n2, n3 })
+                vecSoupNode.push_back(faceMesh->Node(n));
+        }
+    });
+
+    const int soupTriangleCount = int(vecSoupNode.size() / 3);
+    QCOMPARE(soupTriangleCount, 12);
+    Handle_Poly_Triangulation soup = new Poly_Triangulation(int(vecSoupNode.size()), soupTriangleCount, false);
+    for (int i = 0; i < int(vecSoupNode.size()); ++i)
+        MeshUtils::setNode(soup, i + 1, vecSoupNode.at(i));
+
+    for (int i = 0; i < soupTriangleCount; ++i)
+        MeshUtils::setTriangle(soup, i + 1, { 3 * i + 1, 3 * i + 2, 3 * i + 3 });
+
+    // Welding
+    const MeshPostProcess::Result resWeld = MeshPostProcess::weldNodes(soup, 1e-6);
+    QVERIFY(!resWeld.mesh.IsNull());
+    QCOMPARE(resWeld.mesh->NbNodes(), 8);
+    QCOMPARE(resWeld.mesh->NbTriangles(), 12);
+    QCOMPARE(resWeld.removedTriangleCount, 0);
+    QCOMPARE(int(resWeld.vecSourceNode.size()), 8);
+    QVERIFY(std::abs(MeshUtils::triangulationVolume(resWeld.mesh) - 1.) < 1e-9);
+
+    // Nodes closer than tolerance are merged and degenerated triangles are removed
+    Handle_Poly_Triangulation meshThin = new Poly_Triangulation(3, 1, false);
+    MeshUtils::setNode(meshThin, 1, gp_Pnt(0, 0, 0));
+    MeshUtils::setNode(meshThin, 2, gp_Pnt(1e-4, 0, 0));
+    MeshUtils::setNode(meshThin, 3, gp_Pnt(0, 1, 0));
+    MeshUtils::setTriangle(meshThin, 1, { 1, 2, 3 });
+    const MeshPostProcess::Result resWeldThin = MeshPostProcess::weldNodes(meshThin, 1e-3);
+    QCOMPARE(resWeldThin.mesh->NbNodes(), 2);
+    QCOMPARE(resWeldThin.mesh->NbTriangles(), 0);
+    QCOMPARE(resWeldThin.removedTriangleCount, 1);
+    QCOMPARE(MeshPostProcess::weldNodes(meshThin, 0.).mesh->NbNodes(), 3);
+
+    // Sharp edges of the cube are kept with the default crease angle(30°)
+    const double creaseAngle = MeshPostProcess::Parameters().creaseAngle;
+    const MeshPostProcess::Result resSharp = MeshPostProcess::computeSmoothNormals(resWeld.mesh, creaseAngle);
+    QCOMPARE(resSharp.mesh->NbNodes(), 24);
+    QCOMPARE(resSharp.mesh->NbTriangles(), 12);
+    QVERIFY(resSharp.mesh->HasNormals());
+#if OCC_VERSION_HEX >= 0x070600
+    for (const Poly_Triangle& tri : MeshUtils::triangles(resSharp.mesh)) {
+        int n1, n2, n3;
+        tri.Get(n1, n2, n3);
+        const gp_Pnt& p1 = resSharp.mesh->Node(n1);
+        const gp_Dir triNormal(gp_Vec(p1, resSharp.mesh->Node(n2)) ^ gp_Vec(p1, resSharp.mesh->Node(n3)));
+        for (int n : { n1, n2, n3 })
+            QVERIFY(resSharp.mesh->Normal(n).IsEqual(triNormal, 1e-6));
+    }
+#endif
+
+    // Single normal per node when all triangles are smoothed, normals at cube corners are along the
+    // diagonals thanks to angle weighting
+    const MeshPostProcess::Result resSmooth =
+            MeshPostProcess::computeSmoothNormals(resWeld.mesh, 180 * Quantity_Degree.value());
+    QCOMPARE(resSmooth.mesh->NbNodes(), 8);
+#if OCC_VERSION_HEX >= 0x070600
+    for (int i = 1; i <= resSmooth.mesh->NbNodes(); ++i) {
+        const gp_Dir dirDiagonal(gp_Vec(gp_Pnt(0.5, 0.5, 0.5), resSmooth.mesh->Node(i)));
+        QVERIFY(resSmooth.mesh->Normal(i).IsEqual(dirDiagonal, 1e-6));
+    }
+#endif
+
+    // run() chains welding and normals computation, source nodes refer to the input mesh
+    MeshPostProcess::Parameters params;
+    params.weldTolerance = 1e-6;
+    const MeshPostProcess::Result resRun = MeshPostProcess::run(soup, params);
+    QCOMPARE(resRun.mesh->NbNodes(), 24);
+    QCOMPARE(int(resRun.vecSourceNode.size()), 24);
+    for (int i = 1; i <= resRun.mesh->NbNodes(); ++i)
+        QVERIFY(resRun.mesh->Node(i).IsEqual(soup->Node(resRun.vecSourceNode.at(i - 1)), 1e-6));
+}
+
 void TestBase::MeshUtils_test_data()
 {
     QTest::addColumn<double>("boxDx");
@@ -43,16 +43,31 @@ private slots:
     void IO_OccStaticVariablesRollback_test_data();
     void IO_bugGitHub166_test();
     void IO_bugGitHub166_test_data();
+    void IO_DxfFileLineReader_test();
+    void IO_DxfFileLineReader_test_data();
+    void IO_DxfStringToNumeric_test();
 
     void DoubleToString_test();
     void StringConv_test();
 
     void BRepUtils_test();
+    void BRepMeshCache_test();
 
     void CafUtils_test();
 
+    void ImageTextureCache_test();
+
+    void TessellationStats_test();
+    void MassProperties_test();
+    void BndBoxEngine_test();
+    void MeshEdgeEngine_test();
+    void MeshLodEngine_test();
+    void PointCloudOctree_test();
+
     void MeshUtils_test();
     void MeshUtils_test_data();
+    void MeshUtils_batch_test();
+    void MeshPostProcess_test();
     void MeshUtils_orientation_test();
     void MeshUtils_orientation_test_data();
 